@@ -0,0 +1,239 @@
+// allocator.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "allocator.h"
+
+#if defined(_WIN32)
+#	include <windows.h>
+#	include <malloc.h>
+#else
+#	include <stdlib.h>
+#	include <sys/mman.h>
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// AlignedAllocator
+//
+// Every block is preceded by one alignment unit holding a BlockHeader, so
+// Free() knows how the memory was obtained without any global bookkeeping.
+
+namespace
+{
+	enum BlockKind
+	{
+		BLOCK_ALIGNED	= 0,
+		BLOCK_MAPPED	= 1,
+		BLOCK_LARGEPAGE	= 2
+	};
+
+	struct BlockHeader
+	{
+		void*			pBase;
+		size_t			mapped;
+		Enco::uint32	kind;
+	};
+
+	const size_t g_cnst_huge_page_size = ((size_t)2 << 20);
+}
+
+const size_t AlignedAllocator::m_cnst_alignment = 64;
+
+AlignedAllocator::HugePagePolicy	AlignedAllocator::m_hugePagePolicy = AlignedAllocator::HUGEPAGE_NONE;
+size_t								AlignedAllocator::m_hugePageThreshold = ((size_t)32 << 20);
+
+void* AlignedAllocator::Allocate(const size_t& size)
+{
+	const size_t	total = size + m_cnst_alignment;
+	void*			pBase = nullptr;
+	size_t			mapped = 0;
+	Enco::uint32	kind = BLOCK_ALIGNED;
+
+	if (m_hugePagePolicy != HUGEPAGE_NONE && size >= m_hugePageThreshold)
+	{
+		pBase = _AllocateHuge(total, m_hugePagePolicy, kind, mapped);
+	}
+
+	if (pBase == nullptr)
+	{
+		kind = BLOCK_ALIGNED;
+#if defined(_WIN32)
+		pBase = _aligned_malloc(total, m_cnst_alignment);
+#else
+		if (posix_memalign(&pBase, m_cnst_alignment, total) != 0)
+			pBase = nullptr;
+#endif
+		if (pBase == nullptr)
+			throw std::bad_alloc();
+	}
+
+	BlockHeader* pHeader = static_cast<BlockHeader*>(pBase);
+	pHeader->pBase = pBase;
+	pHeader->mapped = mapped;
+	pHeader->kind = kind;
+
+	return static_cast<Enco::byte*>(pBase) + m_cnst_alignment;
+}
+
+void AlignedAllocator::Free(void* pBlock)
+{
+	if (pBlock == nullptr)
+		return;
+
+	BlockHeader* pHeader = reinterpret_cast<BlockHeader*>(static_cast<Enco::byte*>(pBlock) - m_cnst_alignment);
+	switch (pHeader->kind)
+	{
+#if defined(_WIN32)
+	case BLOCK_LARGEPAGE:
+		VirtualFree(pHeader->pBase, 0, MEM_RELEASE);
+		break;
+	default:
+		_aligned_free(pHeader->pBase);
+		break;
+#else
+	case BLOCK_MAPPED:
+	case BLOCK_LARGEPAGE:
+		munmap(pHeader->pBase, pHeader->mapped);
+		break;
+	default:
+		free(pHeader->pBase);
+		break;
+#endif
+	}
+}
+
+void AlignedAllocator::SetHugePagePolicy(const HugePagePolicy& policy, const size_t& threshold)
+{
+	m_hugePagePolicy = policy;
+	m_hugePageThreshold = threshold;
+}
+
+AlignedAllocator::HugePagePolicy AlignedAllocator::GetHugePagePolicy()
+{
+	return m_hugePagePolicy;
+}
+
+void* AlignedAllocator::_AllocateHuge(const size_t& size, const HugePagePolicy& policy, Enco::uint32& kind, size_t& mapped)
+{
+#if defined(_WIN32)
+	// Windows has no transparent huge pages; large pages need SeLockMemoryPrivilege.
+	if (policy != HUGEPAGE_EXPLICIT)
+		return nullptr;
+
+	const size_t large = GetLargePageMinimum();
+	if (large == 0)
+		return nullptr;
+
+	mapped = (size + large - 1) / large * large;
+	void* pBase = VirtualAlloc(nullptr, mapped, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+	kind = BLOCK_LARGEPAGE;
+	return pBase;
+#else
+	mapped = (size + g_cnst_huge_page_size - 1) / g_cnst_huge_page_size * g_cnst_huge_page_size;
+
+#	if defined(MAP_HUGETLB)
+	if (policy == HUGEPAGE_EXPLICIT)
+	{
+		void* pBase = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (pBase != MAP_FAILED)
+		{
+			kind = BLOCK_LARGEPAGE;
+			return pBase;
+		}
+	}
+#	endif
+
+	void* pBase = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (pBase == MAP_FAILED)
+		return nullptr;
+
+#	if defined(MADV_HUGEPAGE)
+	madvise(pBase, mapped, MADV_HUGEPAGE);
+#	endif
+	kind = BLOCK_MAPPED;
+	return pBase;
+#endif
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ScratchArena
+
+ScratchArena::ScratchArena(const size_t& blockSize) :
+m_current(0), m_offset(0), m_blockSize(blockSize)
+{}
+
+ScratchArena::~ScratchArena()
+{
+	for (Block& block : m_blocks)
+	{
+		AlignedAllocator::Free(block.pData);
+	}
+}
+
+void* ScratchArena::Allocate(const size_t& size)
+{
+	const size_t align = AlignedAllocator::m_cnst_alignment;
+	const size_t rounded = (size + align - 1) / align * align;
+
+	while (m_current < m_blocks.size())
+	{
+		if (m_blocks[m_current].size - m_offset >= rounded)
+		{
+			void* pData = m_blocks[m_current].pData + m_offset;
+			m_offset += rounded;
+			return pData;
+		}
+
+		++m_current;
+		m_offset = 0;
+	}
+
+	Block block;
+	block.size = rounded > m_blockSize ? rounded : m_blockSize;
+	block.pData = static_cast<Enco::byte*>(AlignedAllocator::Allocate(block.size));
+	m_blocks.push_back(block);
+
+	m_current = m_blocks.size() - 1;
+	m_offset = rounded;
+	return block.pData;
+}
+
+ScratchArena::Marker ScratchArena::Mark() const
+{
+	Marker marker;
+	marker.block = m_current;
+	marker.offset = m_offset;
+	return marker;
+}
+
+void ScratchArena::Rewind(const Marker& marker)
+{
+	m_current = marker.block;
+	m_offset = marker.offset;
+}
+
+ScratchArena& ScratchArena::ThreadLocal()
+{
+	static thread_local ScratchArena arena;
+	return arena;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ScratchScope
+
+ScratchScope::ScratchScope(ScratchArena& arena) :
+m_arena(arena), m_marker(arena.Mark())
+{}
+
+ScratchScope::~ScratchScope()
+{
+	m_arena.Rewind(m_marker);
+}
+
+ScratchArena& ScratchScope::Arena() const
+{
+	return m_arena;
+}
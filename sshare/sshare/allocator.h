@@ -0,0 +1,120 @@
+// allocator.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(ALLOCATOR_H)
+#define ALLOCATOR_H
+
+/*
+* @class: AlignedAllocator
+*
+* @remarks: every block handed out is aligned to m_cnst_alignment bytes so the
+*           math kernels can use aligned SIMD loads. Blocks at or above the
+*           huge page threshold are backed by huge pages according to the
+*           current policy; when the system refuses, the allocator silently
+*           falls back to ordinary pages.
+*/
+class AlignedAllocator
+{
+public:
+	enum HugePagePolicy
+	{
+		HUGEPAGE_NONE,			// ordinary pages only
+		HUGEPAGE_TRANSPARENT,	// hint the kernel (THP on Linux)
+		HUGEPAGE_EXPLICIT		// MAP_HUGETLB / MEM_LARGE_PAGES, then fall back
+	};
+
+public:
+	static void*	Allocate(const size_t& size);
+	static void		Free(void* pBlock);
+
+	static void				SetHugePagePolicy(const HugePagePolicy& policy, const size_t& threshold);
+	static HugePagePolicy	GetHugePagePolicy();
+
+public:
+	static const size_t		m_cnst_alignment;
+
+private:
+	static void*	_AllocateHuge(const size_t& size, const HugePagePolicy& policy, Enco::uint32& kind, size_t& mapped);
+
+private:
+	static HugePagePolicy	m_hugePagePolicy;
+	static size_t			m_hugePageThreshold;
+};
+
+/*
+* @class: ScratchArena
+*
+* @remarks: bump allocator for short-lived working memory. Blocks are kept
+*           after Rewind(), so a loop that allocates the same amount every
+*           round stops touching the heap after the first one. NOT thread
+*           safe; use ThreadLocal() to get the calling thread's arena.
+*/
+class ScratchArena
+{
+public:
+	struct Marker
+	{
+		size_t	block;
+		size_t	offset;
+	};
+
+public:
+	explicit ScratchArena(const size_t& blockSize = ((size_t)1 << 20));
+	~ScratchArena();
+
+	// deleted:
+	ScratchArena(const ScratchArena& arena) = delete;
+	ScratchArena& operator=(const ScratchArena& arena) = delete;
+
+public:
+	void*		Allocate(const size_t& size);
+
+	template<typename T>
+	T*			Allocate(const size_t& count)
+	{
+		return static_cast<T*>(Allocate(sizeof(T) * count));
+	}
+
+	Marker		Mark() const;
+	void		Rewind(const Marker& marker);
+
+	static ScratchArena&	ThreadLocal();
+
+private:
+	struct Block
+	{
+		Enco::byte*	pData;
+		size_t		size;
+	};
+
+	std::vector<Block>	m_blocks;
+	size_t				m_current;
+	size_t				m_offset;
+	size_t const		m_blockSize;
+};
+
+/*
+* @class: ScratchScope
+*
+* @remarks: rewinds the arena to where it was on construction.
+*/
+class ScratchScope
+{
+public:
+	explicit ScratchScope(ScratchArena& arena);
+	~ScratchScope();
+
+	// deleted:
+	ScratchScope(const ScratchScope& scope) = delete;
+	ScratchScope& operator=(const ScratchScope& scope) = delete;
+
+public:
+	ScratchArena&		Arena() const;
+
+private:
+	ScratchArena&			m_arena;
+	ScratchArena::Marker	m_marker;
+};
+
+#endif
@@ -0,0 +1,842 @@
+// async-share.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "allocator.h"
+#include "buffer.h"
+#include "checksum.h"
+#include "cipher.h"
+#include "perf-counters.h"
+#include "share-stats.h"
+#include "secret-share.h"
+#include "async-share.h"
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ShareExecutor
+
+ShareExecutor::ShareExecutor(const unsigned int& workers) :
+m_stopping(false)
+{
+	unsigned int count = (workers != 0) ? workers : std::thread::hardware_concurrency();
+	count = (count == 0) ? 1 : count;
+	for (unsigned int w = 0; w < count; ++w)
+	{
+		m_threads.push_back(std::thread(&ShareExecutor::_Worker, this));
+	}
+}
+
+ShareExecutor::~ShareExecutor()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_stopping = true;
+	}
+	m_ready.notify_all();
+
+	for (std::thread& t : m_threads)
+	{
+		t.join();
+	}
+}
+
+void ShareExecutor::Post(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_tasks.push_back(std::move(task));
+	}
+	m_ready.notify_one();
+}
+
+const unsigned int ShareExecutor::Workers() const
+{
+	return (unsigned int)m_threads.size();
+}
+
+void ShareExecutor::_Worker()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> guard(m_lock);
+			m_ready.wait(guard, [this]() { return m_stopping || false == m_tasks.empty(); });
+
+			// a task running elsewhere may still post its next step; the worker
+			// running it picks that up before it leaves.
+			if (m_tasks.empty())
+				return;
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+		task();
+	}
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ShareTask
+
+struct ShareTask::State
+{
+	State(ShareExecutor& taskExecutor, const Callback& taskCallback) :
+	executor(taskExecutor), callback(taskCallback), status(STATUS_PENDING), cancelled(false), processed(0), future(promise.get_future().share())
+	{}
+
+	void Complete(const Status& result)
+	{
+#if defined(ENCO_COROUTINES)
+		std::vector<std::coroutine_handle<>> waiting;
+#endif
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			status = result;
+#if defined(ENCO_COROUTINES)
+			waiting.swap(continuations);
+#endif
+		}
+
+		promise.set_value(result);
+		if (callback)
+			callback(result);
+#if defined(ENCO_COROUTINES)
+		for (std::coroutine_handle<>& h : waiting)
+		{
+			h.resume();
+		}
+#endif
+	}
+
+	ShareExecutor&				executor;
+	Callback					callback;
+	std::mutex					lock;
+	std::atomic<int>			status;
+	std::atomic<bool>			cancelled;
+	std::atomic<Enco::uint64>	processed;
+	std::promise<Status>		promise;
+	std::shared_future<Status>	future;
+#if defined(ENCO_COROUTINES)
+	std::vector<std::coroutine_handle<>>	continuations;
+#endif
+};
+
+ShareTask::ShareTask()
+{}
+
+ShareTask::ShareTask(const std::shared_ptr<State>& state) :
+m_state(state)
+{}
+
+ShareTask::Status ShareTask::Poll() const
+{
+	return (m_state == nullptr) ? STATUS_FAILED : (Status)m_state->status.load();
+}
+
+ShareTask::Status ShareTask::Wait() const
+{
+	return (m_state == nullptr) ? STATUS_FAILED : m_state->future.get();
+}
+
+std::shared_future<ShareTask::Status> ShareTask::Future() const
+{
+	if (m_state != nullptr)
+		return m_state->future;
+
+	std::promise<Status> failed;
+	failed.set_value(STATUS_FAILED);
+	return failed.get_future().share();
+}
+
+Enco::uint64 ShareTask::Processed() const
+{
+	return (m_state == nullptr) ? 0 : m_state->processed.load();
+}
+
+void ShareTask::Cancel() const
+{
+	if (m_state != nullptr)
+		m_state->cancelled = true;
+}
+
+#if defined(ENCO_COROUTINES)
+ShareTask::Awaiter::Awaiter(const std::shared_ptr<State>& state) :
+m_state(state)
+{}
+
+bool ShareTask::Awaiter::await_ready() const
+{
+	return m_state == nullptr || m_state->status != STATUS_PENDING;
+}
+
+bool ShareTask::Awaiter::await_suspend(std::coroutine_handle<> continuation) const
+{
+	// false resumes the caller at once: the task ended meanwhile.
+	std::lock_guard<std::mutex> guard(m_state->lock);
+	if (m_state->status != STATUS_PENDING)
+		return false;
+
+	m_state->continuations.push_back(continuation);
+	return true;
+}
+
+ShareTask::Status ShareTask::Awaiter::await_resume() const
+{
+	return (m_state == nullptr) ? STATUS_FAILED : (Status)m_state->status.load();
+}
+
+ShareTask::Awaiter ShareTask::operator co_await() const
+{
+	return Awaiter(m_state);
+}
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// AsyncSharer
+
+const size_t AsyncSharer::m_cnst_chunk_size = ((size_t)256 << 10);
+
+namespace
+{
+	const size_t g_cnst_header_size = sizeof(GUID) + sizeof(Enco::uint32) + 32;
+
+	// bytes of an AES-CTR stream keyed from the seed randomer on the thread that
+	// builds it, so the workers never touch the seed; SystemRandom without AES.
+	// Failed() when the seed had failed or SystemRandom came back empty.
+	class KeystreamRandomer : public Randomer
+	{
+	public:
+		explicit KeystreamRandomer(const Randomer& seed) :
+		m_pStream(nullptr), m_offset(0), m_used(sizeof(m_block)), m_failed(seed.Failed())
+		{
+			if (false == Aes128Ctr::Available())
+				return;
+
+			Enco::byte keyMaterial[24] = { 0 };
+			for (size_t i = 0; i < sizeof(keyMaterial); ++i)
+			{
+				keyMaterial[i] = (Enco::byte)seed.Random();
+			}
+			m_pStream = new Aes128Ctr(keyMaterial, keyMaterial + Aes128Ctr::m_cnst_key_size);
+			memset(keyMaterial, 0, sizeof(keyMaterial));
+			m_failed = m_failed || seed.Failed();
+		}
+
+		~KeystreamRandomer()
+		{
+			delete m_pStream;
+			memset(m_block, 0, sizeof(m_block));
+		}
+
+		virtual int Random() const override
+		{
+			if (m_used == sizeof(m_block))
+			{
+				if (m_pStream != nullptr)
+				{
+					memset(m_block, 0, sizeof(m_block));
+					m_pStream->Apply(m_block, m_block, sizeof(m_block), m_offset);
+					m_offset += sizeof(m_block);
+				}
+				else if (false == SystemRandom::Fill(m_block, sizeof(m_block)))
+				{
+					memset(m_block, 0, sizeof(m_block));
+					m_failed = true;
+				}
+				m_used = 0;
+			}
+			return m_block[m_used++];
+		}
+
+		virtual bool Failed() const override
+		{
+			return m_failed;
+		}
+
+	private:
+		Aes128Ctr*				m_pStream;
+		mutable Enco::uint64	m_offset;
+		mutable Enco::byte		m_block[4096];
+		mutable size_t			m_used;
+		mutable bool			m_failed;
+	};
+
+	// one operation, run a chunk per Step(); steps never overlap.
+	class Operation
+	{
+	public:
+		virtual ~Operation() {}
+
+		// false on failure, finished once nothing is left.
+		virtual bool	Step(ShareTask::State& state, bool& finished) = 0;
+
+		// undo what a failed or cancelled operation left behind.
+		virtual void	Abandon() {}
+	};
+
+	void _Drive(const std::shared_ptr<ShareTask::State>& state, const std::shared_ptr<Operation>& operation, ShareStats * const pStats)
+	{
+		// the stats of the starting thread follow the operation onto the workers.
+		ShareStats::Attached attached(pStats);
+		if (state->cancelled)
+		{
+			operation->Abandon();
+			state->Complete(ShareTask::STATUS_CANCELLED);
+			return;
+		}
+
+		bool finished = false;
+		if (false == operation->Step(*state, finished))
+		{
+			operation->Abandon();
+			state->Complete(ShareTask::STATUS_FAILED);
+			return;
+		}
+		if (finished)
+		{
+			state->Complete(ShareTask::STATUS_DONE);
+			return;
+		}
+
+		// back to the queue, behind the chunks of the other operations.
+		state->executor.Post([state, operation, pStats]() { _Drive(state, operation, pStats); });
+	}
+
+	ShareTask _Start(ShareExecutor& executor, const ShareTask::Callback& done, const std::shared_ptr<Operation>& operation)
+	{
+		std::shared_ptr<ShareTask::State> state = std::make_shared<ShareTask::State>(executor, done);
+		ShareStats* const pStats = ShareStats::Current();
+		executor.Post([state, operation, pStats]() { _Drive(state, operation, pStats); });
+		return ShareTask(state);
+	}
+
+	class EncodeOperation : public Operation
+	{
+	public:
+		EncodeOperation(const Randomer& seed, const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) :
+		m_randomer(seed), m_sharer(m_randomer), m_shares(sharedSecrets), m_n(n), m_k(k), m_secret(secretToShare), m_done(0), m_started(false)
+		{}
+
+		virtual bool Step(ShareTask::State& state, bool& finished) override
+		{
+			if (false == m_started)
+			{
+				if (m_shares.size() < m_n || false == m_sharer.BeginEncode(m_n, m_k))
+					return false;
+				m_started = true;
+			}
+
+			// the chunk goes straight into the caller's shares.
+			const size_t part = (m_secret.Size() - m_done < AsyncSharer::m_cnst_chunk_size) ? m_secret.Size() - m_done : AsyncSharer::m_cnst_chunk_size;
+			m_views.clear();
+			for (unsigned int i = 0; i < m_n; ++i)
+			{
+				m_views.push_back(m_shares[i].Sub(g_cnst_header_size + sizeof(Enco::uint32) * m_done, sizeof(Enco::uint32) * part));
+			}
+			if (false == m_sharer.EncodeChunk(m_views, m_secret.Sub(m_done, part)))
+				return false;
+
+			m_done += part;
+			state.processed = m_done;
+			if (m_done < m_secret.Size())
+				return true;
+
+			m_views.clear();
+			for (unsigned int i = 0; i < m_n; ++i)
+			{
+				m_views.push_back(m_shares[i].Sub(0, g_cnst_header_size));
+			}
+			finished = true;
+			if (false == m_sharer.FinishEncode(m_views))
+				return false;
+
+			// shares with room behind the payload get the trailer sshare -e writes.
+			const size_t payloadSize = g_cnst_header_size + sizeof(Enco::uint32) * m_secret.Size();
+			const size_t sealedSize = payloadSize + ShareChecksum::TrailerSize(payloadSize);
+			for (unsigned int i = 0; i < m_n; ++i)
+			{
+				if (m_shares[i].Size() >= sealedSize)
+					ShareChecksum::Seal(m_shares[i].Sub(0, sealedSize), payloadSize);
+			}
+			return true;
+		}
+
+	private:
+		KeystreamRandomer				m_randomer;
+		StreamSecretSharer				m_sharer;
+		std::vector<MutableBufferView>	m_shares;
+		std::vector<MutableBufferView>	m_views;
+		unsigned int					m_n;
+		unsigned int					m_k;
+		BufferView						m_secret;
+		size_t							m_done;
+		bool							m_started;
+	};
+
+	class DecodeOperation : public Operation
+	{
+	public:
+		DecodeOperation(const Randomer& seed, const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) :
+		m_sharer(seed), m_secret(recoverdSecret), m_shares(sharedSecrets), m_size(0), m_done(0), m_started(false)
+		{}
+
+		virtual bool Step(ShareTask::State& state, bool& finished) override
+		{
+			if (false == m_started)
+			{
+				// shares their trailers find damaged are dropped, the others
+				// decoded from their payloads, as sshare -d does.
+				std::vector<BufferView>	payloads;
+				std::vector<size_t>		badChunks;
+				for (const BufferView& share : m_shares)
+				{
+					if (ShareChecksum::Verify(share, badChunks))
+						payloads.push_back(ShareChecksum::Payload(share));
+				}
+				m_shares.swap(payloads);
+
+				if (m_shares.empty() || m_shares[0].Size() < g_cnst_header_size || (m_shares[0].Size() - g_cnst_header_size) % sizeof(Enco::uint32) != 0)
+					return false;
+
+				m_size = (m_shares[0].Size() - g_cnst_header_size) / sizeof(Enco::uint32);
+				m_views.clear();
+				for (size_t j = 0; j < m_shares.size(); ++j)
+				{
+					if (m_shares[j].Size() != m_shares[0].Size())
+						return false;
+					m_views.push_back(m_shares[j].Sub(0, g_cnst_header_size));
+				}
+				if (m_secret.Size() < m_size || false == m_sharer.BeginDecode(m_views))
+					return false;
+				m_started = true;
+			}
+
+			const size_t part = (m_size - m_done < AsyncSharer::m_cnst_chunk_size) ? m_size - m_done : AsyncSharer::m_cnst_chunk_size;
+			m_views.clear();
+			for (size_t j = 0; j < m_shares.size(); ++j)
+			{
+				m_views.push_back(m_shares[j].Sub(g_cnst_header_size + sizeof(Enco::uint32) * m_done, sizeof(Enco::uint32) * part));
+			}
+			if (false == m_sharer.DecodeChunk(m_secret.Sub(m_done, part), m_views))
+				return false;
+
+			m_done += part;
+			state.processed = m_done;
+			if (m_done < m_size)
+				return true;
+
+			finished = true;
+			return m_sharer.FinishDecode();
+		}
+
+		virtual void Abandon() override
+		{
+			if (m_started)
+				memset(m_secret.Data(), 0, m_size);
+		}
+
+	private:
+		StreamSecretSharer				m_sharer;
+		MutableBufferView				m_secret;
+		std::vector<BufferView>			m_shares;
+		std::vector<BufferView>			m_views;
+		size_t							m_size;
+		size_t							m_done;
+		bool							m_started;
+	};
+
+	// file chunks are sized so that the n share slices stay near 4 chunks.
+	size_t _FileSlice(const size_t& shares)
+	{
+		const size_t slice = AsyncSharer::m_cnst_chunk_size / (shares == 0 ? 1 : shares);
+		return (slice < 64) ? 64 : slice;
+	}
+
+	class EncodeFileOperation : public Operation
+	{
+	public:
+		EncodeFileOperation(const Randomer& seed, const std::string& fileName, const std::vector<std::string>& shareNames, const unsigned int& k) :
+		m_randomer(seed), m_sharer(m_randomer), m_fileName(fileName), m_shareNames(shareNames), m_k(k), m_size(0), m_done(0), m_started(false)
+		{}
+
+		virtual bool Step(ShareTask::State& state, bool& finished) override
+		{
+			const unsigned int n = (unsigned int)m_shareNames.size();
+			if (false == m_started)
+			{
+				m_started = true;
+				if (false == m_sharer.BeginEncode(n, m_k))
+					return false;
+
+				m_input.open(m_fileName, std::ios::in | std::ios::binary);
+				if (false == m_input.is_open())
+					return false;
+				m_input.seekg(0, std::ios::end);
+				m_size = (Enco::uint64)m_input.tellg();
+				m_input.seekg(0, std::ios::beg);
+
+				// the headers are only known at the end, their room is kept.
+				const Enco::byte blank[g_cnst_header_size] = { 0 };
+				m_outputs.resize(n);
+				for (unsigned int i = 0; i < n; ++i)
+				{
+					m_outputs[i].open(m_shareNames[i], std::ios::out | std::ios::binary | std::ios::trunc);
+					m_outputs[i].write((const char*)blank, sizeof(blank));
+					if (false == m_outputs[i].good())
+						return false;
+				}
+
+				m_slice = _FileSlice(n);
+				m_chunk.resize(m_slice);
+				m_bodies.resize(sizeof(Enco::uint32) * m_slice * n);
+				m_sums.assign(n, HeaderLastChecksum(g_cnst_header_size));
+			}
+
+			const size_t part = (size_t)((m_size - m_done < m_slice) ? m_size - m_done : m_slice);
+			const size_t body = sizeof(Enco::uint32) * part;
+			if (part != 0)
+			{
+				ShareStats::Scope stage(ShareStats::STAGE_READ, part);
+				m_input.read((char*)&m_chunk[0], part);
+				if ((size_t)m_input.gcount() != part)
+					return false;
+			}
+
+			m_views.clear();
+			for (unsigned int i = 0; i < n; ++i)
+			{
+				m_views.push_back(MutableBufferView(m_bodies.empty() ? nullptr : &m_bodies[0] + body * i, body));
+			}
+			if (false == m_sharer.EncodeChunk(m_views, BufferView(m_chunk.empty() ? nullptr : &m_chunk[0], part)))
+				return false;
+			ShareStats::Scope stage(ShareStats::STAGE_WRITE, (Enco::uint64)body * n);
+			for (unsigned int i = 0; i < n; ++i)
+			{
+				m_sums[i].Update(m_views[i].Data(), body);
+				m_outputs[i].write((const char*)m_views[i].Data(), body);
+				if (false == m_outputs[i].good())
+					return false;
+			}
+
+			m_done += part;
+			state.processed = m_done;
+			if (m_done < m_size)
+				return true;
+
+			std::vector<Enco::byte> headers(g_cnst_header_size * n);
+			m_views.clear();
+			for (unsigned int i = 0; i < n; ++i)
+			{
+				m_views.push_back(MutableBufferView(&headers[0] + g_cnst_header_size * i, g_cnst_header_size));
+			}
+			if (false == m_sharer.FinishEncode(m_views))
+				return false;
+
+			// sealed like the shares of sshare -e.
+			std::vector<Enco::byte> trailer;
+			for (unsigned int i = 0; i < n; ++i)
+			{
+				m_sums[i].Trailer(m_views[i], trailer);
+				m_outputs[i].write((const char*)&trailer[0], trailer.size());
+				m_outputs[i].seekp(0, std::ios::beg);
+				m_outputs[i].write((const char*)m_views[i].Data(), g_cnst_header_size);
+				m_outputs[i].close();
+				if (m_outputs[i].fail())
+					return false;
+			}
+
+			_Wipe();
+			finished = true;
+			return true;
+		}
+
+		virtual void Abandon() override
+		{
+			_Wipe();
+			m_input.close();
+			for (size_t i = 0; i < m_outputs.size(); ++i)
+			{
+				m_outputs[i].close();
+				remove(m_shareNames[i].c_str());
+			}
+		}
+
+	private:
+		void _Wipe()
+		{
+			if (false == m_chunk.empty())
+				memset(&m_chunk[0], 0, m_chunk.size());
+		}
+
+	private:
+		KeystreamRandomer				m_randomer;
+		StreamSecretSharer				m_sharer;
+		std::string						m_fileName;
+		std::vector<std::string>		m_shareNames;
+		unsigned int					m_k;
+		std::ifstream					m_input;
+		std::vector<std::ofstream>		m_outputs;
+		std::vector<Enco::byte>			m_chunk;
+		std::vector<Enco::byte>			m_bodies;
+		std::vector<MutableBufferView>	m_views;
+		std::vector<HeaderLastChecksum>	m_sums;
+		Enco::uint64					m_size;
+		Enco::uint64					m_done;
+		size_t							m_slice;
+		bool							m_started;
+	};
+
+	class DecodeFilesOperation : public Operation
+	{
+	public:
+		DecodeFilesOperation(const Randomer& seed, const std::string& outFileName, const std::vector<std::string>& shareNames) :
+		m_sharer(seed), m_outFileName(outFileName), m_shareNames(shareNames), m_payloadSize(0), m_screened(0), m_size(0), m_done(0), m_slice(0), m_started(false), m_decoding(false)
+		{}
+
+		virtual bool Step(ShareTask::State& state, bool& finished) override
+		{
+			if (false == m_started)
+			{
+				m_started = true;
+				if (false == _Open())
+					return false;
+			}
+
+			// the sealed shares are read through once first, so the damaged
+			// ones are dropped before anything is decoded, as sshare -d does.
+			if (m_screened < m_payloadSize)
+				return _Screen();
+
+			if (false == m_decoding && false == _Begin())
+				return false;
+
+			const size_t part = (size_t)((m_size - m_done < m_slice) ? m_size - m_done : m_slice);
+			const size_t body = sizeof(Enco::uint32) * part;
+			m_views.clear();
+			for (size_t j = 0; j < m_used.size(); ++j)
+			{
+				Enco::byte* pBody = m_bodies.empty() ? nullptr : &m_bodies[0] + body * j;
+				if (body != 0)
+				{
+					ShareStats::Scope	stage(ShareStats::STAGE_READ, body);
+					std::ifstream&		input = m_inputs[m_used[j]].file;
+					input.read((char*)pBody, body);
+					if ((size_t)input.gcount() != body)
+						return false;
+				}
+				m_views.push_back(BufferView(pBody, body));
+			}
+			if (false == m_sharer.DecodeChunk(MutableBufferView(m_chunk.empty() ? nullptr : &m_chunk[0], part), m_views))
+				return false;
+
+			{
+				ShareStats::Scope stage(ShareStats::STAGE_WRITE, part);
+				m_output.write((const char*)(m_chunk.empty() ? nullptr : &m_chunk[0]), part);
+				if (false == m_output.good())
+					return false;
+			}
+
+			m_done += part;
+			state.processed = m_done;
+			if (m_done < m_size)
+				return true;
+
+			_Wipe();
+			m_output.close();
+			finished = true;
+			return false == m_output.fail() && m_sharer.FinishDecode();
+		}
+
+		virtual void Abandon() override
+		{
+			// the bytes written so far were never verified.
+			_Wipe();
+			if (m_output.is_open())
+				m_output.close();
+			if (m_decoding)
+				remove(m_outFileName.c_str());
+		}
+
+	private:
+		struct Input
+		{
+			Input() : sealed(false), damaged(false) {}
+
+			std::ifstream				file;
+			std::vector<Enco::uint32>	chunkCrcs;
+			ChunkChecksum				sum;
+			bool						sealed;
+			bool						damaged;
+		};
+
+		// opens the shares and reads their trailers, as ShareReader does.
+		bool _Open()
+		{
+			const size_t m = m_shareNames.size();
+			if (m == 0)
+				return false;
+
+			bool anySealed = false;
+			m_inputs.resize(m);
+			for (size_t j = 0; j < m; ++j)
+			{
+				Input& input = m_inputs[j];
+				input.file.open(m_shareNames[j], std::ios::in | std::ios::binary);
+				if (false == input.file.is_open())
+					return false;
+
+				input.file.seekg(0, std::ios::end);
+				const size_t	size = (size_t)input.file.tellg();
+				const size_t	fixed = (size < ShareChecksum::m_cnst_fixed_size) ? size : ShareChecksum::m_cnst_fixed_size;
+				OwnedBuffer		end(fixed);
+				input.file.seekg(size - fixed, std::ios::beg);
+				input.file.read((char*)end.Data(), fixed);
+
+				size_t			payloadSize = size;
+				const size_t	trailerSize = ShareChecksum::StoredTrailerSize(end.View(), size);
+				if (trailerSize > 0)
+				{
+					size_t		chunkSize = 0;
+					OwnedBuffer	trailer(trailerSize);
+					input.file.seekg(size - trailerSize, std::ios::beg);
+					input.file.read((char*)trailer.Data(), trailerSize);
+					input.sealed = true;
+					input.damaged = false == ShareChecksum::ReadTrailer(trailer.View(), payloadSize, chunkSize, input.chunkCrcs);
+					if (false == input.damaged)
+						input.sum = ChunkChecksum(chunkSize);
+					anySealed = anySealed || false == input.damaged;
+				}
+				input.file.clear();
+				input.file.seekg(0, std::ios::beg);
+
+				// every share that is not already given up MUST be of one set.
+				if (input.damaged)
+					continue;
+				if (m_payloadSize == 0)
+					m_payloadSize = payloadSize;
+				if (payloadSize != m_payloadSize)
+					return false;
+			}
+
+			if (m_payloadSize < g_cnst_header_size || (m_payloadSize - g_cnst_header_size) % sizeof(Enco::uint32) != 0)
+				return false;
+
+			m_slice = _FileSlice(m);
+			m_bodies.resize(sizeof(Enco::uint32) * m_slice * m);
+			m_chunk.resize(m_slice);
+			m_screened = anySealed ? 0 : m_payloadSize;
+			return true;
+		}
+
+		bool _Screen()
+		{
+			const size_t span = sizeof(Enco::uint32) * m_slice;
+			const size_t part = (m_payloadSize - m_screened < span) ? (size_t)(m_payloadSize - m_screened) : span;
+			for (Input& input : m_inputs)
+			{
+				if (false == input.sealed || input.damaged)
+					continue;
+
+				ShareStats::Scope stage(ShareStats::STAGE_READ, part);
+				input.file.read((char*)&m_bodies[0], part);
+				if ((size_t)input.file.gcount() != part)
+				{
+					input.damaged = true;
+					continue;
+				}
+				input.sum.Update(&m_bodies[0], part);
+			}
+
+			m_screened += part;
+			if (m_screened < m_payloadSize)
+				return true;
+
+			for (Input& input : m_inputs)
+			{
+				if (false == input.sealed || input.damaged)
+					continue;
+				input.sum.Finish();
+				input.damaged = input.sum.Chunks() != input.chunkCrcs;
+			}
+			return true;
+		}
+
+		bool _Begin()
+		{
+			std::vector<Enco::byte> headers(g_cnst_header_size * m_inputs.size());
+			m_used.clear();
+			m_views.clear();
+			for (size_t j = 0; j < m_inputs.size(); ++j)
+			{
+				Input& input = m_inputs[j];
+				if (input.damaged)
+					continue;
+
+				input.file.clear();
+				input.file.seekg(0, std::ios::beg);
+				input.file.read((char*)&headers[0] + g_cnst_header_size * j, g_cnst_header_size);
+				if ((size_t)input.file.gcount() != g_cnst_header_size)
+					return false;
+				m_views.push_back(BufferView(&headers[0] + g_cnst_header_size * j, g_cnst_header_size));
+				m_used.push_back(j);
+			}
+			if (m_used.empty() || false == m_sharer.BeginDecode(m_views))
+				return false;
+
+			m_size = (m_payloadSize - g_cnst_header_size) / sizeof(Enco::uint32);
+			m_output.open(m_outFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+			m_decoding = true;
+			return m_output.is_open();
+		}
+
+		void _Wipe()
+		{
+			if (false == m_chunk.empty())
+				memset(&m_chunk[0], 0, m_chunk.size());
+		}
+
+	private:
+		StreamSecretSharer				m_sharer;
+		std::string						m_outFileName;
+		std::vector<std::string>		m_shareNames;
+		std::vector<Input>				m_inputs;
+		std::vector<size_t>				m_used;			// the inputs decoded from
+		std::ofstream					m_output;
+		std::vector<Enco::byte>			m_chunk;
+		std::vector<Enco::byte>			m_bodies;
+		std::vector<BufferView>			m_views;
+		Enco::uint64					m_payloadSize;
+		Enco::uint64					m_screened;
+		Enco::uint64					m_size;
+		Enco::uint64					m_done;
+		size_t							m_slice;
+		bool							m_started;
+		bool							m_decoding;		// the output is open
+	};
+}
+
+AsyncSharer::AsyncSharer(ShareExecutor& executor, const Randomer& randomer) :
+m_executor(executor), m_randomer(randomer)
+{}
+
+ShareTask AsyncSharer::Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare, const ShareTask::Callback& done)
+{
+	return _Start(m_executor, done, std::make_shared<EncodeOperation>(m_randomer, sharedSecrets, n, k, secretToShare));
+}
+
+ShareTask AsyncSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const ShareTask::Callback& done)
+{
+	return _Start(m_executor, done, std::make_shared<DecodeOperation>(m_randomer, recoverdSecret, sharedSecrets));
+}
+
+ShareTask AsyncSharer::EncodeFile(const std::string& fileName, const std::vector<std::string>& shareNames, const unsigned int& k, const ShareTask::Callback& done)
+{
+	return _Start(m_executor, done, std::make_shared<EncodeFileOperation>(m_randomer, fileName, shareNames, k));
+}
+
+ShareTask AsyncSharer::DecodeFiles(const std::string& outFileName, const std::vector<std::string>& shareNames, const ShareTask::Callback& done)
+{
+	return _Start(m_executor, done, std::make_shared<DecodeFilesOperation>(m_randomer, outFileName, shareNames));
+}
@@ -0,0 +1,161 @@
+// async-share.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(ASYNC_SHARE_H)
+#define ASYNC_SHARE_H
+
+/*
+* @class: ShareExecutor
+*
+* @remarks: a fixed pool of worker threads running posted tasks in order.
+*           The destructor lets every queued task, and whatever those tasks
+*           post, run to the end before joining.
+*/
+class ShareExecutor
+{
+public:
+	explicit ShareExecutor(const unsigned int& workers = 0);	// 0: one per hardware thread
+	~ShareExecutor();
+
+	// deleted:
+	ShareExecutor(const ShareExecutor& executor) = delete;
+	ShareExecutor& operator=(const ShareExecutor& executor) = delete;
+
+public:
+	void				Post(std::function<void()> task);
+	const unsigned int	Workers() const;
+
+private:
+	void				_Worker();
+
+private:
+	std::mutex							m_lock;
+	std::condition_variable				m_ready;
+	std::deque<std::function<void()>>	m_tasks;
+	bool								m_stopping;
+	std::vector<std::thread>			m_threads;
+};
+
+/*
+* @class: ShareTask
+*
+* @remarks: the handle of one operation started by AsyncSharer; copies share
+*           the operation. Wait for it with Wait(), Future() or co_await, or
+*           have the callback given to AsyncSharer called. Callbacks and
+*           resumed coroutines run on an executor thread.
+*/
+class ShareTask
+{
+public:
+	enum Status
+	{
+		STATUS_PENDING,
+		STATUS_DONE,
+		STATUS_FAILED,
+		STATUS_CANCELLED
+	};
+
+	typedef std::function<void(const Status&)> Callback;
+
+	struct State;
+
+public:
+	ShareTask();
+	explicit ShareTask(const std::shared_ptr<State>& state);
+
+public:
+	Status						Poll() const;
+	Status						Wait() const;
+	std::shared_future<Status>	Future() const;
+
+	// secret bytes done so far.
+	Enco::uint64				Processed() const;
+
+	/*
+	* @interface: Cancel
+	*
+	* @remarks: cooperative: the operation stops at its next chunk and ends
+	*           as STATUS_CANCELLED, unless it has already ended.
+	*/
+	void						Cancel() const;
+
+#if defined(ENCO_COROUTINES)
+	class Awaiter
+	{
+	public:
+		explicit Awaiter(const std::shared_ptr<State>& state);
+
+		bool	await_ready() const;
+		bool	await_suspend(std::coroutine_handle<> continuation) const;
+		Status	await_resume() const;
+
+	private:
+		std::shared_ptr<State>	m_state;
+	};
+
+	Awaiter						operator co_await() const;
+#endif
+
+private:
+	std::shared_ptr<State>		m_state;
+};
+
+/*
+* @class: AsyncSharer
+*
+* @remarks: DefaultStrongSSharer shares made and combined on a ShareExecutor,
+*           m_cnst_chunk_size secret bytes per task, so the calling thread
+*           returns at once and many operations share the workers. One
+*           operation runs one chunk at a time; the file operations read
+*           and write their chunks on the executor as well.
+*
+*           Coefficients come from an AES-CTR keystream keyed from the
+*           randomer on the calling thread, or from SystemRandom without AES;
+*           the workers never call the randomer.
+*           Buffers passed in MUST outlive the tasks, and so MUST the ShareStats
+*           attached to the calling thread, which the workers add to.
+*/
+class AsyncSharer
+{
+public:
+	AsyncSharer(ShareExecutor& executor, const Randomer& randomer);
+
+	// deleted:
+	AsyncSharer(const AsyncSharer& sharer) = delete;
+	AsyncSharer& operator=(const AsyncSharer& sharer) = delete;
+
+public:
+	/*
+	* @interface: Encode / Decode
+	*
+	* @remarks: the same buffers as the blocking DefaultStrongSSharer calls.
+	*           Shares with room for it get the ShareChecksum trailer behind
+	*           the payload; Decode() drops the shares their trailers find
+	*           damaged and takes the payloads of the rest. A failed or
+	*           cancelled Decode() leaves the secret zeroed.
+	*/
+	ShareTask		Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare, const ShareTask::Callback& done = ShareTask::Callback());
+	ShareTask		Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const ShareTask::Callback& done = ShareTask::Callback());
+
+	/*
+	* @interface: EncodeFile / DecodeFiles
+	*
+	* @remarks: file to shareNames.size() share files and back, sealed as
+	*           sshare -e writes them. Neither holds more than a chunk in
+	*           memory; DecodeFiles() reads the sealed shares through once
+	*           first and drops the damaged ones. What a failed or cancelled
+	*           operation has written is deleted.
+	*/
+	ShareTask		EncodeFile(const std::string& fileName, const std::vector<std::string>& shareNames, const unsigned int& k, const ShareTask::Callback& done = ShareTask::Callback());
+	ShareTask		DecodeFiles(const std::string& outFileName, const std::vector<std::string>& shareNames, const ShareTask::Callback& done = ShareTask::Callback());
+
+public:
+	static const size_t	m_cnst_chunk_size;
+
+private:
+	ShareExecutor&		m_executor;
+	const Randomer&		m_randomer;
+};
+
+#endif
@@ -0,0 +1,273 @@
+// bench-harness.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "perf-counters.h"
+#include "bench-harness.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#	include <x86intrin.h>
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// BenchHarness
+
+namespace
+{
+	volatile Enco::uint64 g_sink = 0;
+
+	double _Seconds(const std::chrono::steady_clock::time_point& from, const std::chrono::steady_clock::time_point& to)
+	{
+		return std::chrono::duration<double>(to - from).count();
+	}
+}
+
+BenchHarness::BenchHarness() :
+m_repetitions(15), m_minTime(0.02), m_csv(false), m_counters(false)
+{}
+
+bool BenchHarness::Parse(int& argc, char* argv[])
+{
+	int kept = 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg.compare(0, 9, "--filter=") == 0)
+		{
+			m_filter = arg.substr(9);
+		}
+		else if (arg.compare(0, 7, "--reps=") == 0)
+		{
+			m_repetitions = (size_t)atoi(arg.c_str() + 7);
+			if (m_repetitions < 3)
+				return false;
+		}
+		else if (arg.compare(0, 11, "--min-time=") == 0)
+		{
+			m_minTime = atof(arg.c_str() + 11) / 1000.0;
+			if (m_minTime <= 0)
+				return false;
+		}
+		else if (arg == "--csv")
+		{
+			m_csv = true;
+		}
+		else if (arg == "--counters")
+		{
+			m_counters = true;
+		}
+		else
+		{
+			argv[kept++] = argv[i];
+		}
+	}
+	argc = kept;
+	return true;
+}
+
+bool BenchHarness::Selected(const std::string& name) const
+{
+	return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+void BenchHarness::Run(const std::string& name, const size_t& bytesPerOp, const Body& body)
+{
+	if (false == Selected(name))
+		return;
+
+	// calibrate: grow the count until a run is long enough to scale from.
+	Enco::uint64 iterations = 1;
+	for (;;)
+	{
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		body(iterations);
+		const double elapsed = _Seconds(start, std::chrono::steady_clock::now());
+		if (elapsed >= m_minTime / 10 || iterations >= ((Enco::uint64)1 << 40))
+		{
+			const double scaled = (double)iterations * m_minTime / ((elapsed > 0) ? elapsed : 1e-9);
+			iterations = (scaled < 1) ? 1 : (Enco::uint64)scaled;
+			break;
+		}
+		iterations *= 10;
+	}
+
+	body(iterations);	// warm-up
+
+	Result					result;
+	std::vector<double>		cycles;
+	result.name = name;
+	result.bytesPerOp = bytesPerOp;
+	result.iterations = iterations;
+
+	// the counters add a read() on each side of a repetition, not per op.
+	const PerfCounters&		counters = PerfCounters::ThreadLocal();
+	const bool				counting = m_counters && counters.Available();
+	PerfCounters::Sample	events;
+	memset(&events, 0, sizeof(events));
+	for (size_t r = 0; r < m_repetitions; ++r)
+	{
+		PerfCounters::Sample e0, e1;
+		if (counting)
+			counters.Read(e0);
+		const Enco::uint64								c0 = Cycles();
+		const std::chrono::steady_clock::time_point		start = std::chrono::steady_clock::now();
+		body(iterations);
+		const std::chrono::steady_clock::time_point		stop = std::chrono::steady_clock::now();
+		const Enco::uint64								c1 = Cycles();
+		if (counting && counters.Read(e1))
+		{
+			const PerfCounters::Sample delta = PerfCounters::Delta(e0, e1);
+			for (int c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+			{
+				events.values[c] += delta.values[c];
+			}
+		}
+
+		result.samples.push_back(_Seconds(start, stop) * 1e9 / iterations);
+		cycles.push_back((double)(c1 - c0) / iterations);
+	}
+	if (counting)
+	{
+		for (int c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+		{
+			result.events.push_back((double)events.values[c] / ((double)iterations * m_repetitions));
+		}
+	}
+
+	result.median = _Median(result.samples);
+	std::vector<double> deviations;
+	for (double s : result.samples)
+	{
+		deviations.push_back(fabs(s - result.median));
+	}
+	result.mad = 1.4826 * _Median(deviations);
+
+	double	sum = 0;
+	size_t	kept = 0;
+	for (double s : result.samples)
+	{
+		if (fabs(s - result.median) > 3 * result.mad && result.mad > 0)
+			continue;
+		sum += s;
+		++kept;
+	}
+	result.outliers = result.samples.size() - kept;
+	result.mean = (kept == 0) ? result.median : sum / kept;
+	result.cyclesPerOp = _Median(cycles);
+	m_results.push_back(result);
+}
+
+const std::vector<BenchHarness::Result>& BenchHarness::Results() const
+{
+	return m_results;
+}
+
+void BenchHarness::Add(const Result& result)
+{
+	m_results.push_back(result);
+}
+
+void BenchHarness::Report(std::ostream& out) const
+{
+	out << std::left << std::setw(40) << "case" << std::right << std::setw(16) << "ns/op" << std::setw(14) << "+-mad"
+		<< std::setw(16) << "cycles/op" << std::setw(13) << "bytes/cycle" << std::setw(10) << "outliers" << "\n";
+	for (const Result& r : m_results)
+	{
+		out << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(16) << r.median << std::setw(14) << r.mad << std::setw(16) << r.cyclesPerOp;
+		if (r.bytesPerOp != 0 && r.cyclesPerOp > 0)
+			out << std::setw(13) << std::setprecision(3) << r.bytesPerOp / r.cyclesPerOp;
+		else
+			out << std::setw(13) << "-";
+		out << std::setw(6) << r.outliers << "/" << r.samples.size() << "\n";
+	}
+
+	if (false == m_counters)
+		return;
+	const PerfCounters& counters = PerfCounters::ThreadLocal();
+	if (false == counters.Available())
+	{
+		out << "\ncounters: unavailable (" << counters.Reason() << ")" << std::endl;
+		return;
+	}
+
+	out << "\n" << std::left << std::setw(40) << "case" << std::right << std::setw(8) << "IPC" << std::setw(14) << "instr/op"
+		<< std::setw(15) << "cache-miss/op" << std::setw(15) << "branch-miss/op" << std::setw(15) << "dTLB-miss/op" << std::setw(15) << "cache-miss/B" << "\n";
+	for (const Result& r : m_results)
+	{
+		if (r.events.size() != PerfCounters::COUNTER_COUNT)
+			continue;
+		const double cycles = r.events[PerfCounters::COUNTER_CYCLES];
+		out << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(8) << ((cycles > 0) ? r.events[PerfCounters::COUNTER_INSTRUCTIONS] / cycles : 0)
+			<< std::setw(14) << r.events[PerfCounters::COUNTER_INSTRUCTIONS] << std::setprecision(4);
+		for (int c = PerfCounters::COUNTER_CACHE_MISSES; c < PerfCounters::COUNTER_COUNT; ++c)
+		{
+			if (counters.Has((PerfCounters::Counter)c))
+				out << std::setw(15) << r.events[c];
+			else
+				out << std::setw(15) << "-";
+		}
+		if (r.bytesPerOp != 0 && counters.Has(PerfCounters::COUNTER_CACHE_MISSES))
+			out << std::setw(15) << r.events[PerfCounters::COUNTER_CACHE_MISSES] / r.bytesPerOp;
+		else
+			out << std::setw(15) << "-";
+		out << "\n";
+	}
+	if (false == counters.Reason().empty())
+		out << "counters: " << counters.Reason() << "\n";
+	out.flush();
+}
+
+void BenchHarness::ReportCsv(std::ostream& out) const
+{
+	out << "name,bytes_per_op,ns_per_op,mad,mean,outliers,cycles_per_op,bytes_per_cycle,iterations,samples\n";
+	for (const Result& r : m_results)
+	{
+		out << r.name << "," << r.bytesPerOp << "," << std::setprecision(6) << r.median << "," << r.mad << "," << r.mean << ","
+			<< r.outliers << "," << r.cyclesPerOp << "," << ((r.bytesPerOp != 0 && r.cyclesPerOp > 0) ? r.bytesPerOp / r.cyclesPerOp : 0) << ","
+			<< r.iterations << ",";
+		for (size_t i = 0; i < r.samples.size(); ++i)
+		{
+			out << (i == 0 ? "" : " ") << r.samples[i];
+		}
+		out << "\n";
+	}
+}
+
+bool BenchHarness::Csv() const
+{
+	return m_csv;
+}
+
+void BenchHarness::Keep(const Enco::uint64& value)
+{
+	g_sink = g_sink ^ value;
+}
+
+Enco::uint64 BenchHarness::Cycles()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	return (Enco::uint64)__rdtsc();
+#else
+	return 0;
+#endif
+}
+
+double BenchHarness::_Median(std::vector<double> values)
+{
+	if (values.empty())
+		return 0;
+
+	std::sort(values.begin(), values.end());
+	const size_t half = values.size() / 2;
+	return (values.size() % 2 != 0) ? values[half] : (values[half - 1] + values[half]) / 2;
+}
@@ -0,0 +1,95 @@
+// bench-harness.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(BENCH_HARNESS_H)
+#define BENCH_HARNESS_H
+
+/*
+* @class: BenchHarness
+*
+* @remarks: times one case at a time. A case is a body running a given number
+*           of iterations; the harness calibrates that number so that one
+*           repetition lasts m_minTime, runs a warm-up repetition, then
+*           m_repetitions timed ones. ns/op and cycles/op are the medians over
+*           the repetitions; repetitions further than 3 scaled MADs from the
+*           median are reported as outliers and left out of the mean.
+*
+*           With --counters the timed repetitions also read the PerfCounters
+*           of the bench thread; the report then has a second table of IPC
+*           and misses per op and per byte, or says why there is none.
+*/
+class BenchHarness
+{
+public:
+	struct Result
+	{
+		std::string				name;
+		size_t					bytesPerOp;		// 0 when the case has no byte size
+		std::vector<double>		samples;		// ns/op of every timed repetition
+		double					median;
+		double					mad;			// scaled by 1.4826, comparable to a standard deviation
+		double					mean;			// without the outliers
+		size_t					outliers;
+		double					cyclesPerOp;	// 0 without a cycle counter
+		Enco::uint64			iterations;		// per repetition
+		std::vector<double>		events;			// per op, by PerfCounters::Counter; empty when not counted
+	};
+
+	typedef std::function<void(const Enco::uint64& iterations)> Body;
+
+public:
+	BenchHarness();
+
+public:
+	/*
+	* @interface: Parse
+	*
+	* @remarks: takes the options it knows out of argv: --filter=text,
+	*           --reps=N, --min-time=ms, --csv, --counters. false on a
+	*           malformed one.
+	*/
+	bool				Parse(int& argc, char* argv[]);
+
+	// true if name passes the filter; cases failing it are not run.
+	bool				Selected(const std::string& name) const;
+
+	void				Run(const std::string& name, const size_t& bytesPerOp, const Body& body);
+
+	const std::vector<Result>&	Results() const;
+
+	// adds a result timed elsewhere, a loaded baseline for instance.
+	void				Add(const Result& result);
+
+	/*
+	* @interface: Report
+	*
+	* @remarks: a table, or with --csv one line per case:
+	*           name,bytes_per_op,ns_per_op,mad,mean,outliers,cycles_per_op,
+	*           bytes_per_cycle,iterations,samples (space-separated ns/op).
+	*           The counters are in the table only: the CSV is the baseline
+	*           format of PerfCompare.
+	*/
+	void				Report(std::ostream& out) const;
+	void				ReportCsv(std::ostream& out) const;
+	bool				Csv() const;
+
+	// keeps a value alive so the compiler cannot drop the work behind it.
+	static void			Keep(const Enco::uint64& value);
+
+	// the time stamp counter, 0 where there is none.
+	static Enco::uint64	Cycles();
+
+private:
+	static double		_Median(std::vector<double> values);
+
+private:
+	std::string				m_filter;
+	size_t					m_repetitions;
+	double					m_minTime;		// seconds per repetition
+	bool					m_csv;
+	bool					m_counters;
+	std::vector<Result>		m_results;
+};
+
+#endif
@@ -0,0 +1,254 @@
+// buffer.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "allocator.h"
+#include "buffer.h"
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// BufferView
+
+BufferView::BufferView() :
+m_pData(nullptr), m_size(0)
+{}
+
+BufferView::BufferView(void const * const pData, const size_t& size) :
+m_pData(static_cast<Enco::byte const*>(pData)), m_size(size)
+{}
+
+Enco::byte const* BufferView::Data() const
+{
+	return m_pData;
+}
+
+const size_t BufferView::Size() const
+{
+	return m_size;
+}
+
+bool BufferView::Empty() const
+{
+	return m_size == 0;
+}
+
+BufferView BufferView::Sub(const size_t& offset, const size_t& size) const
+{
+	if (offset > m_size)
+		return BufferView(m_pData + m_size, 0);
+
+	return BufferView(m_pData + offset, (size > m_size - offset) ? m_size - offset : size);
+}
+
+void BufferView::Read(void * const pDist, const size_t& offset, const size_t& size) const
+{
+	memcpy(pDist, m_pData + offset, size);
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// MutableBufferView
+
+MutableBufferView::MutableBufferView() :
+m_pData(nullptr), m_size(0)
+{}
+
+MutableBufferView::MutableBufferView(void * const pData, const size_t& size) :
+m_pData(static_cast<Enco::byte*>(pData)), m_size(size)
+{}
+
+Enco::byte* MutableBufferView::Data() const
+{
+	return m_pData;
+}
+
+const size_t MutableBufferView::Size() const
+{
+	return m_size;
+}
+
+bool MutableBufferView::Empty() const
+{
+	return m_size == 0;
+}
+
+MutableBufferView MutableBufferView::Sub(const size_t& offset, const size_t& size) const
+{
+	if (offset > m_size)
+		return MutableBufferView(m_pData + m_size, 0);
+
+	return MutableBufferView(m_pData + offset, (size > m_size - offset) ? m_size - offset : size);
+}
+
+void MutableBufferView::Write(const size_t& offset, void const * const pSrc, const size_t& size) const
+{
+	memcpy(m_pData + offset, pSrc, size);
+}
+
+void MutableBufferView::Read(void * const pDist, const size_t& offset, const size_t& size) const
+{
+	memcpy(pDist, m_pData + offset, size);
+}
+
+MutableBufferView::operator BufferView() const
+{
+	return BufferView(m_pData, m_size);
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// OwnedBuffer
+
+OwnedBuffer::OwnedBuffer() :
+m_pData(nullptr), m_size(0)
+{}
+
+OwnedBuffer::OwnedBuffer(const size_t& sizeInBytes) :
+m_pData(static_cast<Enco::byte*>(AlignedAllocator::Allocate(sizeInBytes))), m_size(sizeInBytes)
+{}
+
+OwnedBuffer::OwnedBuffer(OwnedBuffer&& other) noexcept :
+m_pData(other.m_pData), m_size(other.m_size)
+{
+	other.m_pData = nullptr;
+	other.m_size = 0;
+}
+
+OwnedBuffer::~OwnedBuffer()
+{
+	_Free();
+}
+
+OwnedBuffer& OwnedBuffer::operator=(OwnedBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		_Free();
+		m_pData = other.m_pData;
+		m_size = other.m_size;
+		other.m_pData = nullptr;
+		other.m_size = 0;
+	}
+	return *this;
+}
+
+Enco::byte* OwnedBuffer::Data() const
+{
+	return m_pData;
+}
+
+const size_t OwnedBuffer::Size() const
+{
+	return m_size;
+}
+
+bool OwnedBuffer::Empty() const
+{
+	return m_size == 0;
+}
+
+BufferView OwnedBuffer::View() const
+{
+	return BufferView(m_pData, m_size);
+}
+
+MutableBufferView OwnedBuffer::MutableView() const
+{
+	return MutableBufferView(m_pData, m_size);
+}
+
+Enco::byte* OwnedBuffer::Release()
+{
+	Enco::byte* pData = m_pData;
+	m_pData = nullptr;
+	m_size = 0;
+	return pData;
+}
+
+void OwnedBuffer::_Free()
+{
+	if (m_pData != nullptr)
+	{
+		AlignedAllocator::Free(m_pData);
+		m_pData = nullptr;
+	}
+	m_size = 0;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ShareMatrix
+
+namespace
+{
+	size_t _RowStride(const size_t& rowSize)
+	{
+		const size_t align = AlignedAllocator::m_cnst_alignment;
+		size_t stride = (rowSize + align - 1) / align * align;
+
+		// rows a multiple of 4 KB apart map onto the same cache sets.
+		if (stride % 4096 == 0)
+			stride += align;
+		return stride;
+	}
+}
+
+ShareMatrix::ShareMatrix() :
+m_rows(0), m_rowSize(0), m_stride(0)
+{}
+
+ShareMatrix::ShareMatrix(const size_t& rows, const size_t& rowSize) :
+m_storage(rows * _RowStride(rowSize)), m_rows(rows), m_rowSize(rowSize), m_stride(_RowStride(rowSize))
+{}
+
+ShareMatrix::ShareMatrix(ShareMatrix&& other) :
+m_storage(std::move(other.m_storage)), m_rows(other.m_rows), m_rowSize(other.m_rowSize), m_stride(other.m_stride)
+{
+	other.m_rows = 0;
+	other.m_rowSize = 0;
+	other.m_stride = 0;
+}
+
+ShareMatrix& ShareMatrix::operator=(ShareMatrix&& other)
+{
+	if (this != &other)
+	{
+		m_storage = std::move(other.m_storage);
+		m_rows = other.m_rows;
+		m_rowSize = other.m_rowSize;
+		m_stride = other.m_stride;
+		other.m_rows = 0;
+		other.m_rowSize = 0;
+		other.m_stride = 0;
+	}
+	return *this;
+}
+
+const size_t ShareMatrix::Rows() const
+{
+	return m_rows;
+}
+
+const size_t ShareMatrix::RowSize() const
+{
+	return m_rowSize;
+}
+
+const size_t ShareMatrix::Stride() const
+{
+	return m_stride;
+}
+
+MutableBufferView ShareMatrix::Row(const size_t& index) const
+{
+	return MutableBufferView(m_storage.Data() + m_stride * index, m_rowSize);
+}
+
+std::vector<MutableBufferView> ShareMatrix::RowViews() const
+{
+	std::vector<MutableBufferView> views;
+	for (size_t i = 0; i < m_rows; ++i)
+	{
+		views.push_back(Row(i));
+	}
+	return views;
+}
@@ -0,0 +1,141 @@
+// buffer.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(BUFFER_H)
+#define BUFFER_H
+
+/*
+* @class: BufferView
+*
+* @remarks: non-owning, read-only window onto memory owned by somebody else
+*           (a caller buffer, a mapped file, a FixedBuffer...). The viewed
+*           memory MUST outlive the view.
+*/
+class BufferView
+{
+public:
+	BufferView();
+	BufferView(void const * const pData, const size_t& size);
+
+public:
+	Enco::byte const*	Data() const;
+	const size_t		Size() const;
+	bool				Empty() const;
+
+	BufferView			Sub(const size_t& offset, const size_t& size) const;
+	void				Read(void * const pDist, const size_t& offset, const size_t& size) const;
+
+private:
+	Enco::byte const*	m_pData;
+	size_t				m_size;
+};
+
+/*
+* @class: MutableBufferView
+*
+* @remarks: non-owning, writable window. Used to let callers hand their own
+*           storage to the sharers so no intermediate buffer is allocated.
+*/
+class MutableBufferView
+{
+public:
+	MutableBufferView();
+	MutableBufferView(void * const pData, const size_t& size);
+
+public:
+	Enco::byte*			Data() const;
+	const size_t		Size() const;
+	bool				Empty() const;
+
+	MutableBufferView	Sub(const size_t& offset, const size_t& size) const;
+	void				Write(const size_t& offset, void const * const pSrc, const size_t& size) const;
+	void				Read(void * const pDist, const size_t& offset, const size_t& size) const;
+
+	operator BufferView() const;
+
+private:
+	Enco::byte*			m_pData;
+	size_t				m_size;
+};
+
+/*
+* @class: OwnedBuffer
+*
+* @remarks: move-only owner of an AlignedAllocator block. Unlike FixedBuffer
+*           it can be returned by value and stored in containers directly.
+*/
+class OwnedBuffer
+{
+public:
+	OwnedBuffer();
+	explicit OwnedBuffer(const size_t& sizeInBytes);
+	OwnedBuffer(OwnedBuffer&& other) noexcept;
+	~OwnedBuffer();
+
+	OwnedBuffer& operator=(OwnedBuffer&& other) noexcept;
+
+	// deleted:
+	OwnedBuffer(const OwnedBuffer& other) = delete;
+	OwnedBuffer& operator=(const OwnedBuffer& other) = delete;
+
+public:
+	Enco::byte*			Data() const;
+	const size_t		Size() const;
+	bool				Empty() const;
+
+	BufferView			View() const;
+	MutableBufferView	MutableView() const;
+
+	/*
+	* @interface: Release
+	*
+	* @remarks: gives up ownership; the caller MUST hand the returned block to
+	*           AlignedAllocator::Free().
+	*/
+	Enco::byte*			Release();
+
+private:
+	void				_Free();
+
+private:
+	Enco::byte*			m_pData;
+	size_t				m_size;
+};
+
+/*
+* @class: ShareMatrix
+*
+* @remarks: all n shares of one secret in a single aligned allocation, one
+*           row per share. Rows start on a cache line and are padded so that
+*           they do not alias each other in the cache.
+*/
+class ShareMatrix
+{
+public:
+	ShareMatrix();
+	ShareMatrix(const size_t& rows, const size_t& rowSize);
+	ShareMatrix(ShareMatrix&& other);
+
+	ShareMatrix& operator=(ShareMatrix&& other);
+
+	// deleted:
+	ShareMatrix(const ShareMatrix& other) = delete;
+	ShareMatrix& operator=(const ShareMatrix& other) = delete;
+
+public:
+	const size_t		Rows() const;
+	const size_t		RowSize() const;
+	const size_t		Stride() const;
+
+	MutableBufferView				Row(const size_t& index) const;
+	std::vector<MutableBufferView>	RowViews() const;
+
+private:
+	OwnedBuffer			m_storage;
+	size_t				m_rows;
+	size_t				m_rowSize;
+	size_t				m_stride;
+};
+
+#endif
@@ -0,0 +1,347 @@
+// checksum.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "buffer.h"
+#include "cpu-features.h"
+#include "checksum.h"
+#include "perf-counters.h"
+#include "share-stats.h"
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// Crc32c
+
+namespace
+{
+	struct CrcTable
+	{
+		Enco::uint32 entry[256];
+
+		CrcTable()
+		{
+			for (Enco::uint32 i = 0; i < 256; ++i)
+			{
+				Enco::uint32 c = i;
+				for (int b = 0; b < 8; ++b)
+				{
+					c = (c & 1) ? (c >> 1) ^ 0x82F63B78 : (c >> 1);
+				}
+				entry[i] = c;
+			}
+		}
+	};
+
+	const CrcTable& _CrcTable()
+	{
+		static const CrcTable table;
+		return table;
+	}
+}
+
+Enco::uint32 Crc32c::Compute(void const * const pData, const size_t& size, const Enco::uint32& crc)
+{
+	Enco::byte const*	p = static_cast<Enco::byte const*>(pData);
+	Enco::uint32		c = ~crc;
+	size_t				i = 0;
+
+#if defined(ENCO_SSE42)
+	if (CpuFeatures::Sse42())
+	{
+#	if defined(_M_X64) || defined(__x86_64__)
+		Enco::uint64 c64 = c;
+		for (; i + 8 <= size; i += 8)
+		{
+			Enco::uint64 v;
+			memcpy(&v, p + i, sizeof(v));
+			c64 = _mm_crc32_u64(c64, v);
+		}
+		c = (Enco::uint32)c64;
+#	endif
+		for (; i + 4 <= size; i += 4)
+		{
+			Enco::uint32 v;
+			memcpy(&v, p + i, sizeof(v));
+			c = _mm_crc32_u32(c, v);
+		}
+		for (; i < size; ++i)
+		{
+			c = _mm_crc32_u8(c, p[i]);
+		}
+		return ~c;
+	}
+#endif
+
+	const Enco::uint32* table = _CrcTable().entry;
+	for (; i < size; ++i)
+	{
+		c = table[(c ^ p[i]) & 0xff] ^ (c >> 8);
+	}
+	return ~c;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ShareChecksum
+
+const size_t ShareChecksum::m_cnst_chunk_size = ((size_t)64 << 10);
+const Enco::uint32 ShareChecksum::m_cnst_magic = ((Enco::uint32)0x314B4343);		// "CCK1"
+const size_t ShareChecksum::m_cnst_fixed_size = 3 * sizeof(Enco::uint32) + sizeof(Enco::uint64);
+
+size_t ShareChecksum::TrailerSize(const size_t& payloadSize)
+{
+	const size_t chunks = (payloadSize + m_cnst_chunk_size - 1) / m_cnst_chunk_size;
+	return chunks * sizeof(Enco::uint32) + m_cnst_fixed_size;
+}
+
+void ShareChecksum::Seal(const MutableBufferView& share, const size_t& payloadSize)
+{
+	ShareStats::Scope	stage(ShareStats::STAGE_CHECKSUM, payloadSize);
+	const size_t		chunks = (payloadSize + m_cnst_chunk_size - 1) / m_cnst_chunk_size;
+	Enco::byte*		pCrc = share.Data() + payloadSize;
+	for (size_t c = 0; c < chunks; ++c)
+	{
+		const size_t	start = c * m_cnst_chunk_size;
+		const size_t	count = (payloadSize - start < m_cnst_chunk_size) ? payloadSize - start : m_cnst_chunk_size;
+		Enco::uint32	crc = Crc32c::Compute(share.Data() + start, count);
+		memcpy(pCrc + c * sizeof(Enco::uint32), &crc, sizeof(Enco::uint32));
+	}
+
+	const Enco::uint32	chunkSize = (Enco::uint32)m_cnst_chunk_size;
+	const Enco::uint64	size = payloadSize;
+	size_t				off = payloadSize + chunks * sizeof(Enco::uint32);
+	share.Write(off, &chunkSize, sizeof(Enco::uint32));
+	share.Write(off + sizeof(Enco::uint32), &size, sizeof(Enco::uint64));
+
+	const Enco::uint32 self = Crc32c::Compute(pCrc, chunks * sizeof(Enco::uint32) + sizeof(Enco::uint32) + sizeof(Enco::uint64));
+	off += sizeof(Enco::uint32) + sizeof(Enco::uint64);
+	share.Write(off, &self, sizeof(Enco::uint32));
+	share.Write(off + sizeof(Enco::uint32), &m_cnst_magic, sizeof(Enco::uint32));
+}
+
+bool ShareChecksum::HasTrailer(const BufferView& share)
+{
+	if (share.Size() < m_cnst_fixed_size)
+		return false;
+
+	// the magic alone could be payload, so the trailer must also check itself.
+	const size_t	end = share.Size();
+	Enco::uint32	magic;
+	Enco::uint32	self;
+	Enco::uint32	chunkSize;
+	Enco::uint64	size;
+	share.Read(&magic, end - sizeof(Enco::uint32), sizeof(Enco::uint32));
+	share.Read(&self, end - 2 * sizeof(Enco::uint32), sizeof(Enco::uint32));
+	share.Read(&size, end - 2 * sizeof(Enco::uint32) - sizeof(Enco::uint64), sizeof(Enco::uint64));
+	share.Read(&chunkSize, end - m_cnst_fixed_size, sizeof(Enco::uint32));
+	if (magic != m_cnst_magic || chunkSize == 0 || size > end)
+		return false;
+
+	const size_t chunks = ((size_t)size + chunkSize - 1) / chunkSize;
+	if ((size_t)size + chunks * sizeof(Enco::uint32) + m_cnst_fixed_size != end)
+		return false;
+
+	return self == Crc32c::Compute(share.Data() + (size_t)size, chunks * sizeof(Enco::uint32) + sizeof(Enco::uint32) + sizeof(Enco::uint64));
+}
+
+BufferView ShareChecksum::Payload(const BufferView& share)
+{
+	if (false == HasTrailer(share))
+		return share;
+
+	Enco::uint64 size;
+	share.Read(&size, share.Size() - 2 * sizeof(Enco::uint32) - sizeof(Enco::uint64), sizeof(Enco::uint64));
+	return share.Sub(0, (size_t)size);
+}
+
+bool ShareChecksum::Verify(const BufferView& share, std::vector<size_t>& badChunks)
+{
+	badChunks.clear();
+	if (false == HasTrailer(share))
+	{
+		// a magic in place but a broken trailer means the trailer itself is damaged.
+		Enco::uint32 magic = 0;
+		if (share.Size() >= sizeof(Enco::uint32))
+			share.Read(&magic, share.Size() - sizeof(Enco::uint32), sizeof(Enco::uint32));
+		return magic != m_cnst_magic;
+	}
+
+	Enco::uint32	chunkSize;
+	Enco::uint64	size;
+	share.Read(&chunkSize, share.Size() - m_cnst_fixed_size, sizeof(Enco::uint32));
+	share.Read(&size, share.Size() - 2 * sizeof(Enco::uint32) - sizeof(Enco::uint64), sizeof(Enco::uint64));
+
+	const size_t		payloadSize = (size_t)size;
+	const size_t		chunks = (payloadSize + chunkSize - 1) / chunkSize;
+	ShareStats::Scope	stage(ShareStats::STAGE_CHECKSUM, payloadSize);
+	for (size_t c = 0; c < chunks; ++c)
+	{
+		const size_t	start = c * chunkSize;
+		const size_t	count = (payloadSize - start < chunkSize) ? payloadSize - start : chunkSize;
+		Enco::uint32	crc;
+		share.Read(&crc, payloadSize + c * sizeof(Enco::uint32), sizeof(Enco::uint32));
+		if (crc != Crc32c::Compute(share.Data() + start, count))
+			badChunks.push_back(c);
+	}
+
+	return badChunks.empty();
+}
+
+size_t ShareChecksum::StoredTrailerSize(const BufferView& end, const size_t& shareSize)
+{
+	if (end.Size() < m_cnst_fixed_size || shareSize < m_cnst_fixed_size)
+		return 0;
+
+	const size_t	tail = end.Size();
+	Enco::uint32	magic;
+	Enco::uint32	chunkSize;
+	Enco::uint64	size;
+	end.Read(&magic, tail - sizeof(Enco::uint32), sizeof(Enco::uint32));
+	end.Read(&size, tail - 2 * sizeof(Enco::uint32) - sizeof(Enco::uint64), sizeof(Enco::uint64));
+	end.Read(&chunkSize, tail - m_cnst_fixed_size, sizeof(Enco::uint32));
+	if (magic != m_cnst_magic || chunkSize == 0 || size > shareSize)
+		return 0;
+
+	const size_t chunks = ((size_t)size + chunkSize - 1) / chunkSize;
+	if ((size_t)size + chunks * sizeof(Enco::uint32) + m_cnst_fixed_size != shareSize)
+		return 0;
+
+	return shareSize - (size_t)size;
+}
+
+bool ShareChecksum::ReadTrailer(const BufferView& trailer, size_t& payloadSize, size_t& chunkSize, std::vector<Enco::uint32>& chunkCrcs)
+{
+	chunkCrcs.clear();
+	if (trailer.Size() < m_cnst_fixed_size)
+		return false;
+
+	const size_t	tail = trailer.Size();
+	Enco::uint32	self;
+	Enco::uint32	stored;
+	Enco::uint64	size;
+	trailer.Read(&self, tail - 2 * sizeof(Enco::uint32), sizeof(Enco::uint32));
+	trailer.Read(&size, tail - 2 * sizeof(Enco::uint32) - sizeof(Enco::uint64), sizeof(Enco::uint64));
+	trailer.Read(&stored, tail - m_cnst_fixed_size, sizeof(Enco::uint32));
+
+	const size_t chunks = (tail - m_cnst_fixed_size) / sizeof(Enco::uint32);
+	if (stored == 0 || ((size_t)size + stored - 1) / stored != chunks ||
+		self != Crc32c::Compute(trailer.Data(), tail - 2 * sizeof(Enco::uint32)))
+		return false;
+
+	chunkCrcs.resize(chunks);
+	if (chunks > 0)
+		trailer.Read(&chunkCrcs[0], 0, chunks * sizeof(Enco::uint32));
+	payloadSize = (size_t)size;
+	chunkSize = stored;
+	return true;
+}
+
+void ShareChecksum::Trailer(const ChunkChecksum& payload, std::vector<Enco::byte>& trailer)
+{
+	const std::vector<Enco::uint32>&	chunks = payload.Chunks();
+	const Enco::uint32					chunkSize = (Enco::uint32)payload.ChunkSize();
+	const Enco::uint64					size = payload.Size();
+	const size_t						table = chunks.size() * sizeof(Enco::uint32);
+
+	trailer.resize(table + m_cnst_fixed_size);
+	if (table > 0)
+		memcpy(&trailer[0], &chunks[0], table);
+	memcpy(&trailer[table], &chunkSize, sizeof(Enco::uint32));
+	memcpy(&trailer[table + sizeof(Enco::uint32)], &size, sizeof(Enco::uint64));
+
+	const Enco::uint32 self = Crc32c::Compute(&trailer[0], table + sizeof(Enco::uint32) + sizeof(Enco::uint64));
+	memcpy(&trailer[table + sizeof(Enco::uint32) + sizeof(Enco::uint64)], &self, sizeof(Enco::uint32));
+	memcpy(&trailer[table + 2 * sizeof(Enco::uint32) + sizeof(Enco::uint64)], &m_cnst_magic, sizeof(Enco::uint32));
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ChunkChecksum
+
+ChunkChecksum::ChunkChecksum(const size_t& chunkSize) :
+m_chunkSize(chunkSize), m_fill(0), m_crc(0), m_size(0)
+{}
+
+void ChunkChecksum::Update(void const * const pData, const size_t& size)
+{
+	ShareStats::Scope	stage(ShareStats::STAGE_CHECKSUM, size);
+	Enco::byte const*	p = static_cast<Enco::byte const*>(pData);
+	size_t				left = size;
+	while (left > 0)
+	{
+		const size_t count = (m_chunkSize - m_fill < left) ? m_chunkSize - m_fill : left;
+		m_crc = Crc32c::Compute(p, count, m_crc);
+		m_fill += count;
+		p += count;
+		left -= count;
+		if (m_fill == m_chunkSize)
+		{
+			m_chunks.push_back(m_crc);
+			m_crc = 0;
+			m_fill = 0;
+		}
+	}
+	m_size += size;
+}
+
+void ChunkChecksum::Finish()
+{
+	if (m_fill > 0)
+		m_chunks.push_back(m_crc);
+	m_crc = 0;
+	m_fill = 0;
+}
+
+void ChunkChecksum::Append(const ChunkChecksum& next)
+{
+	m_chunks.insert(m_chunks.end(), next.m_chunks.begin(), next.m_chunks.end());
+	if (next.m_size > 0)
+	{
+		m_fill = next.m_fill;
+		m_crc = next.m_crc;
+	}
+	m_size += next.m_size;
+}
+
+const std::vector<Enco::uint32>& ChunkChecksum::Chunks() const
+{
+	return m_chunks;
+}
+
+size_t ChunkChecksum::ChunkSize() const
+{
+	return m_chunkSize;
+}
+
+Enco::uint64 ChunkChecksum::Size() const
+{
+	return m_size;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// HeaderLastChecksum
+
+HeaderLastChecksum::HeaderLastChecksum(const size_t& headerSize) :
+m_headerSize(headerSize)
+{}
+
+void HeaderLastChecksum::Update(void const * const pData, const size_t& size)
+{
+	Enco::byte const*	p = static_cast<Enco::byte const*>(pData);
+	const size_t		room = ShareChecksum::m_cnst_chunk_size - m_headerSize - m_head.size();
+	const size_t		kept = (room < size) ? room : size;
+	m_head.insert(m_head.end(), p, p + kept);
+	if (size > kept)
+		m_rest.Update(p + kept, size - kept);
+}
+
+void HeaderLastChecksum::Trailer(const BufferView& header, std::vector<Enco::byte>& trailer) const
+{
+	ChunkChecksum sum;
+	sum.Update(header.Data(), header.Size());
+	if (false == m_head.empty())
+		sum.Update(&m_head[0], m_head.size());
+	sum.Append(m_rest);
+	sum.Finish();
+	ShareChecksum::Trailer(sum, trailer);
+}
@@ -0,0 +1,139 @@
+// checksum.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(CHECKSUM_H)
+#define CHECKSUM_H
+
+class ChunkChecksum;
+
+/*
+* @class: Crc32c
+*
+* @remarks: CRC-32C (Castagnoli). Uses the SSE4.2 crc32 instruction when the
+*           CPU has it, otherwise a table.
+*/
+class Crc32c
+{
+public:
+	static Enco::uint32	Compute(void const * const pData, const size_t& size, const Enco::uint32& crc = 0);
+};
+
+/*
+* @class: ShareChecksum
+*
+* @remarks: per-chunk CRC-32C trailer appended behind any share, so a damaged
+*           share can be found without reconstructing anything. Shares written
+*           before the trailer existed are accepted as they are.
+* @protocal:
+*   ------------------------------------------
+*   |  * share payload  [  x bytes ]         |
+*   |  * chunk crc32c   [4*chunks bytes]     |
+*   |  * chunk size     [  4 bytes ]         |
+*   |  * payload size   [  8 bytes ]         |
+*   |  * trailer crc32c [  4 bytes ]         |
+*   |  * trailer magic  [  4 bytes ]         |
+*   ------------------------------------------
+*/
+class ShareChecksum
+{
+public:
+	static size_t		TrailerSize(const size_t& payloadSize);
+
+	/*
+	* @interface: Seal
+	*
+	* @remarks: writes the trailer for the first payloadSize bytes of share;
+	*           share MUST hold payloadSize + TrailerSize(payloadSize) bytes.
+	*/
+	static void			Seal(const MutableBufferView& share, const size_t& payloadSize);
+
+	static bool			HasTrailer(const BufferView& share);
+	static BufferView	Payload(const BufferView& share);
+
+	/*
+	* @interface: Verify
+	*
+	* @remarks: false if any chunk mismatches, badChunks lists them. A share
+	*           without a trailer verifies as true.
+	*/
+	static bool			Verify(const BufferView& share, std::vector<size_t>& badChunks);
+
+	/*
+	* @interface: StoredTrailerSize / ReadTrailer / Trailer
+	*
+	* @remarks: the same for shares streamed through a file instead of held.
+	*           StoredTrailerSize() tells from the last m_cnst_fixed_size bytes
+	*           of a share of shareSize bytes how long its trailer is, 0 when
+	*           there is none; ReadTrailer() checks that trailer and returns
+	*           the chunk crcs. Trailer() builds the one Seal() would write for
+	*           the payload summed by payload.
+	*/
+	static size_t		StoredTrailerSize(const BufferView& end, const size_t& shareSize);
+	static bool			ReadTrailer(const BufferView& trailer, size_t& payloadSize, size_t& chunkSize, std::vector<Enco::uint32>& chunkCrcs);
+	static void			Trailer(const ChunkChecksum& payload, std::vector<Enco::byte>& trailer);
+
+public:
+	static const size_t			m_cnst_chunk_size;
+	static const size_t			m_cnst_fixed_size;
+
+private:
+	static const Enco::uint32	m_cnst_magic;
+};
+
+/*
+* @class: ChunkChecksum
+*
+* @remarks: the chunk crcs of a payload fed front to back in pieces of any
+*           size. Finish() closes the last, short chunk.
+*/
+class ChunkChecksum
+{
+public:
+	ChunkChecksum(const size_t& chunkSize = ShareChecksum::m_cnst_chunk_size);
+
+public:
+	void								Update(void const * const pData, const size_t& size);
+	void								Finish();
+
+	// the chunks of the bytes right behind these, summed apart; this one
+	// MUST end on a chunk boundary unless next is empty.
+	void								Append(const ChunkChecksum& next);
+
+	const std::vector<Enco::uint32>&	Chunks() const;		// the closed ones
+	size_t								ChunkSize() const;
+	Enco::uint64						Size() const;
+
+private:
+	std::vector<Enco::uint32>	m_chunks;
+	size_t						m_chunkSize;
+	size_t						m_fill;			// bytes in the open chunk
+	Enco::uint32				m_crc;
+	Enco::uint64				m_size;
+};
+
+/*
+* @class: HeaderLastChecksum
+*
+* @remarks: the trailer of a share written body first, whose header is only
+*           known at the end. The body bytes sharing chunk 0 with the header
+*           are kept until then, the rest is summed as it goes by.
+*/
+class HeaderLastChecksum
+{
+public:
+	HeaderLastChecksum(const size_t& headerSize = 0);
+
+public:
+	void			Update(void const * const pData, const size_t& size);		// the next body bytes
+
+	// header MUST be headerSize bytes.
+	void			Trailer(const BufferView& header, std::vector<Enco::byte>& trailer) const;
+
+private:
+	size_t						m_headerSize;
+	std::vector<Enco::byte>		m_head;
+	ChunkChecksum				m_rest;
+};
+
+#endif
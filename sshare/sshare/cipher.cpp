@@ -0,0 +1,255 @@
+// cipher.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "allocator.h"
+#include "cpu-features.h"
+#include "cipher.h"
+
+#if defined(_WIN32)
+#	include <bcrypt.h>
+#	pragma comment(lib, "bcrypt.lib")
+#else
+#	include <errno.h>
+#	include <unistd.h>
+#	if defined(__linux__)
+#		include <sys/random.h>
+#	endif
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// Aes128Ctr
+
+const size_t Aes128Ctr::m_cnst_key_size = 16;
+const size_t Aes128Ctr::m_cnst_nonce_size = 8;
+const size_t Aes128Ctr::m_cnst_block_size = 16;
+
+#if defined(ENCO_AESNI)
+namespace
+{
+	inline __m128i _ExpandStep(__m128i key, __m128i gen)
+	{
+		gen = _mm_shuffle_epi32(gen, 0xff);
+		key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+		key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+		key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+		return _mm_xor_si128(key, gen);
+	}
+}
+
+#	define ENCO_EXPAND_ROUND(i, rcon) \
+		rk[i] = _ExpandStep(rk[i - 1], _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+#endif
+
+Aes128Ctr::Aes128Ctr(Enco::byte const * const pKey, Enco::byte const * const pNonce) :
+m_pRoundKeys(nullptr)
+{
+	memcpy(m_key, pKey, m_cnst_key_size);
+	memcpy(m_nonce, pNonce, m_cnst_nonce_size);
+
+#if defined(ENCO_AESNI)
+	if (CpuFeatures::AesNi())
+	{
+		m_pRoundKeys = static_cast<Enco::byte*>(AlignedAllocator::Allocate(11 * sizeof(__m128i)));
+
+		__m128i* rk = reinterpret_cast<__m128i*>(m_pRoundKeys);
+		rk[0] = _mm_loadu_si128((const __m128i*)m_key);
+		ENCO_EXPAND_ROUND(1, 0x01);
+		ENCO_EXPAND_ROUND(2, 0x02);
+		ENCO_EXPAND_ROUND(3, 0x04);
+		ENCO_EXPAND_ROUND(4, 0x08);
+		ENCO_EXPAND_ROUND(5, 0x10);
+		ENCO_EXPAND_ROUND(6, 0x20);
+		ENCO_EXPAND_ROUND(7, 0x40);
+		ENCO_EXPAND_ROUND(8, 0x80);
+		ENCO_EXPAND_ROUND(9, 0x1b);
+		ENCO_EXPAND_ROUND(10, 0x36);
+	}
+#endif
+}
+
+Aes128Ctr::~Aes128Ctr()
+{
+	if (m_pRoundKeys != nullptr)
+	{
+		memset(m_pRoundKeys, 0, 11 * 16);
+		AlignedAllocator::Free(m_pRoundKeys);
+	}
+	memset(m_key, 0, sizeof(m_key));
+}
+
+void Aes128Ctr::Apply(Enco::byte * const pOut, Enco::byte const * const pIn, const size_t& size, const Enco::uint64& streamOffset) const
+{
+	const size_t	cnst_batch = 64;
+	Enco::byte		stream[64 * 16];
+	Enco::uint64	block = streamOffset / m_cnst_block_size;
+	size_t			skip = (size_t)(streamOffset % m_cnst_block_size);
+	size_t			done = 0;
+
+	while (done < size)
+	{
+		size_t blocks = (skip + (size - done) + m_cnst_block_size - 1) / m_cnst_block_size;
+		if (blocks > cnst_batch)
+			blocks = cnst_batch;
+
+		_Keystream(stream, block, blocks);
+
+		size_t take = blocks * m_cnst_block_size - skip;
+		if (take > size - done)
+			take = size - done;
+
+		for (size_t i = 0; i < take; ++i)
+		{
+			pOut[done + i] = pIn[done + i] ^ stream[skip + i];
+		}
+
+		done += take;
+		block += blocks;
+		skip = 0;
+	}
+}
+
+bool Aes128Ctr::Available()
+{
+#if defined(ENCO_AES128_LIB)
+	return true;
+#else
+	return CpuFeatures::AesNi();
+#endif
+}
+
+void Aes128Ctr::_Keystream(Enco::byte * const pOut, const Enco::uint64& firstBlock, const size_t& blocks) const
+{
+	Enco::byte counter[4][16];
+	for (int l = 0; l < 4; ++l)
+	{
+		memcpy(counter[l], m_nonce, m_cnst_nonce_size);
+	}
+
+#if defined(ENCO_AESNI)
+	if (m_pRoundKeys != nullptr)
+	{
+		const __m128i* rk = reinterpret_cast<const __m128i*>(m_pRoundKeys);
+
+		// four independent blocks keep the AES unit's pipeline full.
+		for (size_t b = 0; b < blocks; b += 4)
+		{
+			__m128i x[4];
+			for (int l = 0; l < 4; ++l)
+			{
+				Enco::uint64 ctr = firstBlock + b + l;
+				for (int i = 15; i >= 8; --i, ctr >>= 8)
+				{
+					counter[l][i] = (Enco::byte)ctr;
+				}
+				x[l] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)counter[l]), rk[0]);
+			}
+
+			for (int r = 1; r < 10; ++r)
+			{
+				x[0] = _mm_aesenc_si128(x[0], rk[r]);
+				x[1] = _mm_aesenc_si128(x[1], rk[r]);
+				x[2] = _mm_aesenc_si128(x[2], rk[r]);
+				x[3] = _mm_aesenc_si128(x[3], rk[r]);
+			}
+
+			for (int l = 0; l < 4 && b + l < blocks; ++l)
+			{
+				_mm_storeu_si128((__m128i*)(pOut + (b + l) * m_cnst_block_size), _mm_aesenclast_si128(x[l], rk[10]));
+			}
+		}
+		return;
+	}
+#endif
+
+#if defined(ENCO_AES128_LIB)
+	for (size_t b = 0; b < blocks; ++b)
+	{
+		Enco::uint64 ctr = firstBlock + b;
+		for (int i = 15; i >= 8; --i, ctr >>= 8)
+		{
+			counter[0][i] = (Enco::byte)ctr;
+		}
+		AES128_ECB_encrypt(counter[0], m_key, pOut + b * m_cnst_block_size);
+	}
+#endif
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// SystemRandom
+
+bool SystemRandom::Fill(void * const pOut, const size_t& size)
+{
+	Enco::byte* const	pData = (Enco::byte*)pOut;
+	size_t				done = 0;
+	while (done < size)
+	{
+#if defined(_WIN32)
+		const ULONG chunk = (ULONG)((size - done < ((size_t)1 << 30)) ? size - done : ((size_t)1 << 30));
+		if (false == BCRYPT_SUCCESS(BCryptGenRandom(nullptr, pData + done, chunk, BCRYPT_USE_SYSTEM_PREFERRED_RNG)))
+			break;
+		done += chunk;
+#elif defined(__linux__)
+		const ssize_t got = getrandom(pData + done, size - done, 0);
+		if (got > 0)
+		{
+			done += (size_t)got;
+			continue;
+		}
+		if (got < 0 && errno == EINTR)
+			continue;
+		break;
+#else
+		// getentropy() hands out at most 256 bytes a call.
+		const size_t chunk = (size - done < 256) ? size - done : 256;
+		if (getentropy(pData + done, chunk) != 0)
+			break;
+		done += chunk;
+#endif
+	}
+
+	if (done == size)
+		return true;
+	memset(pOut, 0, size);
+	return false;
+}
+
+#if !defined(_WIN32)
+long CoCreateGuid(GUID * const pGuid)
+{
+	if (false == SystemRandom::Fill(pGuid, sizeof(GUID)))
+		return -1;
+
+	// version 4, variant 10xx, as ole32 makes them.
+	pGuid->Data3 = (unsigned short)((pGuid->Data3 & 0x0FFF) | 0x4000);
+	pGuid->Data4[0] = (unsigned char)((pGuid->Data4[0] & 0x3F) | 0x80);
+	return 0;
+}
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// KeyedStream
+
+KeyedStream::KeyedStream() :
+m_pCipher(nullptr)
+{
+	Enco::byte keyMaterial[24];
+	if (Aes128Ctr::Available() && SystemRandom::Fill(keyMaterial, Aes128Ctr::m_cnst_key_size + Aes128Ctr::m_cnst_nonce_size))
+	{
+		m_pCipher = new Aes128Ctr(keyMaterial, keyMaterial + Aes128Ctr::m_cnst_key_size);
+	}
+	memset(keyMaterial, 0, sizeof(keyMaterial));
+}
+
+KeyedStream::~KeyedStream()
+{
+	delete m_pCipher;
+}
+
+Aes128Ctr const* KeyedStream::Stream() const
+{
+	return m_pCipher;
+}
@@ -0,0 +1,92 @@
+// cipher.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(CIPHER_H)
+#define CIPHER_H
+
+/*
+* @class: Aes128Ctr
+*
+* @remarks: AES-128 in counter mode. The counter block is the 8-byte nonce
+*           followed by the big-endian block number, so any block of the
+*           stream can be produced independently. Uses AES-NI when the CPU
+*           has it, otherwise the bundled aes128-lib.
+*/
+class Aes128Ctr
+{
+public:
+	Aes128Ctr(Enco::byte const * const pKey, Enco::byte const * const pNonce);
+	~Aes128Ctr();
+
+	// deleted:
+	Aes128Ctr(const Aes128Ctr& cipher) = delete;
+	Aes128Ctr& operator=(const Aes128Ctr& cipher) = delete;
+
+public:
+	/*
+	* @interface: Apply
+	*
+	* @remarks: out = in XOR keystream, starting at byte streamOffset of the
+	*           stream. Encryption and decryption are the same operation; in
+	*           and out may be the same buffer.
+	*/
+	void		Apply(Enco::byte * const pOut, Enco::byte const * const pIn, const size_t& size, const Enco::uint64& streamOffset) const;
+
+	static bool	Available();
+
+public:
+	static const size_t		m_cnst_key_size;
+	static const size_t		m_cnst_nonce_size;
+	static const size_t		m_cnst_block_size;
+
+private:
+	void		_Keystream(Enco::byte * const pOut, const Enco::uint64& firstBlock, const size_t& blocks) const;
+
+private:
+	Enco::byte		m_key[16];
+	Enco::byte		m_nonce[8];
+	Enco::byte*		m_pRoundKeys;	// 11 aligned round keys when AES-NI is used
+};
+
+/*
+* @class: SystemRandom
+*
+* @remarks: the operating system's CSPRNG: BCryptGenRandom on Windows,
+*           getrandom() on Linux, getentropy() elsewhere. Keys, nonces and
+*           the seeds of the coefficient streams come from here, never from
+*           rand(): a time-seeded rand() is guessed from a share's mtime.
+*/
+class SystemRandom
+{
+public:
+	// false only when the system generator fails; pOut is then zeroed.
+	static bool	Fill(void * const pOut, const size_t& size);
+};
+
+/*
+* @class: KeyedStream
+*
+* @remarks: an Aes128Ctr keystream under a key and nonce of its own from
+*           SystemRandom, for the bulk coefficients of refresh, reshare and
+*           the batch engines. Stream() is nullptr without AES or when the
+*           system generator failed; callers then draw from their randomer.
+*/
+class KeyedStream
+{
+public:
+	KeyedStream();
+	~KeyedStream();
+
+	// deleted:
+	KeyedStream(const KeyedStream& stream) = delete;
+	KeyedStream& operator=(const KeyedStream& stream) = delete;
+
+public:
+	Aes128Ctr const*	Stream() const;
+
+private:
+	Aes128Ctr*			m_pCipher;
+};
+
+#endif
@@ -0,0 +1,89 @@
+// cpu-features.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "cpu-features.h"
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#	include <cpuid.h>
+#	define ENCO_GNU_CPUID
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// CpuFeatures
+
+bool CpuFeatures::AesNi()
+{
+	return _Probe().aesni;
+}
+
+bool CpuFeatures::Ssse3()
+{
+	return _Probe().ssse3;
+}
+
+bool CpuFeatures::Sse42()
+{
+	return _Probe().sse42;
+}
+
+bool CpuFeatures::Avx2()
+{
+	return _Probe().avx2;
+}
+
+const CpuFeatures::Flags& CpuFeatures::_Probe()
+{
+	struct Prober
+	{
+		Flags flags;
+
+		Prober()
+		{
+			flags.aesni = false;
+			flags.ssse3 = false;
+			flags.sse42 = false;
+			flags.avx2 = false;
+
+			unsigned int leaf1[4] = { 0 };
+			unsigned int leaf7[4] = { 0 };
+			bool osAvx = false;
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			const int maxLeaf = info[0];
+			__cpuid(info, 1);
+			memcpy(leaf1, info, sizeof(info));
+			if (maxLeaf >= 7)
+			{
+				__cpuidex(info, 7, 0);
+				memcpy(leaf7, info, sizeof(info));
+			}
+			if (leaf1[2] & (1u << 27))
+				osAvx = (_xgetbv(0) & 6) == 6;
+#elif defined(ENCO_GNU_CPUID)
+			const unsigned int maxLeaf = __get_cpuid_max(0, nullptr);
+			__get_cpuid(1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3]);
+			if (maxLeaf >= 7)
+				__cpuid_count(7, 0, leaf7[0], leaf7[1], leaf7[2], leaf7[3]);
+			if (leaf1[2] & (1u << 27))
+			{
+				unsigned int lo, hi;
+				__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+				osAvx = (lo & 6) == 6;
+			}
+#endif
+			flags.aesni = (leaf1[2] & (1u << 25)) != 0;
+			flags.ssse3 = (leaf1[2] & (1u << 9)) != 0;
+			flags.sse42 = (leaf1[2] & (1u << 20)) != 0;
+			flags.avx2 = osAvx && (leaf7[1] & (1u << 5)) != 0;
+		}
+	};
+
+	static const Prober prober;
+	return prober.flags;
+}
@@ -0,0 +1,34 @@
+// cpu-features.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(CPU_FEATURES_H)
+#define CPU_FEATURES_H
+
+/*
+* @class: CpuFeatures
+*
+* @remarks: runtime checks for the instruction set extensions the kernels can
+*           use. The answers are probed once and cached.
+*/
+class CpuFeatures
+{
+public:
+	static bool		AesNi();
+	static bool		Ssse3();
+	static bool		Sse42();
+	static bool		Avx2();
+
+private:
+	struct Flags
+	{
+		bool	aesni;
+		bool	ssse3;
+		bool	sse42;
+		bool	avx2;
+	};
+
+	static const Flags&	_Probe();
+};
+
+#endif
@@ -0,0 +1,521 @@
+// daemon.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "allocator.h"
+#include "buffer.h"
+#include "secret-share.h"
+#include "daemon.h"
+
+#if defined(_WIN32)
+#	include <afunix.h>
+#	pragma comment(lib, "Ws2_32.lib")
+#else
+#	include <errno.h>
+#	include <unistd.h>
+#	include <sys/socket.h>
+#	include <sys/stat.h>
+#	include <sys/time.h>
+#	include <sys/un.h>
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ShareDaemon
+
+const size_t ShareDaemon::m_cnst_max_payload = ((size_t)256 << 20);
+const unsigned int ShareDaemon::m_cnst_idle_seconds = 60;
+
+namespace
+{
+	const Enco::uint64	g_cnst_invalid_handle = ~(Enco::uint64)0;
+	const size_t		g_cnst_request_header = 4 * sizeof(Enco::uint32) + sizeof(Enco::uint64);
+	const size_t		g_cnst_response_header = 2 * sizeof(Enco::uint32) + sizeof(Enco::uint64);
+	const size_t		g_cnst_record_header = sizeof(GUID) + sizeof(Enco::uint32) + 32;
+
+#if defined(_WIN32)
+	typedef SOCKET	Socket;
+	const int		g_cnst_send_flags = 0;
+#else
+	typedef int		Socket;
+#	if defined(MSG_NOSIGNAL)
+	const int		g_cnst_send_flags = MSG_NOSIGNAL;	// a vanished client is not a reason to die
+#	else
+	const int		g_cnst_send_flags = 0;
+#	endif
+#endif
+
+	bool _ReadAll(const Enco::uint64& handle, void * const pData, const size_t& size)
+	{
+		size_t done = 0;
+		while (done < size)
+		{
+			const size_t	chunk = (size - done < ((size_t)1 << 30)) ? size - done : ((size_t)1 << 30);
+			const int		got = (int)recv((Socket)handle, (char*)pData + done, (int)chunk, 0);
+			if (got > 0)
+			{
+				done += got;
+				continue;
+			}
+#if !defined(_WIN32)
+			if (got < 0 && errno == EINTR)
+				continue;
+#endif
+			return false;
+		}
+		return true;
+	}
+
+	bool _WriteAll(const Enco::uint64& handle, void const * const pData, const size_t& size)
+	{
+		size_t done = 0;
+		while (done < size)
+		{
+			const size_t	chunk = (size - done < ((size_t)1 << 30)) ? size - done : ((size_t)1 << 30);
+			const int		sent = (int)send((Socket)handle, (const char*)pData + done, (int)chunk, g_cnst_send_flags);
+			if (sent > 0)
+			{
+				done += sent;
+				continue;
+			}
+#if !defined(_WIN32)
+			if (sent < 0 && errno == EINTR)
+				continue;
+#endif
+			return false;
+		}
+		return true;
+	}
+
+	void _Shutdown(const Enco::uint64& handle)
+	{
+#if defined(_WIN32)
+		shutdown((Socket)handle, SD_BOTH);
+#else
+		shutdown((Socket)handle, SHUT_RDWR);
+#endif
+	}
+
+	void _Close(const Enco::uint64& handle)
+	{
+#if defined(_WIN32)
+		closesocket((Socket)handle);
+#else
+		close((Socket)handle);
+#endif
+	}
+
+	// a recv() or send() blocked longer than that fails, and _Serve() drops the
+	// connection: a client that stalls does not hold a worker for good.
+	void _SetTimeout(const Enco::uint64& handle, const unsigned int& seconds)
+	{
+#if defined(_WIN32)
+		const DWORD		timeout = seconds * 1000;
+#else
+		struct timeval	timeout;
+		timeout.tv_sec = seconds;
+		timeout.tv_usec = 0;
+#endif
+		setsockopt((Socket)handle, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+		setsockopt((Socket)handle, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+	}
+
+	// what a worker keeps between requests: a randomer keyed apart from every
+	// other worker's, the sharers with their keystreams, and buffers that only
+	// ever grow.
+	struct Session
+	{
+		Session() :
+		strong(randomer), batch(randomer), fixed16(randomer), fixed32(randomer), fixed64(randomer)
+		{}
+
+		DefaultRandomer					randomer;
+		DefaultStrongSSharer			strong;
+		BatchSecretSharer				batch;
+		FixedSecretSharer<16>			fixed16;
+		FixedSecretSharer<32>			fixed32;
+		FixedSecretSharer<64>			fixed64;
+
+		std::vector<Enco::byte>			request;
+		std::vector<Enco::byte>			response;		// response header included
+		std::vector<Enco::byte>			scratch;
+		std::vector<MutableBufferView>	shares;
+		std::vector<BufferView>			views;
+		std::vector<size_t>				failed;
+	};
+
+	Enco::byte* _Reserve(std::vector<Enco::byte>& buffer, const size_t& size)
+	{
+		if (buffer.size() < size)
+			buffer.resize(size);
+		return &buffer[0];
+	}
+
+	template <size_t L>
+	bool _EncodeFixed(FixedSecretSharer<L>& sharer, const Enco::uint32& n, const Enco::uint32& k, Enco::byte const * const pSecret, Enco::byte * const pOut)
+	{
+		typename FixedSecretSharer<L>::Secret secret;
+		memcpy(secret.data(), pSecret, L);
+		const bool result = sharer.Encode(reinterpret_cast<typename FixedSecretSharer<L>::Share*>(pOut), n, k, secret);
+		secret.fill(0);
+		return result;
+	}
+
+	template <size_t L>
+	bool _DecodeFixed(const Enco::uint32& count, Enco::byte const * const pShares, Enco::byte * const pOut)
+	{
+		typename FixedSecretSharer<L>::Secret secret;
+		const bool result = FixedSecretSharer<L>::Decode(secret, reinterpret_cast<typename FixedSecretSharer<L>::Share const*>(pShares), count);
+		memcpy(pOut, secret.data(), L);
+		secret.fill(0);
+		return result;
+	}
+
+	Enco::uint32 _Encode(Session& session, const Enco::uint32& n, const Enco::uint32& k, const size_t& size, size_t& outSize)
+	{
+		if (n == 0 || k == 0 || k > n || n >= 65809)
+			return ShareDaemon::STATUS_BAD_REQUEST;
+
+		const size_t record = session.strong.EncodedSize(size, n, k);
+		outSize = record * n;
+		if (outSize > ShareDaemon::m_cnst_max_payload)
+			return ShareDaemon::STATUS_BAD_REQUEST;
+
+		Enco::byte* const	pOut = _Reserve(session.response, g_cnst_response_header + outSize) + g_cnst_response_header;
+		const Enco::byte*	pSecret = &session.request[0];
+		bool				result = false;
+		if (size == 16 && k <= FixedSecretSharer<16>::m_cnst_max_threshold)
+			result = _EncodeFixed(session.fixed16, n, k, pSecret, pOut);
+		else if (size == 32 && k <= FixedSecretSharer<32>::m_cnst_max_threshold)
+			result = _EncodeFixed(session.fixed32, n, k, pSecret, pOut);
+		else if (size == 64 && k <= FixedSecretSharer<64>::m_cnst_max_threshold)
+			result = _EncodeFixed(session.fixed64, n, k, pSecret, pOut);
+		else
+		{
+			session.shares.clear();
+			for (Enco::uint32 i = 0; i < n; ++i)
+			{
+				session.shares.push_back(MutableBufferView(pOut + record * i, record));
+			}
+			result = session.strong.Encode(session.shares, n, k, BufferView(pSecret, size));
+		}
+
+		return result ? ShareDaemon::STATUS_OK : ShareDaemon::STATUS_FAILED;
+	}
+
+	Enco::uint32 _Decode(Session& session, const Enco::uint32& count, const size_t& size, size_t& outSize)
+	{
+		if (count == 0 || size % count != 0 || size / count < g_cnst_record_header)
+			return ShareDaemon::STATUS_BAD_REQUEST;
+
+		const size_t		record = size / count;
+		const Enco::byte*	pShares = &session.request[0];
+		outSize = session.strong.DecodedSize(BufferView(pShares, record));
+
+		Enco::byte* const	pOut = _Reserve(session.response, g_cnst_response_header + outSize) + g_cnst_response_header;
+		bool				result = false;
+		if (record == FixedSecretSharer<16>::m_cnst_share_size && count <= FixedSecretSharer<16>::m_cnst_max_threshold)
+			result = _DecodeFixed<16>(count, pShares, pOut);
+		else if (record == FixedSecretSharer<32>::m_cnst_share_size && count <= FixedSecretSharer<32>::m_cnst_max_threshold)
+			result = _DecodeFixed<32>(count, pShares, pOut);
+		else if (record == FixedSecretSharer<64>::m_cnst_share_size && count <= FixedSecretSharer<64>::m_cnst_max_threshold)
+			result = _DecodeFixed<64>(count, pShares, pOut);
+		else
+		{
+			session.views.clear();
+			for (Enco::uint32 j = 0; j < count; ++j)
+			{
+				session.views.push_back(BufferView(pShares + record * j, record));
+			}
+			result = session.strong.Decode(MutableBufferView(pOut, outSize), session.views);
+		}
+
+		if (false == result)
+		{
+			memset(pOut, 0, outSize);
+			outSize = 0;
+		}
+		return result ? ShareDaemon::STATUS_OK : ShareDaemon::STATUS_FAILED;
+	}
+
+	Enco::uint32 _EncodeBatch(Session& session, const Enco::uint32& n, const Enco::uint32& k, const Enco::uint32& count, const size_t& size, size_t& outSize)
+	{
+		if (n == 0 || k == 0 || k > n || n >= 65809 || count == 0 || size % count != 0)
+			return ShareDaemon::STATUS_BAD_REQUEST;
+
+		const size_t secretSize = size / count;
+		outSize = session.batch.RecordSize(secretSize) * n * count;
+		if (outSize > ShareDaemon::m_cnst_max_payload)
+			return ShareDaemon::STATUS_BAD_REQUEST;
+
+		// back to back in, structure-of-arrays for the sharer.
+		const Enco::byte*	pSecrets = &session.request[0];
+		Enco::byte* const	pSoa = _Reserve(session.scratch, size);
+		for (Enco::uint32 s = 0; s < count; ++s)
+		{
+			for (size_t b = 0; b < secretSize; ++b)
+			{
+				pSoa[b * count + s] = pSecrets[secretSize * s + b];
+			}
+		}
+
+		Enco::byte* const	pOut = _Reserve(session.response, g_cnst_response_header + outSize) + g_cnst_response_header;
+		const bool			result = session.batch.EncodeBatch(pOut, n, k, pSoa, secretSize, count);
+		memset(pSoa, 0, size);
+
+		return result ? ShareDaemon::STATUS_OK : ShareDaemon::STATUS_FAILED;
+	}
+
+	Enco::uint32 _DecodeBatch(Session& session, const Enco::uint32& rows, const Enco::uint32& count, const size_t& size, size_t& outSize)
+	{
+		if (rows == 0 || count == 0 || size % ((size_t)rows * count) != 0)
+			return ShareDaemon::STATUS_BAD_REQUEST;
+
+		const size_t record = size / ((size_t)rows * count);
+		if (record < g_cnst_record_header || (record - g_cnst_record_header) % sizeof(Enco::uint32) != 0)
+			return ShareDaemon::STATUS_BAD_REQUEST;
+
+		const size_t secretSize = (record - g_cnst_record_header) / sizeof(Enco::uint32);
+		outSize = secretSize * count;
+
+		session.views.clear();
+		for (Enco::uint32 j = 0; j < rows; ++j)
+		{
+			session.views.push_back(BufferView(&session.request[0] + record * count * j, record * count));
+		}
+
+		Enco::byte* const	pSoa = _Reserve(session.scratch, outSize);
+		const bool			result = session.batch.DecodeBatch(pSoa, secretSize, count, session.views, session.failed);
+
+		Enco::byte* const	pOut = _Reserve(session.response, g_cnst_response_header + outSize) + g_cnst_response_header;
+		for (Enco::uint32 s = 0; s < count; ++s)
+		{
+			for (size_t b = 0; b < secretSize; ++b)
+			{
+				pOut[secretSize * s + b] = pSoa[b * count + s];
+			}
+		}
+		memset(pSoa, 0, outSize);
+
+		return result ? ShareDaemon::STATUS_OK : ShareDaemon::STATUS_FAILED;
+	}
+
+	// request after request until the client hangs up or breaks the framing.
+	void _Serve(const Enco::uint64& connection, Session& session)
+	{
+		for (;;)
+		{
+			Enco::byte		header[g_cnst_request_header];
+			Enco::uint32	op, n, k, count;
+			Enco::uint64	size;
+			if (false == _ReadAll(connection, header, g_cnst_request_header))
+				return;
+
+			memcpy(&op, header, sizeof(Enco::uint32));
+			memcpy(&n, header + 4, sizeof(Enco::uint32));
+			memcpy(&k, header + 8, sizeof(Enco::uint32));
+			memcpy(&count, header + 12, sizeof(Enco::uint32));
+			memcpy(&size, header + 16, sizeof(Enco::uint64));
+
+			Enco::uint32	status = ShareDaemon::STATUS_BAD_REQUEST;
+			size_t			outSize = 0;
+			const bool		tooLarge = size > ShareDaemon::m_cnst_max_payload;
+			if (false == tooLarge)
+			{
+				_Reserve(session.request, (size_t)size + 1);
+				if (false == _ReadAll(connection, &session.request[0], (size_t)size))
+					return;
+
+				switch (op)
+				{
+				case ShareDaemon::OP_ENCODE:
+					status = _Encode(session, n, k, (size_t)size, outSize);
+					count = n;
+					break;
+				case ShareDaemon::OP_DECODE:
+					status = _Decode(session, count, (size_t)size, outSize);
+					break;
+				case ShareDaemon::OP_ENCODE_BATCH:
+					status = _EncodeBatch(session, n, k, count, (size_t)size, outSize);
+					break;
+				case ShareDaemon::OP_DECODE_BATCH:
+					status = _DecodeBatch(session, n, count, (size_t)size, outSize);
+					break;
+				default:
+					break;
+				}
+				memset(&session.request[0], 0, (size_t)size);
+			}
+			if (status == ShareDaemon::STATUS_BAD_REQUEST)
+				outSize = 0;
+
+			Enco::byte* const	pResponse = _Reserve(session.response, g_cnst_response_header + outSize);
+			const Enco::uint64	out = outSize;
+			memcpy(pResponse, &status, sizeof(Enco::uint32));
+			memcpy(pResponse + 4, &count, sizeof(Enco::uint32));
+			memcpy(pResponse + 8, &out, sizeof(Enco::uint64));
+
+			const bool sent = _WriteAll(connection, pResponse, g_cnst_response_header + outSize);
+			memset(pResponse, 0, g_cnst_response_header + outSize);
+			if (false == sent || tooLarge)
+				return;		// an oversized payload was never read, the stream is lost
+		}
+	}
+}
+
+ShareDaemon::ShareDaemon(const std::string& socketPath, const unsigned int& workers) :
+m_socketPath(socketPath), m_workers((workers == 0) ? 1 : workers), m_stopping(false), m_listener(g_cnst_invalid_handle)
+{}
+
+ShareDaemon::~ShareDaemon()
+{
+	Stop();
+}
+
+bool ShareDaemon::Run()
+{
+#if defined(_WIN32)
+	WSADATA wsaData;
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+		return false;
+#endif
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (m_socketPath.empty() || m_socketPath.size() >= sizeof(address.sun_path))
+		return false;
+	memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.size());
+
+	const Socket listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if ((Enco::uint64)listener == g_cnst_invalid_handle)
+		return false;
+
+	// a stale socket file from an earlier run would make bind() fail.
+#if defined(_WIN32)
+	DeleteFileA(m_socketPath.c_str());
+	const bool bound = bind(listener, (const sockaddr*)&address, sizeof(address)) == 0;
+#else
+	unlink(m_socketPath.c_str());
+	const mode_t mask = umask(077);
+	const bool bound = bind(listener, (const sockaddr*)&address, sizeof(address)) == 0;
+	umask(mask);
+#endif
+	if (false == bound || listen(listener, SOMAXCONN) != 0)
+	{
+		_Close((Enco::uint64)listener);
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_listener = (Enco::uint64)listener;
+
+		// a Stop() that came before the listener existed still counts.
+		if (m_stopping)
+			_Shutdown(m_listener);
+	}
+
+	std::vector<std::thread> threads;
+	for (unsigned int w = 0; w < m_workers; ++w)
+	{
+		threads.push_back(std::thread(&ShareDaemon::_Worker, this));
+	}
+
+	for (;;)
+	{
+		const Socket connection = accept(listener, nullptr, nullptr);
+
+		std::lock_guard<std::mutex> guard(m_lock);
+		if (m_stopping)
+		{
+			if ((Enco::uint64)connection != g_cnst_invalid_handle)
+				_Close((Enco::uint64)connection);
+			break;
+		}
+		if ((Enco::uint64)connection == g_cnst_invalid_handle)
+		{
+#if !defined(_WIN32)
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+#endif
+			m_stopping = true;
+			break;
+		}
+
+		m_pending.push_back((Enco::uint64)connection);
+		m_ready.notify_one();
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		for (const Enco::uint64& connection : m_active)
+		{
+			_Shutdown(connection);
+		}
+		m_ready.notify_all();
+	}
+	for (std::thread& t : threads)
+	{
+		t.join();
+	}
+
+	std::lock_guard<std::mutex> guard(m_lock);
+	for (const Enco::uint64& connection : m_pending)
+	{
+		_Close(connection);
+	}
+	m_pending.clear();
+	_Close(m_listener);
+	m_listener = g_cnst_invalid_handle;
+
+#if defined(_WIN32)
+	DeleteFileA(m_socketPath.c_str());
+	WSACleanup();
+#else
+	unlink(m_socketPath.c_str());
+#endif
+	return true;
+}
+
+void ShareDaemon::Stop()
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	m_stopping = true;
+	if (m_listener != g_cnst_invalid_handle)
+		_Shutdown(m_listener);
+	for (const Enco::uint64& connection : m_active)
+	{
+		_Shutdown(connection);
+	}
+	m_ready.notify_all();
+}
+
+void ShareDaemon::_Worker()
+{
+	Session session;
+	for (;;)
+	{
+		Enco::uint64 connection;
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_ready.wait(lock, [this]() { return m_stopping || false == m_pending.empty(); });
+			if (m_stopping)
+				return;
+
+			// first come, first served.
+			connection = m_pending.front();
+			m_pending.pop_front();
+			m_active.push_back(connection);
+		}
+
+		_SetTimeout(connection, m_cnst_idle_seconds);
+		_Serve(connection, session);
+
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_active.erase(std::find(m_active.begin(), m_active.end(), connection));
+		_Close(connection);
+	}
+}
@@ -0,0 +1,92 @@
+// daemon.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(DAEMON_H)
+#define DAEMON_H
+
+/*
+* @class: ShareDaemon
+*
+* @remarks: serves encode/decode requests over a Unix domain socket, so a
+*           request costs a round trip instead of a process start. Every
+*           worker keeps its sharers, keystream and buffers for its whole
+*           life and serves one connection at a time, request after request.
+*
+*           Framing, little-endian:
+*           request  : op(4) n(4) k(4) count(4) size(8) payload[size]
+*           response : status(4) count(4) size(8) payload[size]
+*
+*           OP_ENCODE        payload is the secret; n DefaultStrongSSharer
+*                            shares come back, count = n.
+*           OP_DECODE        payload is count shares of one size.
+*           OP_ENCODE_BATCH  payload is count secrets of one size back to
+*                            back; n * count shares come back share-major,
+*                            as BatchSecretSharer::EncodeBatch() lays them.
+*           OP_DECODE_BATCH  payload is n rows of count shares, one index per
+*                            row; the count secrets come back back to back.
+*                            STATUS_FAILED with zeroed secrets for the ones
+*                            that could not be recovered.
+*/
+class ShareDaemon
+{
+public:
+	enum Operation
+	{
+		OP_ENCODE			= 1,
+		OP_DECODE			= 2,
+		OP_ENCODE_BATCH		= 3,
+		OP_DECODE_BATCH		= 4
+	};
+
+	enum Status
+	{
+		STATUS_OK			= 0,
+		STATUS_BAD_REQUEST	= 1,
+		STATUS_FAILED		= 2
+	};
+
+public:
+	ShareDaemon(const std::string& socketPath, const unsigned int& workers);
+	~ShareDaemon();
+
+	// deleted:
+	ShareDaemon(const ShareDaemon& daemon) = delete;
+	ShareDaemon& operator=(const ShareDaemon& daemon) = delete;
+
+public:
+	/*
+	* @interface: Run
+	*
+	* @remarks: accepts connections until Stop(), and returns at once after a
+	*           Stop() that came first; false when the socket cannot be set up.
+	*           The socket file is owner-only and removed on return.
+	*/
+	bool				Run();
+
+	/*
+	* @interface: Stop
+	*
+	* @remarks: may be called from any thread; open connections are shut down.
+	*/
+	void				Stop();
+
+public:
+	static const size_t			m_cnst_max_payload;
+	static const unsigned int	m_cnst_idle_seconds;	// a connection idle longer is dropped
+
+private:
+	void				_Worker();
+
+private:
+	std::string					m_socketPath;
+	unsigned int				m_workers;
+	std::mutex					m_lock;
+	std::condition_variable		m_ready;
+	bool						m_stopping;
+	Enco::uint64				m_listener;		// a SOCKET or a descriptor, ~0 when closed
+	std::deque<Enco::uint64>	m_pending;		// accepted, not served yet, oldest first
+	std::vector<Enco::uint64>	m_active;		// being served
+};
+
+#endif
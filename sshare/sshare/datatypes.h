@@ -18,7 +18,7 @@ namespace Enco
 
 	struct guid_equal
 	{
-		bool operator()(const GUID& guid1, const GUID& guid2)
+		bool operator()(const GUID& guid1, const GUID& guid2) const
 		{
 			if (guid1.Data1 == guid2.Data1 &&
 				guid1.Data2 == guid2.Data2 &&
@@ -37,9 +37,19 @@ namespace Enco
 	};
 
 	typedef unsigned char		byte;
+#if defined(_MSC_VER)
+	typedef unsigned __int16	uint16;
 	typedef unsigned __int32	uint32;
 	typedef unsigned __int64	uint64;
 	typedef __int32				int32;
+	typedef __int64				int64;
+#else
+	typedef unsigned short		uint16;
+	typedef unsigned int		uint32;
+	typedef unsigned long long	uint64;
+	typedef int					int32;
+	typedef long long			int64;
+#endif
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,255 @@
+// dispersal.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "cpu-features.h"
+#include "field.h"
+#include "dispersal.h"
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// GaloisField256
+
+namespace
+{
+	// built by the compiler from Gf256Field, nothing is set up at run time.
+	struct GfTables
+	{
+		Enco::byte	mul[256][256];
+		Enco::byte	nibble[256][32];	// c * x and c * (x << 4) for x < 16, for pshufb
+
+		constexpr GfTables() : mul(), nibble()
+		{
+			for (unsigned int a = 0; a < 256; ++a)
+			{
+				for (unsigned int b = 0; b < 256; ++b)
+				{
+					mul[a][b] = (Enco::byte)Gf256Field::Multiply(a, b);
+				}
+
+				for (unsigned int x = 0; x < 16; ++x)
+				{
+					nibble[a][x] = mul[a][x];
+					nibble[a][x + 16] = mul[a][x << 4];
+				}
+			}
+		}
+	};
+
+	constexpr GfTables g_cnst_gf_tables = GfTables();
+
+	const GfTables& _Tables()
+	{
+		return g_cnst_gf_tables;
+	}
+}
+
+Enco::byte GaloisField256::Multiply(const Enco::byte& a, const Enco::byte& b)
+{
+	return _Tables().mul[a][b];
+}
+
+Enco::byte GaloisField256::Inverse(const Enco::byte& a)
+{
+	return (Enco::byte)Gf256Field::Inverse(a);
+}
+
+void GaloisField256::MultiplyAdd(Enco::byte * const pDist, Enco::byte const * const pSrc, const Enco::byte& c, const size_t& size)
+{
+	if (c == 0)
+		return;
+
+	if (c == 1)
+	{
+		for (size_t i = 0; i < size; ++i)
+		{
+			pDist[i] ^= pSrc[i];
+		}
+		return;
+	}
+
+	const GfTables&	t = _Tables();
+	size_t			i = 0;
+
+	// split every byte into nibbles and look both up with a byte shuffle.
+#if defined(ENCO_AVX2)
+	if (CpuFeatures::Avx2())
+	{
+		const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t.nibble[c]));
+		const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(t.nibble[c] + 16)));
+		const __m256i mask = _mm256_set1_epi8(0x0f);
+		for (; i + 32 <= size; i += 32)
+		{
+			__m256i v = _mm256_loadu_si256((const __m256i*)(pSrc + i));
+			__m256i l = _mm256_shuffle_epi8(lo, _mm256_and_si256(v, mask));
+			__m256i h = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(v, 4), mask));
+			__m256i d = _mm256_loadu_si256((const __m256i*)(pDist + i));
+			_mm256_storeu_si256((__m256i*)(pDist + i), _mm256_xor_si256(d, _mm256_xor_si256(l, h)));
+		}
+	}
+#endif
+#if defined(ENCO_SSSE3)
+	if (CpuFeatures::Ssse3())
+	{
+		const __m128i lo = _mm_loadu_si128((const __m128i*)t.nibble[c]);
+		const __m128i hi = _mm_loadu_si128((const __m128i*)(t.nibble[c] + 16));
+		const __m128i mask = _mm_set1_epi8(0x0f);
+		for (; i + 16 <= size; i += 16)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(pSrc + i));
+			__m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(v, mask));
+			__m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(v, 4), mask));
+			__m128i d = _mm_loadu_si128((const __m128i*)(pDist + i));
+			_mm_storeu_si128((__m128i*)(pDist + i), _mm_xor_si128(d, _mm_xor_si128(l, h)));
+		}
+	}
+#endif
+
+	const Enco::byte* row = t.mul[c];
+	for (; i < size; ++i)
+	{
+		pDist[i] ^= row[pSrc[i]];
+	}
+}
+
+bool GaloisField256::Invert(Enco::byte * const pMatrix, const unsigned int& k)
+{
+	std::vector<Gf256Field::Element> matrix(pMatrix, pMatrix + (size_t)k * k);
+	if (false == FieldAlgebra<Gf256Field>::Invert(&matrix[0], k))
+		return false;
+
+	for (size_t i = 0; i < matrix.size(); ++i)
+	{
+		pMatrix[i] = (Enco::byte)matrix[i];
+	}
+	return true;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// InformationDispersal
+
+InformationDispersal::InformationDispersal(const unsigned int& n, const unsigned int& k) :
+m_n(n), m_k(k)
+{}
+
+size_t InformationDispersal::FragmentSize(const size_t& dataSize, const unsigned int& k)
+{
+	return (dataSize + k - 1) / k;
+}
+
+Enco::byte InformationDispersal::Coefficient(const unsigned int& row, const unsigned int& col) const
+{
+	if (row < m_k)
+		return (row == col) ? 1 : 0;
+
+	// cauchy entry 1 / (x_row + y_col) with x in [k, n) and y in [0, k).
+	return GaloisField256::Inverse((Enco::byte)(row ^ col));
+}
+
+void InformationDispersal::EncodeBlock(Enco::byte const * const * ppData, Enco::byte * const * ppParity, const size_t& count) const
+{
+	for (unsigned int p = 0; p + m_k < m_n; ++p)
+	{
+		memset(ppParity[p], 0, count);
+		for (unsigned int j = 0; j < m_k; ++j)
+		{
+			GaloisField256::MultiplyAdd(ppParity[p], ppData[j], Coefficient(m_k + p, j), count);
+		}
+	}
+}
+
+bool InformationDispersal::PrepareDecode(const std::vector<unsigned int>& rows)
+{
+	if (rows.size() != m_k)
+		return false;
+
+	m_rows = rows;
+	m_decode.clear();
+	if (Systematic())
+		return true;
+
+	m_decode.assign(m_k * m_k, 0);
+	for (unsigned int t = 0; t < m_k; ++t)
+	{
+		if (rows[t] >= m_n)
+			return false;
+
+		for (unsigned int j = 0; j < m_k; ++j)
+		{
+			m_decode[t * m_k + j] = Coefficient(rows[t], j);
+		}
+	}
+
+	return GaloisField256::Invert(&m_decode[0], m_k);
+}
+
+int InformationDispersal::FragmentOf(const unsigned int& dataRow) const
+{
+	for (unsigned int t = 0; t < m_rows.size(); ++t)
+	{
+		if (m_rows[t] == dataRow)
+			return (int)t;
+	}
+	return -1;
+}
+
+bool InformationDispersal::Systematic() const
+{
+	for (unsigned int j = 0; j < m_k; ++j)
+	{
+		if (FragmentOf(j) < 0)
+			return false;
+	}
+	return true;
+}
+
+void InformationDispersal::DecodeBlock(Enco::byte const * const * ppFragments, Enco::byte * const * ppData, const size_t& count) const
+{
+	for (unsigned int j = 0; j < m_k; ++j)
+	{
+		// a data fragment that survived is used as is, only missing ones need math.
+		if (FragmentOf(j) >= 0)
+			continue;
+
+		memset(ppData[j], 0, count);
+		for (unsigned int t = 0; t < m_k; ++t)
+		{
+			GaloisField256::MultiplyAdd(ppData[j], ppFragments[t], m_decode[j * m_k + t], count);
+		}
+	}
+}
+
+void InformationDispersal::RepairBlock(const unsigned int& row, Enco::byte const * const * ppFragments, Enco::byte * const pOut, const size_t& count) const
+{
+	// row = Coefficient(row, .) x decode matrix, folded into one weight per fragment.
+	memset(pOut, 0, count);
+	for (unsigned int t = 0; t < m_k; ++t)
+	{
+		Enco::byte c = 0;
+		for (unsigned int j = 0; j < m_k; ++j)
+		{
+			c ^= GaloisField256::Multiply(Coefficient(row, j), _DecodeCoefficient(j, t));
+		}
+		GaloisField256::MultiplyAdd(pOut, ppFragments[t], c, count);
+	}
+}
+
+Enco::byte InformationDispersal::_DecodeCoefficient(const unsigned int& dataRow, const unsigned int& fragment) const
+{
+	if (m_decode.empty())
+		return (m_rows[fragment] == dataRow) ? 1 : 0;		// systematic, no inverse was built
+
+	return m_decode[dataRow * m_k + fragment];
+}
+
+const unsigned int InformationDispersal::N() const
+{
+	return m_n;
+}
+
+const unsigned int InformationDispersal::K() const
+{
+	return m_k;
+}
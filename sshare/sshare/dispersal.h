@@ -0,0 +1,95 @@
+// dispersal.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(DISPERSAL_H)
+#define DISPERSAL_H
+
+/*
+* @class: GaloisField256
+*
+* @remarks: GF(2^8) over the polynomial x^8 + x^4 + x^3 + x^2 + 1, the byte-wide
+*           face of Gf256Field with its tables built at compile time.
+*/
+class GaloisField256
+{
+public:
+	static Enco::byte	Multiply(const Enco::byte& a, const Enco::byte& b);
+	static Enco::byte	Inverse(const Enco::byte& a);
+
+	/*
+	* @interface: MultiplyAdd
+	*
+	* @remarks: pDist[i] ^= c * pSrc[i] for size bytes.
+	*/
+	static void			MultiplyAdd(Enco::byte * const pDist, Enco::byte const * const pSrc, const Enco::byte& c, const size_t& size);
+
+	/*
+	* @interface: Invert
+	*
+	* @remarks: inverts the k x k row-major matrix in place; false if singular.
+	*/
+	static bool			Invert(Enco::byte * const pMatrix, const unsigned int& k);
+};
+
+/*
+* @class: InformationDispersal
+*
+* @remarks: Rabin dispersal with a systematic Cauchy matrix. Rows 0..k-1 are
+*           the identity, so the first k fragments are the data itself, and
+*           any k of the n <= 256 fragments rebuild the data.
+*/
+class InformationDispersal
+{
+public:
+	InformationDispersal(const unsigned int& n, const unsigned int& k);
+
+public:
+	static size_t		FragmentSize(const size_t& dataSize, const unsigned int& k);
+
+	Enco::byte			Coefficient(const unsigned int& row, const unsigned int& col) const;
+
+	/*
+	* @interface: EncodeBlock
+	*
+	* @remarks: computes count bytes of every parity fragment (rows k..n-1)
+	*           from the same window of the k data fragments.
+	*/
+	void				EncodeBlock(Enco::byte const * const * ppData, Enco::byte * const * ppParity, const size_t& count) const;
+
+	/*
+	* @interface: PrepareDecode / DecodeBlock
+	*
+	* @remarks: rows lists the k fragment rows that are available, in the
+	*           order their windows are later handed to DecodeBlock().
+	*           DecodeBlock() only rebuilds the data rows that are missing;
+	*           FragmentOf() tells which fragment already holds a data row.
+	*/
+	bool				PrepareDecode(const std::vector<unsigned int>& rows);
+	void				DecodeBlock(Enco::byte const * const * ppFragments, Enco::byte * const * ppData, const size_t& count) const;
+
+	int					FragmentOf(const unsigned int& dataRow) const;
+	bool				Systematic() const;
+
+	/*
+	* @interface: RepairBlock
+	*
+	* @remarks: after PrepareDecode(), rebuilds count bytes of fragment row
+	*           straight from the k available fragments.
+	*/
+	void				RepairBlock(const unsigned int& row, Enco::byte const * const * ppFragments, Enco::byte * const pOut, const size_t& count) const;
+
+	const unsigned int	N() const;
+	const unsigned int	K() const;
+
+private:
+	Enco::byte			_DecodeCoefficient(const unsigned int& dataRow, const unsigned int& fragment) const;
+
+private:
+	unsigned int				m_n;
+	unsigned int				m_k;
+	std::vector<Enco::byte>		m_decode;		// k x k inverse of the chosen rows
+	std::vector<unsigned int>	m_rows;
+};
+
+#endif
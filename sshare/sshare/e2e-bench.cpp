@@ -0,0 +1,629 @@
+// e2e-bench.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "e2e-bench.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#if defined(_WIN32)
+#	include <psapi.h>
+#	pragma comment(lib, "Psapi.lib")
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/resource.h>
+#	include <sys/wait.h>
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// EndToEndBench
+
+namespace
+{
+	const size_t	g_cnst_io_size = ((size_t)1 << 20);
+
+	std::vector<std::string> _Split(const std::string& text, const char& separator)
+	{
+		std::vector<std::string>	items;
+		size_t						from = 0;
+		while (from <= text.size())
+		{
+			size_t to = text.find(separator, from);
+			if (to == std::string::npos)
+				to = text.size();
+			if (to > from)
+				items.push_back(text.substr(from, to - from));
+			from = to + 1;
+		}
+		return items;
+	}
+
+	bool _ParseSize(const std::string& text, Enco::uint64& size)
+	{
+		char*	pEnd = nullptr;
+		size = strtoull(text.c_str(), &pEnd, 10);
+		if (pEnd == text.c_str() || size == 0)
+			return false;
+
+		switch (*pEnd)
+		{
+		case 'G': case 'g': size <<= 30; ++pEnd; break;
+		case 'M': case 'm': size <<= 20; ++pEnd; break;
+		case 'K': case 'k': size <<= 10; ++pEnd; break;
+		default: break;
+		}
+		return *pEnd == 0;
+	}
+
+	std::string _SizeName(const Enco::uint64& size)
+	{
+		if (size % ((Enco::uint64)1 << 30) == 0)
+			return std::to_string(size >> 30) + "G";
+		if (size % ((Enco::uint64)1 << 20) == 0)
+			return std::to_string(size >> 20) + "M";
+		if (size % ((Enco::uint64)1 << 10) == 0)
+			return std::to_string(size >> 10) + "K";
+		return std::to_string(size);
+	}
+
+	std::string _JsonString(const std::string& text)
+	{
+		std::string quoted = "\"";
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+				quoted += '\\';
+			quoted += c;
+		}
+		return quoted + "\"";
+	}
+}
+
+EndToEndBench::EndToEndBench() :
+m_workDir("sshare-e2e"), m_repetitions(3), m_json(false)
+{}
+
+bool EndToEndBench::Parse(int argc, char* argv[])
+{
+	std::string sizes = "64K,1M,16M,256M";
+	std::string sets = "3:2,5:3,10:6";
+	std::string engines = "shamir,krawczyk,ida,gf256";
+	std::string jobs = "1," + std::to_string(std::max(1u, std::thread::hardware_concurrency()));
+	std::string caches = "warm,cold";
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg.compare(0, 9, "--sshare=") == 0)
+			m_sshare = arg.substr(9);
+		else if (arg.compare(0, 6, "--dir=") == 0)
+			m_workDir = arg.substr(6);
+		else if (arg.compare(0, 8, "--sizes=") == 0)
+			sizes = arg.substr(8);
+		else if (arg.compare(0, 8, "--input=") == 0)
+			m_inputs.push_back(arg.substr(8));
+		else if (arg.compare(0, 10, "--engines=") == 0)
+			engines = arg.substr(10);
+		else if (arg.compare(0, 7, "--sets=") == 0)
+			sets = arg.substr(7);
+		else if (arg.compare(0, 7, "--jobs=") == 0)
+			jobs = arg.substr(7);
+		else if (arg.compare(0, 8, "--cache=") == 0)
+			caches = arg.substr(8);
+		else if (arg.compare(0, 7, "--reps=") == 0)
+			m_repetitions = (size_t)atoi(arg.c_str() + 7);
+		else if (arg == "--json")
+			m_json = true;
+		else
+			return false;
+	}
+
+	if (m_sshare.empty())
+	{
+		// the tool is built next to the bench.
+		const std::filesystem::path self(argv[0]);
+#if defined(_WIN32)
+		m_sshare = (self.parent_path() / "sshare.exe").string();
+#else
+		m_sshare = (self.parent_path() / "sshare").string();
+#endif
+	}
+
+	m_sizes.clear();
+	for (const std::string& item : _Split(sizes, ','))
+	{
+		Enco::uint64 size = 0;
+		if (item == "none")
+			continue;
+		if (false == _ParseSize(item, size))
+			return false;
+		m_sizes.push_back(size);
+	}
+
+	m_engines = _Split(engines, ',');
+	for (const std::string& engine : m_engines)
+	{
+		if (engine != "shamir" && engine != "krawczyk" && engine != "ida" && engine != "packed" &&
+			engine != "gf256" && engine != "gf65536" && engine != "p65809" && engine != "m31")
+			return false;
+	}
+
+	for (const std::string& item : _Split(sets, ','))
+	{
+		const std::vector<std::string> nk = _Split(item, ':');
+		if (nk.size() != 2)
+			return false;
+		const int n = atoi(nk[0].c_str());
+		const int k = atoi(nk[1].c_str());
+		if (k < 1 || n < k || n > 65535)
+			return false;
+		m_sets.push_back(std::make_pair((unsigned int)n, (unsigned int)k));
+	}
+
+	for (const std::string& item : _Split(jobs, ','))
+	{
+		const int j = atoi(item.c_str());
+		if (j < 1)
+			return false;
+		if (std::find(m_jobs.begin(), m_jobs.end(), (unsigned int)j) == m_jobs.end())
+			m_jobs.push_back((unsigned int)j);
+	}
+
+	for (const std::string& item : _Split(caches, ','))
+	{
+		if (item != "warm" && item != "cold")
+			return false;
+		m_caches.push_back(item == "cold");
+	}
+
+	return m_repetitions >= 1 && false == m_engines.empty() && false == m_sets.empty() && false == m_jobs.empty() &&
+		false == m_caches.empty() && (false == m_sizes.empty() || false == m_inputs.empty());
+}
+
+bool EndToEndBench::Run()
+{
+	std::error_code error;
+	std::filesystem::create_directories(m_workDir, error);
+	if (error)
+	{
+		std::cerr << "Cannot create " << m_workDir << std::endl;
+		return false;
+	}
+
+	if (std::find(m_caches.begin(), m_caches.end(), true) != m_caches.end())
+	{
+		const std::string probe = (std::filesystem::path(m_workDir) / "probe").string();
+		std::ofstream(probe, std::ios::out | std::ios::binary) << "probe";
+		if (false == DropCache(probe))
+		{
+			std::cerr << "The page cache cannot be dropped here: cold runs are skipped." << std::endl;
+			m_caches.erase(std::remove(m_caches.begin(), m_caches.end(), true), m_caches.end());
+		}
+		std::filesystem::remove(probe, error);
+	}
+
+	// synthetic inputs first, then the real files.
+	std::vector<std::pair<std::string, Enco::uint64>> inputs;
+	for (const Enco::uint64& size : m_sizes)
+	{
+		inputs.push_back(std::make_pair(std::string("synthetic-") + _SizeName(size), size));
+	}
+	for (const std::string& input : m_inputs)
+	{
+		const Enco::uint64 size = (Enco::uint64)std::filesystem::file_size(input, error);
+		if (error)
+		{
+			std::cerr << "Cannot read " << input << std::endl;
+			return false;
+		}
+		inputs.push_back(std::make_pair(input, size));
+	}
+
+	const unsigned int maxJobs = *std::max_element(m_jobs.begin(), m_jobs.end());
+	for (size_t s = 0; s < inputs.size(); ++s)
+	{
+		// every job works on its own copy, in its own directory: the shares are named after it.
+		const std::string			name = inputs[s].first;
+		const Enco::uint64			size = inputs[s].second;
+		const bool					synthetic = (s < m_sizes.size());
+		const std::string			leaf = synthetic ? name : std::filesystem::path(name).filename().string();
+		std::vector<std::string>	jobInputs;
+		for (unsigned int j = 0; j < maxJobs; ++j)
+		{
+			const std::filesystem::path dir = std::filesystem::path(m_workDir) / ("job" + std::to_string(j));
+			std::filesystem::create_directories(dir, error);
+			const std::string copy = (dir / leaf).string();
+			if (j == 0)
+			{
+				if (synthetic ? false == _Generate(copy, size, s + 1) : false == std::filesystem::copy_file(name, copy, std::filesystem::copy_options::overwrite_existing, error))
+				{
+					std::cerr << "Cannot write " << copy << std::endl;
+					return false;
+				}
+			}
+			else
+			{
+				std::filesystem::remove(copy, error);
+				std::filesystem::create_hard_link(jobInputs[0], copy, error);
+				if (error)
+					std::filesystem::copy_file(jobInputs[0], copy, error);
+			}
+			jobInputs.push_back(copy);
+		}
+
+		for (const std::string& engine : m_engines)
+		{
+			for (const std::pair<unsigned int, unsigned int>& set : m_sets)
+			{
+				if (engine == "packed" && set.second < 2)
+					continue;
+				if (engine == "gf256" && set.first > 255)
+					continue;
+				for (const unsigned int& jobs : m_jobs)
+				{
+					for (const bool cold : m_caches)
+					{
+						std::cerr << name << " " << engine << " " << set.first << ":" << set.second << " x" << jobs << (cold ? " cold" : " warm") << std::endl;
+						_RunPoint(name, std::vector<std::string>(jobInputs.begin(), jobInputs.begin() + jobs), size, engine, set.first, set.second, cold);
+					}
+				}
+			}
+		}
+
+		for (const std::string& copy : jobInputs)
+		{
+			std::filesystem::remove(copy, error);
+		}
+	}
+
+	for (unsigned int j = 0; j < maxJobs; ++j)
+	{
+		std::filesystem::remove_all(std::filesystem::path(m_workDir) / ("job" + std::to_string(j)), error);
+	}
+	std::filesystem::remove(m_workDir, error);
+	return true;
+}
+
+void EndToEndBench::_RunPoint(const std::string& input, const std::vector<std::string>& jobInputs, const Enco::uint64& bytes, const std::string& engine, const unsigned int& n, const unsigned int& k, const bool& cold)
+{
+	std::vector<std::string>				options(1, "--engine=" + engine);
+	std::vector<std::vector<std::string>>	encodes;
+	std::vector<std::vector<std::string>>	decodes;
+	std::vector<std::vector<std::string>>	decodeInputs;
+	std::vector<std::string>				outputs;
+	if (engine == "packed")
+		options.push_back("--privacy=" + std::to_string(k / 2));
+	for (const std::string& jobInput : jobInputs)
+	{
+		std::vector<std::string> encode(1, m_sshare);
+		encode.insert(encode.end(), options.begin(), options.end());
+		encode.push_back("-e");
+		encode.push_back(jobInput);
+		encode.push_back(std::to_string(n));
+		encode.push_back(std::to_string(k));
+		encodes.push_back(encode);
+
+		// the last K shares, so a decode never gets away with the first ones only.
+		const std::string			prefix = (std::filesystem::path(jobInput).parent_path() / "").string();
+		std::vector<std::string>	decode(1, m_sshare);
+		std::vector<std::string>	shares;
+		decode.push_back("-d");
+		decode.push_back(prefix);
+		for (unsigned int i = n - k; i < n; ++i)
+		{
+			shares.push_back(_ShareFileName(jobInput, i, n));
+		}
+		decode.insert(decode.end(), shares.begin(), shares.end());
+		decodes.push_back(decode);
+		decodeInputs.push_back(shares);
+		outputs.push_back(prefix + "rvd-0");
+	}
+
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		const bool										encode = (pass == 0);
+		const std::vector<std::vector<std::string>>&	commands = encode ? encodes : decodes;
+		Result											result;
+		std::vector<double>								seconds;
+		std::vector<double>								cpuSeconds;
+		result.input = input;
+		result.bytes = bytes;
+		result.engine = engine;
+		result.n = n;
+		result.k = k;
+		result.jobs = (unsigned int)jobInputs.size();
+		result.cold = cold;
+		result.encode = encode;
+		result.peakRss = 0;
+		result.verified = true;
+
+		if (false == cold)
+			result.verified = _Spawn(commands).succeeded;	// warm-up
+		for (size_t r = 0; r < m_repetitions; ++r)
+		{
+			if (cold)
+			{
+				for (size_t j = 0; j < jobInputs.size(); ++j)
+				{
+					if (encode)
+					{
+						DropCache(jobInputs[j]);
+						continue;
+					}
+					for (const std::string& share : decodeInputs[j])
+					{
+						DropCache(share);
+					}
+				}
+			}
+
+			const Measure measure = _Spawn(commands);
+			result.verified = result.verified && measure.succeeded;
+			result.peakRss = std::max(result.peakRss, measure.peakRss);
+			result.samples.push_back((double)bytes * jobInputs.size() / 1e6 / ((measure.seconds > 0) ? measure.seconds : 1e-9));
+			seconds.push_back(measure.seconds);
+			cpuSeconds.push_back(measure.cpuSeconds);
+		}
+
+		result.median = _Median(result.samples);
+		result.seconds = _Median(seconds);
+		result.cpuSeconds = _Median(cpuSeconds);
+		if (false == encode)
+		{
+			for (const std::string& output : outputs)
+			{
+				result.verified = result.verified && _Same(jobInputs[0], output);
+			}
+		}
+		m_results.push_back(result);
+	}
+
+	std::error_code error;
+	for (size_t j = 0; j < jobInputs.size(); ++j)
+	{
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			std::filesystem::remove(_ShareFileName(jobInputs[j], i, n), error);
+		}
+		std::filesystem::remove(outputs[j], error);
+	}
+}
+
+EndToEndBench::Measure EndToEndBench::_Spawn(const std::vector<std::vector<std::string>>& commands) const
+{
+	Measure measure = { 0, 0, 0, true };
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+#if defined(_WIN32)
+	std::vector<HANDLE> processes;
+	for (const std::vector<std::string>& command : commands)
+	{
+		std::string line;
+		for (const std::string& arg : command)
+		{
+			line += (line.empty() ? "\"" : " \"") + arg + "\"";
+		}
+
+		STARTUPINFOA		si = { sizeof(si) };
+		PROCESS_INFORMATION	pi = { 0 };
+		if (FALSE == CreateProcessA(nullptr, &line[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi))
+		{
+			measure.succeeded = false;
+			continue;
+		}
+		CloseHandle(pi.hThread);
+		processes.push_back(pi.hProcess);
+	}
+
+	for (HANDLE process : processes)
+	{
+		WaitForSingleObject(process, INFINITE);
+
+		DWORD						code = 1;
+		PROCESS_MEMORY_COUNTERS		memory = { sizeof(memory) };
+		FILETIME					creation, exited, kernel, user;
+		GetExitCodeProcess(process, &code);
+		measure.succeeded = measure.succeeded && (code == 0);
+		if (GetProcessMemoryInfo(process, &memory, sizeof(memory)))
+			measure.peakRss = std::max(measure.peakRss, (Enco::uint64)memory.PeakWorkingSetSize / 1024);
+		if (GetProcessTimes(process, &creation, &exited, &kernel, &user))
+		{
+			// 100 ns units.
+			measure.cpuSeconds += ((((Enco::uint64)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime) +
+								   (((Enco::uint64)user.dwHighDateTime << 32) | user.dwLowDateTime)) / 1e7;
+		}
+		CloseHandle(process);
+	}
+#else
+	std::vector<pid_t> processes;
+	for (const std::vector<std::string>& command : commands)
+	{
+		std::vector<char*> args;
+		for (const std::string& arg : command)
+		{
+			args.push_back(const_cast<char*>(arg.c_str()));
+		}
+		args.push_back(nullptr);
+
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			execv(args[0], &args[0]);
+			_exit(127);
+		}
+		if (pid < 0)
+		{
+			measure.succeeded = false;
+			continue;
+		}
+		processes.push_back(pid);
+	}
+
+	for (const pid_t& pid : processes)
+	{
+		int				status = 0;
+		struct rusage	usage;
+		if (wait4(pid, &status, 0, &usage) != pid)
+		{
+			measure.succeeded = false;
+			continue;
+		}
+		measure.succeeded = measure.succeeded && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+		measure.peakRss = std::max(measure.peakRss, (Enco::uint64)usage.ru_maxrss);		// KB on Linux
+		measure.cpuSeconds += usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+	}
+#endif
+
+	measure.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return measure;
+}
+
+bool EndToEndBench::DropCache(const std::string& fileName)
+{
+#if defined(_WIN32)
+	// write the dirty pages back, then an unbuffered open throws the cached ones away.
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	FlushFileBuffers(file);
+	CloseHandle(file);
+
+	file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	CloseHandle(file);
+	return true;
+#elif defined(POSIX_FADV_DONTNEED)
+	// only clean pages are dropped, hence the sync.
+	const int file = open(fileName.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	fsync(file);
+	const bool dropped = (posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0);
+	close(file);
+	return dropped;
+#else
+	return false;
+#endif
+}
+
+std::string EndToEndBench::_ShareFileName(const std::string& fileName, const unsigned int& i, const unsigned int& n) const
+{
+	// as sshare names them.
+	std::string name = fileName + "-ss";
+	if (n <= 26)
+		return name + ((char)('A' + i));
+
+	const std::string index = std::to_string(i + 1);
+	return name + std::string(std::to_string(n).size() - index.size(), '0') + index;
+}
+
+bool EndToEndBench::_Generate(const std::string& fileName, const Enco::uint64& size, const Enco::uint64& seed)
+{
+	std::ofstream out(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (false == out.is_open())
+		return false;
+
+	// xorshift: incompressible enough, and fast enough for tens of GB.
+	std::vector<Enco::uint64>	block(g_cnst_io_size / sizeof(Enco::uint64));
+	Enco::uint64				state = 0x9E3779B97F4A7C15ull * seed;
+	for (Enco::uint64 done = 0; done < size; done += g_cnst_io_size)
+	{
+		for (Enco::uint64& word : block)
+		{
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			word = state;
+		}
+		const Enco::uint64 chunk = std::min<Enco::uint64>(g_cnst_io_size, size - done);
+		out.write((const char*)&block[0], (std::streamsize)chunk);
+	}
+	return out.good();
+}
+
+bool EndToEndBench::_Same(const std::string& fileName1, const std::string& fileName2)
+{
+	std::ifstream		in1(fileName1, std::ios::in | std::ios::binary);
+	std::ifstream		in2(fileName2, std::ios::in | std::ios::binary);
+	std::vector<char>	block1(g_cnst_io_size);
+	std::vector<char>	block2(g_cnst_io_size);
+	if (false == in1.is_open() || false == in2.is_open())
+		return false;
+
+	for (;;)
+	{
+		in1.read(&block1[0], block1.size());
+		in2.read(&block2[0], block2.size());
+		if (in1.gcount() != in2.gcount() || memcmp(&block1[0], &block2[0], (size_t)in1.gcount()) != 0)
+			return false;
+		if (in1.gcount() == 0)
+			return true;
+	}
+}
+
+double EndToEndBench::_Median(std::vector<double> values)
+{
+	if (values.empty())
+		return 0;
+
+	std::sort(values.begin(), values.end());
+	const size_t half = values.size() / 2;
+	return (values.size() % 2 != 0) ? values[half] : (values[half - 1] + values[half]) / 2;
+}
+
+void EndToEndBench::Report(std::ostream& out) const
+{
+	if (m_json)
+		ReportJson(out);
+	else
+		ReportCsv(out);
+}
+
+void EndToEndBench::ReportCsv(std::ostream& out) const
+{
+	out << "input,bytes,engine,n,k,jobs,cache,op,mb_per_s,seconds,cpu_seconds,peak_rss_kb,verified,samples\n";
+	for (const Result& r : m_results)
+	{
+		out << r.input << "," << r.bytes << "," << r.engine << "," << r.n << "," << r.k << "," << r.jobs << ","
+			<< (r.cold ? "cold" : "warm") << "," << (r.encode ? "encode" : "decode") << "," << std::setprecision(6)
+			<< r.median << "," << r.seconds << "," << r.cpuSeconds << "," << r.peakRss << "," << (r.verified ? 1 : 0) << ",";
+		for (size_t i = 0; i < r.samples.size(); ++i)
+		{
+			out << (i == 0 ? "" : " ") << r.samples[i];
+		}
+		out << "\n";
+	}
+}
+
+void EndToEndBench::ReportJson(std::ostream& out) const
+{
+	out << "[";
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const Result& r = m_results[i];
+		out << (i == 0 ? "\n" : ",\n") << "  {\"input\": " << _JsonString(r.input) << ", \"bytes\": " << r.bytes
+			<< ", \"engine\": " << _JsonString(r.engine) << ", \"n\": " << r.n << ", \"k\": " << r.k << ", \"jobs\": " << r.jobs
+			<< ", \"cache\": \"" << (r.cold ? "cold" : "warm") << "\", \"op\": \"" << (r.encode ? "encode" : "decode") << "\""
+			<< std::setprecision(6) << ", \"mb_per_s\": " << r.median << ", \"seconds\": " << r.seconds << ", \"cpu_seconds\": " << r.cpuSeconds
+			<< ", \"peak_rss_kb\": " << r.peakRss << ", \"verified\": " << (r.verified ? "true" : "false") << ", \"samples\": [";
+		for (size_t s = 0; s < r.samples.size(); ++s)
+		{
+			out << (s == 0 ? "" : ", ") << r.samples[s];
+		}
+		out << "]}";
+	}
+	out << "\n]\n";
+}
+
+void EndToEndBench::Usage(std::ostream& out)
+{
+	out << "usage: sshare-bench --e2e [--sshare=path] [--dir=work-dir] [--sizes=64K,1M,16M,256M] [--input=file]...\n"
+		<< "                    [--engines=shamir,krawczyk,ida,gf256] [--sets=3:2,5:3,10:6] [--jobs=1,T]\n"
+		<< "                    [--cache=warm,cold] [--reps=3] [--json]\n"
+		<< "--sizes=none leaves only the --input files; T is the number of hardware threads." << std::endl;
+}
@@ -0,0 +1,98 @@
+// e2e-bench.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(E2E_BENCH_H)
+#define E2E_BENCH_H
+
+/*
+* @class: EndToEndBench
+*
+* @remarks: times the sshare tool itself, sshare -e and sshare -d, over a grid
+*           of inputs, engines, N:K sets and job counts. A point with J jobs
+*           runs J sshare processes at once, each on its own copy of the input,
+*           so the MB/s of the J rows show where the cores, the memory
+*           bandwidth or the disk run out. Every process is a child of the
+*           bench, which gives its peak resident set and cpu time.
+*
+*           Cold rows flush and evict the files a run reads (the input, or K
+*           shares) from the page cache before each repetition; warm rows
+*           follow one untimed run instead.
+*/
+class EndToEndBench
+{
+public:
+	struct Result
+	{
+		std::string				input;
+		Enco::uint64			bytes;			// per job
+		std::string				engine;
+		unsigned int			n;
+		unsigned int			k;
+		unsigned int			jobs;
+		bool					cold;
+		bool					encode;
+		std::vector<double>		samples;		// MB/s of all jobs together, per repetition
+		double					median;
+		double					seconds;		// median wall time
+		double					cpuSeconds;		// median user + system time of all jobs
+		Enco::uint64			peakRss;		// KB, the largest job of all repetitions
+		bool					verified;		// every run succeeded, the secret came back
+	};
+
+public:
+	EndToEndBench();
+
+public:
+	/*
+	* @interface: Parse
+	*
+	* @remarks: argv without the --e2e mode itself. false on a malformed
+	*           option; sizes take K, M and G suffixes, sets are N:K.
+	*/
+	bool					Parse(int argc, char* argv[]);
+
+	// runs the whole grid, progress to std::cerr. false if the work dir or an input failed.
+	bool					Run();
+
+	void					Report(std::ostream& out) const;	// CSV, or JSON with --json
+	void					ReportCsv(std::ostream& out) const;
+	void					ReportJson(std::ostream& out) const;
+
+	static void				Usage(std::ostream& out);
+
+	// evicts a file from the page cache, writing it back first. false where the OS cannot.
+	static bool				DropCache(const std::string& fileName);
+
+private:
+	struct Measure
+	{
+		double			seconds;
+		double			cpuSeconds;
+		Enco::uint64	peakRss;
+		bool			succeeded;
+	};
+
+	void					_RunPoint(const std::string& input, const std::vector<std::string>& jobInputs, const Enco::uint64& bytes, const std::string& engine, const unsigned int& n, const unsigned int& k, const bool& cold);
+	Measure					_Spawn(const std::vector<std::vector<std::string>>& commands) const;
+	std::string				_ShareFileName(const std::string& fileName, const unsigned int& i, const unsigned int& n) const;
+
+	static bool				_Generate(const std::string& fileName, const Enco::uint64& size, const Enco::uint64& seed);
+	static bool				_Same(const std::string& fileName1, const std::string& fileName2);
+	static double			_Median(std::vector<double> values);
+
+private:
+	std::string								m_sshare;		// the tool under test
+	std::string								m_workDir;
+	std::vector<Enco::uint64>				m_sizes;		// synthetic inputs
+	std::vector<std::string>				m_inputs;		// real ones
+	std::vector<std::string>				m_engines;
+	std::vector<std::pair<unsigned int, unsigned int>>	m_sets;
+	std::vector<unsigned int>				m_jobs;
+	std::vector<bool>						m_caches;		// true: cold
+	size_t									m_repetitions;
+	bool									m_json;
+	std::vector<Result>						m_results;
+};
+
+#endif
@@ -1,18 +1,152 @@
 #include "precompile.h"
 #include "datatypes.h"
+#include "allocator.h"
+#include "buffer.h"
+#include "checksum.h"
+#include "field.h"
 #include "secret-share.h"
+#include "perf-counters.h"
+#include "share-stats.h"
+#include "daemon.h"
+#include <filesystem>
 
 using namespace std;
 
-bool EncodeFile(const std::string& fileName, const int& N, const int& K);
-bool DecodeFiles(const string& outPath, const vector<string>& fileNames);
+bool EncodeFile(const std::string& fileName, const int& N, const int& K, const string& engine, const int& T);
+bool DecodeFiles(const string& outPath, const vector<string>& fileNames, const int& correctK);
+bool VerifyFiles(const vector<string>& fileNames);
+bool RepairFile(const string& index, const string& outFileName, const vector<string>& fileNames);
+bool RefreshFiles(const int& K, const vector<string>& fileNames);
+bool ReshareFiles(const int& N, const int& K, const string& outFileName, const vector<string>& fileNames);
+string ShareFileName(const string& fileName, const int& i, const int& N);
+string UngivenShare(const vector<string>& fileNames, const BufferView& head, const size_t& payloadSize);
+
+// the FieldSecretSharer engines, found by option name or by share.
+struct FieldEngines
+{
+	FieldEngines(const Randomer& randomer);
+
+	SecretSharer*	ByName(const string& engine);
+	SecretSharer*	ByShare(const BufferView& sharedSecret);
+	string			NameOf(const BufferView& sharedSecret);		// the option name, empty for no field share
+
+	FieldSecretSharer<Gf256Field>		gf256;
+	FieldSecretSharer<Gf65536Field>		gf65536;
+	FieldSecretSharer<ShamirField>		p65809;
+	FieldSecretSharer<Mersenne31Field>	m31;
+};
+
+// a share file read front to back. The chunk crcs of its trailer are checked
+// as the payload goes by; shares from before the trailer are taken as they are.
+struct ShareReader
+{
+	ShareReader();
+
+	bool			Open(const string& fileName);
+	bool			Head(const MutableBufferView& data);		// the first bytes, before any Read()
+	bool			Read(const MutableBufferView& data);		// the next bytes; false when short or damaged
+
+	ifstream					file;
+	size_t						payloadSize;
+	size_t						position;
+	size_t						checked;		// chunks compared so far
+	bool						sealed;
+	bool						damaged;
+	std::vector<Enco::uint32>	chunkCrcs;
+	ChunkChecksum				sum;
+};
+
+// a share file written front to back as fileName.new, with a trailer when
+// sealed; Commit() moves it over fileName once the whole job went right.
+struct ShareWriter
+{
+	bool			Open(const string& fileName, const bool& seal);
+	bool			Write(const BufferView& data);
+	bool			Close();
+	bool			Commit();
+	void			Discard();
+
+	// closes all, then commits them all when ok and every close went right,
+	// otherwise discards them all.
+	static bool		CommitAll(std::vector<ShareWriter>& writers, bool ok);
+
+	string			name;
+	ofstream		file;
+	bool			sealed;
+	ChunkChecksum	sum;
+};
+
+// the shares of one set handed to Repair(), Refresh() or Reshare() a window
+// at a time instead of whole. When the engine can cut its shares (see
+// SecretSharer::WindowHeader()) a window is the header and the next run of
+// symbols, ending on a checksum chunk so it is verified before use; otherwise
+// it is the whole payload. A share found damaged drops out of the windows.
+struct ShareWindows
+{
+	ShareWindows();
+
+	bool	Open(const vector<string>& fileNames);
+	void	Start(const SecretSharer& sharer);		// once the engine is picked from head
+	bool	Next();									// false past the last window
+
+	std::vector<ShareReader>		readers;
+	std::vector<OwnedBuffer>		buffers;
+	std::vector<MutableBufferView>	windows;		// of the shares still usable
+	std::vector<BufferView>			views;			// the same, read only
+	std::vector<size_t>				position;		// their place in the file list
+	OwnedBuffer						head;			// the start of the first usable share
+	size_t							payloadSize;
+	size_t							header;			// bytes of header in every window
+	size_t							span;			// most body bytes in a window
+	size_t							skip;			// bytes of the windows handed on before: the header after the first
+	size_t							offset;			// payload bytes read
+	bool							sealed;
+
+	static const size_t				m_cnst_window;
+};
+
+// prints the stats of the job to stderr when main() returns, once the scopes
+// declared after it have closed.
+struct StatsPrinter
+{
+	~StatsPrinter();
+
+	ShareStats	stats;
+	string		format;		// empty: no stats
+};
 
 /*
+Options (before the mode):
+--engine=shamir		- perfect Shamir sharing (default)
+--engine=krawczyk	- computational sharing for large files
+--engine=ida		- information dispersal, no secrecy, |file|/K per share
+--engine=packed		- ramp sharing, needs --privacy, |file|*4/(K-T) per share
+--engine=gf256		- Shamir over GF(2^8), |file| per share, N < 256
+--engine=gf65536	- Shamir over GF(2^16), |file| per share, N < 65536
+--engine=p65809		- Shamir over GF(65809), |file|*3/2 per share
+--engine=m31		- Shamir over GF(2^31-1), |file|*4/3 per share
+--privacy=T		- packed only: any T shares reveal nothing, 0 < T < K
+--correct=K		- decode: treat the files as ONE K-of-N set and skip corrupted shares
+			  (shamir, krawczyk and packed shares)
+--stats[=json]		- per-stage wall / cpu time, bytes and MB/s to stderr, as text or JSON
+--counters		- with --stats: cycles, IPC and cache / branch / dTLB misses per byte (Linux)
+
+Verify Mode:
+argv[1] - "--verify-shares"
+argv[2] - file1
+...
+
+Daemon Mode (serves requests on a Unix domain socket, see daemon.h):
+argv[1] - "--daemon"
+argv[2] - socket path
+argv[3] - workers, optional (hardware threads by default)
+
 Encode Mode:
 argv[1] - "-e"
 argv[2] - file
 argv[3] - N
 argv[4] - K
+shares are named file-ssA ... for N <= 26, file-ss0001 ... (the index) above.
 
 Decode Mode:
 argv[1] - "-d"
@@ -20,15 +154,134 @@ argv[2] - output path
 argv[3] - file1
 argv[4] - file2
 ...
+
+Repair Mode:
+argv[1] - "-r"
+argv[2] - index of the lost share, "C" or "3"
+argv[3] - output file
+argv[4] - file1
+...
+
+Refresh Mode (rewrites EVERY share of the set in place, the secret is kept):
+argv[1] - "-f"
+argv[2] - K, the set's own
+argv[3] - file1
+argv[4] - file2
+...
+
+Reshare Mode (a new K-of-N set from the old shares, written as output-ssA ...):
+argv[1] - "-s"
+argv[2] - N
+argv[3] - K
+argv[4] - output file
+argv[5] - file1
+...
 */
 int main(int argc, char* argv[])
 {
+	string engine = "shamir";
+	int privacy = 0;
+	int correct = 0;
+	bool verify = false;
+	bool daemon = false;
+	StatsPrinter printer;
+	while (argc > 1 && strncmp(argv[1], "--", 2) == 0)
+	{
+		if (strncmp(argv[1], "--engine=", 9) == 0)
+		{
+			engine = argv[1] + 9;
+		}
+		else if (strncmp(argv[1], "--privacy=", 10) == 0)
+		{
+			privacy = atoi(argv[1] + 10);
+		}
+		else if (strncmp(argv[1], "--correct=", 10) == 0)
+		{
+			correct = atoi(argv[1] + 10);
+		}
+		else if (strcmp(argv[1], "--verify-shares") == 0)
+		{
+			verify = true;
+		}
+		else if (strcmp(argv[1], "--daemon") == 0)
+		{
+			daemon = true;
+		}
+		else if (strcmp(argv[1], "--stats") == 0 || strcmp(argv[1], "--stats=text") == 0)
+		{
+			printer.format = "text";
+		}
+		else if (strcmp(argv[1], "--stats=json") == 0)
+		{
+			printer.format = "json";
+		}
+		else if (strcmp(argv[1], "--counters") == 0)
+		{
+			printer.stats.Count(true);
+		}
+		else
+		{
+			cout << "Wrong arguments" << endl;
+			return -100;
+		}
+
+		argv[1] = argv[0];
+		++argv;
+		--argc;
+	}
+
+	if (daemon)
+	{ // Daemon Mode
+		if (argc != 2 && argc != 3)
+		{
+			cout << "Wrong arguments" << endl;
+			return -100;
+		}
+
+		const unsigned int	workers = (argc == 3) ? (unsigned int)atoi(argv[2]) : std::thread::hardware_concurrency();
+		ShareDaemon			server(argv[1], workers);
+		if (false == server.Run())
+		{
+			cout << "Failed to listen." << endl;
+			return -1000;
+		}
+		return 0;
+	}
+
+	// everything below runs with the stats attached; what no stage claims is "other".
+	if (printer.stats.Counting() && printer.format.empty())
+		printer.format = "text";
+	if (printer.stats.Counting())
+		PerfCounters::ThreadLocal();	// opened here, not in the first stage
+	ShareStats::Attached	attached(printer.format.empty() ? nullptr : &printer.stats);
+	ShareStats::Scope		job(ShareStats::STAGE_OTHER);
+
+	if (verify)
+	{ // Verify Mode
+		if (argc < 2)
+		{
+			cout << "Wrong arguments" << endl;
+			return -100;
+		}
+
+		vector<string>	inputFileNames;
+		for (int i = 1; i < argc; ++i)
+		{
+			inputFileNames.push_back(argv[i]);
+		}
+
+		return VerifyFiles(inputFileNames) ? 0 : -600;
+	}
+
 	if (argc < 5)
 	{
 		cout << "Wrong arguments" << endl;
 		return -100;
 	}
 
+	// large share buffers may use transparent huge pages where the OS offers them.
+	AlignedAllocator::SetHugePagePolicy(AlignedAllocator::HUGEPAGE_TRANSPARENT, ((size_t)32 << 20));
+
 	if (strcmp(argv[1], "-e") == 0)
 	{ // Encode Mode
 		if (argc != 5)
@@ -37,7 +290,7 @@ int main(int argc, char* argv[])
 			return -200;
 		}
 
-		if (false == EncodeFile(argv[2], atoi(argv[3]), atoi(argv[4])))
+		if (false == EncodeFile(argv[2], atoi(argv[3]), atoi(argv[4]), engine, privacy))
 		{
 			cout << "Failed to encode." << endl;
 			return -300;
@@ -57,12 +310,54 @@ int main(int argc, char* argv[])
 			inputFileNames.push_back(argv[i]);
 		}
 
-		if (false == DecodeFiles(argv[2], inputFileNames))
+		if (false == DecodeFiles(argv[2], inputFileNames, correct))
 		{
 			cout << "Failed to decode." << endl;
 			return -500;
 		}
 	}
+	else if (strcmp(argv[1], "-r") == 0)
+	{ // Repair Mode
+		vector<string>	inputFileNames;
+		for (int i = 4; i < argc; ++i)
+		{
+			inputFileNames.push_back(argv[i]);
+		}
+
+		if (false == RepairFile(argv[2], argv[3], inputFileNames))
+		{
+			cout << "Failed to repair." << endl;
+			return -700;
+		}
+	}
+	else if (strcmp(argv[1], "-f") == 0)
+	{ // Refresh Mode
+		vector<string>	inputFileNames;
+		for (int i = 3; i < argc; ++i)
+		{
+			inputFileNames.push_back(argv[i]);
+		}
+
+		if (false == RefreshFiles(atoi(argv[2]), inputFileNames))
+		{
+			cout << "Failed to refresh." << endl;
+			return -800;
+		}
+	}
+	else if (strcmp(argv[1], "-s") == 0)
+	{ // Reshare Mode
+		vector<string>	inputFileNames;
+		for (int i = 5; i < argc; ++i)
+		{
+			inputFileNames.push_back(argv[i]);
+		}
+
+		if (false == ReshareFiles(atoi(argv[2]), atoi(argv[3]), argv[4], inputFileNames))
+		{
+			cout << "Failed to reshare." << endl;
+			return -900;
+		}
+	}
 	else
 	{
 		cout << "Wrong arguments" << endl;
@@ -74,8 +369,15 @@ int main(int argc, char* argv[])
 
 
 
-bool EncodeFile(const std::string& fileName, const int& N, const int& K)
+bool EncodeFile(const std::string& fileName, const int& N, const int& K, const string& engine, const int& T)
 {
+	DefaultRandomer			dr;
+	FieldEngines			fields(dr);
+	if (engine != "shamir" && engine != "krawczyk" && engine != "ida" && engine != "packed" && fields.ByName(engine) == nullptr)
+		return false;
+	if (engine == "packed" && (T <= 0 || T >= K))
+		return false;
+
 	ifstream	infile(fileName, ios::in | ios::binary);
 	if (true != infile.is_open())
 		return false;
@@ -84,44 +386,62 @@ bool EncodeFile(const std::string& fileName, const int& N, const int& K)
 	size_t len = (size_t)infile.tellg();
 	infile.seekg(0, ios::beg);
 
-	FixedBuffer origin(len);
-	char* originData = new char[len];
-	infile.read(originData, len);
-	infile.close();
-
-	origin.Write(0, originData, len);
-	delete[] originData;
+	OwnedBuffer origin(len);
+	{
+		ShareStats::Scope stage(ShareStats::STAGE_READ, len);
+		infile.read((char*)origin.Data(), len);
+		infile.close();
+	}
 
-	std::vector<FixedBuffer*>	interdata;
+	ShareMatrix				interdata;
 
-	DefaultRandomer			dr;
 	DefaultStrongSSharer	dts(dr);
+	KrawczykSecretSharer	kss(dr);
+	DispersalSharer			ida;
+	PackedSecretSharer		pss(dr, T);
+	SecretSharer&			sharer = (engine == "krawczyk") ? (SecretSharer&)kss :
+									 (engine == "ida") ? (SecretSharer&)ida :
+									 (engine == "packed") ? (SecretSharer&)pss :
+									 (fields.ByName(engine) != nullptr) ? *fields.ByName(engine) : (SecretSharer&)dts;
+
+	ChecksummedSharer		checked(sharer);
 
-	bool exeres = dts.Encode(interdata, N, K, origin);
+	if (false == checked.Encode(interdata, N, K, origin.View()))
+		return false;
 
+	ShareStats::Scope stage(ShareStats::STAGE_WRITE);
 	for (int i = 0; i < N; ++i)
 	{
-		string outFileName = fileName + "-ss";
-		outFileName += ((char)('A' + i));
+		string outFileName = ShareFileName(fileName, i, N);
 		ofstream outfile(outFileName.c_str(), ios::out | ios::binary);
 
-		outfile.write(static_cast<const char*>(interdata[i]->Buffer()), interdata[i]->Size());
+		MutableBufferView share = interdata.Row(i);
+		outfile.write((const char*)share.Data(), share.Size());
 		outfile.close();
+		stage.Bytes(share.Size());
 	}
-	dts.ReleaseSharedSecrets(interdata);
 
 	return true;
 }
 
 
 
-bool DecodeFiles(const string& outPath, const vector<string>& fileNames)
+bool DecodeFiles(const string& outPath, const vector<string>& fileNames, const int& correctK)
 {
 	ifstream	inFiles;
-	std::vector<FixedBuffer*>	shrdSecs;
+	std::vector<OwnedBuffer>	shrdSecs;
+	std::vector<BufferView>		shrdViews;
+	std::vector<BufferView>		idaViews;
+	std::vector<BufferView>		packedViews;
+	std::vector<BufferView>		fieldViews;
+	std::vector<BufferView>		allViews;
+
+	DefaultRandomer			dr;
+	FieldEngines			fields(dr);
 
 	for (size_t i = 0; i < fileNames.size(); ++i)
 	{
+		ShareStats::Scope stage(ShareStats::STAGE_READ);
 		inFiles.open(fileNames[i], ios::in | ios::binary);
 		if (inFiles.is_open() == false)
 		{
@@ -132,40 +452,664 @@ bool DecodeFiles(const string& outPath, const vector<string>& fileNames)
 		size_t len = (size_t)inFiles.tellg();
 		inFiles.seekg(0, ios::beg);
 
-		FixedBuffer* pFileData = new FixedBuffer(len);
-		Enco::byte*	pData = new Enco::byte[len];
-		inFiles.read((char*)pData, len);
-		pFileData->Write(0, pData, len);
-		delete[] pData;
+		OwnedBuffer fileData(len);
+		inFiles.read((char*)fileData.Data(), len);
+		stage.Bytes(len);
 
-		shrdSecs.push_back(pFileData);
+		if (DispersalSharer::IsDispersal(fileData.View()))
+			idaViews.push_back(fileData.View());
+		else if (PackedSecretSharer::IsPacked(fileData.View()))
+			packedViews.push_back(fileData.View());
+		else if (fields.ByShare(fileData.View()) != nullptr)
+			fieldViews.push_back(fileData.View());
+		else
+			shrdViews.push_back(fileData.View());
+		allViews.push_back(fileData.View());
+		shrdSecs.push_back(std::move(fileData));
 		inFiles.close();
 	}
 
-	DefaultRandomer			dr;
-	DefaultStrongSSharer	dss(dr);
+	// reads both plain strong shares and computational ones; damaged shares are
+	// dropped by their checksums before any of them is decoded.
+	KrawczykSecretSharer	kss(dr);
+	DispersalSharer			dis;
+	PackedSecretSharer		pks(dr, 0);
+	ChecksummedSharer		dss(kss);
+	ChecksummedSharer		ida(dis);
+	ChecksummedSharer		pss(pks);
 
-	std::vector<FixedBuffer*>	recovered;
-	if (false == dss.Decode(recovered, shrdSecs))
-		return false;
+	std::vector<OwnedBuffer>	recovered;
+	if (correctK > 0)
+	{
+		// one set only, of the engine most shares carry the magic of: shares that
+		// do not fit are reported instead of grouped away.
+		SecretSharer*	pSharer = &dss;
+		size_t			most = shrdViews.size();
+		if (packedViews.size() > most)
+		{
+			pSharer = &pss;
+			most = packedViews.size();
+		}
+		if (idaViews.size() > most)
+		{
+			cout << "--correct is not supported for ida shares" << endl;
+			return false;
+		}
+		if (fieldViews.size() > most)
+		{
+			cout << "--correct is not supported for " << fields.NameOf(fieldViews[0]) << " shares" << endl;
+			return false;
+		}
+
+		SecretSharer&			sharer = *pSharer;
+		std::map<size_t, int>	sizes;
+		size_t					size = 0;
+		for (const BufferView& view : allViews)
+		{
+			if (++sizes[sharer.DecodedSize(view)] > sizes[size])
+				size = sharer.DecodedSize(view);
+		}
 
-	dss.ReleaseSharedSecrets(shrdSecs);
+		OwnedBuffer			origin(size);
+		std::vector<size_t>	badShares;
+		const bool			result = sharer.Decode(origin.MutableView(), allViews, correctK, badShares);
+		for (const size_t& b : badShares)
+		{
+			cout << "Bad share: " << fileNames[b] << endl;
+		}
+		if (false == result)
+			return false;
+
+		recovered.push_back(std::move(origin));
+	}
+	else
+	{
+		if (false == dss.Decode(recovered, shrdViews))
+			return false;
+		if (false == ida.Decode(recovered, idaViews))
+			return false;
+		if (false == pss.Decode(recovered, packedViews))
+			return false;
+
+		// every engine picks the shares of its own field.
+		SecretSharer* engines[] = { &fields.gf256, &fields.gf65536, &fields.p65809, &fields.m31 };
+		for (SecretSharer* pEngine : engines)
+		{
+			ChecksummedSharer checked(*pEngine);
+			if (false == checked.Decode(recovered, fieldViews))
+				return false;
+		}
+	}
 
 
-	char text[128] = { 0 };
+	ShareStats::Scope stage(ShareStats::STAGE_WRITE);
 	int i = 0;
 	for (auto& pSec : recovered)
 	{
-		std::string filename = outPath + "rvd-";
-		_itoa_s(i++, text, 128, 10);
-		filename += text;
+		std::string filename = outPath + "rvd-" + std::to_string(i++);
 
 		ofstream outFile(filename, ios::out | ios::binary);
 
-		outFile.write((const char*)pSec->Buffer(), pSec->Size());
+		outFile.write((const char*)pSec.Data(), pSec.Size());
 		outFile.close();
+		stage.Bytes(pSec.Size());
+	}
+
+	return true;
+}
+
+
+
+bool VerifyFiles(const vector<string>& fileNames)
+{
+	bool	allGood = true;
+
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		ifstream inFile(fileNames[i], ios::in | ios::binary);
+		if (inFile.is_open() == false)
+		{
+			cout << fileNames[i] << ": cannot open" << endl;
+			allGood = false;
+			continue;
+		}
+
+		inFile.seekg(0, ios::end);
+		size_t len = (size_t)inFile.tellg();
+		inFile.seekg(0, ios::beg);
+
+		OwnedBuffer fileData(len);
+		inFile.read((char*)fileData.Data(), len);
+		inFile.close();
+
+		std::vector<size_t> badChunks;
+		if (false == ShareChecksum::HasTrailer(fileData.View()) && ShareChecksum::Verify(fileData.View(), badChunks))
+		{
+			cout << fileNames[i] << ": no checksum" << endl;
+		}
+		else if (ShareChecksum::Verify(fileData.View(), badChunks))
+		{
+			cout << fileNames[i] << ": OK" << endl;
+		}
+		else
+		{
+			cout << fileNames[i] << ": DAMAGED";
+			if (badChunks.empty())
+			{
+				cout << " (checksum trailer)";
+			}
+			else
+			{
+				cout << " (" << badChunks.size() << " bad chunks, first at byte " << badChunks[0] * ShareChecksum::m_cnst_chunk_size << ")";
+			}
+			cout << endl;
+			allGood = false;
+		}
 	}
-	dss.ReleaseSharedSecrets(recovered);
 
+	return allGood;
+}
+
+
+
+bool RepairFile(const string& index, const string& outFileName, const vector<string>& fileNames)
+{
+	// "C" names the share the same way EncodeFile() does, "3" is the raw index.
+	unsigned int sidx = 0;
+	if (index.size() == 1 && index[0] >= 'A' && index[0] <= 'Z')
+		sidx = index[0] - 'A' + 1;
+	else
+		sidx = (unsigned int)atoi(index.c_str());
+
+	ShareWindows shares;
+	if (sidx == 0 || false == shares.Open(fileNames))
+		return false;
+
+	DefaultRandomer			dr;
+	KrawczykSecretSharer	kss(dr);
+	DispersalSharer			dis;
+	PackedSecretSharer		pks(dr, 0);
+	FieldEngines			fields(dr);
+	const BufferView		first = shares.head.View();
+	SecretSharer&			sharer = DispersalSharer::IsDispersal(first) ? (SecretSharer&)dis :
+									 PackedSecretSharer::IsPacked(first) ? (SecretSharer&)pks :
+									 (fields.ByShare(first) != nullptr) ? *fields.ByShare(first) : (SecretSharer&)kss;
+	shares.Start(sharer);
+
+	// shares from before the trailer existed are repaired into the same old format.
+	OwnedBuffer repaired(shares.header + shares.span);
+	ShareWriter outFile;
+	bool		ok = outFile.Open(outFileName, shares.sealed);
+	while (ok && shares.Next())
+	{
+		const size_t size = shares.views.empty() ? 0 : shares.views[0].Size();
+		ok = size > 0 && sharer.Repair(repaired.MutableView().Sub(0, size), shares.views, sidx) &&
+			 outFile.Write(repaired.View().Sub(shares.skip, size - shares.skip));
+	}
+
+	if (false == ok || false == outFile.Close() || false == outFile.Commit())
+	{
+		outFile.Discard();
+		return false;
+	}
 	return true;
+}
+
+bool RefreshFiles(const int& K, const vector<string>& fileNames)
+{
+	ShareWindows shares;
+	if (K <= 0 || fileNames.size() < (size_t)K || false == shares.Open(fileNames))
+		return false;
+
+	DefaultRandomer			dr;
+	FieldEngines			fields(dr);
+	KrawczykSecretSharer	kss(dr);
+	PackedSecretSharer		pks(dr, 0);
+	const BufferView		first = shares.head.View();
+	SecretSharer&			sharer = PackedSecretSharer::IsPacked(first) ? (SecretSharer&)pks : (SecretSharer&)kss;
+
+	// ida shares hold no randomness to renew, the field engines have no Refresh().
+	if (DispersalSharer::IsDispersal(first))
+	{
+		cout << "refresh is not supported for ida shares" << endl;
+		return false;
+	}
+	if (fields.ByShare(first) != nullptr)
+	{
+		cout << "refresh is not supported for " << fields.NameOf(first) << " shares" << endl;
+		return false;
+	}
+
+	// a share left out would no longer combine with the refreshed ones.
+	const string left = UngivenShare(fileNames, first, shares.payloadSize);
+	if (false == left.empty())
+	{
+		cout << left << " belongs to the set but was not given" << endl;
+		return false;
+	}
+	shares.Start(sharer);
+
+	// a damaged share would carry its damage into the new set, refuse instead.
+	// The old files are only replaced once every new one is complete.
+	std::vector<ShareWriter>	outFiles(fileNames.size());
+	bool						ok = true;
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		ok = ok && outFiles[i].Open(fileNames[i], shares.readers[i].sealed);
+	}
+
+	while (ok && shares.Next())
+	{
+		ok = shares.windows.size() == fileNames.size() && sharer.Refresh(shares.windows, (unsigned int)K);
+		for (size_t i = 0; ok && i < outFiles.size(); ++i)
+		{
+			ok = outFiles[i].Write(shares.views[i].Sub(shares.skip, shares.views[i].Size() - shares.skip));
+		}
+	}
+
+	return ShareWriter::CommitAll(outFiles, ok);
+}
+
+bool ReshareFiles(const int& N, const int& K, const string& outFileName, const vector<string>& fileNames)
+{
+	ShareWindows shares;
+	if (N <= 0 || K <= 0 || K > N || false == shares.Open(fileNames))
+		return false;
+
+	DefaultRandomer			dr;
+	KrawczykSecretSharer	kss(dr);
+	shares.Start(kss);
+
+	// the new shares go out a window at a time as well, always sealed.
+	ShareMatrix					interdata;
+	std::vector<ShareWriter>	outFiles(N);
+	bool						ok = true;
+	for (int i = 0; i < N; ++i)
+	{
+		ok = ok && outFiles[i].Open(ShareFileName(outFileName, i, N), true);
+	}
+
+	while (ok && shares.Next())
+	{
+		const size_t size = shares.views.empty() ? 0 : kss.ResharedSize(shares.views[0], N, K);
+		if (interdata.RowSize() < size)
+			interdata = ShareMatrix(N, size);
+
+		std::vector<MutableBufferView> newShares;
+		for (int i = 0; i < N; ++i)
+		{
+			newShares.push_back(interdata.Row(i).Sub(0, size));
+		}
+
+		ok = size > shares.skip && kss.Reshare(newShares, N, K, shares.views);
+		for (int i = 0; ok && i < N; ++i)
+		{
+			ok = outFiles[i].Write(newShares[i].Sub(shares.skip, size - shares.skip));
+		}
+	}
+
+	return ShareWriter::CommitAll(outFiles, ok);
+}
+
+string ShareFileName(const string& fileName, const int& i, const int& N)
+{
+	// letters as before for small sets, the zero padded share index beyond Z.
+	string name = fileName + "-ss";
+	if (N <= 26)
+		return name + ((char)('A' + i));
+
+	const string index = to_string(i + 1);
+	return name + string(to_string(N).size() - index.size(), '0') + index;
+}
+
+
+
+string UngivenShare(const vector<string>& fileNames, const BufferView& head, const size_t& payloadSize)
+{
+	// the shares carry no n: look for the siblings EncodeFile() would have
+	// written next to them, of the same size and with the same set GUID (or,
+	// for shares without one, the same hash behind the index).
+	const size_t	same = sizeof(GUID);
+	const size_t	hash = sizeof(Enco::uint32) + 32;
+	std::error_code	error;
+	for (const string& fileName : fileNames)
+	{
+		const size_t mark = fileName.rfind("-ss");
+		if (mark == string::npos)
+			continue;
+
+		const std::filesystem::path	stem(fileName.substr(0, mark + 3));
+		const std::filesystem::path	dir = stem.has_parent_path() ? stem.parent_path() : std::filesystem::path(".");
+		const string				prefix = stem.filename().string();
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(dir, error))
+		{
+			const string name = entry.path().filename().string();
+			if (name.compare(0, prefix.size(), prefix) != 0 || name.size() == prefix.size() ||
+				name.find('.', prefix.size()) != string::npos)
+				continue;
+
+			bool given = false;
+			for (const string& other : fileNames)
+			{
+				given = given || std::filesystem::equivalent(entry.path(), other, error);
+			}
+
+			ShareReader sibling;
+			if (given || false == sibling.Open(entry.path().string()) || sibling.payloadSize != payloadSize || head.Size() < hash)
+				continue;
+
+			OwnedBuffer siblingHead(hash);
+			if (sibling.Head(siblingHead.MutableView()) &&
+				(memcmp(siblingHead.Data(), head.Data(), same) == 0 ||
+				 memcmp(siblingHead.Data() + sizeof(Enco::uint32), head.Data() + sizeof(Enco::uint32), hash - sizeof(Enco::uint32)) == 0))
+				return entry.path().string();
+		}
+		break;
+	}
+	return string();
+}
+
+
+
+ShareReader::ShareReader() :
+payloadSize(0), position(0), checked(0), sealed(false), damaged(false)
+{}
+
+bool ShareReader::Open(const string& fileName)
+{
+	file.open(fileName, ios::in | ios::binary);
+	if (file.is_open() == false)
+		return false;
+
+	file.seekg(0, ios::end);
+	const size_t len = (size_t)file.tellg();
+	payloadSize = len;
+
+	// only the trailer is read here, the payload goes by in Read().
+	const size_t	fixed = (len < ShareChecksum::m_cnst_fixed_size) ? len : ShareChecksum::m_cnst_fixed_size;
+	OwnedBuffer		end(fixed);
+	file.seekg(len - fixed, ios::beg);
+	file.read((char*)end.Data(), fixed);
+
+	const size_t trailerSize = ShareChecksum::StoredTrailerSize(end.View(), len);
+	if (trailerSize > 0)
+	{
+		size_t		chunkSize = 0;
+		OwnedBuffer	trailer(trailerSize);
+		file.seekg(len - trailerSize, ios::beg);
+		file.read((char*)trailer.Data(), trailerSize);
+		if (false == ShareChecksum::ReadTrailer(trailer.View(), payloadSize, chunkSize, chunkCrcs))
+			damaged = true;
+		else
+			sum = ChunkChecksum(chunkSize);
+		sealed = true;
+	}
+
+	file.seekg(0, ios::beg);
+	return file.good();
+}
+
+bool ShareReader::Head(const MutableBufferView& data)
+{
+	if (position != 0 || data.Size() > payloadSize)
+		return false;
+
+	file.read((char*)data.Data(), data.Size());
+	const bool ok = (size_t)file.gcount() == data.Size();
+	file.seekg(0, ios::beg);
+	return ok;
+}
+
+bool ShareReader::Read(const MutableBufferView& data)
+{
+	if (damaged || data.Size() > payloadSize - position)
+		return false;
+
+	file.read((char*)data.Data(), data.Size());
+	if ((size_t)file.gcount() != data.Size())
+	{
+		damaged = true;
+		return false;
+	}
+
+	position += data.Size();
+	if (false == sealed)
+		return true;
+
+	sum.Update(data.Data(), data.Size());
+	if (position == payloadSize)
+		sum.Finish();
+
+	const std::vector<Enco::uint32>& chunks = sum.Chunks();
+	for (; checked < chunks.size(); ++checked)
+	{
+		if (checked >= chunkCrcs.size() || chunks[checked] != chunkCrcs[checked])
+			damaged = true;
+	}
+	return false == damaged;
+}
+
+
+
+bool ShareWriter::Open(const string& fileName, const bool& seal)
+{
+	name = fileName;
+	sealed = seal;
+	sum = ChunkChecksum();
+	file.open(name + ".new", ios::out | ios::binary | ios::trunc);
+	return file.is_open();
+}
+
+bool ShareWriter::Write(const BufferView& data)
+{
+	if (sealed)
+		sum.Update(data.Data(), data.Size());
+
+	file.write((const char*)data.Data(), data.Size());
+	return file.good();
+}
+
+bool ShareWriter::Close()
+{
+	if (sealed)
+	{
+		std::vector<Enco::byte> trailer;
+		sum.Finish();
+		ShareChecksum::Trailer(sum, trailer);
+		file.write((const char*)&trailer[0], trailer.size());
+	}
+
+	file.close();
+	return false == file.fail();
+}
+
+bool ShareWriter::Commit()
+{
+	std::error_code error;
+	std::filesystem::rename(name + ".new", name, error);
+	return !error;
+}
+
+void ShareWriter::Discard()
+{
+	std::error_code error;
+	if (file.is_open())
+		file.close();
+	std::filesystem::remove(name + ".new", error);
+}
+
+bool ShareWriter::CommitAll(std::vector<ShareWriter>& writers, bool ok)
+{
+	for (ShareWriter& writer : writers)
+	{
+		ok = writer.Close() && ok;
+	}
+	for (size_t i = 0; ok && i < writers.size(); ++i)
+	{
+		ok = writers[i].Commit();
+	}
+
+	if (false == ok)
+	{
+		for (ShareWriter& writer : writers)
+		{
+			writer.Discard();
+		}
+	}
+	return ok;
+}
+
+
+
+const size_t ShareWindows::m_cnst_window = 16 * ShareChecksum::m_cnst_chunk_size;
+
+ShareWindows::ShareWindows() :
+payloadSize(0), header(0), span(0), skip(0), offset(0), sealed(false)
+{}
+
+bool ShareWindows::Open(const vector<string>& fileNames)
+{
+	readers.clear();
+	readers.resize(fileNames.size());
+	std::map<size_t, size_t> sizes;
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		if (false == readers[i].Open(fileNames[i]))
+			return false;
+
+		if (false == readers[i].damaged)
+			++sizes[readers[i].payloadSize];
+	}
+
+	// a share of another size than most is damaged, or of another set.
+	size_t most = 0;
+	for (const std::pair<const size_t, size_t>& size : sizes)
+	{
+		if (size.second > most)
+		{
+			most = size.second;
+			payloadSize = size.first;
+		}
+	}
+
+	size_t usable = readers.size();
+	for (size_t i = readers.size(); i-- > 0;)
+	{
+		if (readers[i].payloadSize != payloadSize)
+			readers[i].damaged = true;
+		if (false == readers[i].damaged)
+			usable = i;
+	}
+	if (usable == readers.size() || payloadSize == 0)
+		return false;
+
+	sealed = readers[usable].sealed;
+	head = OwnedBuffer((payloadSize < 4096) ? payloadSize : 4096);
+	return readers[usable].Head(head.MutableView());
+}
+
+void ShareWindows::Start(const SecretSharer& sharer)
+{
+	size_t symbolSize = 0;
+	header = sharer.WindowHeader(head.View(), symbolSize);
+	span = m_cnst_window;
+
+	// windows end on multiples of m_cnst_window, so the header must leave
+	// whole symbols before the first end.
+	if (header == 0 || symbolSize == 0 || header >= m_cnst_window || header > payloadSize ||
+		header % symbolSize != 0 || m_cnst_window % symbolSize != 0 || (payloadSize - header) % symbolSize != 0)
+	{
+		header = payloadSize;
+		span = 0;
+	}
+
+	buffers.clear();
+	for (size_t i = 0; i < readers.size(); ++i)
+	{
+		buffers.push_back(OwnedBuffer(readers[i].damaged ? 0 : header + span));
+	}
+}
+
+bool ShareWindows::Next()
+{
+	if (offset >= payloadSize)
+		return false;
+
+	const bool		first = (offset == 0);
+	const size_t	start = first ? header : offset;
+	const size_t	limit = (start / m_cnst_window + 1) * m_cnst_window;
+	const size_t	end = (span == 0 || limit > payloadSize) ? payloadSize : limit;
+
+	windows.clear();
+	views.clear();
+	position.clear();
+	for (size_t i = 0; i < readers.size(); ++i)
+	{
+		const MutableBufferView buffer = buffers[i].MutableView();
+		if (readers[i].damaged ||
+			(first && false == readers[i].Read(buffer.Sub(0, header))) ||
+			false == readers[i].Read(buffer.Sub(header, end - start)))
+			continue;
+
+		windows.push_back(buffer.Sub(0, header + end - start));
+		views.push_back(windows.back());
+		position.push_back(i);
+	}
+
+	skip = first ? 0 : header;
+	offset = end;
+	return true;
+}
+
+
+
+StatsPrinter::~StatsPrinter()
+{
+	if (format == "json")
+		stats.ReportJson(cerr);
+	else if (false == format.empty())
+		stats.Report(cerr);
+}
+
+
+
+FieldEngines::FieldEngines(const Randomer& randomer) :
+gf256(randomer), gf65536(randomer), p65809(randomer), m31(randomer)
+{}
+
+SecretSharer* FieldEngines::ByName(const string& engine)
+{
+	if (engine == "gf256")
+		return &gf256;
+	if (engine == "gf65536")
+		return &gf65536;
+	if (engine == "p65809")
+		return &p65809;
+	if (engine == "m31")
+		return &m31;
+	return nullptr;
+}
+
+SecretSharer* FieldEngines::ByShare(const BufferView& sharedSecret)
+{
+	if (FieldSecretSharer<Gf256Field>::IsFieldShare(sharedSecret))
+		return &gf256;
+	if (FieldSecretSharer<Gf65536Field>::IsFieldShare(sharedSecret))
+		return &gf65536;
+	if (FieldSecretSharer<ShamirField>::IsFieldShare(sharedSecret))
+		return &p65809;
+	if (FieldSecretSharer<Mersenne31Field>::IsFieldShare(sharedSecret))
+		return &m31;
+	return nullptr;
+}
+
+string FieldEngines::NameOf(const BufferView& sharedSecret)
+{
+	const char* names[] = { "gf256", "gf65536", "p65809", "m31" };
+	for (const char* name : names)
+	{
+		if (ByName(name) == ByShare(sharedSecret))
+			return name;
+	}
+	return string();
 }
\ No newline at end of file
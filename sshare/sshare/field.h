@@ -0,0 +1,289 @@
+// field.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(FIELD_H)
+#define FIELD_H
+
+// A field policy is a class with only static constexpr members:
+//   Element								uint32, every value below Order()
+//   Order()								number of elements
+//   Magic()								4 bytes naming the field in FieldSecretSharer shares
+//   Add() / Sub() / Multiply() / Inverse()	Inverse(0) is 0
+//   FromRandom()							a uniform-enough element from 32 random bits
+// FieldAlgebra<Field> builds everything else on top of those.
+
+/*
+* @class: PrimeField
+*
+* @remarks: GF(P) for a prime P < 2^32. The modulus is a template constant, so
+*           every reduction compiles to a multiply by its reciprocal.
+*/
+template <Enco::uint32 P>
+class PrimeField
+{
+public:
+	typedef Enco::uint32 Element;
+
+	static constexpr Enco::uint64	Order() { return P; }
+	static constexpr Enco::uint32	Magic();
+
+	static constexpr Element		Add(const Element& a, const Element& b) { return (Element)(((Enco::uint64)a + b) % P); }
+	static constexpr Element		Sub(const Element& a, const Element& b) { return (Element)(((Enco::uint64)a + P - b) % P); }
+	static constexpr Element		Multiply(const Element& a, const Element& b) { return (Element)((Enco::uint64)a * b % P); }
+	static constexpr Element		FromRandom(const Enco::uint32& r) { return r % P; }
+
+	static constexpr Element		Inverse(const Element& a)
+	{
+		// a^(P-2) by Fermat.
+		Enco::uint64 r = 1;
+		Enco::uint64 e = a % P;
+		for (Enco::uint32 b = P - 2; b != 0; b >>= 1)
+		{
+			if (b & 1)
+				r = r * e % P;
+			e = e * e % P;
+		}
+		return (Element)r;
+	}
+};
+
+/*
+* @class: BinaryFieldTables
+*
+* @remarks: exp/log tables of GF(2^Bits) over the primitive polynomial Poly,
+*           built by the compiler. exp is doubled so that exp[log a + log b]
+*           needs no reduction.
+*/
+template <unsigned int Bits, Enco::uint32 Poly>
+struct BinaryFieldTables
+{
+	Enco::uint16	exp[2 << Bits];
+	Enco::uint16	log[1 << Bits];
+
+	constexpr BinaryFieldTables() : exp(), log()
+	{
+		const Enco::uint32 last = (1u << Bits) - 1;
+		Enco::uint32 x = 1;
+		for (Enco::uint32 i = 0; i < last; ++i)
+		{
+			exp[i] = (Enco::uint16)x;
+			exp[i + last] = (Enco::uint16)x;
+			log[x] = (Enco::uint16)i;
+			x <<= 1;
+			if (x >> Bits)
+				x ^= Poly;
+		}
+	}
+};
+
+/*
+* @class: BinaryField
+*
+* @remarks: GF(2^Bits), Bits <= 16. Addition is xor, multiplication two log
+*           lookups and one exp lookup in BinaryFieldTables.
+*/
+template <unsigned int Bits, Enco::uint32 Poly>
+class BinaryField
+{
+public:
+	typedef Enco::uint32 Element;
+
+	static constexpr Enco::uint64	Order() { return (Enco::uint64)1 << Bits; }
+	static constexpr Enco::uint32	Magic();
+
+	static constexpr Element		Add(const Element& a, const Element& b) { return a ^ b; }
+	static constexpr Element		Sub(const Element& a, const Element& b) { return a ^ b; }
+	static constexpr Element		FromRandom(const Enco::uint32& r) { return r & ((1u << Bits) - 1); }
+
+	static constexpr Element		Multiply(const Element& a, const Element& b)
+	{
+		return (a == 0 || b == 0) ? 0 : m_cnst_tables.exp[m_cnst_tables.log[a] + m_cnst_tables.log[b]];
+	}
+
+	static constexpr Element		Inverse(const Element& a)
+	{
+		return (a == 0) ? 0 : m_cnst_tables.exp[((1u << Bits) - 1) - m_cnst_tables.log[a]];
+	}
+
+	static constexpr Element		Exp(const unsigned int& i) { return m_cnst_tables.exp[i]; }
+	static constexpr Element		Log(const Element& a) { return m_cnst_tables.log[a]; }
+
+private:
+	static constexpr BinaryFieldTables<Bits, Poly> m_cnst_tables = BinaryFieldTables<Bits, Poly>();
+};
+
+template <unsigned int Bits, Enco::uint32 Poly>
+constexpr BinaryFieldTables<Bits, Poly> BinaryField<Bits, Poly>::m_cnst_tables;
+
+// the fields in use. ShamirField is the one of DefaultSecretSharer and its
+// share format, the others only back FieldSecretSharer.
+typedef PrimeField<65809>					ShamirField;
+typedef PrimeField<2147483647>				Mersenne31Field;
+typedef BinaryField<8, 0x11D>				Gf256Field;
+typedef BinaryField<16, 0x1002D>			Gf65536Field;
+
+template <> constexpr Enco::uint32 ShamirField::Magic() { return 0x50534646; }		// "FFSP"
+template <> constexpr Enco::uint32 Mersenne31Field::Magic() { return 0x4D534646; }	// "FFSM"
+template <> constexpr Enco::uint32 Gf256Field::Magic() { return 0x38534646; }		// "FFS8"
+template <> constexpr Enco::uint32 Gf65536Field::Magic() { return 0x47534646; }		// "FFSG"
+
+/*
+* @class: FieldAlgebra
+*
+* @remarks: what is written once for every field: powers, symbol packing,
+*           lagrange weights and matrix inversion.
+*/
+template <typename Field>
+class FieldAlgebra
+{
+public:
+	typedef typename Field::Element Element;
+
+	// secret bytes packed into one element (every value of them must be an
+	// element), and bytes one element takes in a share.
+	static constexpr size_t		PlainBytes()
+	{
+		size_t b = 0;
+		while (b < 4 && ((Enco::uint64)1 << (8 * (b + 1))) <= Field::Order())
+		{
+			++b;
+		}
+		return b;
+	}
+
+	static constexpr size_t		StoredBytes()
+	{
+		size_t b = 1;
+		while (((Enco::uint64)1 << (8 * b)) < Field::Order())
+		{
+			++b;
+		}
+		return b;
+	}
+
+	static constexpr Element	Power(Element a, Enco::uint64 e)
+	{
+		Element r = 1;
+		for (; e != 0; e >>= 1)
+		{
+			if (e & 1)
+				r = Field::Multiply(r, a);
+			a = Field::Multiply(a, a);
+		}
+		return r;
+	}
+
+	static constexpr Element	Divide(const Element& a, const Element& b)
+	{
+		return Field::Multiply(a, Field::Inverse(b));
+	}
+
+	/*
+	* @interface: LagrangeWeights
+	*
+	* @remarks: weights[j] = prod_(l != j) (target - x_l) / (x_j - x_l), so that
+	*           P(target) = sum weights[j] * P(x_j); false on a repeated x.
+	*/
+	static bool					LagrangeWeights(const Element *x, const int& m, const Element& target, Element *weights)
+	{
+		for (int j = 0; j < m; ++j)
+		{
+			Element num = 1;
+			Element den = 1;
+			for (int l = 0; l < m; ++l)
+			{
+				if (l == j)
+					continue;
+				if (x[l] == x[j])
+					return false;
+
+				num = Field::Multiply(num, Field::Sub(target, x[l]));
+				den = Field::Multiply(den, Field::Sub(x[j], x[l]));
+			}
+			weights[j] = Divide(num, den);
+		}
+		return true;
+	}
+
+	/*
+	* @interface: Invert
+	*
+	* @remarks: Gauss-Jordan on the k x k row-major matrix, in place; false if
+	*           it is singular.
+	*/
+	static bool					Invert(Element * const pMatrix, const unsigned int& k)
+	{
+		std::vector<Element> inv((size_t)k * k, 0);
+		for (unsigned int i = 0; i < k; ++i)
+		{
+			inv[(size_t)i * k + i] = 1;
+		}
+
+		for (unsigned int col = 0; col < k; ++col)
+		{
+			unsigned int pivot = col;
+			while (pivot < k && pMatrix[(size_t)pivot * k + col] == 0)
+			{
+				++pivot;
+			}
+			if (pivot == k)
+				return false;
+
+			if (pivot != col)
+			{
+				for (unsigned int j = 0; j < k; ++j)
+				{
+					std::swap(pMatrix[(size_t)pivot * k + j], pMatrix[(size_t)col * k + j]);
+					std::swap(inv[(size_t)pivot * k + j], inv[(size_t)col * k + j]);
+				}
+			}
+
+			const Element scale = Field::Inverse(pMatrix[(size_t)col * k + col]);
+			for (unsigned int j = 0; j < k; ++j)
+			{
+				pMatrix[(size_t)col * k + j] = Field::Multiply(pMatrix[(size_t)col * k + j], scale);
+				inv[(size_t)col * k + j] = Field::Multiply(inv[(size_t)col * k + j], scale);
+			}
+
+			for (unsigned int row = 0; row < k; ++row)
+			{
+				const Element factor = pMatrix[(size_t)row * k + col];
+				if (row == col || factor == 0)
+					continue;
+
+				for (unsigned int j = 0; j < k; ++j)
+				{
+					pMatrix[(size_t)row * k + j] = Field::Sub(pMatrix[(size_t)row * k + j], Field::Multiply(pMatrix[(size_t)col * k + j], factor));
+					inv[(size_t)row * k + j] = Field::Sub(inv[(size_t)row * k + j], Field::Multiply(inv[(size_t)col * k + j], factor));
+				}
+			}
+		}
+
+		memcpy(pMatrix, &inv[0], sizeof(Element) * k * k);
+		return true;
+	}
+
+	// little-endian: PlainBytes() secret bytes to an element and back, and an
+	// element to StoredBytes() share bytes and back. count < PlainBytes() packs
+	// the tail of the secret.
+	static Element				Pack(Enco::byte const * const p, const size_t& count)
+	{
+		Element e = 0;
+		for (size_t b = 0; b < count; ++b)
+		{
+			e |= (Element)p[b] << (8 * b);
+		}
+		return e;
+	}
+
+	static void					Unpack(const Element& e, Enco::byte * const p, const size_t& count)
+	{
+		for (size_t b = 0; b < count; ++b)
+		{
+			p[b] = (Enco::byte)(e >> (8 * b));
+		}
+	}
+};
+
+#endif
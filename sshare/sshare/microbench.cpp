@@ -0,0 +1,436 @@
+// microbench.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "allocator.h"
+#include "buffer.h"
+#include "cipher.h"
+#include "checksum.h"
+#include "secret-share.h"
+#include "bench-harness.h"
+#include "e2e-bench.h"
+#include "perf-compare.h"
+
+/*
+Usage: sshare-bench [--filter=text] [--reps=N] [--min-time=ms] [--csv] [--counters]
+                    [--save=file [--label=text]] [--compare=baseline [--current=file] [--threshold=5] [--alpha=0.01]]
+       sshare-bench --e2e [options]	- the sshare tool end to end, see EndToEndBench::Usage()
+
+Cases, named group/what:
+field/		_Add, _Multiply and _Power over 4096 independent operands
+solve/		_SolveMatrix on a fresh copy of a k x k system, _Decode of one symbol
+decode/		one symbol through the lagrange weights, and whole 64 KB secrets
+encode/		_Encode of one symbol for n and k, and whole 64 KB secrets
+rng/		DefaultRandomer::Random, _RandomCoefficient, the AES-CTR keystream
+hash/		sha256 and Crc32c over 64 B to 1 MB
+buffer/		FixedBuffer::Write and Read of one symbol, 64 B and 4 KB
+
+--save writes the run as a baseline, --compare runs and compares with one
+(or compares the saved run given by --current) and exits with -3 when a case
+regressed, see PerfCompare.
+
+--counters adds IPC and cache / branch / dTLB misses from perf_event_open,
+where the system allows it, see PerfCounters.
+*/
+
+namespace
+{
+	// the math tools are protected: the benchmark is the one outsider allowed in.
+	class BenchSharer : public DefaultSecretSharer
+	{
+	public:
+		BenchSharer(const Randomer& randomer) : DefaultSecretSharer(randomer) {}
+
+	public:
+		using DefaultSecretSharer::_Add;
+		using DefaultSecretSharer::_Multiply;
+		using DefaultSecretSharer::_Power;
+		using DefaultSecretSharer::_SolveMatrix;
+		using DefaultSecretSharer::_Decode;
+		using DefaultSecretSharer::_Encode;
+		using DefaultSecretSharer::_LagrangeWeights;
+		using DefaultSecretSharer::_RandomCoefficient;
+	};
+
+	const Enco::uint32	g_cnst_prime = 65809;
+	const size_t		g_cnst_operands = 4096;
+	const size_t		g_cnst_secret_size = ((size_t)64 << 10);
+
+	std::string _Name(const std::string& base, const char* key, const size_t& value)
+	{
+		return base + " " + key + "=" + std::to_string(value);
+	}
+
+	std::string _Size(const size_t& bytes)
+	{
+		if (bytes >= ((size_t)1 << 20))
+			return std::to_string(bytes >> 20) + "MB";
+		if (bytes >= ((size_t)1 << 10))
+			return std::to_string(bytes >> 10) + "KB";
+		return std::to_string(bytes) + "B";
+	}
+
+	void _Field(BenchHarness& harness)
+	{
+		std::vector<Enco::uint32> a(g_cnst_operands);
+		std::vector<Enco::uint32> b(g_cnst_operands);
+		for (size_t i = 0; i < g_cnst_operands; ++i)
+		{
+			a[i] = (Enco::uint32)(rand() % g_cnst_prime);
+			b[i] = (Enco::uint32)(rand() % g_cnst_prime);
+		}
+
+		harness.Run("field/_Add", 0, [&](const Enco::uint64& iterations)
+		{
+			Enco::uint32 s = 0;
+			for (Enco::uint64 i = 0; i < iterations; ++i)
+			{
+				s ^= BenchSharer::_Add(a[i & (g_cnst_operands - 1)], b[i & (g_cnst_operands - 1)]);
+			}
+			BenchHarness::Keep(s);
+		});
+
+		harness.Run("field/_Multiply", 0, [&](const Enco::uint64& iterations)
+		{
+			Enco::uint32 s = 0;
+			for (Enco::uint64 i = 0; i < iterations; ++i)
+			{
+				s ^= BenchSharer::_Multiply(a[i & (g_cnst_operands - 1)], b[i & (g_cnst_operands - 1)]);
+			}
+			BenchHarness::Keep(s);
+		});
+
+		harness.Run("field/_Power inverse", 0, [&](const Enco::uint64& iterations)
+		{
+			Enco::uint32 s = 0;
+			for (Enco::uint64 i = 0; i < iterations; ++i)
+			{
+				s ^= BenchSharer::_Power(a[i & (g_cnst_operands - 1)], (int)g_cnst_prime - 2);
+			}
+			BenchHarness::Keep(s);
+		});
+	}
+
+	void _Solve(BenchHarness& harness, const Randomer& randomer)
+	{
+		const int thresholds[] = { 2, 3, 4, 8, 16, 32 };
+		for (int k : thresholds)
+		{
+			// the shares of one symbol at x = 1..k.
+			std::vector<Enco::uint32>	x(k);
+			std::vector<Enco::uint32>	shares(k);
+			std::vector<Enco::uint32>	coef(k);
+			std::vector<Enco::uint32>	eqnAll((size_t)k * (k + 1));
+			std::vector<Enco::uint32>	system((size_t)k * (k + 1));
+			std::vector<Enco::uint32*>	eqn(k);
+			for (int i = 0; i < k; ++i)
+			{
+				x[i] = i + 1;
+			}
+			BenchSharer::_Encode(0x5A, k, k, randomer, &shares[0], &coef[0]);
+			BenchSharer::_Decode(&x[0], &shares[0], k, &eqnAll[0], &eqn[0]);
+
+			// _Decode() leaves the system solved: rebuild the one it started from.
+			for (int r = 0; r < k; ++r)
+			{
+				Enco::uint32 xp = 1;
+				for (int c = 0; c < k; ++c)
+				{
+					system[(size_t)r * (k + 1) + c] = xp;
+					xp = BenchSharer::_Multiply(xp, x[r]);
+				}
+				system[(size_t)r * (k + 1) + k] = shares[r];
+			}
+
+			harness.Run(_Name("solve/_SolveMatrix", "k", k), 0, [&](const Enco::uint64& iterations)
+			{
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					memcpy(&eqnAll[0], &system[0], sizeof(Enco::uint32) * system.size());
+					for (int r = 0; r < k; ++r)
+					{
+						eqn[r] = &eqnAll[0] + (size_t)r * (k + 1);
+					}
+					BenchSharer::_SolveMatrix(&eqn[0], k);
+				}
+				BenchHarness::Keep(eqnAll[0]);
+			});
+
+			harness.Run(_Name("solve/_Decode", "k", k), 1, [&](const Enco::uint64& iterations)
+			{
+				Enco::uint32 s = 0;
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					s ^= BenchSharer::_Decode(&x[0], &shares[0], k, &eqnAll[0], &eqn[0]);
+				}
+				BenchHarness::Keep(s);
+			});
+
+			// what Decode() does per symbol instead: fixed weights, one dot product.
+			std::vector<Enco::uint32> weights(k);
+			BenchSharer::_LagrangeWeights(&x[0], k, &weights[0]);
+			harness.Run(_Name("decode/lagrange symbol", "k", k), 1, [&](const Enco::uint64& iterations)
+			{
+				Enco::uint32 s = 0;
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					Enco::uint64 sum = 0;
+					for (int j = 0; j < k; ++j)
+					{
+						sum += (Enco::uint64)weights[j] * shares[j];
+					}
+					s ^= (Enco::uint32)(sum % g_cnst_prime);
+				}
+				BenchHarness::Keep(s);
+			});
+		}
+	}
+
+	void _Encode(BenchHarness& harness, const Randomer& randomer)
+	{
+		const unsigned int sets[][2] = { { 3, 2 }, { 5, 3 }, { 10, 6 }, { 16, 8 }, { 32, 16 }, { 255, 128 } };
+		for (const unsigned int* set : sets)
+		{
+			const int					n = (int)set[0];
+			const int					k = (int)set[1];
+			std::vector<Enco::uint32>	shares(n);
+			std::vector<Enco::uint32>	coef(k);
+			harness.Run(_Name(_Name("encode/_Encode", "n", n), "k", k), 1, [&](const Enco::uint64& iterations)
+			{
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					BenchSharer::_Encode((Enco::uint32)(i & 0xFF), n, k, randomer, &shares[0], &coef[0]);
+				}
+				BenchHarness::Keep(shares[0]);
+			});
+		}
+
+		// whole secrets through the block kernels.
+		DefaultSecretSharer	sharer(randomer);
+		OwnedBuffer			secret(g_cnst_secret_size);
+		for (size_t i = 0; i < secret.Size(); ++i)
+		{
+			secret.Data()[i] = (Enco::byte)rand();
+		}
+
+		const unsigned int blockSets[][2] = { { 5, 3 }, { 10, 6 }, { 16, 8 }, { 32, 16 } };
+		for (const unsigned int* set : blockSets)
+		{
+			const unsigned int	n = set[0];
+			const unsigned int	k = set[1];
+			ShareMatrix			shares(n, sharer.EncodedSize(secret.Size(), n, k));
+			const std::string	suffix = " " + _Size(secret.Size()) + " n=" + std::to_string(n) + " k=" + std::to_string(k);
+			harness.Run("encode/Encode" + suffix, secret.Size(), [&](const Enco::uint64& iterations)
+			{
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					sharer.Encode(shares.RowViews(), n, k, secret.View());
+				}
+			});
+
+			std::vector<BufferView> views;
+			for (unsigned int i = 0; i < k; ++i)
+			{
+				views.push_back(shares.Row(n - 1 - i));
+			}
+			OwnedBuffer recovered(secret.Size());
+			harness.Run("decode/Decode" + suffix, secret.Size(), [&](const Enco::uint64& iterations)
+			{
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					BenchHarness::Keep(sharer.Decode(recovered.MutableView(), views) ? 1 : 0);
+				}
+			});
+		}
+	}
+
+	void _Random(BenchHarness& harness, const Randomer& randomer)
+	{
+		harness.Run("rng/DefaultRandomer::Random", 1, [&](const Enco::uint64& iterations)
+		{
+			Enco::uint64 s = 0;
+			for (Enco::uint64 i = 0; i < iterations; ++i)
+			{
+				s += (Enco::uint64)randomer.Random();
+			}
+			BenchHarness::Keep(s);
+		});
+
+		harness.Run("rng/_RandomCoefficient", 4, [&](const Enco::uint64& iterations)
+		{
+			Enco::uint32 s = 0;
+			for (Enco::uint64 i = 0; i < iterations; ++i)
+			{
+				s ^= BenchSharer::_RandomCoefficient(randomer);
+			}
+			BenchHarness::Keep(s);
+		});
+
+		if (false == Aes128Ctr::Available())
+			return;
+
+		const Enco::byte	key[24] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24 };
+		Aes128Ctr			stream(key, key + Aes128Ctr::m_cnst_key_size);
+		OwnedBuffer			block(g_cnst_secret_size);
+		memset(block.Data(), 0, block.Size());
+		harness.Run("rng/Aes128Ctr keystream " + _Size(block.Size()), block.Size(), [&](const Enco::uint64& iterations)
+		{
+			for (Enco::uint64 i = 0; i < iterations; ++i)
+			{
+				stream.Apply(block.Data(), block.Data(), block.Size(), i * block.Size());
+			}
+			BenchHarness::Keep(block.Data()[0]);
+		});
+	}
+
+	void _Hash(BenchHarness& harness)
+	{
+		const size_t	sizes[] = { 64, 1 << 10, 64 << 10, 1 << 20 };
+		OwnedBuffer		data((size_t)1 << 20);
+		for (size_t i = 0; i < data.Size(); ++i)
+		{
+			data.Data()[i] = (Enco::byte)(i * 131);
+		}
+
+		for (size_t size : sizes)
+		{
+			unsigned char digest[32] = { 0 };
+			harness.Run("hash/sha256 " + _Size(size), size, [&](const Enco::uint64& iterations)
+			{
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					sha256(data.Data(), (unsigned int)size, digest);
+				}
+				BenchHarness::Keep(digest[0]);
+			});
+		}
+
+		for (size_t size : sizes)
+		{
+			harness.Run("hash/Crc32c " + _Size(size), size, [&](const Enco::uint64& iterations)
+			{
+				Enco::uint32 crc = 0;
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					crc = Crc32c::Compute(data.Data(), size, crc);
+				}
+				BenchHarness::Keep(crc);
+			});
+		}
+	}
+
+	void _Buffer(BenchHarness& harness)
+	{
+		const size_t	sizes[] = { sizeof(Enco::uint32), 64, 4 << 10 };
+		FixedBuffer		buffer(g_cnst_secret_size);
+		OwnedBuffer		data((size_t)4 << 10);
+		memset(buffer.Buffer(), 0, buffer.Size());
+		memset(data.Data(), 0x5A, data.Size());
+
+		for (size_t size : sizes)
+		{
+			// walks the buffer, as the encoders do.
+			const size_t slots = buffer.Size() / size;
+			harness.Run("buffer/FixedBuffer::Write " + _Size(size), size, [&](const Enco::uint64& iterations)
+			{
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					buffer.Write((size_t)(i % slots) * size, data.Data(), size);
+				}
+				BenchHarness::Keep(((const Enco::byte*)buffer.Buffer())[0]);
+			});
+
+			harness.Run("buffer/FixedBuffer::Read " + _Size(size), size, [&](const Enco::uint64& iterations)
+			{
+				for (Enco::uint64 i = 0; i < iterations; ++i)
+				{
+					buffer.Read(data.Data(), (size_t)(i % slots) * size, size);
+				}
+				BenchHarness::Keep(data.Data()[0]);
+			});
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && strcmp(argv[1], "--e2e") == 0)
+	{ // End to End Mode
+		EndToEndBench bench;
+		argv[1] = argv[0];
+		if (false == bench.Parse(argc - 1, argv + 1))
+		{
+			EndToEndBench::Usage(std::cerr);
+			return -1;
+		}
+		if (false == bench.Run())
+			return -2;
+
+		bench.Report(std::cout);
+		return 0;
+	}
+
+	BenchHarness	harness;
+	PerfCompare		compare;
+	if (false == compare.Parse(argc, argv) || false == harness.Parse(argc, argv) || argc != 1)
+	{
+		std::cerr << "usage: sshare-bench [--filter=text] [--reps=N] [--min-time=ms] [--csv] [--counters]" << std::endl
+				  << "                    [--save=file [--label=text]] [--compare=baseline [--current=file] [--threshold=5] [--alpha=0.01]]" << std::endl;
+		return -1;
+	}
+
+	std::vector<BenchHarness::Result> results;
+	if (compare.CurrentFile().empty())
+	{
+		DefaultRandomer randomer;
+		srand(1);
+
+		_Field(harness);
+		_Solve(harness, randomer);
+		_Encode(harness, randomer);
+		_Random(harness, randomer);
+		_Hash(harness);
+		_Buffer(harness);
+		results = harness.Results();
+
+		// with a baseline the comparison is the report.
+		if (compare.BaselineFile().empty() && harness.Csv())
+			harness.ReportCsv(std::cout);
+		else if (compare.BaselineFile().empty())
+			harness.Report(std::cout);
+	}
+	else
+	{
+		PerfCompare::Baseline current;
+		if (false == PerfCompare::Load(compare.CurrentFile(), current))
+		{
+			std::cerr << "Cannot read " << compare.CurrentFile() << std::endl;
+			return -2;
+		}
+		results = current.results;
+	}
+
+	if (false == compare.SaveFile().empty() && false == compare.Save(compare.SaveFile(), results))
+	{
+		std::cerr << "Cannot write " << compare.SaveFile() << std::endl;
+		return -2;
+	}
+
+	if (false == compare.BaselineFile().empty())
+	{
+		PerfCompare::Baseline baseline;
+		if (false == PerfCompare::Load(compare.BaselineFile(), baseline))
+		{
+			std::cerr << "Cannot read " << compare.BaselineFile() << std::endl;
+			return -2;
+		}
+
+		std::cout << "baseline " << baseline.info["label"] << " of " << baseline.info["created"] << " on " << baseline.info["machine"] << std::endl;
+		if (compare.Report(std::cout, compare.Compare(baseline.results, results)))
+			return -3;
+	}
+	return 0;
+}
@@ -0,0 +1,244 @@
+// multipoint.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "multipoint.h"
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ProgressionEvaluator
+
+namespace
+{
+	// both are c * 2^m + 1 with 3 as a primitive root; their product exceeds any
+	// convolution term k * prime^2 < 2^49, so CRT recovers the exact integer.
+	const Enco::uint32 g_cnst_ntt_prime[2] = { 998244353, 469762049 };
+	const Enco::uint32 g_cnst_ntt_root = 3;
+
+	Enco::uint32 _PowMod(Enco::uint64 a, Enco::uint64 e, const Enco::uint32& modulus)
+	{
+		Enco::uint64 r = 1;
+		a %= modulus;
+		while (e > 0)
+		{
+			if (e & 1)
+				r = r * a % modulus;
+			a = a * a % modulus;
+			e >>= 1;
+		}
+		return (Enco::uint32)r;
+	}
+
+	Enco::uint32 _InvMod(const Enco::uint64& a, const Enco::uint32& modulus)
+	{
+		return _PowMod(a, modulus - 2, modulus);
+	}
+
+	// a * pair[0] mod modulus for any 32-bit a, see _Pair().
+	inline Enco::uint32 _MulShoup(const Enco::uint32& a, const Enco::uint32 *pair, const Enco::uint32& modulus)
+	{
+		const Enco::uint32 t = (Enco::uint32)(((Enco::uint64)a * pair[1]) >> 32);
+		const Enco::uint32 r = a * pair[0] - t * modulus;
+		return (r >= modulus) ? r - modulus : r;
+	}
+}
+
+ProgressionEvaluator::ProgressionEvaluator(const Enco::uint32& prime, const unsigned int& n, const unsigned int& k) :
+m_prime(prime), m_inversePrime(1.0 / prime), m_n(n), m_k(k), m_length(1)
+{
+	while (m_length < (size_t)n + k + 1)
+	{
+		m_length <<= 1;
+	}
+
+	// P(x) = Q(x) * sum_i w_i / (x - i) for x >= k, with Q(x) = x (x-1) ... (x-k+1)
+	// and w_i = P(i) * m_weight[i].
+	const unsigned int			d = k - 1;
+	std::vector<Enco::uint32>	fact(k, 1);
+	for (unsigned int i = 1; i < k; ++i)
+	{
+		fact[i] = (Enco::uint32)((Enco::uint64)fact[i - 1] * i % prime);
+	}
+
+	m_weight.resize(2 * (size_t)k);
+	for (unsigned int i = 0; i < k; ++i)
+	{
+		Enco::uint32 w = _InvMod((Enco::uint64)fact[i] * fact[d - i] % prime, prime);
+		_Pair(&m_weight[2 * i], ((d - i) & 1) ? (prime - w) % prime : w, prime);
+	}
+
+	m_scale.assign(2 * ((size_t)n + 1), 0);
+	if (n >= k)
+	{
+		// Q(k) = k!, Q(x + 1) = Q(x) * (x + 1) / (x - d)
+		Enco::uint64 q = (Enco::uint64)fact[d] * k % prime;
+		for (unsigned int x = k; x <= n; ++x)
+		{
+			_Pair(&m_scale[2 * x], (Enco::uint32)q, prime);
+			q = q * (x + 1) % prime * _InvMod(x - d, prime) % prime;
+		}
+	}
+
+	for (int t = 0; t < 2; ++t)
+	{
+		const Enco::uint32 modulus = g_cnst_ntt_prime[t];
+		const Enco::uint32 root = _PowMod(g_cnst_ntt_root, (modulus - 1) / m_length, modulus);
+		const Enco::uint32 inverse = _InvMod(root, modulus);
+
+		m_roots[t].resize(m_length);
+		m_inverseRoots[t].resize(m_length);
+		Enco::uint64 r = 1;
+		Enco::uint64 ir = 1;
+		for (size_t j = 0; j < m_length / 2; ++j)
+		{
+			_Pair(&m_roots[t][2 * j], (Enco::uint32)r, modulus);
+			_Pair(&m_inverseRoots[t][2 * j], (Enco::uint32)ir, modulus);
+			r = r * root % modulus;
+			ir = ir * inverse % modulus;
+		}
+
+		const Enco::uint64			scale = _InvMod(m_length, modulus);
+		std::vector<Enco::uint32>	kernel(m_length, 0);
+		for (unsigned int x = 1; x <= n; ++x)
+		{
+			kernel[x] = _InvMod(x, prime);
+		}
+		_Transform(&kernel[0], m_length, &m_roots[t][0], modulus);
+
+		m_kernel[t].resize(2 * m_length);
+		for (size_t j = 0; j < m_length; ++j)
+		{
+			_Pair(&m_kernel[t][2 * j], (Enco::uint32)(kernel[j] * scale % modulus), modulus);
+		}
+	}
+}
+
+bool ProgressionEvaluator::Worthwhile(const unsigned int& n, const unsigned int& k)
+{
+	if (n < 2 * k)
+		return false;
+
+	size_t length = 1;
+	size_t stages = 0;
+	while (length < (size_t)n + k + 1)
+	{
+		length <<= 1;
+		++stages;
+	}
+
+	// four transforms of length / 2 * stages scalar butterflies against n * k
+	// vectorized multiply-adds; the factor was measured on the encode path.
+	return (Enco::uint64)n * k > (Enco::uint64)20 * length * stages;
+}
+
+void ProgressionEvaluator::Evaluate(const Enco::uint32 *pValues, Enco::uint32 *pOut, Enco::uint32 *pWork) const
+{
+	const unsigned int first = (m_n < m_k) ? m_n : m_k - 1;
+	for (unsigned int x = 1; x <= first; ++x)
+	{
+		pOut[x - 1] = pValues[x];
+	}
+	if (m_n < m_k)
+		return;
+
+	Enco::uint32* pLow = pWork;
+	Enco::uint32* pHigh = pWork + m_length;
+	for (unsigned int i = 0; i < m_k; ++i)
+	{
+		pLow[i] = pHigh[i] = _MulShoup(pValues[i], &m_weight[2 * i], m_prime);
+	}
+	memset(pLow + m_k, 0, sizeof(Enco::uint32) * (m_length - m_k));
+	memset(pHigh + m_k, 0, sizeof(Enco::uint32) * (m_length - m_k));
+
+	Enco::uint32* parts[2] = { pLow, pHigh };
+	for (int t = 0; t < 2; ++t)
+	{
+		const Enco::uint32	modulus = g_cnst_ntt_prime[t];
+		const Enco::uint32*	kernel = &m_kernel[t][0];
+		Enco::uint32*		a = parts[t];
+
+		_Transform(a, m_length, &m_roots[t][0], modulus);
+		for (size_t j = 0; j < m_length; ++j)
+		{
+			a[j] = _MulShoup(a[j], kernel + 2 * j, modulus);
+		}
+		_Transform(a, m_length, &m_inverseRoots[t][0], modulus);
+	}
+
+	// c = lo + p0 * ((hi - lo) / p0 mod p1), exact below p0 * p1.
+	const Enco::uint32	p0 = g_cnst_ntt_prime[0];
+	const Enco::uint32	p1 = g_cnst_ntt_prime[1];
+	Enco::uint32		bridge[2];
+	_Pair(bridge, _InvMod(p0 % p1, p1), p1);
+	for (unsigned int x = m_k; x <= m_n; ++x)
+	{
+		const Enco::uint32 lo = pLow[x];
+		const Enco::uint32 diff = (pHigh[x] >= lo % p1) ? pHigh[x] - lo % p1 : pHigh[x] + p1 - lo % p1;
+		const Enco::uint64 c = lo + (Enco::uint64)p0 * _MulShoup(diff, bridge, p1);
+		pOut[x - 1] = _MulShoup(_Reduce(c), &m_scale[2 * x], m_prime);
+	}
+}
+
+const size_t ProgressionEvaluator::WorkSize() const
+{
+	return 2 * m_length;
+}
+
+void ProgressionEvaluator::_Transform(Enco::uint32 *a, const size_t& length, const Enco::uint32 *roots, const Enco::uint32& modulus)
+{
+	// a local copy: a may alias the reference as far as the compiler knows.
+	const Enco::uint32 q = modulus;
+	const size_t size = length;
+	for (size_t i = 1, j = 0; i < size; ++i)
+	{
+		size_t bit = size >> 1;
+		for (; j & bit; bit >>= 1)
+		{
+			j ^= bit;
+		}
+		j ^= bit;
+
+		if (i < j)
+			std::swap(a[i], a[j]);
+	}
+
+	for (size_t len = 2; len <= size; len <<= 1)
+	{
+		const size_t half = len >> 1;
+		const size_t step = 2 * (size / len);
+		for (size_t i = 0; i < size; i += len)
+		{
+			const Enco::uint32* w = roots;
+			for (size_t j = 0; j < half; ++j, w += step)
+			{
+				const Enco::uint32 u = a[i + j];
+				const Enco::uint32 v = _MulShoup(a[i + j + half], w, q);
+				a[i + j] = (u + v >= q) ? u + v - q : u + v;
+				a[i + j + half] = (u >= v) ? u - v : u + q - v;
+			}
+		}
+	}
+}
+
+void ProgressionEvaluator::_Pair(Enco::uint32 *pair, const Enco::uint32& w, const Enco::uint32& modulus)
+{
+	pair[0] = w;
+	pair[1] = (Enco::uint32)(((Enco::uint64)w << 32) / modulus);
+}
+
+Enco::uint32 ProgressionEvaluator::_Reduce(const Enco::uint64& c) const
+{
+	// c < 2^59: the double quotient is off by a few units at most.
+	Enco::int64 r = (Enco::int64)(c - (Enco::uint64)((double)c * m_inversePrime) * m_prime);
+	while (r < 0)
+	{
+		r += m_prime;
+	}
+	while (r >= (Enco::int64)m_prime)
+	{
+		r -= m_prime;
+	}
+	return (Enco::uint32)r;
+}
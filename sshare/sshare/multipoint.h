@@ -0,0 +1,60 @@
+// multipoint.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(MULTIPOINT_H)
+#define MULTIPOINT_H
+
+/*
+* @class: ProgressionEvaluator
+*
+* @remarks: evaluates a polynomial of degree < k over GF(prime), given by its
+*           values at 0..k-1, at every share index 1..n. The indices form an
+*           arithmetic progression, so Lagrange extrapolation becomes one
+*           convolution, done with NTTs over two 30-bit primes and joined by
+*           CRT: O((n + k) log(n + k)) per polynomial instead of O(n * k).
+*/
+class ProgressionEvaluator
+{
+public:
+	ProgressionEvaluator(const Enco::uint32& prime, const unsigned int& n, const unsigned int& k);
+
+public:
+	/*
+	* @interface: Worthwhile
+	*
+	* @remarks: true when the transforms beat the direct n x k product.
+	*/
+	static bool			Worthwhile(const unsigned int& n, const unsigned int& k);
+
+	/*
+	* @interface: Evaluate
+	*
+	* @remarks: pValues holds P(0)..P(k-1), pOut receives P(1)..P(n). pWork
+	*           must hold WorkSize() words.
+	*/
+	void				Evaluate(const Enco::uint32 *pValues, Enco::uint32 *pOut, Enco::uint32 *pWork) const;
+
+	const size_t		WorkSize() const;
+
+private:
+	// every multiplier below is fixed, so it is stored next to its Shoup
+	// quotient floor(w * 2^32 / modulus): w * a mod modulus without a division.
+	static void			_Transform(Enco::uint32 *a, const size_t& length, const Enco::uint32 *roots, const Enco::uint32& modulus);
+	static void			_Pair(Enco::uint32 *pair, const Enco::uint32& w, const Enco::uint32& modulus);
+	Enco::uint32		_Reduce(const Enco::uint64& c) const;
+
+private:
+	Enco::uint32				m_prime;
+	double						m_inversePrime;
+	unsigned int				m_n;
+	unsigned int				m_k;
+	size_t						m_length;			// transform length, a power of 2 >= n + k
+	std::vector<Enco::uint32>	m_weight;			// (-1)^(k-1-i) / (i! (k-1-i)!), paired
+	std::vector<Enco::uint32>	m_scale;			// x (x-1) ... (x-k+1) for x = k..n, paired
+	std::vector<Enco::uint32>	m_kernel[2];		// transformed 1/t divided by m_length, paired
+	std::vector<Enco::uint32>	m_roots[2];			// paired
+	std::vector<Enco::uint32>	m_inverseRoots[2];	// paired
+};
+
+#endif
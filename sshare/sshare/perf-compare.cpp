@@ -0,0 +1,393 @@
+// perf-compare.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "cpu-features.h"
+#include "bench-harness.h"
+#include "perf-compare.h"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// PerfCompare
+
+const int PerfCompare::m_cnst_format_version = 1;
+
+namespace
+{
+	// no ties and both samples up to this size: the exact distribution is cheap.
+	const size_t g_cnst_exact_limit = 30;
+
+	std::vector<std::string> _Fields(const std::string& line, const char& separator)
+	{
+		std::vector<std::string>	fields;
+		std::stringstream			in(line);
+		std::string					field;
+		while (std::getline(in, field, separator))
+		{
+			fields.push_back(field);
+		}
+		return fields;
+	}
+
+	std::string _Trim(const std::string& text)
+	{
+		const size_t from = text.find_first_not_of(" \t\r");
+		const size_t to = text.find_last_not_of(" \t\r");
+		return (from == std::string::npos) ? std::string() : text.substr(from, to - from + 1);
+	}
+
+	double _Median(std::vector<double> values)
+	{
+		if (values.empty())
+			return 0;
+
+		std::sort(values.begin(), values.end());
+		const size_t half = values.size() / 2;
+		return (values.size() % 2 != 0) ? values[half] : (values[half - 1] + values[half]) / 2;
+	}
+
+	// P(U >= u) over all arrangements of m x's and n y's, U counting the pairs x > y.
+	double _ExactUpperTail(const size_t& m, const size_t& n, const double& u)
+	{
+		// ways[i][j][v]: arrangements of i x's and j y's with U = v. The largest of
+		// them is either an x, beating all j y's, or a y, beating nothing.
+		std::vector<std::vector<std::vector<double>>> ways(m + 1, std::vector<std::vector<double>>(n + 1));
+		for (size_t i = 0; i <= m; ++i)
+		{
+			for (size_t j = 0; j <= n; ++j)
+			{
+				ways[i][j].assign(i * j + 1, 0);
+				if (i == 0 || j == 0)
+				{
+					ways[i][j][0] = 1;
+					continue;
+				}
+				for (size_t v = 0; v <= i * j; ++v)
+				{
+					ways[i][j][v] = ((v >= j && v - j <= (i - 1) * j) ? ways[i - 1][j][v - j] : 0) +
+									((v <= i * (j - 1)) ? ways[i][j - 1][v] : 0);
+				}
+			}
+		}
+
+		double total = 0;
+		double tail = 0;
+		for (size_t v = 0; v <= m * n; ++v)
+		{
+			total += ways[m][n][v];
+			if ((double)v >= u - 1e-9)
+				tail += ways[m][n][v];
+		}
+		return tail / total;
+	}
+
+	const char* _OutcomeName(const PerfCompare::Outcome& outcome)
+	{
+		switch (outcome)
+		{
+		case PerfCompare::OUTCOME_FASTER:		return "faster";
+		case PerfCompare::OUTCOME_SLOWER:		return "slower";
+		case PerfCompare::OUTCOME_REGRESSED:	return "REGRESSED";
+		case PerfCompare::OUTCOME_MISSING:		return "missing";
+		case PerfCompare::OUTCOME_NEW:			return "new";
+		default:								return "same";
+		}
+	}
+}
+
+PerfCompare::PerfCompare() :
+m_threshold(0.05), m_alpha(0.01)
+{}
+
+bool PerfCompare::Parse(int& argc, char* argv[])
+{
+	int kept = 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg.compare(0, 7, "--save=") == 0)
+		{
+			m_saveFile = arg.substr(7);
+		}
+		else if (arg.compare(0, 8, "--label=") == 0)
+		{
+			m_label = arg.substr(8);
+		}
+		else if (arg.compare(0, 10, "--compare=") == 0)
+		{
+			m_baselineFile = arg.substr(10);
+		}
+		else if (arg.compare(0, 10, "--current=") == 0)
+		{
+			m_currentFile = arg.substr(10);
+		}
+		else if (arg.compare(0, 12, "--threshold=") == 0)
+		{
+			m_threshold = atof(arg.c_str() + 12) / 100.0;
+			if (m_threshold < 0)
+				return false;
+		}
+		else if (arg.compare(0, 8, "--alpha=") == 0)
+		{
+			m_alpha = atof(arg.c_str() + 8);
+			if (m_alpha <= 0 || m_alpha >= 1)
+				return false;
+		}
+		else
+		{
+			argv[kept++] = argv[i];
+		}
+	}
+	argc = kept;
+
+	// a saved run only means something next to a baseline.
+	return m_currentFile.empty() || false == m_baselineFile.empty();
+}
+
+const std::string& PerfCompare::SaveFile() const
+{
+	return m_saveFile;
+}
+
+const std::string& PerfCompare::BaselineFile() const
+{
+	return m_baselineFile;
+}
+
+const std::string& PerfCompare::CurrentFile() const
+{
+	return m_currentFile;
+}
+
+bool PerfCompare::Save(const std::string& fileName, const std::vector<BenchHarness::Result>& results) const
+{
+	std::ofstream out(fileName, std::ios::out | std::ios::trunc);
+	if (false == out.is_open())
+		return false;
+
+	char		created[64] = { 0 };
+	time_t		now = time(nullptr);
+	struct tm	local;
+#if defined(_WIN32)
+	localtime_s(&local, &now);
+#else
+	localtime_r(&now, &local);
+#endif
+	strftime(created, sizeof(created), "%Y-%m-%d %H:%M:%S", &local);
+
+	out << "# format: " << m_cnst_format_version << "\n"
+		<< "# label: " << (m_label.empty() ? std::string("unlabelled") : m_label) << "\n"
+		<< "# created: " << created << "\n"
+		<< "# machine: " << _Machine() << "\n";
+
+	BenchHarness harness;
+	for (const BenchHarness::Result& result : results)
+	{
+		harness.Add(result);
+	}
+	harness.ReportCsv(out);
+	return out.good();
+}
+
+bool PerfCompare::Load(const std::string& fileName, Baseline& baseline)
+{
+	std::ifstream in(fileName, std::ios::in);
+	if (false == in.is_open())
+		return false;
+
+	std::string	line;
+	bool		header = false;
+	while (std::getline(in, line))
+	{
+		line = _Trim(line);
+		if (line.empty())
+			continue;
+
+		if (line[0] == '#')
+		{
+			const size_t colon = line.find(':');
+			if (colon != std::string::npos)
+				baseline.info[_Trim(line.substr(1, colon - 1))] = _Trim(line.substr(colon + 1));
+			continue;
+		}
+
+		if (false == header)
+		{
+			// a plain --csv report has no format line, and is format 1.
+			if (line.compare(0, 5, "name,") != 0 || (baseline.info.count("format") != 0 && atoi(baseline.info["format"].c_str()) != m_cnst_format_version))
+				return false;
+			header = true;
+			continue;
+		}
+
+		const std::vector<std::string> fields = _Fields(line, ',');
+		if (fields.size() != 10)
+			return false;
+
+		BenchHarness::Result result;
+		result.name = fields[0];
+		result.bytesPerOp = (size_t)strtoull(fields[1].c_str(), nullptr, 10);
+		result.median = atof(fields[2].c_str());
+		result.mad = atof(fields[3].c_str());
+		result.mean = atof(fields[4].c_str());
+		result.outliers = (size_t)atoi(fields[5].c_str());
+		result.cyclesPerOp = atof(fields[6].c_str());
+		result.iterations = strtoull(fields[8].c_str(), nullptr, 10);
+		for (const std::string& sample : _Fields(fields[9], ' '))
+		{
+			if (false == sample.empty())
+				result.samples.push_back(atof(sample.c_str()));
+		}
+		if (result.samples.empty())
+			return false;
+		baseline.results.push_back(result);
+	}
+	return header;
+}
+
+std::vector<PerfCompare::Verdict> PerfCompare::Compare(const std::vector<BenchHarness::Result>& baseline, const std::vector<BenchHarness::Result>& current) const
+{
+	std::vector<Verdict>							verdicts;
+	std::map<std::string, const BenchHarness::Result*>	currents;
+	for (const BenchHarness::Result& result : current)
+	{
+		currents[result.name] = &result;
+	}
+
+	for (const BenchHarness::Result& base : baseline)
+	{
+		Verdict verdict = { base.name, _Median(base.samples), 0, 0, 1, 1, OUTCOME_MISSING };
+		const std::map<std::string, const BenchHarness::Result*>::iterator found = currents.find(base.name);
+		if (found != currents.end())
+		{
+			const BenchHarness::Result& result = *found->second;
+			verdict.current = _Median(result.samples);
+			verdict.change = (verdict.baseline > 0) ? verdict.current / verdict.baseline - 1 : 0;
+			verdict.pSlower = MannWhitney(result.samples, base.samples);
+			verdict.pFaster = MannWhitney(base.samples, result.samples);
+			if (verdict.pSlower < m_alpha && verdict.change > 0)
+				verdict.outcome = (verdict.change > m_threshold) ? OUTCOME_REGRESSED : OUTCOME_SLOWER;
+			else if (verdict.pFaster < m_alpha && verdict.change < 0)
+				verdict.outcome = OUTCOME_FASTER;
+			else
+				verdict.outcome = OUTCOME_SAME;
+			currents.erase(found);
+		}
+		verdicts.push_back(verdict);
+	}
+
+	for (const BenchHarness::Result& result : current)
+	{
+		if (currents.count(result.name) == 0)
+			continue;
+		Verdict verdict = { result.name, 0, _Median(result.samples), 0, 1, 1, OUTCOME_NEW };
+		verdicts.push_back(verdict);
+	}
+	return verdicts;
+}
+
+bool PerfCompare::Report(std::ostream& out, const std::vector<Verdict>& verdicts) const
+{
+	size_t counts[OUTCOME_NEW + 1] = { 0 };
+	out << std::left << std::setw(40) << "case" << std::right << std::setw(16) << "baseline ns/op" << std::setw(16) << "current ns/op"
+		<< std::setw(10) << "change" << std::setw(11) << "p" << "  verdict\n";
+	for (const Verdict& v : verdicts)
+	{
+		++counts[v.outcome];
+		out << std::left << std::setw(40) << v.name << std::right << std::fixed << std::setprecision(2);
+		if (v.outcome == OUTCOME_MISSING || v.outcome == OUTCOME_NEW)
+		{
+			out << std::setw(16) << v.baseline << std::setw(16) << v.current << std::setw(10) << "-" << std::setw(11) << "-";
+		}
+		else
+		{
+			out << std::setw(16) << v.baseline << std::setw(16) << v.current << std::setw(9) << std::showpos << v.change * 100 << std::noshowpos << "%"
+				<< std::setw(11) << std::setprecision(4) << ((v.change > 0) ? v.pSlower : v.pFaster);
+		}
+		out << "  " << _OutcomeName(v.outcome) << "\n";
+	}
+
+	out << counts[OUTCOME_REGRESSED] << " regressed beyond " << std::setprecision(1) << m_threshold * 100 << "%, "
+		<< counts[OUTCOME_SLOWER] << " slower, " << counts[OUTCOME_FASTER] << " faster, " << counts[OUTCOME_SAME] << " same, "
+		<< counts[OUTCOME_MISSING] << " missing, " << counts[OUTCOME_NEW] << " new (alpha " << std::setprecision(3) << m_alpha << ")" << std::endl;
+	return counts[OUTCOME_REGRESSED] != 0;
+}
+
+double PerfCompare::MannWhitney(const std::vector<double>& x, const std::vector<double>& y)
+{
+	const size_t m = x.size();
+	const size_t n = y.size();
+	if (m == 0 || n == 0)
+		return 1;
+
+	// midranks of the pooled samples.
+	std::vector<std::pair<double, bool>> pooled;
+	for (double v : x)
+	{
+		pooled.push_back(std::make_pair(v, true));
+	}
+	for (double v : y)
+	{
+		pooled.push_back(std::make_pair(v, false));
+	}
+	std::sort(pooled.begin(), pooled.end());
+
+	double	rankSum = 0;
+	double	tieTerm = 0;
+	bool	ties = false;
+	for (size_t i = 0; i < pooled.size();)
+	{
+		size_t j = i;
+		while (j < pooled.size() && pooled[j].first == pooled[i].first)
+		{
+			++j;
+		}
+		const double rank = (i + 1 + j) / 2.0;
+		const double t = (double)(j - i);
+		for (size_t r = i; r < j; ++r)
+		{
+			if (pooled[r].second)
+				rankSum += rank;
+		}
+		tieTerm += t * t * t - t;
+		ties = ties || (t > 1);
+		i = j;
+	}
+
+	const double u = rankSum - m * (m + 1) / 2.0;
+	if (false == ties && m <= g_cnst_exact_limit && n <= g_cnst_exact_limit)
+		return _ExactUpperTail(m, n, u);
+
+	const double N = (double)(m + n);
+	const double mu = m * n / 2.0;
+	const double sigma = sqrt(m * n / 12.0 * ((N + 1) - tieTerm / (N * (N - 1))));
+	if (sigma <= 0)
+		return 1;
+	const double z = (u - mu - 0.5) / sigma;
+	return 0.5 * erfc(z / sqrt(2.0));
+}
+
+std::string PerfCompare::_Machine() const
+{
+	std::string machine = std::to_string(std::thread::hardware_concurrency()) + " threads";
+	if (CpuFeatures::AesNi())
+		machine += ", aesni";
+	if (CpuFeatures::Ssse3())
+		machine += ", ssse3";
+	if (CpuFeatures::Sse42())
+		machine += ", sse4.2";
+	if (CpuFeatures::Avx2())
+		machine += ", avx2";
+#if defined(_MSC_VER)
+	machine += ", msvc " + std::to_string(_MSC_VER);
+#elif defined(__VERSION__)
+	machine += std::string(", ") + __VERSION__;
+#endif
+	return machine;
+}
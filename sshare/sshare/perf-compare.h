@@ -0,0 +1,100 @@
+// perf-compare.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(PERF_COMPARE_H)
+#define PERF_COMPARE_H
+
+/*
+* @class: PerfCompare
+*
+* @remarks: the regression gate of sshare-bench. Saves a run as a baseline
+*           file, or compares a run with one: a case regressed when its
+*           repetitions are slower than the baseline's with a one-sided
+*           Mann-Whitney p below m_alpha AND its median is more than
+*           m_threshold slower. Both sides should be run with the same
+*           --reps and --min-time, on the same machine.
+*
+*           A baseline is the --csv report of BenchHarness under a few
+*           "# key: value" lines: the file format version, a label naming
+*           the code it was taken from, the time and the machine.
+*/
+class PerfCompare
+{
+public:
+	enum Outcome
+	{
+		OUTCOME_SAME,		// no significant difference
+		OUTCOME_FASTER,
+		OUTCOME_SLOWER,		// significant, within the threshold
+		OUTCOME_REGRESSED,
+		OUTCOME_MISSING,	// in the baseline only
+		OUTCOME_NEW			// in the run only
+	};
+
+	struct Verdict
+	{
+		std::string		name;
+		double			baseline;		// median ns/op
+		double			current;
+		double			change;			// current / baseline - 1
+		double			pSlower;		// one-sided p values
+		double			pFaster;
+		Outcome			outcome;
+	};
+
+	struct Baseline
+	{
+		std::map<std::string, std::string>	info;		// the "# key: value" lines
+		std::vector<BenchHarness::Result>	results;
+	};
+
+public:
+	PerfCompare();
+
+public:
+	/*
+	* @interface: Parse
+	*
+	* @remarks: takes its options out of argv, as BenchHarness::Parse() does:
+	*           --save=file, --label=text, --compare=file, --current=file,
+	*           --threshold=percent, --alpha=p. false on a malformed one.
+	*/
+	bool					Parse(int& argc, char* argv[]);
+
+	const std::string&		SaveFile() const;
+	const std::string&		BaselineFile() const;
+	const std::string&		CurrentFile() const;		// a saved run to compare instead of running
+
+	bool					Save(const std::string& fileName, const std::vector<BenchHarness::Result>& results) const;
+	static bool				Load(const std::string& fileName, Baseline& baseline);
+
+	std::vector<Verdict>	Compare(const std::vector<BenchHarness::Result>& baseline, const std::vector<BenchHarness::Result>& current) const;
+
+	// a table of the verdicts and a summary line. true if any case regressed.
+	bool					Report(std::ostream& out, const std::vector<Verdict>& verdicts) const;
+
+	/*
+	* @interface: MannWhitney
+	*
+	* @remarks: the one-sided p value of "x tends to be larger than y". Exact
+	*           for small samples without ties, the normal approximation with
+	*           tie and continuity corrections otherwise.
+	*/
+	static double			MannWhitney(const std::vector<double>& x, const std::vector<double>& y);
+
+	static const int		m_cnst_format_version;
+
+private:
+	std::string				_Machine() const;
+
+private:
+	std::string		m_saveFile;
+	std::string		m_label;
+	std::string		m_baselineFile;
+	std::string		m_currentFile;
+	double			m_threshold;	// fraction, 0.05 for 5%
+	double			m_alpha;
+};
+
+#endif
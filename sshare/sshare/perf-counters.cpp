@@ -0,0 +1,193 @@
+// perf-counters.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "perf-counters.h"
+
+#if defined(__linux__)
+#	include <errno.h>
+#	include <string.h>
+#	include <unistd.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <linux/perf_event.h>
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// PerfCounters
+
+namespace
+{
+#if defined(__linux__)
+	struct Event
+	{
+		Enco::uint32	type;
+		Enco::uint64	config;
+	};
+
+	// in PerfCounters::Counter order; the first leads the group.
+	const Event g_cnst_events[PerfCounters::COUNTER_COUNT] =
+	{
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+		{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) }
+	};
+
+	int _Open(const Event& event, const int& leader)
+	{
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = event.type;
+		attr.config = event.config;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.disabled = (leader == -1) ? 1 : 0;		// the group starts once complete
+		attr.exclude_kernel = 1;					// allowed up to perf_event_paranoid 2
+		attr.exclude_hv = 1;
+
+		// this thread, any cpu.
+		return (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+	}
+
+	// what the leader's errno means for whoever reads the report.
+	std::string _Why(const int& error)
+	{
+		std::string why = std::string("perf_event_open: ") + strerror(error);
+		switch (error)
+		{
+		case ENOENT:
+		case EOPNOTSUPP:
+		case ENODEV:
+			why += " (no hardware PMU here, typical of VMs and containers)";
+			break;
+		case EACCES:
+		case EPERM:
+			why += " (see /proc/sys/kernel/perf_event_paranoid, or a seccomp filter)";
+			break;
+		case ENOSYS:
+			why += " (kernel built without perf events)";
+			break;
+		}
+		return why;
+	}
+#endif
+}
+
+PerfCounters::PerfCounters() :
+m_opened(0)
+{
+	for (int c = 0; c < COUNTER_COUNT; ++c)
+	{
+		m_fds[c] = -1;
+		m_slots[c] = -1;
+	}
+
+#if defined(__linux__)
+	m_fds[COUNTER_CYCLES] = _Open(g_cnst_events[COUNTER_CYCLES], -1);
+	if (m_fds[COUNTER_CYCLES] == -1)
+	{
+		m_reason = _Why(errno);
+		return;
+	}
+	m_slots[COUNTER_CYCLES] = m_opened++;
+
+	std::string missing;
+	for (int c = COUNTER_CYCLES + 1; c < COUNTER_COUNT; ++c)
+	{
+		m_fds[c] = _Open(g_cnst_events[c], m_fds[COUNTER_CYCLES]);
+		if (m_fds[c] == -1)
+		{
+			missing += std::string(missing.empty() ? "" : ", ") + CounterName((Counter)c);
+			continue;
+		}
+		m_slots[c] = m_opened++;
+	}
+	if (false == missing.empty())
+		m_reason = "not counted: " + missing;
+
+	ioctl(m_fds[COUNTER_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(m_fds[COUNTER_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+	m_reason = "not supported on this platform";
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+	// the members first, the leader last.
+	for (int c = COUNTER_COUNT - 1; c >= 0; --c)
+	{
+		if (m_fds[c] != -1)
+			close(m_fds[c]);
+	}
+#endif
+}
+
+bool PerfCounters::Available() const
+{
+	return m_opened != 0;
+}
+
+bool PerfCounters::Has(const Counter& counter) const
+{
+	return counter >= 0 && counter < COUNTER_COUNT && m_slots[counter] != -1;
+}
+
+const std::string& PerfCounters::Reason() const
+{
+	return m_reason;
+}
+
+bool PerfCounters::Read(Sample& sample) const
+{
+	memset(&sample, 0, sizeof(sample));
+	if (false == Available())
+		return false;
+
+#if defined(__linux__)
+	// { nr, time_enabled, time_running, value[nr] }
+	Enco::uint64 data[3 + COUNTER_COUNT] = { 0 };
+	const ssize_t got = read(m_fds[COUNTER_CYCLES], data, sizeof(data));
+	if (got < (ssize_t)(3 * sizeof(Enco::uint64)) || data[0] != (Enco::uint64)m_opened || data[2] == 0)
+		return false;
+
+	// multiplexed: counted data[2] of data[1] ns.
+	const double scale = (data[2] < data[1]) ? (double)data[1] / data[2] : 1.0;
+	for (int c = 0; c < COUNTER_COUNT; ++c)
+	{
+		if (m_slots[c] != -1)
+			sample.values[c] = (Enco::uint64)(data[3 + m_slots[c]] * scale);
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+const char* PerfCounters::CounterName(const Counter& counter)
+{
+	static const char* const names[COUNTER_COUNT] = { "cycles", "instructions", "cache_misses", "branch_misses", "dtlb_misses" };
+	return (counter >= 0 && counter < COUNTER_COUNT) ? names[counter] : "";
+}
+
+PerfCounters& PerfCounters::ThreadLocal()
+{
+	thread_local PerfCounters counters;
+	return counters;
+}
+
+PerfCounters::Sample PerfCounters::Delta(const Sample& from, const Sample& to)
+{
+	Sample delta;
+	for (int c = 0; c < COUNTER_COUNT; ++c)
+	{
+		delta.values[c] = (to.values[c] > from.values[c]) ? to.values[c] - from.values[c] : 0;
+	}
+	return delta;
+}
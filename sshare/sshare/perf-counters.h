@@ -0,0 +1,74 @@
+// perf-counters.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(PERF_COUNTERS_H)
+#define PERF_COUNTERS_H
+
+/*
+* @class: PerfCounters
+*
+* @remarks: the hardware counters of the calling thread, through one
+*           perf_event_open group led by the cycle counter, user space only.
+*           The group is scheduled on the PMU as a whole, so the counters of
+*           a sample are of the same instructions; when the PMU multiplexes,
+*           the values are scaled by enabled / running time.
+*
+*           Counters the CPU lacks are left out of the group; when the leader
+*           cannot be opened (no PMU in the VM or container, a seccomp filter,
+*           perf_event_paranoid, not Linux) nothing is available and Reason()
+*           says why. Nothing ever fails because of the counters.
+*
+*           The counters belong to the thread that built the object and count
+*           that thread only: use ThreadLocal() from any other.
+*/
+class PerfCounters
+{
+public:
+	enum Counter
+	{
+		COUNTER_CYCLES,
+		COUNTER_INSTRUCTIONS,
+		COUNTER_CACHE_MISSES,		// last level
+		COUNTER_BRANCH_MISSES,
+		COUNTER_DTLB_MISSES,		// loads
+		COUNTER_COUNT
+	};
+
+	struct Sample
+	{
+		Enco::uint64	values[COUNTER_COUNT];	// running totals, 0 for a counter not available
+	};
+
+public:
+	PerfCounters();
+	~PerfCounters();
+
+	// deleted:
+	PerfCounters(const PerfCounters& counters) = delete;
+	PerfCounters& operator=(const PerfCounters& counters) = delete;
+
+public:
+	bool					Available() const;
+	bool					Has(const Counter& counter) const;
+	const std::string&		Reason() const;		// empty while every counter is there
+
+	// the totals so far; false, and zeros, when nothing is available.
+	bool					Read(Sample& sample) const;
+
+	static const char*		CounterName(const Counter& counter);
+
+	// the counters of the calling thread, opened at its first call.
+	static PerfCounters&	ThreadLocal();
+
+	// to - from, counter by counter.
+	static Sample			Delta(const Sample& from, const Sample& to);
+
+private:
+	int				m_fds[COUNTER_COUNT];		// -1 when not opened
+	int				m_slots[COUNTER_COUNT];		// place in the group read, -1 when not opened
+	int				m_opened;
+	std::string		m_reason;
+};
+
+#endif
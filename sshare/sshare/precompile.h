@@ -7,29 +7,101 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <map>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <array>
+#include <deque>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <memory>
 
 #include <time.h>
-#include <guiddef.h>
-#include <comdef.h>
+#include <string.h>
+#include <stdint.h>
+#if defined(_WIN32)
+#	include <winsock2.h>	// before windows.h pulls in winsock.h
+#	include <guiddef.h>
+#	include <comdef.h>
+#else
+typedef struct _GUID
+{
+	uint32_t		Data1;
+	unsigned short	Data2;
+	unsigned short	Data3;
+	unsigned char	Data4[8];
+} GUID;
+
+long CoCreateGuid(GUID * const pGuid);		// cipher.cpp, a v4 GUID from SystemRandom
+#endif
+
+#if !defined(_MSC_VER)
+#	define abstract
+#endif
+
+#if defined(__cpp_impl_coroutine)
+#	include <coroutine>
+#	define ENCO_COROUTINES
+#endif
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#	include <emmintrin.h>
+#	define ENCO_SSE2
+#endif
+
+#if defined(_MSC_VER) || defined(__SSSE3__)
+#	include <tmmintrin.h>
+#	define ENCO_SSSE3
+#endif
+
+#if defined(_MSC_VER) || defined(__SSE4_2__)
+#	include <nmmintrin.h>
+#	define ENCO_SSE42
+#endif
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#	define ENCO_AVX2
+#endif
+
+#if defined(_MSC_VER) || defined(__AES__)
+#	include <wmmintrin.h>
+#	define ENCO_AESNI
+#endif
 
 #include "../../inc/sha2-lib/sha2.h"
 
+#if defined(_WIN32) && !defined(_x64)	// aes128-lib is only shipped for 32-bits windows
+extern "C" {
+#	include "../../inc/aes128-lib/aes.h"
+}
+#	define ENCO_AES128_LIB
+#endif
+
 
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 // !!!        DON NOT USE 32-BITs MOD SO FAR        !!!
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
 
-#if defined(_DEBUG)	// Debug
-#	if !defined(_x64)	// 32-bits
-#		pragma comment(lib, "../../bin/sha2-lib_d.lib")
-#	else				// 64-bits
-#		pragma comment(lib, "../../bin/sha2-lib_x64_d.lib")
-#	endif
-#else				// Release
-#	if !defined(_x64)	// 32-bits
-#		pragma comment(lib, "../../bin/sha2-lib.lib")
-#	else				// 64-bits
-#		pragma comment(lib, "../../bin/sha2-lib_x64.lib")
+// bin/ only holds the msvc builds; elsewhere sha2-lib is compiled in, see CMakeLists.txt.
+#if defined(_MSC_VER)
+#	if defined(_DEBUG)	// Debug
+#		if !defined(_x64)	// 32-bits
+#			pragma comment(lib, "../../bin/sha2-lib_d.lib")
+#			pragma comment(lib, "../../bin/aes128-lib_d.lib")
+#		else				// 64-bits
+#			pragma comment(lib, "../../bin/sha2-lib_x64_d.lib")
+#		endif
+#	else				// Release
+#		if !defined(_x64)	// 32-bits
+#			pragma comment(lib, "../../bin/sha2-lib.lib")
+#			pragma comment(lib, "../../bin/aes128-lib.lib")
+#		else				// 64-bits
+#			pragma comment(lib, "../../bin/sha2-lib_x64.lib")
+#		endif
 #	endif
 #endif
\ No newline at end of file
@@ -5,32 +5,175 @@
 
 #include "precompile.h"
 #include "datatypes.h"
+#include "allocator.h"
+#include "buffer.h"
+#include "cipher.h"
+#include "dispersal.h"
+#include "multipoint.h"
+#include "field.h"
+#include "checksum.h"
+#include "perf-counters.h"
+#include "share-stats.h"
 #include "secret-share.h"
 
+namespace
+{
+	// the system generator behind the Randomer interface, for the few draws
+	// that protect a key; Failed() tells whether any of them came back empty.
+	class SystemRandomer : public Randomer
+	{
+	public:
+		SystemRandomer() :
+		m_failed(false)
+		{}
+
+		virtual int Random() const override
+		{
+			Enco::uint32 value = 0;
+			if (false == SystemRandom::Fill(&value, sizeof(value)))
+				m_failed = true;
+			return (int)(value & 0x7FFFFFFF);
+		}
+
+		virtual bool Failed() const override
+		{
+			return m_failed;
+		}
+
+	private:
+		mutable bool	m_failed;
+	};
+
+	// the share headers are not covered by any code, so a correcting decode trusts
+	// the header most shares agree on. The 4-byte index at indexOffset may differ.
+	bool _SameHeader(const BufferView& a, const BufferView& b, const size_t& headerSize, const size_t& indexOffset)
+	{
+		if (a.Size() != b.Size() || a.Size() < headerSize)
+			return false;
+
+		if (indexOffset >= headerSize)
+			return memcmp(a.Data(), b.Data(), headerSize) == 0;
+
+		return memcmp(a.Data(), b.Data(), indexOffset) == 0 &&
+			memcmp(a.Data() + indexOffset + 4, b.Data() + indexOffset + 4, headerSize - indexOffset - 4) == 0;
+	}
+
+	size_t _MajorityHeader(const std::vector<BufferView>& shares, const size_t& headerSize, const size_t& indexOffset)
+	{
+		size_t best = 0;
+		size_t bestVotes = 0;
+		for (size_t i = 0; i < shares.size(); ++i)
+		{
+			size_t votes = 0;
+			for (size_t j = 0; j < shares.size(); ++j)
+			{
+				if (_SameHeader(shares[i], shares[j], headerSize, indexOffset))
+					++votes;
+			}
+
+			if (votes > bestVotes)
+			{
+				best = i;
+				bestVotes = votes;
+			}
+		}
+		return best;
+	}
+}
+
 // //////////////////////////////////////////////////////////////////////////////////////////////
 // DefaultRandomer
-DefaultRandomer::DefaultRandomer()
+namespace
+{
+	// the process stream: SystemRandom is asked once, every DefaultRandomer then
+	// takes its key and nonce from a slice of its own.
+	bool _DeriveKey(Enco::byte * const pOut, const size_t& size)
+	{
+		static const KeyedStream			s_process;
+		static std::atomic<Enco::uint64>	s_offset(0);
+
+		Aes128Ctr const* const pStream = s_process.Stream();
+		if (pStream == nullptr)
+			return false;
+
+		memset(pOut, 0, size);
+		pStream->Apply(pOut, pOut, size, s_offset.fetch_add(size));
+		return true;
+	}
+}
+
+DefaultRandomer::DefaultRandomer() :
+m_pStream(nullptr), m_offset(0), m_used(sizeof(m_block)), m_failed(false)
+{
+	Enco::byte keyMaterial[24];
+	if (_DeriveKey(keyMaterial, Aes128Ctr::m_cnst_key_size + Aes128Ctr::m_cnst_nonce_size))
+	{
+		m_pStream = new Aes128Ctr(keyMaterial, keyMaterial + Aes128Ctr::m_cnst_key_size);
+	}
+	memset(keyMaterial, 0, sizeof(keyMaterial));
+
+	// without AES every block comes from the system generator: draw the first
+	// now, so a sharer sees Failed() before it starts.
+	if (m_pStream == nullptr)
+	{
+		_Refill();
+	}
+}
+
+DefaultRandomer::~DefaultRandomer()
 {
-	srand((unsigned int)time(nullptr));
+	delete m_pStream;
+	memset(m_block, 0, sizeof(m_block));
 }
 
 int DefaultRandomer::Random() const
 {
-	return rand();
+	if (m_used == sizeof(m_block))
+	{
+		_Refill();
+	}
+	return m_block[m_used++];
+}
+
+bool DefaultRandomer::Failed() const
+{
+	return m_failed;
+}
+
+void DefaultRandomer::_Refill() const
+{
+	if (m_pStream != nullptr)
+	{
+		memset(m_block, 0, sizeof(m_block));
+		m_pStream->Apply(m_block, m_block, sizeof(m_block), m_offset);
+		m_offset += sizeof(m_block);
+	}
+	else if (false == SystemRandom::Fill(m_block, sizeof(m_block)))
+	{
+		// no stand-in generator: the block is zeros and whoever drew from it
+		// has to fail.
+		memset(m_block, 0, sizeof(m_block));
+		m_failed = true;
+	}
+	m_used = 0;
 }
 
 // //////////////////////////////////////////////////////////////////////////////////////////////
 // FixedBuffer
 
 FixedBuffer::FixedBuffer(const size_t& sizeInBytes) :
-m_size(sizeInBytes), m_pData(new Enco::byte[sizeInBytes])
+m_size(sizeInBytes), m_pData(static_cast<Enco::byte*>(AlignedAllocator::Allocate(sizeInBytes)))
+{}
+
+FixedBuffer::FixedBuffer(OwnedBuffer&& buffer) :
+m_size(buffer.Size()), m_pData(buffer.Release())
 {}
 
 FixedBuffer::~FixedBuffer()
 {
 	if (m_pData != nullptr)
 	{
-		delete[] m_pData;
+		AlignedAllocator::Free(m_pData);
 	}
 }
 
@@ -58,10 +201,142 @@ void* FixedBuffer::Buffer() const
 	return m_pData;
 }
 
+BufferView FixedBuffer::View() const
+{
+	return BufferView(m_pData, m_size);
+}
+
+MutableBufferView FixedBuffer::MutableView() const
+{
+	return MutableBufferView(m_pData, m_size);
+}
+
 
 // //////////////////////////////////////////////////////////////////////////////////////////////
 // SecretSharer
 
+bool SecretSharer::Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets)
+{
+	recoverdSecrets.clear();
+
+	if (sharedSecrets.size() <= 0)
+		return false;
+
+	OwnedBuffer recovered(DecodedSize(sharedSecrets[0]));
+	if (false == Decode(recovered.MutableView(), sharedSecrets))
+		return false;
+
+	recoverdSecrets.push_back(std::move(recovered));
+	return true;
+}
+
+bool SecretSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares)
+{
+	badShares.clear();
+	return Decode(recoverdSecret, sharedSecrets);
+}
+
+bool SecretSharer::Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index)
+{
+	return false;
+}
+
+bool SecretSharer::Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k)
+{
+	return false;
+}
+
+size_t SecretSharer::ResharedSize(const BufferView& sharedSecret, const unsigned int& n, const unsigned int& k) const
+{
+	return EncodedSize(DecodedSize(sharedSecret), n, k);
+}
+
+bool SecretSharer::Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets)
+{
+	return false;
+}
+
+size_t SecretSharer::WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const
+{
+	symbolSize = 0;
+	return 0;
+}
+
+bool SecretSharer::Encode(std::vector<OwnedBuffer>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	sharedSecrets.clear();
+
+	const size_t					shareSize = EncodedSize(secretToShare.Size(), n, k);
+	std::vector<MutableBufferView>	views;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		sharedSecrets.push_back(OwnedBuffer(shareSize));
+		views.push_back(sharedSecrets.back().MutableView());
+	}
+
+	if (false == Encode(views, n, k, secretToShare))
+	{
+		sharedSecrets.clear();
+		return false;
+	}
+	return true;
+}
+
+bool SecretSharer::Encode(ShareMatrix& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	sharedSecrets = ShareMatrix(n, EncodedSize(secretToShare.Size(), n, k));
+
+	if (false == Encode(sharedSecrets.RowViews(), n, k, secretToShare))
+	{
+		sharedSecrets = ShareMatrix();
+		return false;
+	}
+	return true;
+}
+
+bool SecretSharer::Encode(std::vector<FixedBuffer*>& sharedSecrets, const unsigned int& n, const unsigned int& k, const FixedBuffer& secretToShare)
+{
+	// release the possible trash data.
+	ReleaseSharedSecrets(sharedSecrets);
+	sharedSecrets.clear();
+
+	const size_t					shareSize = EncodedSize(secretToShare.Size(), n, k);
+	std::vector<MutableBufferView>	views;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		FixedBuffer* pBuf = new FixedBuffer(shareSize);
+		sharedSecrets.push_back(pBuf);
+		views.push_back(pBuf->MutableView());
+	}
+
+	if (false == Encode(views, n, k, secretToShare.View()))
+	{
+		ReleaseSharedSecrets(sharedSecrets);
+		sharedSecrets.clear();
+		return false;
+	}
+	return true;
+}
+
+bool SecretSharer::Decode(std::vector<FixedBuffer*>& recoverdSecrets, const std::vector<FixedBuffer*>& sharedSecrets)
+{
+	std::vector<BufferView>		views;
+	for (FixedBuffer* pSec : sharedSecrets)
+	{
+		views.push_back(pSec->View());
+	}
+
+	std::vector<OwnedBuffer>	recovered;
+	if (false == Decode(recovered, views))
+		return false;
+
+	for (OwnedBuffer& buf : recovered)
+	{
+		recoverdSecrets.push_back(new FixedBuffer(std::move(buf)));
+	}
+	return true;
+}
+
 void SecretSharer::ReleaseSharedSecrets(std::vector<FixedBuffer*>& sharedSecrets)
 {
 	std::vector<FixedBuffer*>::iterator iter;
@@ -80,13 +355,26 @@ void SecretSharer::ReleaseSharedSecrets(std::vector<FixedBuffer*>& sharedSecrets
 // //////////////////////////////////////////////////////////////////////////////////////////////
 // DefaultSecretSharer
 
-const Enco::uint32 DefaultSecretSharer::m_cnst_shamir_threshold = ((Enco::uint32)65262);
-const Enco::uint32 DefaultSecretSharer::m_cnst_shamir_prime = ((Enco::uint32)65809);
+const Enco::uint32 DefaultSecretSharer::m_cnst_shamir_prime = ((Enco::uint32)ShamirField::Order());
+const size_t DefaultSecretSharer::m_cnst_decode_tile_bytes = ((size_t)128 << 10);
+const size_t DefaultSecretSharer::m_cnst_encode_tile_bytes = ((size_t)64 << 10);
 
 DefaultSecretSharer::DefaultSecretSharer(const Randomer& randomer) :
 m_randomer(randomer)
 {}
 
+size_t DefaultSecretSharer::EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const
+{
+	return secretSize * 4 + sizeof(Enco::uint32) + 32;
+}
+
+size_t DefaultSecretSharer::DecodedSize(const BufferView& sharedSecret) const
+{
+	if (sharedSecret.Size() < sizeof(Enco::uint32) + 32)
+		return 0;
+	return (sharedSecret.Size() - sizeof(Enco::uint32) - 32) / 4;
+}
+
 /*
 * @implementation: Encode
 * @description:
@@ -97,50 +385,148 @@ m_randomer(randomer)
 *   |  * secret data    [  x bytes ]         |
 *   ------------------------------------------
 */
-bool DefaultSecretSharer::Encode(std::vector<FixedBuffer*>& sharedSecrets, const unsigned int& n, const unsigned int& k, const FixedBuffer& secretToShare)
+bool DefaultSecretSharer::Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
 {
-	// release the possible trash data.
-	ReleaseSharedSecrets(sharedSecrets);
+	if (n == 0 || k == 0 || k > n || n >= m_cnst_shamir_prime || sharedSecrets.size() < n)
+		return false;
 
 	// fetch the size of origin secret to share.
 	size_t originSize = secretToShare.Size();
+	size_t shareSize = DefaultSecretSharer::EncodedSize(originSize, n, k);
+	for (Enco::uint32 i = 0; i < n; ++i)
+	{
+		if (sharedSecrets[i].Size() < shareSize)
+			return false;
+	}
 	
 	// calculate hash value
 	unsigned char hash_value[32] = { 0 };
-	sha256((const unsigned char*)secretToShare.Buffer(), (unsigned int)secretToShare.Size(), hash_value);
+	{
+		ShareStats::Scope stage(ShareStats::STAGE_HASH, originSize);
+		sha256(secretToShare.Data(), (unsigned int)originSize, hash_value);
+	}
 	
 	// prepare the buffers to catch secrets
-	for (Enco::uint32 i = 0; i < n; ++i)
 	{
-		FixedBuffer*	pBuf = new FixedBuffer(originSize * 4 + sizeof(Enco::uint32) + 32);
-		Enco::uint32	sidx = i + 1;
-		sharedSecrets.push_back(pBuf);
-		pBuf->Write(0, &sidx, sizeof(Enco::uint32));		// record sequence
-		pBuf->Write(sizeof(Enco::uint32), hash_value, 32);	// record hash
+		ShareStats::Scope stage(ShareStats::STAGE_FRAME);
+		for (Enco::uint32 i = 0; i < n; ++i)
+		{
+			Enco::uint32	sidx = i + 1;
+			sharedSecrets[i].Write(0, &sidx, sizeof(Enco::uint32));		// record sequence
+			sharedSecrets[i].Write(sizeof(Enco::uint32), hash_value, 32);	// record hash
+		}
 	}
 
-	// loop each bytes
-	Enco::byte const*	pChar = static_cast<Enco::byte const*>(secretToShare.Buffer());
-	Enco::uint32*		pShrs = new Enco::uint32[n];
-	const size_t		soff = sizeof(Enco::uint32) + 32;
-	for (size_t idx = 0; idx < originSize; ++idx)
+	return _EncodeSymbols(sharedSecrets, sizeof(Enco::uint32) + 32, n, k, secretToShare);
+}
+
+bool DefaultSecretSharer::_EncodeSymbols(const std::vector<MutableBufferView>& sharedSecrets, const size_t& soff, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	// coefficients drawn from a failed randomer are not random: refuse to
+	// start, and report a failure that came up half way.
+	if (m_randomer.Failed())
+		return false;
+
+	if (ProgressionEvaluator::Worthwhile(n, k))
+		return _EncodeProgression(sharedSecrets, soff, n, k, secretToShare) && false == m_randomer.Failed();
+
+	// work in input blocks: draw the coefficients of a whole block, then
+	// evaluate every share over it while the coefficients are still in cache.
+	ScratchScope		scratch(ScratchArena::ThreadLocal());
+	size_t				block = m_cnst_encode_tile_bytes / sizeof(Enco::uint32) / k;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*		pCoef = scratch.Arena().Allocate<Enco::uint32>(block * k);
+	Enco::uint32*		pPower = scratch.Arena().Allocate<Enco::uint32>(k);
+	Enco::uint64*		pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*		pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+	Enco::byte const*	pChar = secretToShare.Data();
+	const size_t		originSize = secretToShare.Size();
+	for (size_t base = 0; base < originSize; base += block)
 	{
-		Enco::uint32 sec = *pChar;
-		++pChar;
+		const size_t count = (originSize - base < block) ? originSize - base : block;
 
-		_Encode(sec, n, k, m_randomer, pShrs);
+		// row c of the tile holds coefficient c of every byte, drawn in the same
+		// order as the per-byte _Encode() so both paths agree for one randomer.
+		{
+			ShareStats::Scope stage(ShareStats::STAGE_RANDOM, sizeof(Enco::uint32) * count * (k - 1));
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				pCoef[idx] = pChar[base + idx];
+				for (unsigned int c = 1; c < k; ++c)
+				{
+					pCoef[block * c + idx] = _RandomCoefficient(m_randomer);
+				}
+			}
+		}
 
-		for (unsigned int i = 0; i < n; ++i)
+		ShareStats::Scope stage(ShareStats::STAGE_MATH, count);
+		for (Enco::uint32 x = 1; x <= n; ++x)
 		{
-			sharedSecrets[i]->Write(sizeof(Enco::uint32)*idx + soff, &(pShrs[i]), sizeof(Enco::uint32));
+			pPower[0] = 1;
+			for (unsigned int c = 1; c < k; ++c)
+			{
+				pPower[c] = _Multiply(pPower[c - 1], x);
+			}
+
+			_CombineBlock(pCoef, block, pPower, (int)k, count, pAcc, pRow);
+			sharedSecrets[x - 1].Write(sizeof(Enco::uint32) * base + soff, pRow, sizeof(Enco::uint32) * count);
 		}
 	}
 
-	delete[] pShrs;
+	return false == m_randomer.Failed();
+}
 
-	if (sharedSecrets.size() > 0)
-		return true;
-	return false;
+bool DefaultSecretSharer::_EncodeProgression(const std::vector<MutableBufferView>& sharedSecrets, const size_t& soff, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	// the polynomial of a byte is fixed by P(0) = byte and P(1)..P(k-1) drawn
+	// uniformly, which is the same distribution as uniform coefficients. The
+	// first k-1 shares are those draws, the evaluator extrapolates the rest.
+	const ProgressionEvaluator	evaluator(m_cnst_shamir_prime, n, k);
+	const size_t				originSize = secretToShare.Size();
+
+	ScratchScope		scratch(ScratchArena::ThreadLocal());
+	size_t				block = m_cnst_encode_tile_bytes / sizeof(Enco::uint32) / n;
+	block = (block < 16) ? 16 : block;
+	Enco::uint32*		pValue = scratch.Arena().Allocate<Enco::uint32>(block * k);
+	Enco::uint32*		pPoint = scratch.Arena().Allocate<Enco::uint32>(n);
+	Enco::uint32*		pWork = scratch.Arena().Allocate<Enco::uint32>(evaluator.WorkSize());
+	Enco::uint32*		pTile = scratch.Arena().Allocate<Enco::uint32>(block * n);
+	Enco::byte const*	pChar = secretToShare.Data();
+	for (size_t base = 0; base < originSize; base += block)
+	{
+		// the values of the whole block first, in the per-byte order.
+		const size_t count = (originSize - base < block) ? originSize - base : block;
+		{
+			ShareStats::Scope stage(ShareStats::STAGE_RANDOM, sizeof(Enco::uint32) * count * (k - 1));
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				pValue[k * idx] = pChar[base + idx];
+				for (unsigned int c = 1; c < k; ++c)
+				{
+					pValue[k * idx + c] = _RandomCoefficient(m_randomer);
+				}
+			}
+		}
+
+		ShareStats::Scope stage(ShareStats::STAGE_MATH, count);
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			evaluator.Evaluate(pValue + k * idx, pPoint, pWork);
+			for (unsigned int x = 0; x < n; ++x)
+			{
+				pTile[block * x + idx] = pPoint[x];
+			}
+		}
+
+		for (unsigned int x = 0; x < n; ++x)
+		{
+			sharedSecrets[x].Write(sizeof(Enco::uint32) * base + soff, pTile + block * x, sizeof(Enco::uint32) * count);
+		}
+	}
+
+	memset(pValue, 0, sizeof(Enco::uint32) * block * k);
+	memset(pWork, 0, sizeof(Enco::uint32) * evaluator.WorkSize());
+	return true;
 }
 
 /*
@@ -153,143 +539,446 @@ bool DefaultSecretSharer::Encode(std::vector<FixedBuffer*>& sharedSecrets, const
 *   |  * secret data    [  x bytes ]         |
 *   ------------------------------------------
 */
-bool DefaultSecretSharer::Decode(std::vector<FixedBuffer*>& recoverdSecrets, const std::vector<FixedBuffer*>& sharedSecrets)
+bool DefaultSecretSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets)
 {
-	// release the possible trash data.
-	ReleaseSharedSecrets(recoverdSecrets);
-
 	if (sharedSecrets.size() <= 0)
 		return false;
 
 	// fetch indices and check the length of data.
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	const int		m = (int)sharedSecrets.size();
 	size_t			secLen;
-	Enco::uint32*	pIndice = new Enco::uint32[sharedSecrets.size()];
+	Enco::uint32*	pIndice = scratch.Arena().Allocate<Enco::uint32>(m);
 	unsigned char	hash_value[32] = { 0 };
 	unsigned char	tmp_hash_value[32] = { 0 };
-	secLen = sharedSecrets[0]->Size();
-	for (unsigned int i = 0; i < sharedSecrets.size(); ++i)
+	secLen = sharedSecrets[0].Size();
+	if (secLen < sizeof(Enco::uint32) + 32 || recoverdSecret.Size() < DefaultSecretSharer::DecodedSize(sharedSecrets[0]))
+		return false;
+
 	{
-		sharedSecrets[i]->Read(&(pIndice[i]), 0, sizeof(Enco::uint32));
-		if (secLen != sharedSecrets[i]->Size())
+		ShareStats::Scope stage(ShareStats::STAGE_FRAME);
+		for (unsigned int i = 0; i < sharedSecrets.size(); ++i)
 		{
-			if (pIndice != nullptr)
-				delete[] pIndice;
-			return false;
-		}
+			if (secLen != sharedSecrets[i].Size())
+				return false;
+			sharedSecrets[i].Read(&(pIndice[i]), 0, sizeof(Enco::uint32));
 		
-		if (i == 0)
-		{
-			sharedSecrets[i]->Read(hash_value, sizeof(Enco::uint32), 32);
-		}
-		else
-		{
-			sharedSecrets[i]->Read(tmp_hash_value, sizeof(Enco::uint32), 32);
-			if (memcmp(tmp_hash_value, hash_value, 32) != 0)
+			if (i == 0)
 			{
-				if (pIndice != nullptr)
-					delete[] pIndice;
-				return false;
+				sharedSecrets[i].Read(hash_value, sizeof(Enco::uint32), 32);
+			}
+			else
+			{
+				sharedSecrets[i].Read(tmp_hash_value, sizeof(Enco::uint32), 32);
+				if (memcmp(tmp_hash_value, hash_value, 32) != 0)
+					return false;
 			}
 		}
 	}
 		
-	Enco::uint32*	pShr = new Enco::uint32[sharedSecrets.size()];
-	char			data;
-	size_t			soff = sizeof(Enco::uint32) + 32;
+	// the weights only depend on the indices, so the per-byte work is a dot product.
+	Enco::uint32*	pWeight = scratch.Arena().Allocate<Enco::uint32>(m);
+	if (false == _LagrangeWeights(pIndice, m, pWeight))
+		return false;
 
-	const size_t origin_secLen = (secLen - sizeof(Enco::uint32) - 32) / 4;
-	FixedBuffer* pRecoverdSecret = new FixedBuffer(origin_secLen);
-	for (size_t idx = 0; idx < origin_secLen; ++idx)
-	{
-		for (unsigned int j = 0; j < sharedSecrets.size(); ++j)
-		{
-			sharedSecrets[j]->Read(&pShr[j], sizeof(Enco::uint32)*idx + soff, sizeof(Enco::uint32));
-		}
+	const size_t origin_secLen = DefaultSecretSharer::DecodedSize(sharedSecrets[0]);
+	_DecodeSymbols(recoverdSecret, sharedSecrets, sizeof(Enco::uint32) + 32, pWeight, m, origin_secLen);
 
-		data = (char)_Decode(pIndice, pShr, (int)sharedSecrets.size());
-		pRecoverdSecret->Write(idx, &data, sizeof(char));
+	{
+		ShareStats::Scope stage(ShareStats::STAGE_HASH, origin_secLen);
+		sha256(recoverdSecret.Data(), (unsigned int)origin_secLen, tmp_hash_value);
 	}
-
-	sha256((const unsigned char*)pRecoverdSecret->Buffer(), (unsigned int)pRecoverdSecret->Size(), tmp_hash_value);	
 	if (memcmp(tmp_hash_value, hash_value, 32) != 0)
-	{
-		if (pRecoverdSecret != nullptr)
-			delete pRecoverdSecret;
-
-		if (pShr != nullptr)
-			delete[] pShr;
-
-		if (pIndice != nullptr)
-			delete[] pIndice;
-
 		return false;
-	}
-
-	recoverdSecrets.push_back(pRecoverdSecret);
-
-	if (pShr != nullptr)
-		delete[] pShr;
 
-	if (pIndice != nullptr)
-		delete[] pIndice;
 	return true;
 }
 
-// math tools
-Enco::uint32 DefaultSecretSharer::_Power(Enco::uint32 a, int b)
+void DefaultSecretSharer::_DecodeSymbols(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const size_t& soff, const Enco::uint32 *weights, int m, size_t count)
 {
-	//Enco::uint32 t = 1;
-	Enco::int32 t = 1;
-	
-	int m = 0x0001;
-	Enco::uint32 e = a;
-
-	while (m != 0)
+	// gather one L2-sized tile from every share, then combine it in one pass.
+	ShareStats::Scope	stage(ShareStats::STAGE_MATH, count);
+	ScratchScope		scratch(ScratchArena::ThreadLocal());
+	size_t			block = m_cnst_decode_tile_bytes / sizeof(Enco::uint32) / m;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*	pTile = scratch.Arena().Allocate<Enco::uint32>(block * m);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	for (size_t base = 0; base < count; base += block)
 	{
-		if (m & b)
+		const size_t part = (count - base < block) ? count - base : block;
+		for (int j = 0; j < m; ++j)
 		{
-			t = _Multiply(t, e);
+			sharedSecrets[j].Read(pTile + block * j, sizeof(Enco::uint32) * base + soff, sizeof(Enco::uint32) * part);
 		}
-		m = (m << 1) & 0x1FFFF;
-		e = _Multiply(e, e);
-	}
 
-	return t;
+		_CombineBlock(pTile, block, weights, m, part, pAcc, recoverdSecret.Data() + base);
+	}
 }
 
-Enco::uint32 DefaultSecretSharer::_Multiply(Enco::uint32 a, Enco::uint32 b)
+bool DefaultSecretSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares)
 {
-	if (a > m_cnst_shamir_threshold)
+	badShares.clear();
+	if (k == 0 || sharedSecrets.size() < k)
+		return false;
+
+	// shares with a minority header or an unusable index are simply dropped.
+	const size_t				soff = sizeof(Enco::uint32) + 32;
+	const BufferView&			ref = sharedSecrets[_MajorityHeader(sharedSecrets, soff, 0)];
+	std::vector<BufferView>		candidates;
+	std::vector<size_t>			position;
+	std::vector<Enco::uint32>	indice;
+	for (size_t i = 0; i < sharedSecrets.size(); ++i)
 	{
-		Enco::uint64 alarge = a;
-		Enco::uint64 blarge = b;
+		Enco::uint32 sidx = 0;
+		if (_SameHeader(sharedSecrets[i], ref, soff, 0))
+			sharedSecrets[i].Read(&sidx, 0, sizeof(Enco::uint32));
+
+		if (sidx == 0 || sidx >= m_cnst_shamir_prime || std::find(indice.begin(), indice.end(), sidx) != indice.end())
+		{
+			badShares.push_back(i);
+			continue;
+		}
 
-		return (alarge * blarge) % m_cnst_shamir_prime;
+		candidates.push_back(sharedSecrets[i]);
+		position.push_back(i);
+		indice.push_back(sidx);
 	}
-	else
+
+	if (candidates.size() < k || recoverdSecret.Size() < DefaultSecretSharer::DecodedSize(ref))
+		return false;
+
+	std::vector<bool> bad;
+	if (false == _FindBadShares(candidates, &indice[0], (int)k, soff, DefaultSecretSharer::DecodedSize(ref), bad))
+		return false;
+
+	std::vector<BufferView> good;
+	for (size_t c = 0; c < candidates.size(); ++c)
 	{
-		return (a * b) % m_cnst_shamir_prime;
+		if (bad[c])
+			badShares.push_back(position[c]);
+		else
+			good.push_back(candidates[c]);
 	}
-}
+	std::sort(badShares.begin(), badShares.end());
 
-Enco::uint32 DefaultSecretSharer::_Sub(Enco::uint32 a, Enco::uint32 b)
-{
-	return (a - b + m_cnst_shamir_prime) % m_cnst_shamir_prime;
+	return DefaultSecretSharer::Decode(recoverdSecret, good);
 }
 
-Enco::uint32 DefaultSecretSharer::_Add(Enco::uint32 a, Enco::uint32 b)
+bool DefaultSecretSharer::Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index)
 {
-	return (a + b) % m_cnst_shamir_prime;
-}
+	const size_t soff = sizeof(Enco::uint32) + 32;
+	if (sharedSecrets.size() <= 0 || index == 0 || index >= m_cnst_shamir_prime)
+		return false;
 
-void DefaultSecretSharer::_SubRow(Enco::uint32 *from, Enco::uint32 *to, int k)
-{
-	int i;
-	for (i = 0; i <= k; i++)
+	const BufferView& first = sharedSecrets[0];
+	if (first.Size() < soff || repairedShare.Size() < first.Size())
+		return false;
+
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	const int		m = (int)sharedSecrets.size();
+	Enco::uint32*	pIndice = scratch.Arena().Allocate<Enco::uint32>(m);
+	for (int i = 0; i < m; ++i)
 	{
-		to[i] = _Sub(from[i], to[i]);
-	}
-}
+		if (sharedSecrets[i].Size() != first.Size() ||
+			memcmp(sharedSecrets[i].Data() + sizeof(Enco::uint32), first.Data() + sizeof(Enco::uint32), 32) != 0)
+			return false;
+
+		sharedSecrets[i].Read(&(pIndice[i]), 0, sizeof(Enco::uint32));
+		if (pIndice[i] == 0 || std::find(pIndice, pIndice + i, pIndice[i]) != pIndice + i)
+			return false;
+	}
+
+	// the same tile loop as Decode(), only the weights aim at index instead of 0.
+	// The set's k is not in the header: fewer than k shares interpolate some
+	// other polynomial, whose value at 0 is no byte, as Reshare() checks too.
+	Enco::uint32* pWeight = scratch.Arena().Allocate<Enco::uint32>(m);
+	Enco::uint32* pCheck = scratch.Arena().Allocate<Enco::uint32>(m);
+	if (false == _LagrangeWeights(pIndice, m, index, pWeight) || false == _LagrangeWeights(pIndice, m, pCheck))
+		return false;
+
+	size_t			block = m_cnst_decode_tile_bytes / sizeof(Enco::uint32) / m;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*	pTile = scratch.Arena().Allocate<Enco::uint32>(block * m);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*	pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+
+	bool			agree = true;
+	const size_t	symbols = (first.Size() - soff) / sizeof(Enco::uint32);
+	for (size_t base = 0; base < symbols && agree; base += block)
+	{
+		const size_t count = (symbols - base < block) ? symbols - base : block;
+		for (int j = 0; j < m; ++j)
+		{
+			sharedSecrets[j].Read(pTile + block * j, sizeof(Enco::uint32) * base + soff, sizeof(Enco::uint32) * count);
+		}
+
+		_CombineBlock(pTile, block, pCheck, m, count, pAcc, pRow);
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			agree = agree && (pRow[idx] <= 0xFF);
+		}
+
+		_CombineBlock(pTile, block, pWeight, m, count, pAcc, pRow);
+		repairedShare.Write(sizeof(Enco::uint32) * base + soff, pRow, sizeof(Enco::uint32) * count);
+	}
+	memset(pRow, 0, sizeof(Enco::uint32) * block);
+	memset(pAcc, 0, sizeof(Enco::uint64) * block);
+	if (false == agree)
+	{
+		memset(repairedShare.Data(), 0, first.Size());
+		return false;
+	}
+
+	const Enco::uint32 sidx = index;
+	repairedShare.Write(0, &sidx, sizeof(Enco::uint32));
+	repairedShare.Write(sizeof(Enco::uint32), first.Data() + sizeof(Enco::uint32), 32);
+	return true;
+}
+
+bool DefaultSecretSharer::Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k)
+{
+	const size_t soff = sizeof(Enco::uint32) + 32;
+	if (sharedSecrets.size() < k || k == 0 || m_randomer.Failed())
+		return false;
+
+	const MutableBufferView& first = sharedSecrets[0];
+	if (first.Size() < soff)
+		return false;
+
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	const int		m = (int)sharedSecrets.size();
+	Enco::uint32*	pIndice = scratch.Arena().Allocate<Enco::uint32>(m);
+	for (int i = 0; i < m; ++i)
+	{
+		if (sharedSecrets[i].Size() != first.Size() ||
+			memcmp(sharedSecrets[i].Data() + sizeof(Enco::uint32), first.Data() + sizeof(Enco::uint32), 32) != 0)
+			return false;
+
+		memcpy(&(pIndice[i]), sharedSecrets[i].Data(), sizeof(Enco::uint32));
+		if (pIndice[i] == 0 || pIndice[i] >= m_cnst_shamir_prime || std::find(pIndice, pIndice + i, pIndice[i]) != pIndice + i)
+			return false;
+	}
+
+	// the shares carry no k: a k above the set's would raise its threshold,
+	// one below it or a share of another polynomial would break it. Checked
+	// at the share points alone, the secret is not formed here either.
+	const std::vector<BufferView> views(sharedSecrets.begin(), sharedSecrets.end());
+	if (false == _CheckThreshold(views, pIndice, (int)k, soff, (first.Size() - soff) / sizeof(Enco::uint32)))
+		return false;
+
+	if (k == 1)
+		return true;		// a constant polynomial has nothing to re-randomize
+
+	// x^1 .. x^(k-1) of every share; row c - 1 of the tile holds r_c.
+	const unsigned int	rows = k - 1;
+	Enco::uint32*		pPower = scratch.Arena().Allocate<Enco::uint32>((size_t)m * rows);
+	for (int i = 0; i < m; ++i)
+	{
+		pPower[i * rows] = pIndice[i];
+		for (unsigned int c = 1; c < rows; ++c)
+		{
+			pPower[i * rows + c] = _Multiply(pPower[i * rows + c - 1], pIndice[i]);
+		}
+	}
+
+	const KeyedStream	keystream;
+	Aes128Ctr const*	pStream = keystream.Stream();
+
+	size_t			block = m_cnst_encode_tile_bytes / sizeof(Enco::uint32) / rows;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*	pCoef = scratch.Arena().Allocate<Enco::uint32>(block * rows);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*	pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+	Enco::uint64	streamOffset = 0;
+
+	// draw one tile of d(x) and fold it into every share before the next one,
+	// so each share is read and written once, front to back.
+	const size_t symbols = (first.Size() - soff) / sizeof(Enco::uint32);
+	for (size_t base = 0; base < symbols; base += block)
+	{
+		const size_t count = (symbols - base < block) ? symbols - base : block;
+		for (unsigned int c = 0; c < rows; ++c)
+		{
+			_RandomCoefficients(m_randomer, pStream, streamOffset, pCoef + block * c, count);
+		}
+
+		for (int i = 0; i < m; ++i)
+		{
+			_AccumulateBlock(pCoef, block, pPower + i * rows, (int)rows, count, pAcc);
+			sharedSecrets[i].Read(pRow, sizeof(Enco::uint32) * base + soff, sizeof(Enco::uint32) * count);
+			for (size_t j = 0; j < count; ++j)
+			{
+				pAcc[j] += pRow[j];
+			}
+			_ReduceBlock(pAcc, count, pRow);
+			sharedSecrets[i].Write(sizeof(Enco::uint32) * base + soff, pRow, sizeof(Enco::uint32) * count);
+		}
+	}
+
+	memset(pCoef, 0, sizeof(Enco::uint32) * block * rows);
+	return false == m_randomer.Failed();
+}
+
+bool DefaultSecretSharer::Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets)
+{
+	const size_t soff = sizeof(Enco::uint32) + 32;
+	if (n == 0 || k == 0 || k > n || n >= m_cnst_shamir_prime || newShares.size() < n || sharedSecrets.size() <= 0 || m_randomer.Failed())
+		return false;
+
+	const BufferView& first = sharedSecrets[0];
+	if (first.Size() < soff)
+		return false;
+
+	const size_t symbols = (first.Size() - soff) / sizeof(Enco::uint32);
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (newShares[i].Size() < first.Size())
+			return false;
+	}
+
+	const int					m = (int)sharedSecrets.size();
+	std::vector<Enco::uint32>	indice(m);
+	for (int i = 0; i < m; ++i)
+	{
+		if (sharedSecrets[i].Size() != first.Size() ||
+			memcmp(sharedSecrets[i].Data() + sizeof(Enco::uint32), first.Data() + sizeof(Enco::uint32), 32) != 0)
+			return false;
+
+		sharedSecrets[i].Read(&(indice[i]), 0, sizeof(Enco::uint32));
+		if (indice[i] == 0 || std::find(indice.begin(), indice.begin() + i, indice[i]) != indice.begin() + i)
+			return false;
+	}
+
+	std::vector<Enco::uint32> weight(m);
+	if (false == _LagrangeWeights(&indice[0], m, &weight[0]))
+		return false;
+
+	std::vector<Enco::uint32> power((size_t)n * k);
+	for (Enco::uint32 x = 1; x <= n; ++x)
+	{
+		power[(x - 1) * k] = 1;
+		for (unsigned int c = 1; c < k; ++c)
+		{
+			power[(x - 1) * k + c] = _Multiply(power[(x - 1) * k + c - 1], x);
+		}
+	}
+
+	for (Enco::uint32 i = 0; i < n; ++i)
+	{
+		Enco::uint32 sidx = i + 1;
+		newShares[i].Write(0, &sidx, sizeof(Enco::uint32));
+		newShares[i].Write(sizeof(Enco::uint32), first.Data() + sizeof(Enco::uint32), 32);
+	}
+
+	const KeyedStream	keystream;
+	Aes128Ctr const*	pStream = keystream.Stream();
+
+	const size_t	stride = (size_t)(k > (unsigned int)m ? k : m);
+	size_t			block = m_cnst_encode_tile_bytes / sizeof(Enco::uint32) / stride;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	const size_t	tiles = (symbols + block - 1) / block;
+
+	// coefficient c of symbol s sits at a fixed keystream position, so a tile
+	// draws the same values whichever thread runs it. The randomer is not
+	// thread safe: without the keystream everything stays on this thread.
+	size_t workers = (pStream == nullptr) ? 1 : (size_t)std::thread::hardware_concurrency();
+	if (workers == 0)
+		workers = 1;
+	if (workers > tiles)
+		workers = (tiles == 0) ? 1 : tiles;
+
+	std::vector<char>	failed(workers, 0);
+	auto				work = [&](size_t worker)
+	{
+		ScratchScope	scratch(ScratchArena::ThreadLocal());
+		Enco::uint32*	pTile = scratch.Arena().Allocate<Enco::uint32>(block * m);
+		Enco::uint32*	pCoef = scratch.Arena().Allocate<Enco::uint32>(block * k);
+		Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+		Enco::uint32*	pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+		const size_t	firstTile = tiles * worker / workers;
+		const size_t	lastTile = tiles * (worker + 1) / workers;
+		for (size_t base = firstTile * block; base < lastTile * block && base < symbols; base += block)
+		{
+			const size_t count = (symbols - base < block) ? symbols - base : block;
+			for (int j = 0; j < m; ++j)
+			{
+				sharedSecrets[j].Read(pTile + block * j, sizeof(Enco::uint32) * base + soff, sizeof(Enco::uint32) * count);
+			}
+
+			// row 0 of the coefficient tile is the plaintext of this window, only.
+			_CombineBlock(pTile, block, &weight[0], m, count, pAcc, pCoef);
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				failed[worker] |= (pCoef[idx] > 0xFF) ? 1 : 0;		// the old shares do not agree
+			}
+
+			for (unsigned int c = 1; c < k; ++c)
+			{
+				Enco::uint64 streamOffset = sizeof(Enco::uint32) * ((c - 1) * (Enco::uint64)symbols + base);
+				_RandomCoefficients(m_randomer, pStream, streamOffset, pCoef + block * c, count);
+			}
+
+			for (unsigned int x = 0; x < n; ++x)
+			{
+				_CombineBlock(pCoef, block, &power[x * k], (int)k, count, pAcc, pRow);
+				newShares[x].Write(sizeof(Enco::uint32) * base + soff, pRow, sizeof(Enco::uint32) * count);
+			}
+
+			memset(pCoef, 0, sizeof(Enco::uint32) * block);
+		}
+		memset(pAcc, 0, sizeof(Enco::uint64) * block);
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t w = 1; w < workers; ++w)
+	{
+		threads.push_back(std::thread(work, w));
+	}
+	work(0);
+	for (std::thread& t : threads)
+	{
+		t.join();
+	}
+
+	return std::find(failed.begin(), failed.end(), 1) == failed.end() && false == m_randomer.Failed();
+}
+
+size_t DefaultSecretSharer::WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const
+{
+	const size_t soff = sizeof(Enco::uint32) + 32;
+	symbolSize = sizeof(Enco::uint32);
+	return (sharedSecret.Size() >= soff) ? soff : 0;
+}
+
+// math tools
+Enco::uint32 DefaultSecretSharer::_Power(Enco::uint32 a, int b)
+{
+	return FieldAlgebra<ShamirField>::Power(a, (Enco::uint32)b);
+}
+
+Enco::uint32 DefaultSecretSharer::_Multiply(Enco::uint32 a, Enco::uint32 b)
+{
+	return ShamirField::Multiply(a, b);
+}
+
+Enco::uint32 DefaultSecretSharer::_Sub(Enco::uint32 a, Enco::uint32 b)
+{
+	return ShamirField::Sub(a, b);
+}
+
+Enco::uint32 DefaultSecretSharer::_Add(Enco::uint32 a, Enco::uint32 b)
+{
+	return ShamirField::Add(a, b);
+}
+
+void DefaultSecretSharer::_SubRow(Enco::uint32 *from, Enco::uint32 *to, int k)
+{
+	int i;
+	for (i = 0; i <= k; i++)
+	{
+		to[i] = _Sub(from[i], to[i]);
+	}
+}
 
 void DefaultSecretSharer::_MulRow(Enco::uint32 *row, unsigned int a, int k)
 {
@@ -328,181 +1017,3173 @@ void DefaultSecretSharer::_SolveMatrix(Enco::uint32 **eqn, int k)
 
 Enco::uint32 DefaultSecretSharer::_LinearSolve(Enco::uint32 a, Enco::uint32 b)
 {
-	Enco::uint32 inv = _Power(a, m_cnst_shamir_prime - 2);
-	return _Multiply(inv, b);
+	return FieldAlgebra<ShamirField>::Divide(b, a);
 }
 
-Enco::uint32* DefaultSecretSharer::_Encode(Enco::uint32 secret, int n, int k, const Randomer& randomer, Enco::uint32 *shares)
+bool DefaultSecretSharer::_LagrangeWeights(const Enco::uint32 *x, int m, Enco::uint32 *weights)
 {
-	if (secret >= m_cnst_shamir_prime || secret < 0) { return NULL; }
-	if (n >= m_cnst_shamir_prime || k > n) { return NULL; }
-	if (shares == NULL) { return NULL; }
-
-	Enco::uint32* c_buffer = new Enco::uint32[k];//malloc(sizeof(*c_buffer)*k);
-	c_buffer[0] = secret;
-	int c;
-	for (c = 1; c < k; c++)
+	// index 0 would be the secret itself.
+	for (int j = 0; j < m; ++j)
 	{
-		Enco::uint32 t;
-		char random;
-		random = (char)(randomer.Random());
-		t = random;
-		random = (char)(randomer.Random());
-		t = (t << 8) ^ random;
-		random = (char)(randomer.Random());
-		t = (t << 8) ^ random;
-		random = (char)(randomer.Random());
-		t = (t << 8) ^ random;
+		if (x[j] % m_cnst_shamir_prime == 0)
+			return false;
+	}
+	return _LagrangeWeights(x, m, 0, weights);
+}
 
-		c_buffer[c] = t % m_cnst_shamir_prime;
+bool DefaultSecretSharer::_LagrangeWeights(const Enco::uint32 *x, int m, Enco::uint32 target, Enco::uint32 *weights)
+{
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	Enco::uint32*	pReduced = scratch.Arena().Allocate<Enco::uint32>(m);
+	for (int j = 0; j < m; ++j)
+	{
+		pReduced[j] = x[j] % m_cnst_shamir_prime;
 	}
+	return FieldAlgebra<ShamirField>::LagrangeWeights(pReduced, m, target % m_cnst_shamir_prime, weights);
+}
 
-	int x;
-	for (x = 1; x <= n; x++)
+void DefaultSecretSharer::_AccumulateBlock(const Enco::uint32 *tile, size_t stride, const Enco::uint32 *weights, int m, size_t count, Enco::uint64 *acc)
+{
+	// every product is below 2^48, so m terms fit in 64 bits for any practical m.
+	memset(acc, 0, sizeof(Enco::uint64) * count);
+
+	for (int j = 0; j < m; ++j)
 	{
-		Enco::uint32 s = 0;
-		int xp = 1;
-		for (c = 0; c < k; c++)
+		const Enco::uint32*	row = tile + stride * j;
+		const Enco::uint64	w = weights[j];
+		size_t				i = 0;
+#if defined(ENCO_SSE2)
+		const __m128i		wv = _mm_set1_epi32((int)weights[j]);
+		for (; i + 4 <= count; i += 4)
 		{
-			s = _Add(s, _Multiply(c_buffer[c], xp));
-			xp = _Multiply(xp, x);
+			__m128i y = _mm_load_si128((const __m128i*)(row + i));
+			__m128i even = _mm_mul_epu32(y, wv);
+			__m128i odd = _mm_mul_epu32(_mm_srli_epi64(y, 32), wv);
+			__m128i* pAcc = (__m128i*)(acc + i);
+
+			_mm_store_si128(pAcc, _mm_add_epi64(_mm_load_si128(pAcc), _mm_unpacklo_epi64(even, odd)));
+			_mm_store_si128(pAcc + 1, _mm_add_epi64(_mm_load_si128(pAcc + 1), _mm_unpackhi_epi64(even, odd)));
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			acc[i] += w * row[i];
 		}
-		shares[x - 1] = s;
 	}
-	delete[] c_buffer;
+}
 
-	return shares;
+void DefaultSecretSharer::_ReduceBlock(const Enco::uint64 *acc, size_t count, Enco::uint32 *out)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = (Enco::uint32)(acc[i] % m_cnst_shamir_prime);
+	}
 }
 
-Enco::uint32 DefaultSecretSharer::_Decode(Enco::uint32 *x, Enco::uint32 *shares, int k)
+void DefaultSecretSharer::_ReduceBlock(const Enco::uint64 *acc, size_t count, Enco::byte *out)
 {
-	Enco::uint32 **eqn;
-	Enco::uint32 *eqn_all;
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = (Enco::byte)(acc[i] % m_cnst_shamir_prime);
+	}
+}
 
-	eqn = new Enco::uint32*[k];				// malloc(sizeof(*eqn) * k);
-	eqn_all = new Enco::uint32[k*(k+1)];	// malloc(sizeof(*eqn_all) * k *(k + 1));
+template <typename T>
+void DefaultSecretSharer::_CombineBlock(const Enco::uint32 *tile, size_t stride, const Enco::uint32 *weights, int m, size_t count, Enco::uint64 *acc, T *out)
+{
+	switch (m)
+	{
+	case 2: _CombineFixed<2>(tile, stride, weights, count, out); return;
+	case 3: _CombineFixed<3>(tile, stride, weights, count, out); return;
+	case 4: _CombineFixed<4>(tile, stride, weights, count, out); return;
+	case 5: _CombineFixed<5>(tile, stride, weights, count, out); return;
+	case 6: _CombineFixed<6>(tile, stride, weights, count, out); return;
+	case 7: _CombineFixed<7>(tile, stride, weights, count, out); return;
+	case 8: _CombineFixed<8>(tile, stride, weights, count, out); return;
+	default:
+		_AccumulateBlock(tile, stride, weights, m, count, acc);
+		_ReduceBlock(acc, count, out);
+	}
+}
 
-	int a;
-	for (a = 0; a < k; a++)
+template <int M, typename T>
+void DefaultSecretSharer::_CombineFixed(const Enco::uint32 *tile, size_t stride, const Enco::uint32 *weights, size_t count, T *out)
+{
+	// M is known here: the row loop unrolls, the weights stay in registers and
+	// the sums never go through acc, four symbols are reduced straight away.
+	size_t i = 0;
+#if defined(ENCO_SSE2)
+	__m128i wv[M];
+	for (int j = 0; j < M; ++j)
 	{
-		eqn[a] = eqn_all + ((k + 1) * a);
+		wv[j] = _mm_set1_epi32((int)weights[j]);
 	}
 
-	int b;
-	for (b = 0; b < k; b++)
+	Enco::uint64 lanes[4];
+	for (; i + 4 <= count; i += 4)
 	{
-		Enco::uint32 xp = 1;
-		Enco::uint32 xr = x[b];
+		__m128i even = _mm_setzero_si128();
+		__m128i odd = _mm_setzero_si128();
+		for (int j = 0; j < M; ++j)
+		{
+			__m128i y = _mm_load_si128((const __m128i*)(tile + stride * j + i));
+			even = _mm_add_epi64(even, _mm_mul_epu32(y, wv[j]));
+			odd = _mm_add_epi64(odd, _mm_mul_epu32(_mm_srli_epi64(y, 32), wv[j]));
+		}
 
-		for (a = 0; a < k; a++)
+		_mm_storeu_si128((__m128i*)lanes, _mm_unpacklo_epi64(even, odd));
+		_mm_storeu_si128((__m128i*)(lanes + 2), _mm_unpackhi_epi64(even, odd));
+		out[i] = (T)(lanes[0] % m_cnst_shamir_prime);
+		out[i + 1] = (T)(lanes[1] % m_cnst_shamir_prime);
+		out[i + 2] = (T)(lanes[2] % m_cnst_shamir_prime);
+		out[i + 3] = (T)(lanes[3] % m_cnst_shamir_prime);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		Enco::uint64 sum = 0;
+		for (int j = 0; j < M; ++j)
 		{
-			eqn[b][a] = xp;
-			xp = _Multiply(xp, xr);
+			sum += (Enco::uint64)weights[j] * tile[stride * j + i];
 		}
-		eqn[b][k] = shares[b];
+		out[i] = (T)(sum % m_cnst_shamir_prime);
 	}
-
-	_SolveMatrix(eqn, k);
-	return _LinearSolve(eqn[0][0], eqn[0][k]);
 }
 
-// //////////////////////////////////////////////////////////////////////////////////////////////
-// DefaultStrongSSharer
-DefaultStrongSSharer::DefaultStrongSSharer(const Randomer& randomer)
-: DefaultSecretSharer(randomer)
-{}
-
-/*
-* @implementation: Encode
-* @description:
-* @protocal:
-*   ------------------------------------------
-*   |  * GUID code      [ id bytes ]         |
-*   |  * shared index   [  4 bytes ]         |
-*   |  * sha256 value   [ 32 bytes ]         |
-*   |  * secret data    [  x bytes ]         |
-*   ------------------------------------------
-*/
-bool DefaultStrongSSharer::Encode(std::vector<FixedBuffer*>& sharedSecrets, const unsigned int& n, const unsigned int& k, const FixedBuffer& secretToShare)
+Enco::uint32 DefaultSecretSharer::_RandomCoefficient(const Randomer& randomer)
 {
-	ReleaseSharedSecrets(sharedSecrets);
-	std::vector<FixedBuffer*> originss;
+	Enco::uint32 t;
+	char random;
+	random = (char)(randomer.Random());
+	t = random;
+	random = (char)(randomer.Random());
+	t = (t << 8) ^ random;
+	random = (char)(randomer.Random());
+	t = (t << 8) ^ random;
+	random = (char)(randomer.Random());
+	t = (t << 8) ^ random;
 
-	if (false == DefaultSecretSharer::Encode(originss, n, k, secretToShare))
+	return t % m_cnst_shamir_prime;
+}
+
+void DefaultSecretSharer::_RandomCoefficients(const Randomer& randomer, Aes128Ctr const * const pStream, Enco::uint64& streamOffset, Enco::uint32 *out, size_t count)
+{
+	ShareStats::Scope stage(ShareStats::STAGE_RANDOM, sizeof(Enco::uint32) * count);
+	if (pStream == nullptr)
 	{
-		ReleaseSharedSecrets(originss);
-		return false;
+		for (size_t i = 0; i < count; ++i)
+		{
+			out[i] = _RandomCoefficient(randomer);
+		}
+		return;
 	}
 
-	GUID id;
-	CoCreateGuid(&id);
-
-	for (FixedBuffer* pSec : originss)
+	// 32 keystream bits per coefficient, reduced like _RandomCoefficient().
+	memset(out, 0, sizeof(Enco::uint32) * count);
+	pStream->Apply((Enco::byte*)out, (Enco::byte const*)out, sizeof(Enco::uint32) * count, streamOffset);
+	streamOffset += sizeof(Enco::uint32) * count;
+	for (size_t i = 0; i < count; ++i)
 	{
-		FixedBuffer* newss = new FixedBuffer(pSec->Size() + sizeof(GUID));
-		newss->Write(0, &id, sizeof(GUID));
-
-		newss->Write(sizeof(GUID), pSec->Buffer(), pSec->Size());
-		sharedSecrets.push_back(newss);
+		out[i] %= m_cnst_shamir_prime;
 	}
-
-	return true;
 }
 
-
-/*
-* @implementation: Decode
-* @description:
-* @protocal:
-*   ------------------------------------------
-*   |  * GUID code      [ id bytes ]         |
-*   |  * shared index   [  4 bytes ]         |
-*   |  * sha256 value   [ 32 bytes ]         |
-*   |  * secret data    [  x bytes ]         |
-*   ------------------------------------------
-*/
-bool DefaultStrongSSharer::Decode(std::vector<FixedBuffer*>& recoverdSecrets, const std::vector<FixedBuffer*>& sharedSecrets)
+bool DefaultSecretSharer::_FindBadShares(const std::vector<BufferView>& shares, const Enco::uint32 *x, int k, size_t offset, size_t symbols, std::vector<bool>& bad)
 {
-	std::unordered_map<GUID, std::vector<FixedBuffer*>*, Enco::guid_hash, Enco::guid_equal> ided_secs;
+	const int m = (int)shares.size();
+	bad.assign(m, false);
+	if (m < k)
+		return false;
+	if (m == k)
+		return true;		// no redundancy, nothing to check against
 
-	for (FixedBuffer* pSecParts : sharedSecrets)
+	// the codewords satisfy m - k parity checks sum(v_i * x_i^r * y_i) = 0 with
+	// v_i = 1 / prod(x_i - x_l), so a zero syndrome means the byte is clean.
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	const int		r = m - k;
+	const int		maxErrors = r / 2;
+	Enco::uint32*	pCheck = scratch.Arena().Allocate<Enco::uint32>(r * m);
+	for (int i = 0; i < m; ++i)
 	{
-		GUID tempID;
+		Enco::uint32 den = 1;
+		for (int l = 0; l < m; ++l)
+		{
+			if (l == i)
+				continue;
+			if (x[l] % m_cnst_shamir_prime == x[i] % m_cnst_shamir_prime)
+				return false;
+			den = _Multiply(den, _Sub(x[i] % m_cnst_shamir_prime, x[l] % m_cnst_shamir_prime));
+		}
 
-		pSecParts->Read(&tempID, 0, sizeof(GUID));
-		if (ided_secs[tempID] == nullptr)
+		Enco::uint32 v = _LinearSolve(den, 1);
+		for (int c = 0; c < r; ++c)
 		{
-			ided_secs[tempID] = new std::vector<FixedBuffer*>;
+			pCheck[c * m + i] = v;
+			v = _Multiply(v, x[i] % m_cnst_shamir_prime);
 		}
-		ided_secs[tempID]->push_back(pSecParts);
 	}
 
-	std::unordered_map<GUID, std::vector<FixedBuffer*>*, Enco::guid_hash, Enco::guid_equal>::const_iterator citer;
-	for (citer = ided_secs.begin();
-		citer != ided_secs.end();
-		++citer)
-	{
-		std::vector<FixedBuffer*>	secgroup;
+	size_t			block = m_cnst_decode_tile_bytes / sizeof(Enco::uint32) / m;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*	pTile = scratch.Arena().Allocate<Enco::uint32>(block * m);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*	pSyndrome = scratch.Arena().Allocate<Enco::uint32>(block);
+	Enco::byte*		pDirty = scratch.Arena().Allocate<Enco::byte>(block);
+	Enco::uint32*	pY = scratch.Arena().Allocate<Enco::uint32>(m);
 
-		for (auto& pSecs : *(citer->second))
+	// once shares are known bad, a dirty byte is first checked against the rest:
+	// the first k good shares predict every other good one.
+	int*			pGood = scratch.Arena().Allocate<int>(m);
+	Enco::uint32*	pGoodX = scratch.Arena().Allocate<Enco::uint32>(m);
+	Enco::uint32*	pPredict = scratch.Arena().Allocate<Enco::uint32>(m * k);
+	int				goods = 0;
+	int				bads = 0;
+
+	for (size_t base = 0; base < symbols; base += block)
+	{
+		const size_t count = (symbols - base < block) ? symbols - base : block;
+		for (int j = 0; j < m; ++j)
 		{
-			FixedBuffer*	pUnpacked = new FixedBuffer(pSecs->Size() - sizeof(GUID));
-			Enco::byte*		pStart = (Enco::byte*)pSecs->Buffer() + sizeof(GUID);
-			pUnpacked->Write(0, pStart, pSecs->Size() - sizeof(GUID));
-			secgroup.push_back(pUnpacked);
+			shares[j].Read(pTile + block * j, sizeof(Enco::uint32) * base + offset, sizeof(Enco::uint32) * count);
 		}
 
-		std::vector<FixedBuffer*>	recovered;		
-		if (true != DefaultSecretSharer::Decode(recovered, secgroup))
+		memset(pDirty, 0, count);
+		for (int c = 0; c < r; ++c)
 		{
-			ReleaseSharedSecrets(secgroup);
-			ReleaseSharedSecrets(recovered);
-			continue;
+			_CombineBlock(pTile, block, pCheck + c * m, m, count, pAcc, pSyndrome);
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				pDirty[idx] |= (pSyndrome[idx] != 0);
+			}
 		}
 
-		ReleaseSharedSecrets(secgroup);
-		recoverdSecrets.push_back(recovered[0]);
-	}
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			if (pDirty[idx] == 0)
+				continue;
 
-	return true;
-}
\ No newline at end of file
+			for (int j = 0; j < m; ++j)
+			{
+				pY[j] = pTile[block * j + idx] % m_cnst_shamir_prime;
+			}
+
+			bool consistent = (bads > 0);
+			for (int g = k; consistent && g < goods; ++g)
+			{
+				Enco::uint64 predicted = 0;
+				for (int j = 0; j < k; ++j)
+				{
+					predicted += (Enco::uint64)pPredict[g * k + j] * pY[pGood[j]];
+				}
+				consistent = (predicted % m_cnst_shamir_prime == pY[pGood[g]]);
+			}
+			if (consistent)
+				continue;
+
+			if (false == _WelchBerlekamp(x, pY, m, k, bad))
+				return false;
+
+			bads = 0;
+			goods = 0;
+			for (int j = 0; j < m; ++j)
+			{
+				if (bad[j])
+				{
+					++bads;
+					continue;
+				}
+				pGoodX[goods] = x[j] % m_cnst_shamir_prime;
+				pGood[goods++] = j;
+			}
+			if (bads > maxErrors)
+				return false;
+
+			for (int g = k; g < goods; ++g)
+			{
+				if (false == _LagrangeWeights(pGoodX, k, pGoodX[g], pPredict + g * k))
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool DefaultSecretSharer::_CheckThreshold(const std::vector<BufferView>& shares, const Enco::uint32 *x, int k, size_t offset, size_t symbols)
+{
+	const int m = (int)shares.size();
+	if (k <= 0 || m < k)
+		return false;
+
+	// only share points are interpolated to, never 0: row t - k of pWeight
+	// carries the first k shares to share t, the last row the first k - 1 to
+	// share k - 1.
+	const int		checks = m - k;
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	Enco::uint32*	pWeight = scratch.Arena().Allocate<Enco::uint32>((size_t)(checks + 1) * k);
+	for (int t = k; t < m; ++t)
+	{
+		if (false == _LagrangeWeights(x, k, x[t], pWeight + (size_t)(t - k) * k))
+			return false;
+	}
+	if (k > 1 && false == _LagrangeWeights(x, k - 1, x[k - 1], pWeight + (size_t)checks * k))
+		return false;
+
+	size_t			block = m_cnst_decode_tile_bytes / sizeof(Enco::uint32) / m;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*	pTile = scratch.Arena().Allocate<Enco::uint32>(block * m);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*	pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+
+	// the first k must predict every other share, or one is foreign or k is
+	// below the set's; the first k - 1 predicting share k - 1 at every symbol
+	// means a polynomial of lower degree, k above the set's. A true degree of
+	// k - 1 hits share k - 1 only once in 65809 per symbol.
+	bool agree = true;
+	bool lower = (k > 1);
+	for (size_t base = 0; base < symbols && agree; base += block)
+	{
+		const size_t count = (symbols - base < block) ? symbols - base : block;
+		for (int j = 0; j < m; ++j)
+		{
+			shares[j].Read(pTile + block * j, sizeof(Enco::uint32) * base + offset, sizeof(Enco::uint32) * count);
+		}
+
+		for (int t = k; t < m && agree; ++t)
+		{
+			const Enco::uint32* pShare = pTile + block * t;
+			_CombineBlock(pTile, block, pWeight + (size_t)(t - k) * k, k, count, pAcc, pRow);
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				agree = agree && (pRow[idx] == pShare[idx]);
+			}
+		}
+
+		if (lower)
+		{
+			const Enco::uint32* pShare = pTile + block * (k - 1);
+			_CombineBlock(pTile, block, pWeight + (size_t)checks * k, k - 1, count, pAcc, pRow);
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				lower = lower && (pRow[idx] == pShare[idx]);
+			}
+		}
+	}
+
+	return agree && false == (lower && symbols > 0);
+}
+
+bool DefaultSecretSharer::_WelchBerlekamp(const Enco::uint32 *x, const Enco::uint32 *y, int m, int k, std::vector<bool>& bad)
+{
+	// find E monic of degree e and Q of degree < k + e with Q(x_i) = y_i * E(x_i);
+	// then P = Q / E and the shares where P(x_i) != y_i are the bad ones.
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	const int		e = (m - k) / 2;
+	const int		cols = k + 2 * e;
+	Enco::uint32*	pEqn = scratch.Arena().Allocate<Enco::uint32>(m * (cols + 1));
+	for (int i = 0; i < m; ++i)
+	{
+		Enco::uint32*	row = pEqn + i * (cols + 1);
+		Enco::uint32	xi = x[i] % m_cnst_shamir_prime;
+		Enco::uint32	xp = 1;
+		for (int c = 0; c < k + e; ++c)
+		{
+			row[c] = xp;
+			if (c < e)
+				row[k + e + c] = _Sub(0, _Multiply(y[i], xp));
+			if (c == e)
+				row[cols] = _Multiply(y[i], xp);
+			xp = _Multiply(xp, xi);
+		}
+	}
+
+	// reduced row echelon form; free unknowns are left at zero.
+	int*	pPivot = scratch.Arena().Allocate<int>(cols);
+	int		rank = 0;
+	for (int c = 0; c < cols && rank < m; ++c)
+	{
+		int p = rank;
+		while (p < m && pEqn[p * (cols + 1) + c] == 0)
+		{
+			++p;
+		}
+		if (p == m)
+			continue;
+
+		Enco::uint32* pr = pEqn + p * (cols + 1);
+		Enco::uint32* rr = pEqn + rank * (cols + 1);
+		if (p != rank)
+		{
+			for (int j = 0; j <= cols; ++j)
+			{
+				std::swap(pr[j], rr[j]);
+			}
+		}
+		_MulRow(rr, _LinearSolve(rr[c], 1), cols);
+
+		for (int i = 0; i < m; ++i)
+		{
+			Enco::uint32* ri = pEqn + i * (cols + 1);
+			if (i == rank || ri[c] == 0)
+				continue;
+
+			const Enco::uint32 f = ri[c];
+			for (int j = c; j <= cols; ++j)
+			{
+				ri[j] = _Sub(ri[j], _Multiply(f, rr[j]));
+			}
+		}
+		pPivot[rank++] = c;
+	}
+
+	for (int i = rank; i < m; ++i)
+	{
+		if (pEqn[i * (cols + 1) + cols] != 0)
+			return false;
+	}
+
+	Enco::uint32* pSol = scratch.Arena().Allocate<Enco::uint32>(cols + e + 1);
+	memset(pSol, 0, sizeof(Enco::uint32) * (cols + e + 1));
+	for (int i = 0; i < rank; ++i)
+	{
+		pSol[pPivot[i]] = pEqn[i * (cols + 1) + cols];
+	}
+
+	// pSol = Q[0 .. k+e) followed by E[0 .. e), E[e] = 1.
+	Enco::uint32*	pQ = pSol;
+	Enco::uint32*	pE = pSol + k + e;
+	Enco::uint32*	pP = scratch.Arena().Allocate<Enco::uint32>(k);
+	pE[e] = 1;
+	for (int d = k + e - 1; d >= e; --d)
+	{
+		const Enco::uint32 lead = pQ[d];
+		pP[d - e] = lead;
+		for (int j = 0; j <= e; ++j)
+		{
+			pQ[d - e + j] = _Sub(pQ[d - e + j], _Multiply(lead, pE[j]));
+		}
+	}
+	for (int j = 0; j < e; ++j)
+	{
+		if (pQ[j] != 0)
+			return false;
+	}
+
+	int errors = 0;
+	for (int i = 0; i < m; ++i)
+	{
+		Enco::uint32 xi = x[i] % m_cnst_shamir_prime;
+		Enco::uint32 v = 0;
+		for (int c = k - 1; c >= 0; --c)
+		{
+			v = _Add(_Multiply(v, xi), pP[c]);
+		}
+		if (v != y[i])
+		{
+			bad[i] = true;
+			++errors;
+		}
+	}
+
+	return errors <= e;
+}
+
+Enco::uint32* DefaultSecretSharer::_Encode(Enco::uint32 secret, int n, int k, const Randomer& randomer, Enco::uint32 *shares, Enco::uint32 *c_buffer)
+{
+	if (secret >= m_cnst_shamir_prime || secret < 0) { return NULL; }
+	if (n >= m_cnst_shamir_prime || k > n) { return NULL; }
+	if (shares == NULL || c_buffer == NULL) { return NULL; }
+
+	c_buffer[0] = secret;
+	int c;
+	for (c = 1; c < k; c++)
+	{
+		c_buffer[c] = _RandomCoefficient(randomer);
+	}
+
+	int x;
+	for (x = 1; x <= n; x++)
+	{
+		Enco::uint32 s = 0;
+		int xp = 1;
+		for (c = 0; c < k; c++)
+		{
+			s = _Add(s, _Multiply(c_buffer[c], xp));
+			xp = _Multiply(xp, x);
+		}
+		shares[x - 1] = s;
+	}
+
+	return shares;
+}
+
+Enco::uint32 DefaultSecretSharer::_Decode(Enco::uint32 *x, Enco::uint32 *shares, int k, Enco::uint32 *eqn_all, Enco::uint32 **eqn)
+{
+	int a;
+	for (a = 0; a < k; a++)
+	{
+		eqn[a] = eqn_all + ((k + 1) * a);
+	}
+
+	int b;
+	for (b = 0; b < k; b++)
+	{
+		Enco::uint32 xp = 1;
+		Enco::uint32 xr = x[b];
+
+		for (a = 0; a < k; a++)
+		{
+			eqn[b][a] = xp;
+			xp = _Multiply(xp, xr);
+		}
+		eqn[b][k] = shares[b];
+	}
+
+	_SolveMatrix(eqn, k);
+	return _LinearSolve(eqn[0][0], eqn[0][k]);
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// DefaultStrongSSharer
+DefaultStrongSSharer::DefaultStrongSSharer(const Randomer& randomer)
+: DefaultSecretSharer(randomer)
+{}
+
+size_t DefaultStrongSSharer::EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const
+{
+	return DefaultSecretSharer::EncodedSize(secretSize, n, k) + sizeof(GUID);
+}
+
+size_t DefaultStrongSSharer::DecodedSize(const BufferView& sharedSecret) const
+{
+	if (sharedSecret.Size() < sizeof(GUID))
+		return 0;
+	return DefaultSecretSharer::DecodedSize(sharedSecret.Sub(sizeof(GUID), sharedSecret.Size()));
+}
+
+/*
+* @implementation: Encode
+* @description:
+* @protocal:
+*   ------------------------------------------
+*   |  * GUID code      [ id bytes ]         |
+*   |  * shared index   [  4 bytes ]         |
+*   |  * sha256 value   [ 32 bytes ]         |
+*   |  * secret data    [  x bytes ]         |
+*   ------------------------------------------
+*/
+bool DefaultStrongSSharer::Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	if (sharedSecrets.size() < n)
+		return false;
+
+	// the inner shares live right behind the GUID code, no copy needed.
+	std::vector<MutableBufferView> originss;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		originss.push_back(sharedSecrets[i].Sub(sizeof(GUID), sharedSecrets[i].Size()));
+	}
+
+	if (false == DefaultSecretSharer::Encode(originss, n, k, secretToShare))
+		return false;
+
+	ShareStats::Scope stage(ShareStats::STAGE_FRAME);
+	GUID id;
+	CoCreateGuid(&id);
+
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		sharedSecrets[i].Write(0, &id, sizeof(GUID));
+	}
+
+	return true;
+}
+
+
+/*
+* @implementation: Decode
+* @description:
+* @protocal:
+*   ------------------------------------------
+*   |  * GUID code      [ id bytes ]         |
+*   |  * shared index   [  4 bytes ]         |
+*   |  * sha256 value   [ 32 bytes ]         |
+*   |  * secret data    [  x bytes ]         |
+*   ------------------------------------------
+*/
+bool DefaultStrongSSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets)
+{
+	if (sharedSecrets.size() <= 0)
+		return false;
+
+	GUID id;
+	GUID tempID;
+	Enco::guid_equal equal;
+	std::vector<BufferView> secgroup;
+	{
+		ShareStats::Scope stage(ShareStats::STAGE_FRAME);
+		for (unsigned int i = 0; i < sharedSecrets.size(); ++i)
+		{
+			if (sharedSecrets[i].Size() < sizeof(GUID))
+				return false;
+
+			sharedSecrets[i].Read(i == 0 ? &id : &tempID, 0, sizeof(GUID));
+			if (i != 0 && false == equal(id, tempID))
+				return false;
+
+			secgroup.push_back(sharedSecrets[i].Sub(sizeof(GUID), sharedSecrets[i].Size()));
+		}
+	}
+
+	return DefaultSecretSharer::Decode(recoverdSecret, secgroup);
+}
+
+bool DefaultStrongSSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares)
+{
+	badShares.clear();
+	if (sharedSecrets.size() <= 0)
+		return false;
+
+	const BufferView&		ref = sharedSecrets[_MajorityHeader(sharedSecrets, sizeof(GUID), sizeof(GUID))];
+	std::vector<BufferView>	secgroup;
+	std::vector<size_t>		position;
+	for (size_t i = 0; i < sharedSecrets.size(); ++i)
+	{
+		if (false == _SameHeader(sharedSecrets[i], ref, sizeof(GUID), sizeof(GUID)))
+		{
+			badShares.push_back(i);
+			continue;
+		}
+
+		secgroup.push_back(sharedSecrets[i].Sub(sizeof(GUID), sharedSecrets[i].Size()));
+		position.push_back(i);
+	}
+
+	std::vector<size_t> innerBad;
+	const bool result = DefaultSecretSharer::Decode(recoverdSecret, secgroup, k, innerBad);
+	for (const size_t& b : innerBad)
+	{
+		badShares.push_back(position[b]);
+	}
+	std::sort(badShares.begin(), badShares.end());
+
+	return result;
+}
+
+bool DefaultStrongSSharer::Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index)
+{
+	if (sharedSecrets.size() <= 0 || sharedSecrets[0].Size() < sizeof(GUID) || repairedShare.Size() < sharedSecrets[0].Size())
+		return false;
+
+	std::vector<BufferView> secgroup;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (share.Size() < sizeof(GUID) || memcmp(share.Data(), sharedSecrets[0].Data(), sizeof(GUID)) != 0)
+			return false;
+
+		secgroup.push_back(share.Sub(sizeof(GUID), share.Size()));
+	}
+
+	if (false == DefaultSecretSharer::Repair(repairedShare.Sub(sizeof(GUID), sharedSecrets[0].Size() - sizeof(GUID)), secgroup, index))
+		return false;
+
+	repairedShare.Write(0, sharedSecrets[0].Data(), sizeof(GUID));
+	return true;
+}
+
+bool DefaultStrongSSharer::Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k)
+{
+	if (sharedSecrets.size() <= 0 || sharedSecrets[0].Size() < sizeof(GUID))
+		return false;
+
+	std::vector<MutableBufferView> secgroup;
+	for (const MutableBufferView& share : sharedSecrets)
+	{
+		if (share.Size() < sizeof(GUID) || memcmp(share.Data(), sharedSecrets[0].Data(), sizeof(GUID)) != 0)
+			return false;
+
+		secgroup.push_back(share.Sub(sizeof(GUID), share.Size() - sizeof(GUID)));
+	}
+
+	return DefaultSecretSharer::Refresh(secgroup, k);
+}
+
+bool DefaultStrongSSharer::Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets)
+{
+	if (sharedSecrets.size() <= 0 || sharedSecrets[0].Size() < sizeof(GUID) || newShares.size() < n)
+		return false;
+
+	std::vector<BufferView> secgroup;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (share.Size() < sizeof(GUID) || memcmp(share.Data(), sharedSecrets[0].Data(), sizeof(GUID)) != 0)
+			return false;
+
+		secgroup.push_back(share.Sub(sizeof(GUID), share.Size() - sizeof(GUID)));
+	}
+
+	GUID id;
+	CoCreateGuid(&id);
+
+	std::vector<MutableBufferView> newgroup;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (newShares[i].Size() < sizeof(GUID))
+			return false;
+
+		newShares[i].Write(0, &id, sizeof(GUID));
+		newgroup.push_back(newShares[i].Sub(sizeof(GUID), newShares[i].Size() - sizeof(GUID)));
+	}
+
+	return DefaultSecretSharer::Reshare(newgroup, n, k, secgroup);
+}
+
+size_t DefaultStrongSSharer::WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const
+{
+	if (sharedSecret.Size() < sizeof(GUID))
+		return 0;
+
+	const size_t soff = DefaultSecretSharer::WindowHeader(sharedSecret.Sub(sizeof(GUID), sharedSecret.Size() - sizeof(GUID)), symbolSize);
+	return (soff == 0) ? 0 : sizeof(GUID) + soff;
+}
+
+bool DefaultStrongSSharer::Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets)
+{
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal> ided_secs;
+
+	for (const BufferView& secParts : sharedSecrets)
+	{
+		if (secParts.Size() < sizeof(GUID))
+			continue;
+
+		GUID tempID;
+		secParts.Read(&tempID, 0, sizeof(GUID));
+		ided_secs[tempID].push_back(secParts.Sub(sizeof(GUID), secParts.Size()));
+	}
+
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal>::const_iterator citer;
+	for (citer = ided_secs.begin();
+		citer != ided_secs.end();
+		++citer)
+	{
+		OwnedBuffer recovered(DefaultSecretSharer::DecodedSize(citer->second[0]));
+		if (true != DefaultSecretSharer::Decode(recovered.MutableView(), citer->second))
+			continue;
+
+		recoverdSecrets.push_back(std::move(recovered));
+	}
+
+	return true;
+}
+
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// BatchSecretSharer
+
+BatchSecretSharer::BatchSecretSharer(const Randomer& randomer)
+: DefaultStrongSSharer(randomer)
+{}
+
+size_t BatchSecretSharer::RecordSize(const size_t& secretSize) const
+{
+	return DefaultStrongSSharer::EncodedSize(secretSize, 1, 1);
+}
+
+bool BatchSecretSharer::EncodeBatch(Enco::byte * const pShares, const unsigned int& n, const unsigned int& k, Enco::byte const * const pSecrets, const size_t& secretSize, const size_t& count)
+{
+	if (n == 0 || k == 0 || k > n || n >= m_cnst_shamir_prime || count == 0 || m_randomer.Failed())
+		return false;
+
+	const size_t	record = RecordSize(secretSize);
+	const size_t	soff = sizeof(GUID) + sizeof(Enco::uint32) + 32;
+
+	const KeyedStream	keystream;
+	Aes128Ctr const*	pStream = keystream.Stream();
+
+	// random version 4 GUIDs instead of one CoCreateGuid() per secret.
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	GUID*			pId = scratch.Arena().Allocate<GUID>(count);
+	Enco::byte*		pOne = scratch.Arena().Allocate<Enco::byte>(secretSize + 1);
+	Enco::uint64	streamOffset = 0;
+	memset(pId, 0, sizeof(GUID) * count);
+	if (pStream != nullptr)
+	{
+		pStream->Apply((Enco::byte*)pId, (Enco::byte const*)pId, sizeof(GUID) * count, streamOffset);
+		streamOffset += sizeof(GUID) * count;
+	}
+	else
+	{
+		for (size_t i = 0; i < sizeof(GUID) * count; ++i)
+		{
+			((Enco::byte*)pId)[i] = (Enco::byte)m_randomer.Random();
+		}
+	}
+
+	for (size_t s = 0; s < count; ++s)
+	{
+		pId[s].Data3 = (pId[s].Data3 & 0x0FFF) | 0x4000;
+		pId[s].Data4[0] = (pId[s].Data4[0] & 0x3F) | 0x80;
+
+		for (size_t b = 0; b < secretSize; ++b)
+		{
+			pOne[b] = pSecrets[b * count + s];
+		}
+		unsigned char hash_value[32] = { 0 };
+		sha256(pOne, (unsigned int)secretSize, hash_value);
+
+		for (Enco::uint32 i = 0; i < n; ++i)
+		{
+			Enco::byte*		pRecord = pShares + record * (i * count + s);
+			Enco::uint32	sidx = i + 1;
+			memcpy(pRecord, &pId[s], sizeof(GUID));
+			memcpy(pRecord + sizeof(GUID), &sidx, sizeof(Enco::uint32));
+			memcpy(pRecord + sizeof(GUID) + sizeof(Enco::uint32), hash_value, 32);
+		}
+	}
+	memset(pOne, 0, secretSize + 1);
+
+	// the whole batch is one run of secretSize * count symbols; a tile row holds
+	// one coefficient of consecutive symbols, i.e. of neighbouring secrets.
+	const size_t	total = secretSize * count;
+	size_t			block = m_cnst_encode_tile_bytes / sizeof(Enco::uint32) / k;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	if (block > ((total + 15) & ~((size_t)15)))
+		block = (total + 15) & ~((size_t)15);
+	Enco::uint32*	pCoef = scratch.Arena().Allocate<Enco::uint32>(block * k);
+	Enco::uint32*	pPower = scratch.Arena().Allocate<Enco::uint32>((size_t)n * k);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*	pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+	for (Enco::uint32 x = 1; x <= n; ++x)
+	{
+		Enco::uint32* pp = pPower + (size_t)(x - 1) * k;
+		pp[0] = 1;
+		for (unsigned int c = 1; c < k; ++c)
+		{
+			pp[c] = _Multiply(pp[c - 1], x);
+		}
+	}
+
+	for (size_t base = 0; base < total; base += block)
+	{
+		const size_t cnt = (total - base < block) ? total - base : block;
+		for (size_t t = 0; t < cnt; ++t)
+		{
+			pCoef[t] = pSecrets[base + t];
+		}
+		for (unsigned int c = 1; c < k; ++c)
+		{
+			_RandomCoefficients(m_randomer, pStream, streamOffset, pCoef + block * c, cnt);
+		}
+
+		for (Enco::uint32 i = 0; i < n; ++i)
+		{
+			_CombineBlock(pCoef, block, pPower + (size_t)i * k, (int)k, cnt, pAcc, pRow);
+
+			// symbol base + t is byte b of secret s.
+			Enco::byte*	pFirst = pShares + record * ((size_t)i * count) + soff;
+			size_t		b = base / count;
+			size_t		s = base % count;
+			for (size_t t = 0; t < cnt; ++t)
+			{
+				memcpy(pFirst + record * s + sizeof(Enco::uint32) * b, &pRow[t], sizeof(Enco::uint32));
+				if (++s == count)
+				{
+					s = 0;
+					++b;
+				}
+			}
+		}
+	}
+
+	memset(pCoef, 0, sizeof(Enco::uint32) * block * k);
+	return false == m_randomer.Failed();
+}
+
+bool BatchSecretSharer::DecodeBatch(Enco::byte * const pSecrets, const size_t& secretSize, const size_t& count, const std::vector<BufferView>& shareRows, std::vector<size_t>& failed)
+{
+	failed.clear();
+
+	const int		m = (int)shareRows.size();
+	const size_t	record = RecordSize(secretSize);
+	const size_t	ioff = sizeof(GUID);
+	const size_t	soff = ioff + sizeof(Enco::uint32) + 32;
+	if (m == 0 || count == 0)
+		return false;
+
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	Enco::uint32*	pX = scratch.Arena().Allocate<Enco::uint32>(m);
+	Enco::uint32*	pWeight = scratch.Arena().Allocate<Enco::uint32>(m);
+	for (int j = 0; j < m; ++j)
+	{
+		if (shareRows[j].Size() < record * count)
+			return false;
+		shareRows[j].Read(&pX[j], ioff, sizeof(Enco::uint32));
+	}
+	if (false == _LagrangeWeights(pX, m, pWeight))
+		return false;
+
+	// a secret whose records do not form one set is dropped, not the batch.
+	std::vector<Enco::byte> bad(count, 0);
+	for (size_t s = 0; s < count; ++s)
+	{
+		Enco::byte const* pRef = shareRows[0].Data() + record * s;
+		for (int j = 0; j < m; ++j)
+		{
+			Enco::byte const*	pRecord = shareRows[j].Data() + record * s;
+			Enco::uint32		sidx;
+			memcpy(&sidx, pRecord + ioff, sizeof(Enco::uint32));
+			if (sidx != pX[j] || memcmp(pRecord, pRef, sizeof(GUID)) != 0 ||
+				memcmp(pRecord + ioff + sizeof(Enco::uint32), pRef + ioff + sizeof(Enco::uint32), 32) != 0)
+				bad[s] = 1;
+		}
+	}
+
+	const size_t	total = secretSize * count;
+	size_t			block = m_cnst_decode_tile_bytes / sizeof(Enco::uint32) / m;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	if (block > ((total + 15) & ~((size_t)15)))
+		block = (total + 15) & ~((size_t)15);
+	Enco::uint32*	pTile = scratch.Arena().Allocate<Enco::uint32>(block * m);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	for (size_t base = 0; base < total; base += block)
+	{
+		const size_t cnt = (total - base < block) ? total - base : block;
+		for (int j = 0; j < m; ++j)
+		{
+			Enco::byte const*	pFirst = shareRows[j].Data() + soff;
+			Enco::uint32*		pDist = pTile + block * j;
+			size_t				b = base / count;
+			size_t				s = base % count;
+			for (size_t t = 0; t < cnt; ++t)
+			{
+				memcpy(&pDist[t], pFirst + record * s + sizeof(Enco::uint32) * b, sizeof(Enco::uint32));
+				if (++s == count)
+				{
+					s = 0;
+					++b;
+				}
+			}
+		}
+
+		_CombineBlock(pTile, block, pWeight, m, cnt, pAcc, pSecrets + base);
+	}
+
+	Enco::byte* pOne = scratch.Arena().Allocate<Enco::byte>(secretSize + 1);
+	for (size_t s = 0; s < count; ++s)
+	{
+		for (size_t b = 0; b < secretSize; ++b)
+		{
+			pOne[b] = pSecrets[b * count + s];
+		}
+
+		unsigned char tmp_hash_value[32] = { 0 };
+		sha256(pOne, (unsigned int)secretSize, tmp_hash_value);
+		if (bad[s] == 0 && memcmp(tmp_hash_value, shareRows[0].Data() + record * s + ioff + sizeof(Enco::uint32), 32) == 0)
+			continue;
+
+		for (size_t b = 0; b < secretSize; ++b)
+		{
+			pSecrets[b * count + s] = 0;
+		}
+		failed.push_back(s);
+	}
+	memset(pOne, 0, secretSize + 1);
+
+	return failed.empty();
+}
+
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// FixedSecretSharer
+
+template <size_t L>
+FixedSecretSharer<L>::FixedSecretSharer(const Randomer& randomer) :
+m_randomer(randomer), m_pStream(new KeyedStream()), m_streamOffset(0)
+{}
+
+template <size_t L>
+FixedSecretSharer<L>::~FixedSecretSharer()
+{
+	delete m_pStream;
+}
+
+template <size_t L>
+bool FixedSecretSharer<L>::Encode(Share * const pShares, const unsigned int& n, const unsigned int& k, const Secret& secret)
+{
+	if (n == 0 || k == 0 || k > n || k > m_cnst_max_threshold || n >= ShamirField::Order() || m_randomer.Failed())
+		return false;
+
+	const size_t	ioff = sizeof(GUID);
+	const size_t	soff = ioff + sizeof(Enco::uint32) + 32;
+	GUID			id;
+	unsigned char	hash_value[32] = { 0 };
+	CoCreateGuid(&id);
+	sha256(secret.data(), (unsigned int)L, hash_value);
+
+	// coef[c][b] is coefficient c of byte b, row 0 the secret.
+	Enco::uint32 coef[m_cnst_max_threshold][L];
+	for (size_t b = 0; b < L; ++b)
+	{
+		coef[0][b] = secret[b];
+	}
+	_Random((Enco::byte*)coef[1], sizeof(Enco::uint32) * L * (k - 1));
+	for (unsigned int c = 1; c < k; ++c)
+	{
+		for (size_t b = 0; b < L; ++b)
+		{
+			coef[c][b] = ShamirField::FromRandom(coef[c][b]);
+		}
+	}
+
+	for (Enco::uint32 i = 0; i < n; ++i)
+	{
+		Enco::byte* const	pShare = pShares[i].data();
+		const Enco::uint32	x = i + 1;
+		memcpy(pShare, &id, sizeof(GUID));
+		memcpy(pShare + ioff, &x, sizeof(Enco::uint32));
+		memcpy(pShare + ioff + sizeof(Enco::uint32), hash_value, 32);
+
+		// every term is below 2^34, so k <= 32 of them are summed unreduced and
+		// each byte costs one reduction, like _AccumulateBlock().
+		Enco::uint64 acc[L];
+		Enco::uint32 power = 1;
+		for (size_t b = 0; b < L; ++b)
+		{
+			acc[b] = coef[0][b];
+		}
+		for (unsigned int c = 1; c < k; ++c)
+		{
+			power = ShamirField::Multiply(power, x);
+			for (size_t b = 0; b < L; ++b)
+			{
+				acc[b] += (Enco::uint64)coef[c][b] * power;
+			}
+		}
+		for (size_t b = 0; b < L; ++b)
+		{
+			const Enco::uint32 v = (Enco::uint32)(acc[b] % ShamirField::Order());
+			memcpy(pShare + soff + sizeof(Enco::uint32) * b, &v, sizeof(Enco::uint32));
+		}
+	}
+
+	memset(coef, 0, sizeof(Enco::uint32) * L * k);
+	return false == m_randomer.Failed();
+}
+
+template <size_t L>
+bool FixedSecretSharer<L>::Decode(Secret& secret, Share const * const pShares, const unsigned int& m)
+{
+	if (m == 0 || m > m_cnst_max_threshold)
+		return false;
+
+	const size_t	ioff = sizeof(GUID);
+	const size_t	soff = ioff + sizeof(Enco::uint32) + 32;
+	Enco::uint32	x[m_cnst_max_threshold];
+	Enco::uint32	weight[m_cnst_max_threshold];
+	for (unsigned int j = 0; j < m; ++j)
+	{
+		if (memcmp(pShares[j].data(), pShares[0].data(), sizeof(GUID)) != 0 ||
+			memcmp(pShares[j].data() + ioff + sizeof(Enco::uint32), pShares[0].data() + ioff + sizeof(Enco::uint32), 32) != 0)
+			return false;
+
+		memcpy(&x[j], pShares[j].data() + ioff, sizeof(Enco::uint32));
+		if (x[j] == 0 || x[j] >= ShamirField::Order())
+			return false;
+	}
+	if (false == FieldAlgebra<ShamirField>::LagrangeWeights(x, (int)m, 0, weight))
+		return false;
+
+	// weight * y < 2^49 even for a damaged y, m <= 32 of them fit in 64 bits.
+	Enco::uint64 acc[L] = { 0 };
+	for (unsigned int j = 0; j < m; ++j)
+	{
+		Enco::uint32 y[L];
+		memcpy(y, pShares[j].data() + soff, sizeof(y));
+		for (size_t b = 0; b < L; ++b)
+		{
+			acc[b] += (Enco::uint64)weight[j] * y[b];
+		}
+	}
+	for (size_t b = 0; b < L; ++b)
+	{
+		const Enco::uint64 v = acc[b] % ShamirField::Order();
+		if (v > 0xFF)
+		{
+			secret.fill(0);
+			return false;
+		}
+		secret[b] = (Enco::byte)v;
+	}
+
+	unsigned char tmp_hash_value[32] = { 0 };
+	sha256(secret.data(), (unsigned int)L, tmp_hash_value);
+	if (memcmp(tmp_hash_value, pShares[0].data() + ioff + sizeof(Enco::uint32), 32) != 0)
+	{
+		secret.fill(0);
+		return false;
+	}
+
+	return true;
+}
+
+template <size_t L>
+void FixedSecretSharer<L>::_Random(Enco::byte * const pOut, const size_t& count)
+{
+	Aes128Ctr const* const pStream = m_pStream->Stream();
+	if (pStream == nullptr)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			pOut[i] = (Enco::byte)m_randomer.Random();
+		}
+		return;
+	}
+
+	memset(pOut, 0, count);
+	pStream->Apply(pOut, pOut, count, m_streamOffset);
+	m_streamOffset += count;
+}
+
+template class FixedSecretSharer<16>;
+template class FixedSecretSharer<32>;
+template class FixedSecretSharer<64>;
+
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// StreamSecretSharer
+
+const size_t StreamSecretSharer::m_cnst_header_size = sizeof(GUID) + sizeof(Enco::uint32) + 32;
+
+StreamSecretSharer::StreamSecretSharer(const Randomer& randomer) :
+DefaultStrongSSharer(randomer), m_state(STATE_IDLE), m_n(0), m_k(0), m_processed(0), m_id(), m_digest()
+{
+	sha256_init(&m_hash);
+}
+
+bool StreamSecretSharer::BeginEncode(const unsigned int& n, const unsigned int& k)
+{
+	m_state = STATE_IDLE;
+	if (n == 0 || k == 0 || k > n || n >= m_cnst_shamir_prime || m_randomer.Failed())
+		return false;
+
+	m_n = n;
+	m_k = k;
+	m_processed = 0;
+	CoCreateGuid(&m_id);
+	sha256_init(&m_hash);
+	m_state = STATE_ENCODING;
+	return true;
+}
+
+bool StreamSecretSharer::EncodeChunk(const std::vector<MutableBufferView>& bodies, const BufferView& chunk)
+{
+	if (m_state != STATE_ENCODING || bodies.size() < m_n)
+		return false;
+
+	for (unsigned int i = 0; i < m_n; ++i)
+	{
+		if (bodies[i].Size() < sizeof(Enco::uint32) * chunk.Size())
+			return false;
+	}
+
+	_Hash(chunk.Data(), chunk.Size());
+	m_processed += chunk.Size();
+	return _EncodeSymbols(bodies, 0, m_n, m_k, chunk);
+}
+
+bool StreamSecretSharer::FinishEncode(const std::vector<MutableBufferView>& headers)
+{
+	if (m_state != STATE_ENCODING || headers.size() < m_n)
+		return false;
+
+	for (unsigned int i = 0; i < m_n; ++i)
+	{
+		if (headers[i].Size() < m_cnst_header_size)
+			return false;
+	}
+
+	ShareStats::Scope stage(ShareStats::STAGE_FRAME);
+	sha256_final(&m_hash, m_digest);
+	for (Enco::uint32 i = 0; i < m_n; ++i)
+	{
+		Enco::uint32 sidx = i + 1;
+		headers[i].Write(0, &m_id, sizeof(GUID));
+		headers[i].Write(sizeof(GUID), &sidx, sizeof(Enco::uint32));
+		headers[i].Write(sizeof(GUID) + sizeof(Enco::uint32), m_digest, 32);
+	}
+
+	m_state = STATE_IDLE;
+	return true;
+}
+
+bool StreamSecretSharer::BeginDecode(const std::vector<BufferView>& headers)
+{
+	m_state = STATE_IDLE;
+	if (headers.empty() || headers.size() >= m_cnst_shamir_prime)
+		return false;
+
+	const size_t				hoff = sizeof(GUID) + sizeof(Enco::uint32);
+	std::vector<Enco::uint32>	indice(headers.size());
+	for (size_t i = 0; i < headers.size(); ++i)
+	{
+		if (headers[i].Size() < m_cnst_header_size)
+			return false;
+		if (i != 0 && (memcmp(headers[i].Data(), headers[0].Data(), sizeof(GUID)) != 0 ||
+			memcmp(headers[i].Data() + hoff, headers[0].Data() + hoff, 32) != 0))
+			return false;
+
+		headers[i].Read(&indice[i], sizeof(GUID), sizeof(Enco::uint32));
+	}
+
+	m_weights.resize(headers.size());
+	if (false == _LagrangeWeights(&indice[0], (int)headers.size(), &m_weights[0]))
+		return false;
+
+	headers[0].Read(&m_id, 0, sizeof(GUID));
+	headers[0].Read(m_digest, hoff, 32);
+	m_n = (unsigned int)headers.size();
+	m_processed = 0;
+	sha256_init(&m_hash);
+	m_state = STATE_DECODING;
+	return true;
+}
+
+bool StreamSecretSharer::DecodeChunk(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& bodies)
+{
+	if (m_state != STATE_DECODING || bodies.size() != m_n || bodies[0].Size() % sizeof(Enco::uint32) != 0)
+		return false;
+
+	const size_t count = bodies[0].Size() / sizeof(Enco::uint32);
+	for (unsigned int j = 0; j < m_n; ++j)
+	{
+		if (bodies[j].Size() != bodies[0].Size())
+			return false;
+	}
+	if (recoverdSecret.Size() < count)
+		return false;
+
+	_DecodeSymbols(recoverdSecret, bodies, 0, &m_weights[0], (int)m_n, count);
+	_Hash(recoverdSecret.Data(), count);
+	m_processed += count;
+	return true;
+}
+
+bool StreamSecretSharer::FinishDecode()
+{
+	if (m_state != STATE_DECODING)
+		return false;
+
+	unsigned char tmp_hash_value[32] = { 0 };
+	sha256_final(&m_hash, tmp_hash_value);
+	m_state = STATE_IDLE;
+	return memcmp(tmp_hash_value, m_digest, 32) == 0;
+}
+
+Enco::uint64 StreamSecretSharer::Processed() const
+{
+	return m_processed;
+}
+
+void StreamSecretSharer::_Hash(Enco::byte const * const pData, const size_t& size)
+{
+	// sha256_update() counts in unsigned int.
+	ShareStats::Scope	stage(ShareStats::STAGE_HASH, size);
+	const size_t		piece = (size_t)1 << 30;
+	for (size_t done = 0; done < size; done += piece)
+	{
+		sha256_update(&m_hash, pData + done, (unsigned int)((size - done < piece) ? size - done : piece));
+	}
+}
+
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// KrawczykSecretSharer
+
+const size_t KrawczykSecretSharer::m_cnst_min_computational_size = ((size_t)64 << 10);
+const Enco::uint32 KrawczykSecretSharer::m_cnst_magic = ((Enco::uint32)0x5353434B);		// "KCSS", never a valid index
+const size_t KrawczykSecretSharer::m_cnst_key_material_size = 16 + 8;					// AES key + CTR nonce
+const size_t KrawczykSecretSharer::m_cnst_key_share_size = 24 * 4 + sizeof(Enco::uint32) + 32;
+const size_t KrawczykSecretSharer::m_cnst_header_size = sizeof(GUID) + 3 * sizeof(Enco::uint32) + sizeof(Enco::uint64) + 32 + 24 * 4 + sizeof(Enco::uint32) + 32;
+const size_t KrawczykSecretSharer::m_cnst_block_size = ((size_t)64 << 10);
+
+namespace
+{
+	const size_t g_cnst_kcss_magic = sizeof(GUID);
+	const size_t g_cnst_kcss_index = g_cnst_kcss_magic + sizeof(Enco::uint32);
+	const size_t g_cnst_kcss_k = g_cnst_kcss_index + sizeof(Enco::uint32);
+	const size_t g_cnst_kcss_size = g_cnst_kcss_k + sizeof(Enco::uint32);
+	const size_t g_cnst_kcss_hash = g_cnst_kcss_size + sizeof(Enco::uint64);
+	const size_t g_cnst_kcss_key = g_cnst_kcss_hash + 32;
+}
+
+KrawczykSecretSharer::KrawczykSecretSharer(const Randomer& randomer, const size_t& minComputationalSize)
+: DefaultStrongSSharer(randomer), m_minComputationalSize(minComputationalSize)
+{}
+
+size_t KrawczykSecretSharer::EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const
+{
+	if (k == 0 || false == _UseComputational(secretSize, n))
+		return DefaultStrongSSharer::EncodedSize(secretSize, n, k);
+
+	return m_cnst_header_size + InformationDispersal::FragmentSize(secretSize, k);
+}
+
+size_t KrawczykSecretSharer::DecodedSize(const BufferView& sharedSecret) const
+{
+	if (false == _IsComputational(sharedSecret))
+		return DefaultStrongSSharer::DecodedSize(sharedSecret);
+
+	Enco::uint64 size;
+	sharedSecret.Read(&size, g_cnst_kcss_size, sizeof(Enco::uint64));
+	return (size_t)size;
+}
+
+bool KrawczykSecretSharer::Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	if (false == _UseComputational(secretToShare.Size(), n))
+		return DefaultStrongSSharer::Encode(sharedSecrets, n, k, secretToShare);
+
+	if (n == 0 || k == 0 || k > n || sharedSecrets.size() < n)
+		return false;
+
+	const size_t originSize = secretToShare.Size();
+	const size_t fragSize = InformationDispersal::FragmentSize(originSize, k);
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (sharedSecrets[i].Size() < m_cnst_header_size + fragSize)
+			return false;
+	}
+
+	// the key and nonce come from the system generator: any one of shares
+	// 1..k is raw ciphertext, so a guessable key gives its fragment away.
+	// They are shared with plain shamir, straight into each header, on
+	// coefficients of the same generator.
+	Enco::byte keyMaterial[24];
+	{
+		ShareStats::Scope stage(ShareStats::STAGE_RANDOM, m_cnst_key_material_size);
+		if (false == SystemRandom::Fill(keyMaterial, m_cnst_key_material_size))
+			return false;
+	}
+
+	std::vector<MutableBufferView> keyShares;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		keyShares.push_back(sharedSecrets[i].Sub(g_cnst_kcss_key, m_cnst_key_share_size));
+	}
+	const SystemRandomer			keyRandomer;
+	DefaultSecretSharer				keySharer(keyRandomer);
+	if (false == keySharer.Encode(keyShares, n, k, BufferView(keyMaterial, m_cnst_key_material_size)) || keyRandomer.Failed())
+	{
+		memset(keyMaterial, 0, sizeof(keyMaterial));
+		return false;
+	}
+
+	unsigned char hash_value[32] = { 0 };
+	{
+		ShareStats::Scope stage(ShareStats::STAGE_HASH, originSize);
+		sha256(secretToShare.Data(), (unsigned int)originSize, hash_value);
+	}
+
+	GUID id;
+	CoCreateGuid(&id);
+
+	const Enco::uint64 size = originSize;
+	{
+		ShareStats::Scope stage(ShareStats::STAGE_FRAME);
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			Enco::uint32 sidx = i + 1;
+			sharedSecrets[i].Write(0, &id, sizeof(GUID));
+			sharedSecrets[i].Write(g_cnst_kcss_magic, &m_cnst_magic, sizeof(Enco::uint32));
+			sharedSecrets[i].Write(g_cnst_kcss_index, &sidx, sizeof(Enco::uint32));
+			sharedSecrets[i].Write(g_cnst_kcss_k, &k, sizeof(Enco::uint32));
+			sharedSecrets[i].Write(g_cnst_kcss_size, &size, sizeof(Enco::uint64));
+			sharedSecrets[i].Write(g_cnst_kcss_hash, hash_value, 32);
+		}
+	}
+
+	// encrypt each data fragment in place in shares 1..k, then derive the parity
+	// fragments of the same window while it is still in cache.
+	Aes128Ctr				cipher(keyMaterial, keyMaterial + Aes128Ctr::m_cnst_key_size);
+	InformationDispersal	dispersal(n, k);
+	std::vector<Enco::byte const*>	data(k);
+	std::vector<Enco::byte*>		parity(n - k + 1);
+	memset(keyMaterial, 0, sizeof(keyMaterial));
+
+	for (size_t off = 0; off < fragSize; off += m_cnst_block_size)
+	{
+		const size_t count = (fragSize - off < m_cnst_block_size) ? fragSize - off : m_cnst_block_size;
+		{
+			ShareStats::Scope stage(ShareStats::STAGE_CIPHER);
+			for (unsigned int j = 0; j < k; ++j)
+			{
+				Enco::byte*		pDist = sharedSecrets[j].Data() + m_cnst_header_size + off;
+				const size_t	start = fragSize * j + off;
+				size_t			avail = (start < originSize) ? originSize - start : 0;
+				if (avail > count)
+					avail = count;
+
+				cipher.Apply(pDist, secretToShare.Data() + start, avail, start);
+				memset(pDist + avail, 0, count - avail);
+				data[j] = pDist;
+				stage.Bytes(avail);
+			}
+		}
+
+		for (unsigned int p = k; p < n; ++p)
+		{
+			parity[p - k] = sharedSecrets[p].Data() + m_cnst_header_size + off;
+		}
+		ShareStats::Scope stage(ShareStats::STAGE_MATH, count * k);
+		dispersal.EncodeBlock(&data[0], &parity[0], count);
+	}
+
+	return true;
+}
+
+bool KrawczykSecretSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets)
+{
+	if (sharedSecrets.size() <= 0)
+		return false;
+
+	if (false == _IsComputational(sharedSecrets[0]))
+		return DefaultStrongSSharer::Decode(recoverdSecret, sharedSecrets);
+
+	// every share must carry the same set header.
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	Enco::uint64		size;
+	unsigned char		hash_value[32] = { 0 };
+	first.Read(&k, g_cnst_kcss_k, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_kcss_size, sizeof(Enco::uint64));
+	first.Read(hash_value, g_cnst_kcss_hash, 32);
+
+	if (k == 0 || k > 256 || recoverdSecret.Size() < size)
+		return false;
+
+	const size_t originSize = (size_t)size;
+	const size_t fragSize = InformationDispersal::FragmentSize(originSize, k);
+
+	std::vector<BufferView>		chosen;
+	std::vector<unsigned int>	rows;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (false == _IsComputational(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_kcss_k, first.Data() + g_cnst_kcss_k, g_cnst_kcss_key - g_cnst_kcss_k) != 0)
+			return false;
+
+		Enco::uint32 sidx;
+		share.Read(&sidx, g_cnst_kcss_index, sizeof(Enco::uint32));
+		if (sidx == 0 || sidx > 256 || std::find(rows.begin(), rows.end(), sidx - 1) != rows.end())
+			continue;
+
+		if (rows.size() < k)
+		{
+			chosen.push_back(share);
+			rows.push_back(sidx - 1);
+		}
+	}
+
+	if (rows.size() < k || first.Size() < m_cnst_header_size + fragSize)
+		return false;
+
+	std::vector<BufferView> keyShares;
+	for (const BufferView& share : chosen)
+	{
+		keyShares.push_back(share.Sub(g_cnst_kcss_key, m_cnst_key_share_size));
+	}
+
+	Enco::byte keyMaterial[24];
+	if (false == DefaultSecretSharer::Decode(MutableBufferView(keyMaterial, m_cnst_key_material_size), keyShares))
+		return false;
+
+	InformationDispersal dispersal(*std::max_element(rows.begin(), rows.end()) + 1, k);
+	if (false == dispersal.PrepareDecode(rows))
+	{
+		memset(keyMaterial, 0, sizeof(keyMaterial));
+		return false;
+	}
+
+	Aes128Ctr cipher(keyMaterial, keyMaterial + Aes128Ctr::m_cnst_key_size);
+	memset(keyMaterial, 0, sizeof(keyMaterial));
+
+	ScratchScope					scratch(ScratchArena::ThreadLocal());
+	std::vector<Enco::byte const*>	fragments(k);
+	std::vector<Enco::byte*>		data(k);
+	for (unsigned int j = 0; j < k; ++j)
+	{
+		data[j] = (dispersal.FragmentOf(j) < 0) ? scratch.Arena().Allocate<Enco::byte>(m_cnst_block_size) : nullptr;
+	}
+
+	for (size_t off = 0; off < fragSize; off += m_cnst_block_size)
+	{
+		const size_t count = (fragSize - off < m_cnst_block_size) ? fragSize - off : m_cnst_block_size;
+		for (unsigned int t = 0; t < k; ++t)
+		{
+			fragments[t] = chosen[t].Data() + m_cnst_header_size + off;
+		}
+		{
+			ShareStats::Scope stage(ShareStats::STAGE_MATH, count * k);
+			dispersal.DecodeBlock(&fragments[0], &data[0], count);
+		}
+
+		ShareStats::Scope stage(ShareStats::STAGE_CIPHER);
+		for (unsigned int j = 0; j < k; ++j)
+		{
+			const size_t start = fragSize * j + off;
+			if (start >= originSize)
+				break;
+
+			const size_t	avail = (originSize - start < count) ? originSize - start : count;
+			const int		t = dispersal.FragmentOf(j);
+			cipher.Apply(recoverdSecret.Data() + start, (t < 0) ? data[j] : fragments[t], avail, start);
+			stage.Bytes(avail);
+		}
+	}
+
+	unsigned char tmp_hash_value[32] = { 0 };
+	{
+		ShareStats::Scope stage(ShareStats::STAGE_HASH, originSize);
+		sha256(recoverdSecret.Data(), (unsigned int)originSize, tmp_hash_value);
+	}
+	if (memcmp(tmp_hash_value, hash_value, 32) != 0)
+		return false;
+
+	return true;
+}
+
+bool KrawczykSecretSharer::Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets)
+{
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal> ided_secs;
+
+	for (const BufferView& secParts : sharedSecrets)
+	{
+		if (secParts.Size() < sizeof(GUID))
+			continue;
+
+		GUID tempID;
+		secParts.Read(&tempID, 0, sizeof(GUID));
+		ided_secs[tempID].push_back(secParts);
+	}
+
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal>::const_iterator citer;
+	for (citer = ided_secs.begin();
+		citer != ided_secs.end();
+		++citer)
+	{
+		OwnedBuffer recovered(DecodedSize(citer->second[0]));
+		if (true != Decode(recovered.MutableView(), citer->second))
+			continue;
+
+		recoverdSecrets.push_back(std::move(recovered));
+	}
+
+	return true;
+}
+
+bool KrawczykSecretSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares)
+{
+	if (sharedSecrets.size() > 0 && _IsComputational(sharedSecrets[0]))
+		return SecretSharer::Decode(recoverdSecret, sharedSecrets, k, badShares);
+
+	return DefaultStrongSSharer::Decode(recoverdSecret, sharedSecrets, k, badShares);
+}
+
+bool KrawczykSecretSharer::Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index)
+{
+	if (sharedSecrets.size() <= 0)
+		return false;
+
+	if (false == _IsComputational(sharedSecrets[0]))
+		return DefaultStrongSSharer::Repair(repairedShare, sharedSecrets, index);
+
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	Enco::uint64		size;
+	first.Read(&k, g_cnst_kcss_k, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_kcss_size, sizeof(Enco::uint64));
+
+	const size_t fragSize = InformationDispersal::FragmentSize((size_t)size, k);
+	if (k == 0 || k > 256 || index == 0 || index > 256 ||
+		first.Size() < m_cnst_header_size + fragSize || repairedShare.Size() < first.Size())
+		return false;
+
+	std::vector<BufferView>		chosen;
+	std::vector<BufferView>		keyShares;
+	std::vector<unsigned int>	rows;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (false == _IsComputational(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_kcss_k, first.Data() + g_cnst_kcss_k, g_cnst_kcss_key - g_cnst_kcss_k) != 0)
+			return false;
+
+		Enco::uint32 sidx;
+		share.Read(&sidx, g_cnst_kcss_index, sizeof(Enco::uint32));
+		if (sidx == 0 || sidx > 256 || std::find(rows.begin(), rows.end(), sidx - 1) != rows.end())
+			continue;
+
+		if (rows.size() < k)
+		{
+			chosen.push_back(share);
+			keyShares.push_back(share.Sub(g_cnst_kcss_key, m_cnst_key_share_size));
+			rows.push_back(sidx - 1);
+		}
+	}
+
+	if (rows.size() < k)
+		return false;
+
+	InformationDispersal dispersal(256, k);
+	if (false == dispersal.PrepareDecode(rows) ||
+		false == DefaultSecretSharer::Repair(repairedShare.Sub(g_cnst_kcss_key, m_cnst_key_share_size), keyShares, index))
+		return false;
+
+	std::vector<Enco::byte const*> fragments(k);
+	for (size_t off = 0; off < fragSize; off += m_cnst_block_size)
+	{
+		const size_t count = (fragSize - off < m_cnst_block_size) ? fragSize - off : m_cnst_block_size;
+		for (unsigned int t = 0; t < k; ++t)
+		{
+			fragments[t] = chosen[t].Data() + m_cnst_header_size + off;
+		}
+		dispersal.RepairBlock(index - 1, &fragments[0], repairedShare.Data() + m_cnst_header_size + off, count);
+	}
+
+	const Enco::uint32 sidx = index;
+	repairedShare.Write(0, first.Data(), g_cnst_kcss_key);
+	repairedShare.Write(g_cnst_kcss_index, &sidx, sizeof(Enco::uint32));
+	return true;
+}
+
+bool KrawczykSecretSharer::Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k)
+{
+	if (sharedSecrets.size() <= 0)
+		return false;
+
+	if (false == _IsComputational(sharedSecrets[0]))
+		return DefaultStrongSSharer::Refresh(sharedSecrets, k);
+
+	// the threshold of the key is the one recorded in the header.
+	const MutableBufferView&		first = sharedSecrets[0];
+	Enco::uint32					headerK;
+	std::vector<MutableBufferView>	keyShares;
+	first.Read(&headerK, g_cnst_kcss_k, sizeof(Enco::uint32));
+	if (headerK != k)
+		return false;
+	for (const MutableBufferView& share : sharedSecrets)
+	{
+		if (false == _IsComputational(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_kcss_k, first.Data() + g_cnst_kcss_k, g_cnst_kcss_key - g_cnst_kcss_k) != 0)
+			return false;
+
+		keyShares.push_back(share.Sub(g_cnst_kcss_key, m_cnst_key_share_size));
+	}
+
+	return DefaultSecretSharer::Refresh(keyShares, headerK);
+}
+
+size_t KrawczykSecretSharer::ResharedSize(const BufferView& sharedSecret, const unsigned int& n, const unsigned int& k) const
+{
+	// a set keeps its engine, whatever EncodedSize() would pick for the size.
+	if (false == _IsComputational(sharedSecret))
+		return DefaultStrongSSharer::EncodedSize(DefaultStrongSSharer::DecodedSize(sharedSecret), n, k);
+
+	return m_cnst_header_size + InformationDispersal::FragmentSize(DecodedSize(sharedSecret), k);
+}
+
+bool KrawczykSecretSharer::Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets)
+{
+	if (sharedSecrets.size() <= 0)
+		return false;
+
+	if (false == _IsComputational(sharedSecrets[0]))
+		return DefaultStrongSSharer::Reshare(newShares, n, k, sharedSecrets);
+
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		oldK;
+	Enco::uint64		size;
+	first.Read(&oldK, g_cnst_kcss_k, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_kcss_size, sizeof(Enco::uint64));
+
+	const size_t originSize = (size_t)size;
+	const size_t oldFragSize = InformationDispersal::FragmentSize(originSize, oldK);
+	const size_t fragSize = InformationDispersal::FragmentSize(originSize, k);
+	if (oldK == 0 || oldK > 256 || n == 0 || k == 0 || k > n || n > 256 || newShares.size() < n ||
+		first.Size() < m_cnst_header_size + oldFragSize)
+		return false;
+
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (newShares[i].Size() < m_cnst_header_size + fragSize)
+			return false;
+	}
+
+	std::vector<BufferView>		chosen;
+	std::vector<BufferView>		keyShares;
+	std::vector<unsigned int>	rows;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (false == _IsComputational(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_kcss_k, first.Data() + g_cnst_kcss_k, g_cnst_kcss_key - g_cnst_kcss_k) != 0)
+			return false;
+
+		Enco::uint32 sidx;
+		share.Read(&sidx, g_cnst_kcss_index, sizeof(Enco::uint32));
+		if (sidx == 0 || sidx > 256 || std::find(rows.begin(), rows.end(), sidx - 1) != rows.end())
+			continue;
+
+		if (rows.size() < oldK)
+		{
+			chosen.push_back(share);
+			keyShares.push_back(share.Sub(g_cnst_kcss_key, m_cnst_key_share_size));
+			rows.push_back(sidx - 1);
+		}
+	}
+
+	if (rows.size() < oldK)
+		return false;
+
+	InformationDispersal dispersal(*std::max_element(rows.begin(), rows.end()) + 1, oldK);
+	if (false == dispersal.PrepareDecode(rows))
+		return false;
+
+	// the same key under a new k: the ciphertext stays valid as it is.
+	std::vector<MutableBufferView> newKeyShares;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		newKeyShares.push_back(newShares[i].Sub(g_cnst_kcss_key, m_cnst_key_share_size));
+	}
+	if (false == DefaultSecretSharer::Reshare(newKeyShares, n, k, keyShares))
+		return false;
+
+	GUID id;
+	CoCreateGuid(&id);
+
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		Enco::uint32 sidx = i + 1;
+		newShares[i].Write(0, &id, sizeof(GUID));
+		newShares[i].Write(g_cnst_kcss_magic, &m_cnst_magic, sizeof(Enco::uint32));
+		newShares[i].Write(g_cnst_kcss_index, &sidx, sizeof(Enco::uint32));
+		newShares[i].Write(g_cnst_kcss_k, &k, sizeof(Enco::uint32));
+		newShares[i].Write(g_cnst_kcss_size, &size, sizeof(Enco::uint64));
+		newShares[i].Write(g_cnst_kcss_hash, first.Data() + g_cnst_kcss_hash, 32);
+	}
+
+	// rebuild the ciphertext a window at a time straight into the new data
+	// fragments (shares 1..k), where it lives anyway, then derive the parity.
+	ScratchScope					scratch(ScratchArena::ThreadLocal());
+	std::vector<Enco::byte const*>	fragments(oldK);
+	std::vector<Enco::byte*>		data(oldK);
+	for (unsigned int j = 0; j < oldK; ++j)
+	{
+		data[j] = (dispersal.FragmentOf(j) < 0) ? scratch.Arena().Allocate<Enco::byte>(m_cnst_block_size) : nullptr;
+	}
+
+	for (unsigned int j = 0; j < k; ++j)
+	{
+		memset(newShares[j].Data() + m_cnst_header_size, 0, fragSize);
+	}
+
+	for (size_t off = 0; off < oldFragSize; off += m_cnst_block_size)
+	{
+		const size_t count = (oldFragSize - off < m_cnst_block_size) ? oldFragSize - off : m_cnst_block_size;
+		for (unsigned int t = 0; t < oldK; ++t)
+		{
+			fragments[t] = chosen[t].Data() + m_cnst_header_size + off;
+		}
+		dispersal.DecodeBlock(&fragments[0], &data[0], count);
+
+		for (unsigned int j = 0; j < oldK; ++j)
+		{
+			const int			t = dispersal.FragmentOf(j);
+			Enco::byte const*	pSrc = (t < 0) ? data[j] : fragments[t];
+			size_t				start = oldFragSize * j + off;
+			size_t				done = 0;
+			while (done < count && start < originSize)
+			{
+				// a window of the old row may straddle two new rows.
+				const size_t	row = start / fragSize;
+				const size_t	col = start % fragSize;
+				size_t			span = fragSize - col;
+				if (span > count - done)
+					span = count - done;
+				if (span > originSize - start)
+					span = originSize - start;
+
+				memcpy(newShares[row].Data() + m_cnst_header_size + col, pSrc + done, span);
+				done += span;
+				start += span;
+			}
+		}
+	}
+
+	InformationDispersal			encoder(n, k);
+	std::vector<Enco::byte const*>	newData(k);
+	std::vector<Enco::byte*>		parity(n - k + 1);
+	for (size_t off = 0; off < fragSize; off += m_cnst_block_size)
+	{
+		const size_t count = (fragSize - off < m_cnst_block_size) ? fragSize - off : m_cnst_block_size;
+		for (unsigned int j = 0; j < k; ++j)
+		{
+			newData[j] = newShares[j].Data() + m_cnst_header_size + off;
+		}
+		for (unsigned int p = k; p < n; ++p)
+		{
+			parity[p - k] = newShares[p].Data() + m_cnst_header_size + off;
+		}
+		encoder.EncodeBlock(&newData[0], &parity[0], count);
+	}
+
+	return true;
+}
+
+size_t KrawczykSecretSharer::WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const
+{
+	if (_IsComputational(sharedSecret))
+	{
+		symbolSize = 0;
+		return 0;
+	}
+
+	return DefaultStrongSSharer::WindowHeader(sharedSecret, symbolSize);
+}
+
+bool KrawczykSecretSharer::_UseComputational(const size_t& secretSize, const unsigned int& n) const
+{
+	return secretSize >= m_minComputationalSize && n <= 256 && Aes128Ctr::Available();
+}
+
+bool KrawczykSecretSharer::_IsComputational(const BufferView& sharedSecret)
+{
+	if (sharedSecret.Size() < m_cnst_header_size)
+		return false;
+
+	Enco::uint32 magic;
+	sharedSecret.Read(&magic, g_cnst_kcss_magic, sizeof(Enco::uint32));
+	return magic == m_cnst_magic;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// PackedSecretSharer
+
+const Enco::uint32 PackedSecretSharer::m_cnst_magic = ((Enco::uint32)0x53534B50);		// "PKSS", never a valid index
+const size_t PackedSecretSharer::m_cnst_header_size = sizeof(GUID) + 4 * sizeof(Enco::uint32) + sizeof(Enco::uint64) + 32;
+
+namespace
+{
+	const size_t g_cnst_pkss_magic = sizeof(GUID);
+	const size_t g_cnst_pkss_index = g_cnst_pkss_magic + sizeof(Enco::uint32);
+	const size_t g_cnst_pkss_k = g_cnst_pkss_index + sizeof(Enco::uint32);
+	const size_t g_cnst_pkss_t = g_cnst_pkss_k + sizeof(Enco::uint32);
+	const size_t g_cnst_pkss_size = g_cnst_pkss_t + sizeof(Enco::uint32);
+	const size_t g_cnst_pkss_hash = g_cnst_pkss_size + sizeof(Enco::uint64);
+	const size_t g_cnst_pkss_data = g_cnst_pkss_hash + 32;
+}
+
+PackedSecretSharer::PackedSecretSharer(const Randomer& randomer, const unsigned int& privacyThreshold)
+: DefaultSecretSharer(randomer), m_privacyThreshold(privacyThreshold)
+{}
+
+size_t PackedSecretSharer::EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const
+{
+	if (k <= m_privacyThreshold)
+		return m_cnst_header_size;
+
+	const size_t pack = k - m_privacyThreshold;
+	return m_cnst_header_size + sizeof(Enco::uint32) * ((secretSize + pack - 1) / pack);
+}
+
+size_t PackedSecretSharer::DecodedSize(const BufferView& sharedSecret) const
+{
+	if (false == IsPacked(sharedSecret))
+		return 0;
+
+	Enco::uint64 size;
+	sharedSecret.Read(&size, g_cnst_pkss_size, sizeof(Enco::uint64));
+	return (size_t)size;
+}
+
+bool PackedSecretSharer::Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	const unsigned int t = m_privacyThreshold;
+	if (n == 0 || t == 0 || k <= t || k > n || n + k >= m_cnst_shamir_prime || sharedSecrets.size() < n || m_randomer.Failed())
+		return false;
+
+	const unsigned int	pack = k - t;
+	const size_t		originSize = secretToShare.Size();
+	const size_t		groups = (originSize + pack - 1) / pack;
+	const size_t		shareSize = PackedSecretSharer::EncodedSize(originSize, n, k);
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (sharedSecrets[i].Size() < shareSize)
+			return false;
+	}
+
+	unsigned char hash_value[32] = { 0 };
+	sha256(secretToShare.Data(), (unsigned int)originSize, hash_value);
+
+	GUID id;
+	CoCreateGuid(&id);
+
+	const Enco::uint64 size = originSize;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		Enco::uint32 sidx = i + 1;
+		sharedSecrets[i].Write(0, &id, sizeof(GUID));
+		sharedSecrets[i].Write(g_cnst_pkss_magic, &m_cnst_magic, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_pkss_index, &sidx, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_pkss_k, &k, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_pkss_t, &t, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_pkss_size, &size, sizeof(Enco::uint64));
+		sharedSecrets[i].Write(g_cnst_pkss_hash, hash_value, 32);
+	}
+
+	// the polynomial is fixed by its values at the k slot points, so every share
+	// is a fixed combination of the slots: one weight row per share index.
+	ScratchScope		scratch(ScratchArena::ThreadLocal());
+	Enco::uint32*		pPoint = scratch.Arena().Allocate<Enco::uint32>(k);
+	Enco::uint32*		pWeight = scratch.Arena().Allocate<Enco::uint32>(n * k);
+	for (unsigned int s = 0; s < k; ++s)
+	{
+		pPoint[s] = _SlotPoint(s);
+	}
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (false == _LagrangeWeights(pPoint, (int)k, i + 1, pWeight + i * k))
+			return false;
+	}
+
+	size_t				block = m_cnst_encode_tile_bytes / sizeof(Enco::uint32) / k;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*		pSlot = scratch.Arena().Allocate<Enco::uint32>(block * k);
+	Enco::uint64*		pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*		pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+	Enco::byte const*	pChar = secretToShare.Data();
+	for (size_t base = 0; base < groups; base += block)
+	{
+		const size_t count = (groups - base < block) ? groups - base : block;
+
+		// row s of the tile holds slot s of every group: pack secret bytes, then t randoms.
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			const size_t first = (base + idx) * pack;
+			for (unsigned int s = 0; s < pack; ++s)
+			{
+				pSlot[block * s + idx] = (first + s < originSize) ? pChar[first + s] : 0;
+			}
+			for (unsigned int s = pack; s < k; ++s)
+			{
+				pSlot[block * s + idx] = _RandomCoefficient(m_randomer);
+			}
+		}
+
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			_CombineBlock(pSlot, block, pWeight + i * k, (int)k, count, pAcc, pRow);
+			sharedSecrets[i].Write(g_cnst_pkss_data + sizeof(Enco::uint32) * base, pRow, sizeof(Enco::uint32) * count);
+		}
+	}
+
+	return false == m_randomer.Failed();
+}
+
+bool PackedSecretSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets)
+{
+	if (sharedSecrets.size() <= 0 || false == IsPacked(sharedSecrets[0]))
+		return false;
+
+	// every share must carry the same set header.
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	Enco::uint32		t;
+	Enco::uint64		size;
+	unsigned char		hash_value[32] = { 0 };
+	first.Read(&k, g_cnst_pkss_k, sizeof(Enco::uint32));
+	first.Read(&t, g_cnst_pkss_t, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_pkss_size, sizeof(Enco::uint64));
+	first.Read(hash_value, g_cnst_pkss_hash, 32);
+
+	if (t == 0 || k <= t || k >= m_cnst_shamir_prime || recoverdSecret.Size() < size)
+		return false;
+
+	const unsigned int	pack = k - t;
+	const size_t		originSize = (size_t)size;
+	const size_t		groups = (originSize + pack - 1) / pack;
+	if (first.Size() < g_cnst_pkss_data + sizeof(Enco::uint32) * groups)
+		return false;
+
+	ScratchScope			scratch(ScratchArena::ThreadLocal());
+	Enco::uint32*			pIndice = scratch.Arena().Allocate<Enco::uint32>(k);
+	std::vector<BufferView>	chosen;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (false == IsPacked(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_pkss_k, first.Data() + g_cnst_pkss_k, g_cnst_pkss_data - g_cnst_pkss_k) != 0)
+			return false;
+
+		Enco::uint32 sidx;
+		share.Read(&sidx, g_cnst_pkss_index, sizeof(Enco::uint32));
+		if (sidx == 0 || sidx + k >= m_cnst_shamir_prime || std::find(pIndice, pIndice + chosen.size(), sidx) != pIndice + chosen.size())
+			continue;
+
+		if (chosen.size() < k)
+		{
+			pIndice[chosen.size()] = sidx;
+			chosen.push_back(share);
+		}
+	}
+
+	if (chosen.size() < k)
+		return false;
+
+	// one weight row per secret slot, from the chosen indices to that slot point.
+	Enco::uint32* pWeight = scratch.Arena().Allocate<Enco::uint32>(pack * k);
+	for (unsigned int s = 0; s < pack; ++s)
+	{
+		if (false == _LagrangeWeights(pIndice, (int)k, _SlotPoint(s), pWeight + s * k))
+			return false;
+	}
+
+	size_t			block = m_cnst_decode_tile_bytes / sizeof(Enco::uint32) / k;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*	pTile = scratch.Arena().Allocate<Enco::uint32>(block * k);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::byte*		pSlot = scratch.Arena().Allocate<Enco::byte>(block);
+	for (size_t base = 0; base < groups; base += block)
+	{
+		const size_t count = (groups - base < block) ? groups - base : block;
+		for (unsigned int j = 0; j < k; ++j)
+		{
+			chosen[j].Read(pTile + block * j, g_cnst_pkss_data + sizeof(Enco::uint32) * base, sizeof(Enco::uint32) * count);
+		}
+
+		for (unsigned int s = 0; s < pack; ++s)
+		{
+			_CombineBlock(pTile, block, pWeight + s * k, (int)k, count, pAcc, pSlot);
+
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				const size_t pos = (base + idx) * pack + s;
+				if (pos < originSize)
+					recoverdSecret.Data()[pos] = pSlot[idx];
+			}
+		}
+	}
+
+	unsigned char tmp_hash_value[32] = { 0 };
+	sha256(recoverdSecret.Data(), (unsigned int)originSize, tmp_hash_value);
+	if (memcmp(tmp_hash_value, hash_value, 32) != 0)
+		return false;
+
+	return true;
+}
+
+bool PackedSecretSharer::Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets)
+{
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal> ided_secs;
+
+	for (const BufferView& secParts : sharedSecrets)
+	{
+		if (false == IsPacked(secParts))
+			continue;
+
+		GUID tempID;
+		secParts.Read(&tempID, 0, sizeof(GUID));
+		ided_secs[tempID].push_back(secParts);
+	}
+
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal>::const_iterator citer;
+	for (citer = ided_secs.begin();
+		citer != ided_secs.end();
+		++citer)
+	{
+		OwnedBuffer recovered(DecodedSize(citer->second[0]));
+		if (true != Decode(recovered.MutableView(), citer->second))
+			continue;
+
+		recoverdSecrets.push_back(std::move(recovered));
+	}
+
+	return true;
+}
+
+bool PackedSecretSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares)
+{
+	badShares.clear();
+	if (sharedSecrets.size() <= 0)
+		return false;
+
+	// k comes from the majority header, the argument only has to agree with it.
+	const BufferView&	ref = sharedSecrets[_MajorityHeader(sharedSecrets, g_cnst_pkss_data, g_cnst_pkss_index)];
+	Enco::uint32		hk;
+	Enco::uint32		ht;
+	Enco::uint64		size;
+	if (false == IsPacked(ref))
+		return false;
+	ref.Read(&hk, g_cnst_pkss_k, sizeof(Enco::uint32));
+	ref.Read(&ht, g_cnst_pkss_t, sizeof(Enco::uint32));
+	ref.Read(&size, g_cnst_pkss_size, sizeof(Enco::uint64));
+	if (ht == 0 || hk <= ht || hk >= m_cnst_shamir_prime || (k != 0 && k != hk))
+		return false;
+
+	const size_t				groups = ((size_t)size + (hk - ht) - 1) / (hk - ht);
+	std::vector<BufferView>		candidates;
+	std::vector<size_t>			position;
+	std::vector<Enco::uint32>	indice;
+	for (size_t i = 0; i < sharedSecrets.size(); ++i)
+	{
+		Enco::uint32 sidx = 0;
+		if (_SameHeader(sharedSecrets[i], ref, g_cnst_pkss_data, g_cnst_pkss_index))
+			sharedSecrets[i].Read(&sidx, g_cnst_pkss_index, sizeof(Enco::uint32));
+
+		if (sidx == 0 || sidx + hk >= m_cnst_shamir_prime || std::find(indice.begin(), indice.end(), sidx) != indice.end())
+		{
+			badShares.push_back(i);
+			continue;
+		}
+
+		candidates.push_back(sharedSecrets[i]);
+		position.push_back(i);
+		indice.push_back(sidx);
+	}
+
+	if (candidates.size() < hk || ref.Size() < g_cnst_pkss_data + sizeof(Enco::uint32) * groups)
+		return false;
+
+	std::vector<bool> bad;
+	if (false == _FindBadShares(candidates, &indice[0], (int)hk, g_cnst_pkss_data, groups, bad))
+		return false;
+
+	std::vector<BufferView> good;
+	for (size_t c = 0; c < candidates.size(); ++c)
+	{
+		if (bad[c])
+			badShares.push_back(position[c]);
+		else
+			good.push_back(candidates[c]);
+	}
+	std::sort(badShares.begin(), badShares.end());
+
+	return PackedSecretSharer::Decode(recoverdSecret, good);
+}
+
+bool PackedSecretSharer::Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index)
+{
+	if (sharedSecrets.size() <= 0 || false == IsPacked(sharedSecrets[0]))
+		return false;
+
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	Enco::uint32		t;
+	Enco::uint64		size;
+	first.Read(&k, g_cnst_pkss_k, sizeof(Enco::uint32));
+	first.Read(&t, g_cnst_pkss_t, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_pkss_size, sizeof(Enco::uint64));
+	if (t == 0 || k <= t || index == 0 || index + k >= m_cnst_shamir_prime || repairedShare.Size() < first.Size())
+		return false;
+
+	const size_t groups = ((size_t)size + (k - t) - 1) / (k - t);
+	if (first.Size() < g_cnst_pkss_data + sizeof(Enco::uint32) * groups)
+		return false;
+
+	ScratchScope			scratch(ScratchArena::ThreadLocal());
+	Enco::uint32*			pIndice = scratch.Arena().Allocate<Enco::uint32>(k);
+	std::vector<BufferView>	chosen;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (false == IsPacked(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_pkss_k, first.Data() + g_cnst_pkss_k, g_cnst_pkss_data - g_cnst_pkss_k) != 0)
+			return false;
+
+		Enco::uint32 sidx;
+		share.Read(&sidx, g_cnst_pkss_index, sizeof(Enco::uint32));
+		if (sidx == 0 || sidx + k >= m_cnst_shamir_prime || std::find(pIndice, pIndice + chosen.size(), sidx) != pIndice + chosen.size())
+			continue;
+
+		if (chosen.size() < k)
+		{
+			pIndice[chosen.size()] = sidx;
+			chosen.push_back(share);
+		}
+	}
+
+	if (chosen.size() < k)
+		return false;
+
+	Enco::uint32* pWeight = scratch.Arena().Allocate<Enco::uint32>(k);
+	if (false == _LagrangeWeights(pIndice, (int)k, index, pWeight))
+		return false;
+
+	size_t			block = m_cnst_decode_tile_bytes / sizeof(Enco::uint32) / k;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*	pTile = scratch.Arena().Allocate<Enco::uint32>(block * k);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*	pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+	for (size_t base = 0; base < groups; base += block)
+	{
+		const size_t count = (groups - base < block) ? groups - base : block;
+		for (unsigned int j = 0; j < k; ++j)
+		{
+			chosen[j].Read(pTile + block * j, g_cnst_pkss_data + sizeof(Enco::uint32) * base, sizeof(Enco::uint32) * count);
+		}
+
+		_CombineBlock(pTile, block, pWeight, (int)k, count, pAcc, pRow);
+		repairedShare.Write(g_cnst_pkss_data + sizeof(Enco::uint32) * base, pRow, sizeof(Enco::uint32) * count);
+	}
+
+	const Enco::uint32 sidx = index;
+	repairedShare.Write(0, first.Data(), g_cnst_pkss_data);
+	repairedShare.Write(g_cnst_pkss_index, &sidx, sizeof(Enco::uint32));
+	return true;
+}
+
+bool PackedSecretSharer::Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k)
+{
+	if (sharedSecrets.size() <= 0 || false == IsPacked(sharedSecrets[0]) || m_randomer.Failed())
+		return false;
+
+	const MutableBufferView&	first = sharedSecrets[0];
+	Enco::uint32				headerK;
+	Enco::uint32				t;
+	Enco::uint64				size;
+	first.Read(&headerK, g_cnst_pkss_k, sizeof(Enco::uint32));
+	first.Read(&t, g_cnst_pkss_t, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_pkss_size, sizeof(Enco::uint64));
+	if (t == 0 || headerK <= t || headerK != k || headerK >= m_cnst_shamir_prime || sharedSecrets.size() < headerK)
+		return false;
+
+	const unsigned int	pack = headerK - t;
+	const size_t		groups = ((size_t)size + pack - 1) / pack;
+	if (first.Size() < g_cnst_pkss_data + sizeof(Enco::uint32) * groups)
+		return false;
+
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	const size_t	m = sharedSecrets.size();
+	Enco::uint32*	pIndice = scratch.Arena().Allocate<Enco::uint32>(m);
+	for (size_t i = 0; i < m; ++i)
+	{
+		const MutableBufferView& share = sharedSecrets[i];
+		if (false == IsPacked(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_pkss_k, first.Data() + g_cnst_pkss_k, g_cnst_pkss_data - g_cnst_pkss_k) != 0)
+			return false;
+
+		share.Read(&(pIndice[i]), g_cnst_pkss_index, sizeof(Enco::uint32));
+		if (pIndice[i] == 0 || pIndice[i] + headerK >= m_cnst_shamir_prime || std::find(pIndice, pIndice + i, pIndice[i]) != pIndice + i)
+			return false;
+	}
+
+	// d(x) is zero on the pack secret slots and fresh on the t random ones, so
+	// only the last t weights of each share row are needed.
+	Enco::uint32* pPoint = scratch.Arena().Allocate<Enco::uint32>(headerK);
+	Enco::uint32* pWeight = scratch.Arena().Allocate<Enco::uint32>(m * headerK);
+	for (unsigned int s = 0; s < headerK; ++s)
+	{
+		pPoint[s] = _SlotPoint(s);
+	}
+	for (size_t i = 0; i < m; ++i)
+	{
+		if (false == _LagrangeWeights(pPoint, (int)headerK, pIndice[i], pWeight + i * headerK))
+			return false;
+	}
+
+	const KeyedStream	keystream;
+	Aes128Ctr const*	pStream = keystream.Stream();
+
+	size_t			block = m_cnst_encode_tile_bytes / sizeof(Enco::uint32) / t;
+	block = (block < 256) ? 256 : (block & ~((size_t)15));
+	Enco::uint32*	pSlot = scratch.Arena().Allocate<Enco::uint32>(block * t);
+	Enco::uint64*	pAcc = scratch.Arena().Allocate<Enco::uint64>(block);
+	Enco::uint32*	pRow = scratch.Arena().Allocate<Enco::uint32>(block);
+	Enco::uint64	streamOffset = 0;
+	for (size_t base = 0; base < groups; base += block)
+	{
+		const size_t count = (groups - base < block) ? groups - base : block;
+		for (unsigned int s = 0; s < t; ++s)
+		{
+			_RandomCoefficients(m_randomer, pStream, streamOffset, pSlot + block * s, count);
+		}
+
+		for (size_t i = 0; i < m; ++i)
+		{
+			_AccumulateBlock(pSlot, block, pWeight + i * headerK + pack, (int)t, count, pAcc);
+			sharedSecrets[i].Read(pRow, g_cnst_pkss_data + sizeof(Enco::uint32) * base, sizeof(Enco::uint32) * count);
+			for (size_t j = 0; j < count; ++j)
+			{
+				pAcc[j] += pRow[j];
+			}
+			_ReduceBlock(pAcc, count, pRow);
+			sharedSecrets[i].Write(g_cnst_pkss_data + sizeof(Enco::uint32) * base, pRow, sizeof(Enco::uint32) * count);
+		}
+	}
+
+	memset(pSlot, 0, sizeof(Enco::uint32) * block * t);
+	return false == m_randomer.Failed();
+}
+
+size_t PackedSecretSharer::WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const
+{
+	return SecretSharer::WindowHeader(sharedSecret, symbolSize);
+}
+
+bool PackedSecretSharer::IsPacked(const BufferView& sharedSecret)
+{
+	if (sharedSecret.Size() < m_cnst_header_size)
+		return false;
+
+	Enco::uint32 magic;
+	sharedSecret.Read(&magic, g_cnst_pkss_magic, sizeof(Enco::uint32));
+	return magic == m_cnst_magic;
+}
+
+Enco::uint32 PackedSecretSharer::_SlotPoint(const unsigned int& slot)
+{
+	return m_cnst_shamir_prime - 1 - slot;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// DispersalSharer
+
+const Enco::uint32 DispersalSharer::m_cnst_magic = ((Enco::uint32)0x31414449);		// "IDA1", never a valid index
+const size_t DispersalSharer::m_cnst_header_size = sizeof(GUID) + 3 * sizeof(Enco::uint32) + sizeof(Enco::uint64) + 32;
+const size_t DispersalSharer::m_cnst_block_size = ((size_t)64 << 10);
+
+namespace
+{
+	const size_t g_cnst_ida_magic = sizeof(GUID);
+	const size_t g_cnst_ida_index = g_cnst_ida_magic + sizeof(Enco::uint32);
+	const size_t g_cnst_ida_k = g_cnst_ida_index + sizeof(Enco::uint32);
+	const size_t g_cnst_ida_size = g_cnst_ida_k + sizeof(Enco::uint32);
+	const size_t g_cnst_ida_hash = g_cnst_ida_size + sizeof(Enco::uint64);
+}
+
+DispersalSharer::DispersalSharer()
+{}
+
+size_t DispersalSharer::EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const
+{
+	if (k == 0)
+		return m_cnst_header_size;
+
+	return m_cnst_header_size + InformationDispersal::FragmentSize(secretSize, k);
+}
+
+size_t DispersalSharer::DecodedSize(const BufferView& sharedSecret) const
+{
+	if (false == IsDispersal(sharedSecret))
+		return 0;
+
+	Enco::uint64 size;
+	sharedSecret.Read(&size, g_cnst_ida_size, sizeof(Enco::uint64));
+	return (size_t)size;
+}
+
+bool DispersalSharer::Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	if (n == 0 || k == 0 || k > n || n > 256 || sharedSecrets.size() < n)
+		return false;
+
+	const size_t originSize = secretToShare.Size();
+	const size_t fragSize = InformationDispersal::FragmentSize(originSize, k);
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (sharedSecrets[i].Size() < m_cnst_header_size + fragSize)
+			return false;
+	}
+
+	unsigned char hash_value[32] = { 0 };
+	sha256(secretToShare.Data(), (unsigned int)originSize, hash_value);
+
+	GUID id;
+	CoCreateGuid(&id);
+
+	const Enco::uint64 size = originSize;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		Enco::uint32 sidx = i + 1;
+		sharedSecrets[i].Write(0, &id, sizeof(GUID));
+		sharedSecrets[i].Write(g_cnst_ida_magic, &m_cnst_magic, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_ida_index, &sidx, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_ida_k, &k, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_ida_size, &size, sizeof(Enco::uint64));
+		sharedSecrets[i].Write(g_cnst_ida_hash, hash_value, 32);
+	}
+
+	// copy a window of every data fragment into shares 1..k, then derive the
+	// parity fragments of the same window while it is still in cache.
+	InformationDispersal			dispersal(n, k);
+	std::vector<Enco::byte const*>	data(k);
+	std::vector<Enco::byte*>		parity(n - k + 1);
+
+	for (size_t off = 0; off < fragSize; off += m_cnst_block_size)
+	{
+		const size_t count = (fragSize - off < m_cnst_block_size) ? fragSize - off : m_cnst_block_size;
+		for (unsigned int j = 0; j < k; ++j)
+		{
+			Enco::byte*		pDist = sharedSecrets[j].Data() + m_cnst_header_size + off;
+			const size_t	start = fragSize * j + off;
+			size_t			avail = (start < originSize) ? originSize - start : 0;
+			if (avail > count)
+				avail = count;
+
+			if (avail > 0)
+				memcpy(pDist, secretToShare.Data() + start, avail);
+			memset(pDist + avail, 0, count - avail);
+			data[j] = pDist;
+		}
+
+		for (unsigned int p = k; p < n; ++p)
+		{
+			parity[p - k] = sharedSecrets[p].Data() + m_cnst_header_size + off;
+		}
+		dispersal.EncodeBlock(&data[0], &parity[0], count);
+	}
+
+	return true;
+}
+
+bool DispersalSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets)
+{
+	if (sharedSecrets.size() <= 0 || false == IsDispersal(sharedSecrets[0]))
+		return false;
+
+	// every share must carry the same set header.
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	Enco::uint64		size;
+	unsigned char		hash_value[32] = { 0 };
+	first.Read(&k, g_cnst_ida_k, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_ida_size, sizeof(Enco::uint64));
+	first.Read(hash_value, g_cnst_ida_hash, 32);
+
+	if (k == 0 || k > 256 || recoverdSecret.Size() < size)
+		return false;
+
+	const size_t originSize = (size_t)size;
+	const size_t fragSize = InformationDispersal::FragmentSize(originSize, k);
+
+	std::vector<BufferView>		chosen;
+	std::vector<unsigned int>	rows;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (false == IsDispersal(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_ida_k, first.Data() + g_cnst_ida_k, m_cnst_header_size - g_cnst_ida_k) != 0)
+			return false;
+
+		Enco::uint32 sidx;
+		share.Read(&sidx, g_cnst_ida_index, sizeof(Enco::uint32));
+		if (sidx == 0 || sidx > 256 || std::find(rows.begin(), rows.end(), sidx - 1) != rows.end())
+			continue;
+
+		// prefer data shares, they need no math at all.
+		if (rows.size() < k)
+		{
+			chosen.push_back(share);
+			rows.push_back(sidx - 1);
+		}
+		else if (sidx <= k)
+		{
+			for (unsigned int t = 0; t < k; ++t)
+			{
+				if (rows[t] >= k)
+				{
+					chosen[t] = share;
+					rows[t] = sidx - 1;
+					break;
+				}
+			}
+		}
+	}
+
+	if (rows.size() < k || first.Size() < m_cnst_header_size + fragSize)
+		return false;
+
+	InformationDispersal dispersal(*std::max_element(rows.begin(), rows.end()) + 1, k);
+	if (false == dispersal.PrepareDecode(rows))
+		return false;
+
+	// a fragment is a contiguous slice of the secret, so the data shares are
+	// copied out whole and only the missing slices are rebuilt block by block.
+	for (unsigned int j = 0; j < k; ++j)
+	{
+		const int		t = dispersal.FragmentOf(j);
+		const size_t	start = fragSize * j;
+		if (t < 0 || start >= originSize)
+			continue;
+
+		const size_t avail = (originSize - start < fragSize) ? originSize - start : fragSize;
+		memcpy(recoverdSecret.Data() + start, chosen[t].Data() + m_cnst_header_size, avail);
+	}
+
+	if (false == dispersal.Systematic())
+	{
+		ScratchScope					scratch(ScratchArena::ThreadLocal());
+		std::vector<Enco::byte const*>	fragments(k);
+		std::vector<Enco::byte*>		data(k);
+		for (unsigned int j = 0; j < k; ++j)
+		{
+			data[j] = (dispersal.FragmentOf(j) < 0) ? scratch.Arena().Allocate<Enco::byte>(m_cnst_block_size) : nullptr;
+		}
+
+		for (size_t off = 0; off < fragSize; off += m_cnst_block_size)
+		{
+			const size_t count = (fragSize - off < m_cnst_block_size) ? fragSize - off : m_cnst_block_size;
+			for (unsigned int t = 0; t < k; ++t)
+			{
+				fragments[t] = chosen[t].Data() + m_cnst_header_size + off;
+			}
+			dispersal.DecodeBlock(&fragments[0], &data[0], count);
+
+			for (unsigned int j = 0; j < k; ++j)
+			{
+				const size_t start = fragSize * j + off;
+				if (data[j] == nullptr || start >= originSize)
+					continue;
+
+				const size_t avail = (originSize - start < count) ? originSize - start : count;
+				memcpy(recoverdSecret.Data() + start, data[j], avail);
+			}
+		}
+	}
+
+	unsigned char tmp_hash_value[32] = { 0 };
+	sha256(recoverdSecret.Data(), (unsigned int)originSize, tmp_hash_value);
+	if (memcmp(tmp_hash_value, hash_value, 32) != 0)
+		return false;
+
+	return true;
+}
+
+bool DispersalSharer::Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets)
+{
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal> ided_secs;
+
+	for (const BufferView& secParts : sharedSecrets)
+	{
+		if (false == IsDispersal(secParts))
+			continue;
+
+		GUID tempID;
+		secParts.Read(&tempID, 0, sizeof(GUID));
+		ided_secs[tempID].push_back(secParts);
+	}
+
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal>::const_iterator citer;
+	for (citer = ided_secs.begin();
+		citer != ided_secs.end();
+		++citer)
+	{
+		OwnedBuffer recovered(DecodedSize(citer->second[0]));
+		if (true != Decode(recovered.MutableView(), citer->second))
+			continue;
+
+		recoverdSecrets.push_back(std::move(recovered));
+	}
+
+	return true;
+}
+
+bool DispersalSharer::Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index)
+{
+	if (sharedSecrets.size() <= 0 || false == IsDispersal(sharedSecrets[0]))
+		return false;
+
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	Enco::uint64		size;
+	first.Read(&k, g_cnst_ida_k, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_ida_size, sizeof(Enco::uint64));
+
+	const size_t fragSize = InformationDispersal::FragmentSize((size_t)size, k);
+	if (k == 0 || k > 256 || index == 0 || index > 256 ||
+		first.Size() < m_cnst_header_size + fragSize || repairedShare.Size() < first.Size())
+		return false;
+
+	std::vector<BufferView>		chosen;
+	std::vector<unsigned int>	rows;
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (false == IsDispersal(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_ida_k, first.Data() + g_cnst_ida_k, m_cnst_header_size - g_cnst_ida_k) != 0)
+			return false;
+
+		Enco::uint32 sidx;
+		share.Read(&sidx, g_cnst_ida_index, sizeof(Enco::uint32));
+		if (sidx == 0 || sidx > 256 || std::find(rows.begin(), rows.end(), sidx - 1) != rows.end())
+			continue;
+
+		if (rows.size() < k)
+		{
+			chosen.push_back(share);
+			rows.push_back(sidx - 1);
+		}
+	}
+
+	InformationDispersal dispersal(256, k);
+	if (rows.size() < k || false == dispersal.PrepareDecode(rows))
+		return false;
+
+	std::vector<Enco::byte const*> fragments(k);
+	for (size_t off = 0; off < fragSize; off += m_cnst_block_size)
+	{
+		const size_t count = (fragSize - off < m_cnst_block_size) ? fragSize - off : m_cnst_block_size;
+		for (unsigned int t = 0; t < k; ++t)
+		{
+			fragments[t] = chosen[t].Data() + m_cnst_header_size + off;
+		}
+		dispersal.RepairBlock(index - 1, &fragments[0], repairedShare.Data() + m_cnst_header_size + off, count);
+	}
+
+	const Enco::uint32 sidx = index;
+	repairedShare.Write(0, first.Data(), m_cnst_header_size);
+	repairedShare.Write(g_cnst_ida_index, &sidx, sizeof(Enco::uint32));
+	return true;
+}
+
+bool DispersalSharer::IsDispersal(const BufferView& sharedSecret)
+{
+	if (sharedSecret.Size() < m_cnst_header_size)
+		return false;
+
+	Enco::uint32 magic;
+	sharedSecret.Read(&magic, g_cnst_ida_magic, sizeof(Enco::uint32));
+	return magic == m_cnst_magic;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// FieldSecretSharer
+
+namespace
+{
+	const size_t g_cnst_ffss_magic = sizeof(GUID);
+	const size_t g_cnst_ffss_index = g_cnst_ffss_magic + sizeof(Enco::uint32);
+	const size_t g_cnst_ffss_k = g_cnst_ffss_index + sizeof(Enco::uint32);
+	const size_t g_cnst_ffss_size = g_cnst_ffss_k + sizeof(Enco::uint32);
+	const size_t g_cnst_ffss_hash = g_cnst_ffss_size + sizeof(Enco::uint64);
+
+	// 32 keystream bits per element when the stream is there, four randomer
+	// bytes otherwise, reduced by Field::FromRandom().
+	template <typename Field>
+	void _FieldRandom(const Randomer& randomer, Aes128Ctr const * const pStream, Enco::uint64& streamOffset, typename Field::Element *out, const size_t& count)
+	{
+		if (pStream != nullptr)
+		{
+			memset(out, 0, sizeof(Enco::uint32) * count);
+			pStream->Apply((Enco::byte*)out, (Enco::byte const*)out, sizeof(Enco::uint32) * count, streamOffset);
+			streamOffset += sizeof(Enco::uint32) * count;
+		}
+		else
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out[i] = 0;
+				for (int b = 0; b < 4; ++b)
+				{
+					out[i] = (out[i] << 8) | (Enco::byte)randomer.Random();
+				}
+			}
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			out[i] = Field::FromRandom(out[i]);
+		}
+	}
+}
+
+template <typename Field>
+const size_t FieldSecretSharer<Field>::m_cnst_header_size = sizeof(GUID) + 3 * sizeof(Enco::uint32) + sizeof(Enco::uint64) + 32;
+template <typename Field>
+const size_t FieldSecretSharer<Field>::m_cnst_block_size = 4096;
+
+template <typename Field>
+FieldSecretSharer<Field>::FieldSecretSharer(const Randomer& randomer) :
+m_randomer(randomer)
+{}
+
+template <typename Field>
+size_t FieldSecretSharer<Field>::EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const
+{
+	const size_t plain = FieldAlgebra<Field>::PlainBytes();
+	return m_cnst_header_size + (secretSize + plain - 1) / plain * FieldAlgebra<Field>::StoredBytes();
+}
+
+template <typename Field>
+size_t FieldSecretSharer<Field>::DecodedSize(const BufferView& sharedSecret) const
+{
+	if (false == IsFieldShare(sharedSecret))
+		return 0;
+
+	Enco::uint64 size;
+	sharedSecret.Read(&size, g_cnst_ffss_size, sizeof(Enco::uint64));
+	return (size_t)size;
+}
+
+template <typename Field>
+bool FieldSecretSharer<Field>::Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	typedef typename Field::Element	Element;
+	typedef FieldAlgebra<Field>		Algebra;
+
+	if (n == 0 || k == 0 || k > n || n >= Field::Order() || sharedSecrets.size() < n || m_randomer.Failed())
+		return false;
+
+	const size_t originSize = secretToShare.Size();
+	const size_t shareSize = EncodedSize(originSize, n, k);
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (sharedSecrets[i].Size() < shareSize)
+			return false;
+	}
+
+	unsigned char hash_value[32] = { 0 };
+	sha256(secretToShare.Data(), (unsigned int)originSize, hash_value);
+
+	GUID id;
+	CoCreateGuid(&id);
+
+	const Enco::uint32 magic = Field::Magic();
+	const Enco::uint64 size = originSize;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		Enco::uint32 sidx = i + 1;
+		sharedSecrets[i].Write(0, &id, sizeof(GUID));
+		sharedSecrets[i].Write(g_cnst_ffss_magic, &magic, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_ffss_index, &sidx, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_ffss_k, &k, sizeof(Enco::uint32));
+		sharedSecrets[i].Write(g_cnst_ffss_size, &size, sizeof(Enco::uint64));
+		sharedSecrets[i].Write(g_cnst_ffss_hash, hash_value, 32);
+	}
+
+	const KeyedStream	keystream;
+	Aes128Ctr const*	pStream = keystream.Stream();
+
+	// row c of the tile holds coefficient c of every symbol, row 0 the secret;
+	// each share is one Horner pass over the rows.
+	const size_t	plain = Algebra::PlainBytes();
+	const size_t	stored = Algebra::StoredBytes();
+	const size_t	symbols = (shareSize - m_cnst_header_size) / stored;
+	const size_t	block = m_cnst_block_size;
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	Element*		pCoef = scratch.Arena().Allocate<Element>(block * k);
+	Element*		pAcc = scratch.Arena().Allocate<Element>(block);
+	Enco::uint64	streamOffset = 0;
+
+	for (size_t off = 0; off < symbols; off += block)
+	{
+		const size_t count = (symbols - off < block) ? symbols - off : block;
+		for (size_t s = 0; s < count; ++s)
+		{
+			const size_t start = (off + s) * plain;
+			pCoef[s] = Algebra::Pack(secretToShare.Data() + start, (originSize - start < plain) ? originSize - start : plain);
+		}
+		_FieldRandom<Field>(m_randomer, pStream, streamOffset, pCoef + block, block * (k - 1));
+
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			const Element x = i + 1;
+			memcpy(pAcc, pCoef + (size_t)(k - 1) * block, sizeof(Element) * count);
+			for (unsigned int c = k - 1; c > 0; --c)
+			{
+				const Element* pRow = pCoef + (size_t)(c - 1) * block;
+				for (size_t s = 0; s < count; ++s)
+				{
+					pAcc[s] = Field::Add(Field::Multiply(pAcc[s], x), pRow[s]);
+				}
+			}
+
+			Enco::byte* pDist = sharedSecrets[i].Data() + m_cnst_header_size + off * stored;
+			for (size_t s = 0; s < count; ++s)
+			{
+				Algebra::Unpack(pAcc[s], pDist + s * stored, stored);
+			}
+		}
+	}
+
+	memset(pCoef, 0, sizeof(Element) * block * k);
+	memset(pAcc, 0, sizeof(Element) * block);
+	return false == m_randomer.Failed();
+}
+
+template <typename Field>
+bool FieldSecretSharer<Field>::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets)
+{
+	if (sharedSecrets.size() <= 0 || false == IsFieldShare(sharedSecrets[0]))
+		return false;
+
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	Enco::uint64		size;
+	unsigned char		hash_value[32] = { 0 };
+	first.Read(&k, g_cnst_ffss_k, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_ffss_size, sizeof(Enco::uint64));
+	first.Read(hash_value, g_cnst_ffss_hash, 32);
+
+	if (k == 0 || k > sharedSecrets.size() || recoverdSecret.Size() < size ||
+		first.Size() < EncodedSize((size_t)size, k, k))
+		return false;
+
+	ScratchScope				scratch(ScratchArena::ThreadLocal());
+	typename Field::Element*	pX = scratch.Arena().Allocate<typename Field::Element>(k);
+	std::vector<BufferView>		chosen;
+	if (false == _Choose(sharedSecrets, chosen, pX) ||
+		false == _Interpolate(chosen, pX, 0, recoverdSecret.Data(), (size_t)size, true))
+		return false;
+
+	unsigned char tmp_hash_value[32] = { 0 };
+	sha256(recoverdSecret.Data(), (unsigned int)size, tmp_hash_value);
+	if (memcmp(tmp_hash_value, hash_value, 32) != 0)
+		return false;
+
+	return true;
+}
+
+template <typename Field>
+bool FieldSecretSharer<Field>::Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets)
+{
+	std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal> ided_secs;
+
+	for (const BufferView& secParts : sharedSecrets)
+	{
+		if (false == IsFieldShare(secParts))
+			continue;
+
+		GUID tempID;
+		secParts.Read(&tempID, 0, sizeof(GUID));
+		ided_secs[tempID].push_back(secParts);
+	}
+
+	typename std::unordered_map<GUID, std::vector<BufferView>, Enco::guid_hash, Enco::guid_equal>::const_iterator citer;
+	for (citer = ided_secs.begin();
+		citer != ided_secs.end();
+		++citer)
+	{
+		OwnedBuffer recovered(DecodedSize(citer->second[0]));
+		if (true != Decode(recovered.MutableView(), citer->second))
+			continue;
+
+		recoverdSecrets.push_back(std::move(recovered));
+	}
+
+	return true;
+}
+
+template <typename Field>
+bool FieldSecretSharer<Field>::Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index)
+{
+	if (sharedSecrets.size() <= 0 || false == IsFieldShare(sharedSecrets[0]))
+		return false;
+
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	Enco::uint64		size;
+	first.Read(&k, g_cnst_ffss_k, sizeof(Enco::uint32));
+	first.Read(&size, g_cnst_ffss_size, sizeof(Enco::uint64));
+
+	if (k == 0 || k > sharedSecrets.size() || index == 0 || index >= Field::Order() ||
+		first.Size() < EncodedSize((size_t)size, k, k) || repairedShare.Size() < first.Size())
+		return false;
+
+	ScratchScope				scratch(ScratchArena::ThreadLocal());
+	typename Field::Element*	pX = scratch.Arena().Allocate<typename Field::Element>(k);
+	std::vector<BufferView>		chosen;
+	if (false == _Choose(sharedSecrets, chosen, pX))
+		return false;
+
+	// the set header is shared, only the index differs.
+	memcpy(repairedShare.Data(), first.Data(), m_cnst_header_size);
+	repairedShare.Write(g_cnst_ffss_index, &index, sizeof(Enco::uint32));
+	return _Interpolate(chosen, pX, index, repairedShare.Data() + m_cnst_header_size, first.Size() - m_cnst_header_size, false);
+}
+
+template <typename Field>
+bool FieldSecretSharer<Field>::IsFieldShare(const BufferView& sharedSecret)
+{
+	if (sharedSecret.Size() < m_cnst_header_size)
+		return false;
+
+	Enco::uint32 magic;
+	sharedSecret.Read(&magic, g_cnst_ffss_magic, sizeof(Enco::uint32));
+	return magic == Field::Magic();
+}
+
+template <typename Field>
+bool FieldSecretSharer<Field>::_Choose(const std::vector<BufferView>& sharedSecrets, std::vector<BufferView>& chosen, typename Field::Element *pX) const
+{
+	const BufferView&	first = sharedSecrets[0];
+	Enco::uint32		k;
+	first.Read(&k, g_cnst_ffss_k, sizeof(Enco::uint32));
+
+	chosen.clear();
+	for (const BufferView& share : sharedSecrets)
+	{
+		if (false == IsFieldShare(share) || share.Size() != first.Size() ||
+			memcmp(share.Data(), first.Data(), sizeof(GUID)) != 0 ||
+			memcmp(share.Data() + g_cnst_ffss_k, first.Data() + g_cnst_ffss_k, m_cnst_header_size - g_cnst_ffss_k) != 0)
+			return false;
+
+		Enco::uint32 sidx;
+		share.Read(&sidx, g_cnst_ffss_index, sizeof(Enco::uint32));
+		if (sidx == 0 || sidx >= Field::Order() || std::find(pX, pX + chosen.size(), sidx) != pX + chosen.size())
+			continue;
+
+		if (chosen.size() < k)
+		{
+			pX[chosen.size()] = sidx;
+			chosen.push_back(share);
+		}
+	}
+
+	return chosen.size() == k;
+}
+
+template <typename Field>
+bool FieldSecretSharer<Field>::_Interpolate(const std::vector<BufferView>& chosen, const typename Field::Element *pX, const typename Field::Element& target, Enco::byte *pOut, const size_t& outSize, const bool& plain)
+{
+	typedef typename Field::Element	Element;
+	typedef FieldAlgebra<Field>		Algebra;
+
+	const int		m = (int)chosen.size();
+	const size_t	stored = Algebra::StoredBytes();
+	const size_t	width = plain ? Algebra::PlainBytes() : stored;
+	const size_t	symbols = (outSize + width - 1) / width;
+	const size_t	block = m_cnst_block_size;
+	ScratchScope	scratch(ScratchArena::ThreadLocal());
+	Element*		pWeight = scratch.Arena().Allocate<Element>(m);
+	Element*		pAcc = scratch.Arena().Allocate<Element>(block);
+	if (false == Algebra::LagrangeWeights(pX, m, target, pWeight))
+		return false;
+
+	for (size_t off = 0; off < symbols; off += block)
+	{
+		const size_t count = (symbols - off < block) ? symbols - off : block;
+		memset(pAcc, 0, sizeof(Element) * count);
+		for (int j = 0; j < m; ++j)
+		{
+			const Enco::byte*	pSrc = chosen[j].Data() + m_cnst_header_size + off * stored;
+			const Element		w = pWeight[j];
+			for (size_t s = 0; s < count; ++s)
+			{
+				pAcc[s] = Field::Add(pAcc[s], Field::Multiply(w, Algebra::Pack(pSrc + s * stored, stored)));
+			}
+		}
+
+		for (size_t s = 0; s < count; ++s)
+		{
+			// a plain symbol above PlainBytes() means the shares disagree.
+			if (plain && ((Enco::uint64)pAcc[s] >> (8 * width)) != 0)
+				return false;
+
+			const size_t pos = (off + s) * width;
+			Algebra::Unpack(pAcc[s], pOut + pos, (outSize - pos < width) ? outSize - pos : width);
+		}
+	}
+
+	memset(pAcc, 0, sizeof(Element) * block);
+	return true;
+}
+
+template class FieldSecretSharer<ShamirField>;
+template class FieldSecretSharer<Mersenne31Field>;
+template class FieldSecretSharer<Gf256Field>;
+template class FieldSecretSharer<Gf65536Field>;
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ChecksummedSharer
+
+ChecksummedSharer::ChecksummedSharer(SecretSharer& sharer)
+: m_sharer(sharer)
+{}
+
+size_t ChecksummedSharer::EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const
+{
+	const size_t payloadSize = m_sharer.EncodedSize(secretSize, n, k);
+	return payloadSize + ShareChecksum::TrailerSize(payloadSize);
+}
+
+size_t ChecksummedSharer::DecodedSize(const BufferView& sharedSecret) const
+{
+	return m_sharer.DecodedSize(ShareChecksum::Payload(sharedSecret));
+}
+
+bool ChecksummedSharer::Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare)
+{
+	if (sharedSecrets.size() < n)
+		return false;
+
+	const size_t payloadSize = m_sharer.EncodedSize(secretToShare.Size(), n, k);
+	const size_t shareSize = payloadSize + ShareChecksum::TrailerSize(payloadSize);
+
+	std::vector<MutableBufferView> payloads;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (sharedSecrets[i].Size() < shareSize)
+			return false;
+		payloads.push_back(sharedSecrets[i].Sub(0, payloadSize));
+	}
+
+	if (false == m_sharer.Encode(payloads, n, k, secretToShare))
+		return false;
+
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		ShareChecksum::Seal(sharedSecrets[i].Sub(0, shareSize), payloadSize);
+	}
+	return true;
+}
+
+bool ChecksummedSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets)
+{
+	std::vector<BufferView>	payloads;
+	std::vector<size_t>		position;
+	std::vector<size_t>		damaged;
+	_Screen(sharedSecrets, payloads, position, damaged);
+
+	if (payloads.size() <= 0)
+		return false;
+
+	return m_sharer.Decode(recoverdSecret, payloads);
+}
+
+bool ChecksummedSharer::Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets)
+{
+	std::vector<BufferView>	payloads;
+	std::vector<size_t>		position;
+	std::vector<size_t>		damaged;
+	_Screen(sharedSecrets, payloads, position, damaged);
+
+	return m_sharer.Decode(recoverdSecrets, payloads);
+}
+
+bool ChecksummedSharer::Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares)
+{
+	std::vector<BufferView>	payloads;
+	std::vector<size_t>		position;
+	_Screen(sharedSecrets, payloads, position, badShares);
+
+	std::vector<size_t>	innerBad;
+	const bool			result = (payloads.size() > 0) && m_sharer.Decode(recoverdSecret, payloads, k, innerBad);
+	for (const size_t& b : innerBad)
+	{
+		badShares.push_back(position[b]);
+	}
+	std::sort(badShares.begin(), badShares.end());
+
+	return result;
+}
+
+bool ChecksummedSharer::Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index)
+{
+	std::vector<BufferView>	payloads;
+	std::vector<size_t>		position;
+	std::vector<size_t>		damaged;
+	_Screen(sharedSecrets, payloads, position, damaged);
+
+	if (payloads.size() <= 0)
+		return false;
+
+	// shares from before the trailer existed are repaired into the same old format.
+	const size_t	payloadSize = payloads[0].Size();
+	const bool		sealed = ShareChecksum::HasTrailer(sharedSecrets[position[0]]);
+	const size_t	shareSize = sealed ? payloadSize + ShareChecksum::TrailerSize(payloadSize) : payloadSize;
+	if (repairedShare.Size() < shareSize)
+		return false;
+
+	if (false == m_sharer.Repair(repairedShare.Sub(0, payloadSize), payloads, index))
+		return false;
+
+	if (sealed)
+		ShareChecksum::Seal(repairedShare.Sub(0, shareSize), payloadSize);
+	return true;
+}
+
+bool ChecksummedSharer::Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k)
+{
+	// a damaged share would carry its damage into the new set, refuse instead.
+	std::vector<MutableBufferView>	payloads;
+	std::vector<bool>				sealed;
+	std::vector<size_t>				badChunks;
+	for (const MutableBufferView& share : sharedSecrets)
+	{
+		if (false == ShareChecksum::Verify(share, badChunks))
+			return false;
+
+		sealed.push_back(ShareChecksum::HasTrailer(share));
+		payloads.push_back(share.Sub(0, ShareChecksum::Payload(share).Size()));
+	}
+
+	if (false == m_sharer.Refresh(payloads, k))
+		return false;
+
+	for (size_t i = 0; i < payloads.size(); ++i)
+	{
+		if (sealed[i])
+			ShareChecksum::Seal(sharedSecrets[i], payloads[i].Size());
+	}
+	return true;
+}
+
+size_t ChecksummedSharer::ResharedSize(const BufferView& sharedSecret, const unsigned int& n, const unsigned int& k) const
+{
+	const size_t payloadSize = m_sharer.ResharedSize(ShareChecksum::Payload(sharedSecret), n, k);
+	return payloadSize + ShareChecksum::TrailerSize(payloadSize);
+}
+
+bool ChecksummedSharer::Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets)
+{
+	std::vector<BufferView>	payloads;
+	std::vector<size_t>		position;
+	std::vector<size_t>		damaged;
+	_Screen(sharedSecrets, payloads, position, damaged);
+
+	if (payloads.size() <= 0 || newShares.size() < n)
+		return false;
+
+	const size_t payloadSize = m_sharer.ResharedSize(payloads[0], n, k);
+	std::vector<MutableBufferView> newPayloads;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (newShares[i].Size() < payloadSize + ShareChecksum::TrailerSize(payloadSize))
+			return false;
+
+		newPayloads.push_back(newShares[i].Sub(0, payloadSize));
+	}
+
+	if (false == m_sharer.Reshare(newPayloads, n, k, payloads))
+		return false;
+
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		ShareChecksum::Seal(newShares[i].Sub(0, payloadSize + ShareChecksum::TrailerSize(payloadSize)), payloadSize);
+	}
+	return true;
+}
+
+void ChecksummedSharer::_Screen(const std::vector<BufferView>& sharedSecrets, std::vector<BufferView>& payloads, std::vector<size_t>& position, std::vector<size_t>& damaged)
+{
+	payloads.clear();
+	position.clear();
+	damaged.clear();
+
+	std::vector<size_t> badChunks;
+	for (size_t i = 0; i < sharedSecrets.size(); ++i)
+	{
+		if (false == ShareChecksum::Verify(sharedSecrets[i], badChunks))
+		{
+			damaged.push_back(i);
+			continue;
+		}
+
+		payloads.push_back(ShareChecksum::Payload(sharedSecrets[i]));
+		position.push_back(i);
+	}
+}
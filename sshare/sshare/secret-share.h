@@ -5,25 +5,59 @@
 #if !defined(SECRET_SHARE_H)
 #define SECRET_SHARE_H
 
+class Aes128Ctr;
+class KeyedStream;
+
 class Randomer abstract
 {
 public:
 	virtual int	Random() const = 0;
+
+	// true once a draw could not be served from a real source: the bytes
+	// since are not random, and the sharers refuse to go on or to report
+	// success with them.
+	virtual bool	Failed() const { return false; }
 };
 
+/*
+* @class: DefaultRandomer
+*
+* @remarks: bytes of an Aes128Ctr stream whose key and nonce are cut from a
+*           process stream keyed once from SystemRandom, so every object (one
+*           per thread) draws an independent stream; SystemRandom directly
+*           without AES, Failed() once that came back empty. Only the low
+*           byte of Random() is meant to be used.
+*/
 class DefaultRandomer : public Randomer
 {
 public:
 	DefaultRandomer();
+	~DefaultRandomer();
+
+	// deleted:
+	DefaultRandomer(const DefaultRandomer& randomer) = delete;
+	DefaultRandomer& operator=(const DefaultRandomer& randomer) = delete;
 
 public:
 	virtual int Random() const override;
+	virtual bool Failed() const override;
+
+private:
+	void	_Refill() const;
+
+private:
+	Aes128Ctr*				m_pStream;
+	mutable Enco::uint64	m_offset;
+	mutable Enco::byte		m_block[256];
+	mutable size_t			m_used;
+	mutable bool			m_failed;
 };
 
 class FixedBuffer
 {
 public:
 	FixedBuffer(const size_t& sizeInBytes);
+	explicit FixedBuffer(OwnedBuffer&& buffer);
 	virtual ~FixedBuffer();
 
 	// deleted:
@@ -36,6 +70,9 @@ public:
 
 	const size_t Size() const;
 	void* Buffer() const;
+
+	BufferView			View() const;
+	MutableBufferView	MutableView() const;
 private:
 	size_t const		m_size;
 	Enco::byte * const	m_pData;
@@ -45,13 +82,109 @@ private:
 class SecretSharer abstract
 {
 public:
+	/*
+	* @interface: EncodedSize / DecodedSize
+	*
+	* @remarks: size of every shared secret produced for a secret of secretSize
+	*           bytes, and the size of the secret a share belongs to.
+	*/
+	virtual size_t	EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const = 0;
+	virtual size_t	DecodedSize(const BufferView& sharedSecret) const = 0;
+
+	/*
+	* @interface: Encode
+	*
+	* @remarks: writes n shared secrets straight into the caller's storage.
+	*           sharedSecrets MUST hold at least n views of EncodedSize() bytes.
+	*/
+	virtual bool	Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) = 0;
+
+	/*
+	* @interface: Decode
+	*
+	* @remarks: recovers ONE secret from shares of the same set into the caller's
+	*           storage, which MUST hold at least DecodedSize() bytes.
+	*/
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) = 0;
+
+	/*
+	* @interface: Decode
+	*
+	* @remarks: recovers every secret that can be rebuilt from sharedSecrets.
+	*/
+	virtual bool	Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets);
+
+	/*
+	* @interface: Decode
+	*
+	* @remarks: error-correcting decode of ONE k-of-n set. With m shares up to
+	*           (m - k) / 2 corrupted ones are located and left out; badShares
+	*           receives their positions in sharedSecrets. Sharers without a
+	*           correcting code fall back to the plain Decode().
+	*/
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares);
+
+	/*
+	* @interface: Repair
+	*
+	* @remarks: rebuilds the share with the 1-based index from at least k other
+	*           shares of the same set, without recovering the secret. The new
+	*           share fits the existing set; repairedShare MUST be as large as
+	*           the given shares; fewer than k shares are refused. The
+	*           default refuses (returns false).
+	*/
+	virtual bool	Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index);
+
+	/*
+	* @interface: Refresh
+	*
+	* @remarks: re-randomizes a k-of-n set in place; the secret is unchanged and
+	*           never reconstructed. EVERY share still in use MUST be passed, the
+	*           ones left out no longer combine with the refreshed ones. A k
+	*           that is not the set's is refused. The default refuses (returns
+	*           false).
+	*/
+	virtual bool	Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k);
+
+	/*
+	* @interface: Reshare
+	*
+	* @remarks: turns the shares of one set into a new k-of-n set of the same
+	*           secret, a tile at a time, so the plaintext never exists as a
+	*           whole. Size the new shares with ResharedSize(). The default
+	*           refuses (returns false).
+	*/
+	virtual size_t	ResharedSize(const BufferView& sharedSecret, const unsigned int& n, const unsigned int& k) const;
+	virtual bool	Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets);
+
+	/*
+	* @interface: WindowHeader
+	*
+	* @remarks: for callers that stream a set through Repair(), Refresh() and
+	*           Reshare() rather than hold it: the size of the share header,
+	*           and in symbolSize the unit of the body those work on one by
+	*           one. The header followed by any run of whole symbols is then a
+	*           share of the same set. The default returns 0: the share can
+	*           only be handled whole.
+	*/
+	virtual size_t	WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const;
+
+	bool			Encode(std::vector<OwnedBuffer>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare);
+
+	/*
+	* @interface: Encode
+	*
+	* @remarks: all shares land in one contiguous ShareMatrix, row i is share i.
+	*/
+	bool			Encode(ShareMatrix& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare);
+
 	/*
 	* @interface: Encode
 	*
 	* @remarks: MUST RELEASE THE SECRET CONTAINER' DATA, by calling ReleaseSharedSecrets().
 	*/
-	virtual bool	Encode(std::vector<FixedBuffer*>& sharedSecrets, const unsigned int& n, const unsigned int& k, const FixedBuffer& secretToShare) = 0;
-	virtual bool	Decode(std::vector<FixedBuffer*>& recoverdSecrets, const std::vector<FixedBuffer*>& sharedSecrets) = 0;
+	bool			Encode(std::vector<FixedBuffer*>& sharedSecrets, const unsigned int& n, const unsigned int& k, const FixedBuffer& secretToShare);
+	bool			Decode(std::vector<FixedBuffer*>& recoverdSecrets, const std::vector<FixedBuffer*>& sharedSecrets);
 
 	static void		ReleaseSharedSecrets(std::vector<FixedBuffer*>& sharedSecrets);
 };
@@ -62,6 +195,12 @@ public:
 	DefaultSecretSharer(const Randomer& randomer);
 
 public:
+	using SecretSharer::Encode;
+	using SecretSharer::Decode;
+
+	virtual size_t	EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const override;
+	virtual size_t	DecodedSize(const BufferView& sharedSecret) const override;
+
 	/*
 	* @implementation: Encode
 	* @description: 
@@ -72,7 +211,7 @@ public:
 	*   |  * secret data    [  x bytes ]         |
 	*   ------------------------------------------
 	*/
-	virtual bool	Encode(std::vector<FixedBuffer*>& sharedSecrets, const unsigned int& n, const unsigned int& k, const FixedBuffer& secretToShare) override;
+	virtual bool	Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) override;
 
 	/*
 	* @implementation: Decode
@@ -84,9 +223,41 @@ public:
 	*   |  * secret data    [  x bytes ]         |
 	*   ------------------------------------------
 	*/
-	virtual bool	Decode(std::vector<FixedBuffer*>& recoverdSecrets, const std::vector<FixedBuffer*>& sharedSecrets) override;
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) override;
 
-private: 	// math tools
+	/*
+	* @implementation: Decode
+	* @description: the shares of one byte are a Reed-Solomon codeword. Syndromes
+	*               flag the bytes where the shares disagree, and only those are
+	*               run through Berlekamp-Welch to locate the bad shares.
+	*/
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares) override;
+
+	/*
+	* @implementation: Repair
+	* @description: the shares carry no k, so ALL given shares are interpolated;
+	*               fewer than k of them are caught as their value at 0 is no byte.
+	*/
+	virtual bool	Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index) override;
+
+	/*
+	* @implementation: Refresh
+	* @description: adds d(x) = r1 x + ... + r(k-1) x^(k-1) to every share, with
+	*               fresh r per byte drawn tile by tile, once a first pass has
+	*               found the shares on a polynomial of degree k - 1.
+	*/
+	virtual bool	Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k) override;
+
+	/*
+	* @implementation: Reshare
+	* @description: interpolates one tile of secret bytes from the old shares,
+	*               encodes it straight into the new ones and wipes it. Tiles
+	*               are spread over all cores when the AES keystream is used.
+	*/
+	virtual bool	Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets) override;
+	virtual size_t	WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const override;
+
+protected: 	// math tools, ShamirField of field.h
 	static Enco::uint32 _Power(Enco::uint32 a, int b);
 	static Enco::uint32 _Multiply(Enco::uint32 a, Enco::uint32 b);
 	static Enco::uint32 _Sub(Enco::uint32 a, Enco::uint32 b);
@@ -97,14 +268,56 @@ private: 	// math tools
 	static void _MulRow(Enco::uint32 *row, unsigned int a, int k);
 	static void _SolveMatrix(Enco::uint32 **eqn, int k);
 
-	static Enco::uint32* _Encode(Enco::uint32 secret, int n, int k, const Randomer& randomer, Enco::uint32 *shares);
-	static Enco::uint32  _Decode(Enco::uint32 *x, Enco::uint32 *shares, int k);
+	// block kernels: tile holds m rows of count symbols, stride symbols apart, and
+	// acc receives sum(weights[j] * row j). Decode weights are the lagrange basis at
+	// x = 0, encode weights are the powers of one share index.
+	static bool _LagrangeWeights(const Enco::uint32 *x, int m, Enco::uint32 *weights);
+	static bool _LagrangeWeights(const Enco::uint32 *x, int m, Enco::uint32 target, Enco::uint32 *weights);
+	static void _AccumulateBlock(const Enco::uint32 *tile, size_t stride, const Enco::uint32 *weights, int m, size_t count, Enco::uint64 *acc);
+	static void _ReduceBlock(const Enco::uint64 *acc, size_t count, Enco::uint32 *out);
+	static void _ReduceBlock(const Enco::uint64 *acc, size_t count, Enco::byte *out);
 
-private:
+	// _AccumulateBlock() + _ReduceBlock(). m = 2..8 runs a _CombineFixed<m>
+	// instantiation in one pass, anything else the generic pair through acc.
+	template <typename T>
+	static void _CombineBlock(const Enco::uint32 *tile, size_t stride, const Enco::uint32 *weights, int m, size_t count, Enco::uint64 *acc, T *out);
+	template <int M, typename T>
+	static void _CombineFixed(const Enco::uint32 *tile, size_t stride, const Enco::uint32 *weights, size_t count, T *out);
+
+	static Enco::uint32 _RandomCoefficient(const Randomer& randomer);
+
+	// the symbol part of Encode() / Decode(): symbol i of a share lives at soff + 4 i,
+	// so the same loops serve whole shares and the chunks of StreamSecretSharer.
+	bool _EncodeSymbols(const std::vector<MutableBufferView>& sharedSecrets, const size_t& soff, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare);
+	static void _DecodeSymbols(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const size_t& soff, const Enco::uint32 *weights, int m, size_t count);
+
+	// Encode() for large n: every share index at once by ProgressionEvaluator.
+	bool _EncodeProgression(const std::vector<MutableBufferView>& sharedSecrets, const size_t& soff, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare);
+
+	// bulk coefficients for refresh: the keystream of a KeyedStream (pStream) when
+	// available, otherwise the randomer itself.
+	static void _RandomCoefficients(const Randomer& randomer, Aes128Ctr const * const pStream, Enco::uint64& streamOffset, Enco::uint32 *out, size_t count);
+
+	// error correction: shares hold symbols uint32 apart from offset on, evaluated
+	// at x from a polynomial of degree < k. bad receives the shares found corrupted.
+	static bool _FindBadShares(const std::vector<BufferView>& shares, const Enco::uint32 *x, int k, size_t offset, size_t symbols, std::vector<bool>& bad);
+	static bool _WelchBerlekamp(const Enco::uint32 *x, const Enco::uint32 *y, int m, int k, std::vector<bool>& bad);
+
+	// true when the shares lie on one polynomial of degree exactly k - 1: the
+	// first k predict every other share, the first k - 1 do not predict share
+	// k - 1. Never evaluated at 0, so nothing of the secret is formed.
+	static bool _CheckThreshold(const std::vector<BufferView>& shares, const Enco::uint32 *x, int k, size_t offset, size_t symbols);
+
+	// c_buffer holds k coefficients; eqn_all/eqn hold k*(k+1) cells and k row pointers.
+	static Enco::uint32* _Encode(Enco::uint32 secret, int n, int k, const Randomer& randomer, Enco::uint32 *shares, Enco::uint32 *c_buffer);
+	static Enco::uint32  _Decode(Enco::uint32 *x, Enco::uint32 *shares, int k, Enco::uint32 *eqn_all, Enco::uint32 **eqn);
+
+protected:
 	const Randomer&				m_randomer;
 
-	static const Enco::uint32	m_cnst_shamir_threshold;
-	static const Enco::uint32	m_cnst_shamir_prime;
+	static const Enco::uint32	m_cnst_shamir_prime;		// ShamirField::Order()
+	static const size_t			m_cnst_decode_tile_bytes;
+	static const size_t			m_cnst_encode_tile_bytes;
 };
 
 class DefaultStrongSSharer : public DefaultSecretSharer
@@ -113,6 +326,12 @@ public:
 	DefaultStrongSSharer(const Randomer& randomer);
 
 public:
+	using DefaultSecretSharer::Encode;
+	using DefaultSecretSharer::Decode;
+
+	virtual size_t	EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const override;
+	virtual size_t	DecodedSize(const BufferView& sharedSecret) const override;
+
 	/*
 	* @implementation: Encode
 	* @description:
@@ -124,7 +343,7 @@ public:
 	*   |  * secret data    [  x bytes ]         |
 	*   ------------------------------------------
 	*/
-	virtual bool	Encode(std::vector<FixedBuffer*>& sharedSecrets, const unsigned int& n, const unsigned int& k, const FixedBuffer& secretToShare) override;
+	virtual bool	Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) override;
 
 	/*
 	* @implementation: Decode
@@ -137,7 +356,510 @@ public:
 	*   |  * secret data    [  x bytes ]         |
 	*   ------------------------------------------
 	*/
-	virtual bool	Decode(std::vector<FixedBuffer*>& recoverdSecrets, const std::vector<FixedBuffer*>& sharedSecrets) override;
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares) override;
+	virtual bool	Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index) override;
+	virtual bool	Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k) override;
+
+	/*
+	* @implementation: Reshare
+	* @description: the new set gets a GUID of its own.
+	*/
+	virtual bool	Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets) override;
+	virtual size_t	WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const override;
+
+	/*
+	* @implementation: Decode
+	* @description: groups the shares by their GUID code and recovers every set.
+	*/
+	virtual bool	Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets) override;
+};
+
+/*
+* @class: BatchSecretSharer
+*
+* @remarks: many small secrets of one size under the same n and k, for key
+*           splitting at high rates. Every secret gets coefficients and a set
+*           GUID of its own and its shares are plain DefaultStrongSSharer
+*           shares, but the work runs across secrets: the lanes of the block
+*           kernels hold the same byte of neighbouring secrets.
+*
+*           Secrets are structure-of-arrays, byte b of secret s is
+*           pSecrets[b * count + s]. Shares are share-major, the share of
+*           secret s for index i starts at RecordSize() * (i * count + s).
+*/
+class BatchSecretSharer : public DefaultStrongSSharer
+{
+public:
+	BatchSecretSharer(const Randomer& randomer);
+
+public:
+	using DefaultStrongSSharer::Encode;
+	using DefaultStrongSSharer::Decode;
+
+	// one share of a secretSize-byte secret.
+	size_t			RecordSize(const size_t& secretSize) const;
+
+	/*
+	* @interface: EncodeBatch
+	*
+	* @remarks: pShares holds n * count records. Set GUIDs and coefficients come
+	*           from one KeyedStream, keyed by the system CSPRNG.
+	*/
+	bool			EncodeBatch(Enco::byte * const pShares, const unsigned int& n, const unsigned int& k, Enco::byte const * const pSecrets, const size_t& secretSize, const size_t& count);
+
+	/*
+	* @interface: DecodeBatch
+	*
+	* @remarks: shareRows[j] holds the count records of one index, in the order
+	*           of the secrets, so one set of lagrange weights serves the whole
+	*           batch. failed receives the secrets whose shares disagree or miss
+	*           their hash; their bytes in pSecrets are zeroed.
+	*/
+	bool			DecodeBatch(Enco::byte * const pSecrets, const size_t& secretSize, const size_t& count, const std::vector<BufferView>& shareRows, std::vector<size_t>& failed);
+};
+
+/*
+* @class: FixedSecretSharer
+*
+* @remarks: DefaultStrongSSharer shares of an L-byte secret (instantiated for
+*           16, 32 and 64) in caller-provided std::arrays, with no heap
+*           allocation and no virtual call per secret. Coefficients come
+*           from a KeyedStream of its own, set GUIDs from CoCreateGuid(), and
+*           the randomer is only used without AES; one object serves one
+*           thread. k and the shares given to Decode() are at most
+*           m_cnst_max_threshold.
+*/
+template <size_t L>
+class FixedSecretSharer
+{
+public:
+	static const size_t			m_cnst_share_size = sizeof(GUID) + sizeof(Enco::uint32) + 32 + sizeof(Enco::uint32) * L;
+	static const unsigned int	m_cnst_max_threshold = 32;
+
+	typedef std::array<Enco::byte, L>					Secret;
+	typedef std::array<Enco::byte, m_cnst_share_size>	Share;
+
+public:
+	explicit FixedSecretSharer(const Randomer& randomer);
+	~FixedSecretSharer();
+
+	// deleted:
+	FixedSecretSharer(const FixedSecretSharer& sharer) = delete;
+	FixedSecretSharer& operator=(const FixedSecretSharer& sharer) = delete;
+
+public:
+	/*
+	* @interface: Encode
+	*
+	* @remarks: fills pShares[0..n-1].
+	*/
+	bool			Encode(Share * const pShares, const unsigned int& n, const unsigned int& k, const Secret& secret);
+
+	/*
+	* @interface: Decode
+	*
+	* @remarks: m shares of one set, all of them used.
+	*/
+	static bool		Decode(Secret& secret, Share const * const pShares, const unsigned int& m);
+
+private:
+	// count bytes of the stream, or of the randomer when there is no AES.
+	void			_Random(Enco::byte * const pOut, const size_t& count);
+
+private:
+	const Randomer&		m_randomer;
+	KeyedStream*		m_pStream;
+	Enco::uint64		m_streamOffset;
+};
+
+/*
+* @class: StreamSecretSharer
+*
+* @remarks: DefaultStrongSSharer shares written and read a chunk at a time,
+*           for secrets that are never in memory as a whole. A share is its
+*           m_cnst_header_size bytes of header, then 4 bytes per secret byte;
+*           the header holds the hash of the whole secret, so it is the last
+*           thing an encoding writes. One object runs one stream at a time
+*           and starts over with the next Begin*().
+*/
+class StreamSecretSharer : public DefaultStrongSSharer
+{
+public:
+	static const size_t		m_cnst_header_size;
+
+public:
+	StreamSecretSharer(const Randomer& randomer);
+
+	// deleted:
+	StreamSecretSharer(const StreamSecretSharer& sharer) = delete;
+	StreamSecretSharer& operator=(const StreamSecretSharer& sharer) = delete;
+
+public:
+	using DefaultStrongSSharer::Encode;
+	using DefaultStrongSSharer::Decode;
+
+	/*
+	* @interface: BeginEncode / EncodeChunk / FinishEncode
+	*
+	* @remarks: EncodeChunk() writes the 4 * chunk.Size() bytes that follow
+	*           the previous chunk's in every share to the start of bodies[i],
+	*           share i + 1. FinishEncode() writes the n headers.
+	*/
+	bool			BeginEncode(const unsigned int& n, const unsigned int& k);
+	bool			EncodeChunk(const std::vector<MutableBufferView>& bodies, const BufferView& chunk);
+	bool			FinishEncode(const std::vector<MutableBufferView>& headers);
+
+	/*
+	* @interface: BeginDecode / DecodeChunk / FinishDecode
+	*
+	* @remarks: BeginDecode() takes the headers of the shares to combine, all of
+	*           one set. Every DecodeChunk() takes the next bytes of each body,
+	*           the same multiple of 4 from all of them in the same order, and
+	*           recovers a quarter as many secret bytes. Nothing is verified
+	*           before FinishDecode() checks the hash: when it fails, all the
+	*           recovered bytes MUST be thrown away.
+	*/
+	bool			BeginDecode(const std::vector<BufferView>& headers);
+	bool			DecodeChunk(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& bodies);
+	bool			FinishDecode();
+
+	// secret bytes gone through the running stream.
+	Enco::uint64	Processed() const;
+
+private:
+	void			_Hash(Enco::byte const * const pData, const size_t& size);
+
+private:
+	enum State
+	{
+		STATE_IDLE,
+		STATE_ENCODING,
+		STATE_DECODING
+	};
+
+	State						m_state;
+	unsigned int				m_n;
+	unsigned int				m_k;
+	Enco::uint64				m_processed;
+	GUID						m_id;
+	unsigned char				m_digest[32];
+	sha256_ctx					m_hash;
+	std::vector<Enco::uint32>	m_weights;
+};
+
+class KrawczykSecretSharer : public DefaultStrongSSharer
+{
+public:
+	KrawczykSecretSharer(const Randomer& randomer, const size_t& minComputationalSize = m_cnst_min_computational_size);
+
+public:
+	using DefaultStrongSSharer::Encode;
+	using DefaultStrongSSharer::Decode;
+
+	virtual size_t	EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const override;
+	virtual size_t	DecodedSize(const BufferView& sharedSecret) const override;
+
+	/*
+	* @implementation: Encode
+	* @description: computational sharing. The secret is encrypted with AES-128-CTR
+	*               under a random key, the key and nonce are Shamir-shared and the
+	*               ciphertext is dispersed so every share is about |secret| / k.
+	*               Secrets below minComputationalSize (or n > 256, or no AES)
+	*               get plain DefaultStrongSSharer shares instead.
+	* @protocal:
+	*   ------------------------------------------
+	*   |  * GUID code      [ id bytes ]         |
+	*   |  * scheme magic   [  4 bytes ]         |
+	*   |  * shared index   [  4 bytes ]         |
+	*   |  * threshold k    [  4 bytes ]         |
+	*   |  * secret size    [  8 bytes ]         |
+	*   |  * sha256 value   [ 32 bytes ]         |
+	*   |  * key share      [132 bytes ]         |
+	*   |  * fragment       [ x/k bytes ]        |
+	*   ------------------------------------------
+	*/
+	virtual bool	Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) override;
+
+	/*
+	* @implementation: Decode
+	* @description: accepts computational shares as well as plain strong shares.
+	*               Only the plain ones can be corrected.
+	*/
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares) override;
+
+	/*
+	* @implementation: Repair
+	* @description: the key share is re-interpolated and the fragment re-dispersed
+	*               from the ciphertext fragments; nothing is decrypted.
+	*/
+	virtual bool	Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index) override;
+
+	/*
+	* @implementation: Refresh
+	* @description: only the Shamir-shared key is refreshed; the ciphertext
+	*               fragments carry no randomness of their own. k MUST be the
+	*               one in the header.
+	*/
+	virtual bool	Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k) override;
+
+	/*
+	* @implementation: Reshare
+	* @description: reshares the key and re-disperses the ciphertext over the
+	*               new k, the file is never decrypted. n must stay <= 256.
+	*/
+	virtual size_t	ResharedSize(const BufferView& sharedSecret, const unsigned int& n, const unsigned int& k) const override;
+	virtual bool	Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets) override;
+
+	/*
+	* @implementation: WindowHeader
+	* @description: computational shares are handled whole, the fragments
+	*               are laid out by the size in the header.
+	*/
+	virtual size_t	WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const override;
+
+public:
+	static const size_t			m_cnst_min_computational_size;
+
+private:
+	bool			_UseComputational(const size_t& secretSize, const unsigned int& n) const;
+	static bool		_IsComputational(const BufferView& sharedSecret);
+
+private:
+	size_t						m_minComputationalSize;
+
+	static const Enco::uint32	m_cnst_magic;
+	static const size_t			m_cnst_key_material_size;
+	static const size_t			m_cnst_key_share_size;
+	static const size_t			m_cnst_header_size;
+	static const size_t			m_cnst_block_size;
+};
+
+class PackedSecretSharer : public DefaultSecretSharer
+{
+public:
+	PackedSecretSharer(const Randomer& randomer, const unsigned int& privacyThreshold);
+
+public:
+	using DefaultSecretSharer::Encode;
+	using DefaultSecretSharer::Decode;
+
+	virtual size_t	EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const override;
+	virtual size_t	DecodedSize(const BufferView& sharedSecret) const override;
+
+	/*
+	* @implementation: Encode
+	* @description: ramp sharing. One polynomial of degree k - 1 carries k - t
+	*               secret bytes plus t random values, so any k shares recover the
+	*               secret while any t shares reveal nothing; t + 1 .. k - 1
+	*               shares leak partial information. Shares and randomness both
+	*               shrink by the packing factor k - t.
+	* @protocal:
+	*   ------------------------------------------
+	*   |  * GUID code      [ id bytes ]         |
+	*   |  * scheme magic   [  4 bytes ]         |
+	*   |  * shared index   [  4 bytes ]         |
+	*   |  * threshold k    [  4 bytes ]         |
+	*   |  * privacy t      [  4 bytes ]         |
+	*   |  * secret size    [  8 bytes ]         |
+	*   |  * sha256 value   [ 32 bytes ]         |
+	*   |  * secret data    [ 4x/(k-t) bytes ]   |
+	*   ------------------------------------------
+	*/
+	virtual bool	Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) override;
+
+	/*
+	* @implementation: Decode
+	* @description: k and t are read from the shares, not from the sharer.
+	*/
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares) override;
+	virtual bool	Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index) override;
+
+	/*
+	* @implementation: Refresh
+	* @description: adds a polynomial that is zero on every secret slot. k and t
+	*               come from the header, a different k is refused.
+	*/
+	virtual bool	Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k) override;
+
+	/*
+	* @implementation: WindowHeader
+	* @description: packed shares are handled whole, the groups are laid out
+	*               by the size in the header.
+	*/
+	virtual size_t	WindowHeader(const BufferView& sharedSecret, size_t& symbolSize) const override;
+
+	static bool		IsPacked(const BufferView& sharedSecret);
+
+private:
+	// the secret slots sit at x = p - 1 .. p - L and the random ones below them.
+	static Enco::uint32	_SlotPoint(const unsigned int& slot);
+
+private:
+	unsigned int				m_privacyThreshold;
+
+	static const Enco::uint32	m_cnst_magic;
+	static const size_t			m_cnst_header_size;
+};
+
+class DispersalSharer : public SecretSharer
+{
+public:
+	DispersalSharer();
+
+public:
+	using SecretSharer::Encode;
+	using SecretSharer::Decode;
+
+	virtual size_t	EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const override;
+	virtual size_t	DecodedSize(const BufferView& sharedSecret) const override;
+
+	/*
+	* @implementation: Encode
+	* @description: Rabin information dispersal, NOT secret sharing: any k of the
+	*               n <= 256 shares rebuild the data, but fewer than k shares
+	*               reveal parts of it. Shares 1..k hold the data as is, the
+	*               others hold Cauchy parity, so every share is |secret| / k.
+	* @protocal:
+	*   ------------------------------------------
+	*   |  * GUID code      [ id bytes ]         |
+	*   |  * scheme magic   [  4 bytes ]         |
+	*   |  * shared index   [  4 bytes ]         |
+	*   |  * threshold k    [  4 bytes ]         |
+	*   |  * secret size    [  8 bytes ]         |
+	*   |  * sha256 value   [ 32 bytes ]         |
+	*   |  * fragment       [ x/k bytes ]        |
+	*   ------------------------------------------
+	*/
+	virtual bool	Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) override;
+
+	/*
+	* @implementation: Decode
+	* @description: when shares 1..k are all present the data is only copied.
+	*/
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index) override;
+
+	static bool		IsDispersal(const BufferView& sharedSecret);
+
+private:
+	static const Enco::uint32	m_cnst_magic;
+	static const size_t			m_cnst_header_size;
+	static const size_t			m_cnst_block_size;
+};
+
+/*
+* @class: FieldSecretSharer
+*
+* @remarks: Shamir sharing over any field policy of field.h, with the encode,
+*           decode and repair loops written once. Instantiated in
+*           secret-share.cpp for ShamirField, Mersenne31Field, Gf256Field and
+*           Gf65536Field; a new field needs its policy and one more line there.
+*/
+template <typename Field>
+class FieldSecretSharer : public SecretSharer
+{
+public:
+	FieldSecretSharer(const Randomer& randomer);
+
+public:
+	using SecretSharer::Encode;
+	using SecretSharer::Decode;
+
+	virtual size_t	EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const override;
+	virtual size_t	DecodedSize(const BufferView& sharedSecret) const override;
+
+	/*
+	* @implementation: Encode
+	* @description: every PlainBytes() bytes of the secret are the constant term
+	*               of a polynomial of degree k - 1 over Field, share i holds its
+	*               value at x = i in StoredBytes(). n < Field::Order().
+	* @protocal:
+	*   ------------------------------------------
+	*   |  * GUID code      [ id bytes ]         |
+	*   |  * field magic    [  4 bytes ]         |
+	*   |  * shared index   [  4 bytes ]         |
+	*   |  * threshold k    [  4 bytes ]         |
+	*   |  * secret size    [  8 bytes ]         |
+	*   |  * sha256 value   [ 32 bytes ]         |
+	*   |  * symbols        [ StoredBytes() each]|
+	*   ------------------------------------------
+	*/
+	virtual bool	Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) override;
+
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index) override;
+
+	static bool		IsFieldShare(const BufferView& sharedSecret);
+
+private:
+	// picks k shares of one set with distinct indices into pX / chosen.
+	bool			_Choose(const std::vector<BufferView>& sharedSecrets, std::vector<BufferView>& chosen, typename Field::Element *pX) const;
+
+	// the lagrange combination of the chosen shares at target, tile by tile.
+	// pOut receives PlainBytes() per symbol when plain, StoredBytes() otherwise.
+	static bool		_Interpolate(const std::vector<BufferView>& chosen, const typename Field::Element *pX, const typename Field::Element& target, Enco::byte *pOut, const size_t& outSize, const bool& plain);
+
+private:
+	const Randomer&				m_randomer;
+
+	static const size_t			m_cnst_header_size;
+	static const size_t			m_cnst_block_size;		// symbols per tile
+};
+
+class ChecksummedSharer : public SecretSharer
+{
+public:
+	ChecksummedSharer(SecretSharer& sharer);
+
+public:
+	using SecretSharer::Encode;
+	using SecretSharer::Decode;
+
+	virtual size_t	EncodedSize(const size_t& secretSize, const unsigned int& n, const unsigned int& k) const override;
+	virtual size_t	DecodedSize(const BufferView& sharedSecret) const override;
+
+	/*
+	* @implementation: Encode
+	* @description: shares of the wrapped sharer, each sealed with a ShareChecksum
+	*               trailer.
+	*/
+	virtual bool	Encode(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& n, const unsigned int& k, const BufferView& secretToShare) override;
+
+	/*
+	* @implementation: Decode
+	* @description: shares failing their checksums are dropped before the wrapped
+	*               sharer sees them, so it falls back to the remaining ones.
+	*/
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(std::vector<OwnedBuffer>& recoverdSecrets, const std::vector<BufferView>& sharedSecrets) override;
+	virtual bool	Decode(const MutableBufferView& recoverdSecret, const std::vector<BufferView>& sharedSecrets, const unsigned int& k, std::vector<size_t>& badShares) override;
+
+	/*
+	* @implementation: Repair
+	* @description: the repaired share is sealed when the set carries checksums.
+	*/
+	virtual bool	Repair(const MutableBufferView& repairedShare, const std::vector<BufferView>& sharedSecrets, const unsigned int& index) override;
+
+	/*
+	* @implementation: Refresh
+	* @description: refuses damaged shares and re-seals the refreshed ones.
+	*/
+	virtual bool	Refresh(const std::vector<MutableBufferView>& sharedSecrets, const unsigned int& k) override;
+	virtual size_t	ResharedSize(const BufferView& sharedSecret, const unsigned int& n, const unsigned int& k) const override;
+	virtual bool	Reshare(const std::vector<MutableBufferView>& newShares, const unsigned int& n, const unsigned int& k, const std::vector<BufferView>& sharedSecrets) override;
+
+private:
+	static void		_Screen(const std::vector<BufferView>& sharedSecrets, std::vector<BufferView>& payloads, std::vector<size_t>& position, std::vector<size_t>& damaged);
+
+private:
+	SecretSharer&	m_sharer;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,313 @@
+// share-stats.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "perf-counters.h"
+#include "share-stats.h"
+
+#include <chrono>
+#include <iomanip>
+#if !defined(_WIN32)
+#	include <time.h>
+#endif
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// ShareStats
+
+namespace
+{
+	thread_local ShareStats*			g_pAttached = nullptr;
+	thread_local ShareStats::Scope*		g_pInnermost = nullptr;
+
+	double _Milliseconds(const Enco::uint64& ns)
+	{
+		return ns / 1e6;
+	}
+
+	double _MBps(const ShareStats::Entry& entry)
+	{
+		return (entry.wallNs == 0) ? 0 : entry.bytes * 1e3 / entry.wallNs;
+	}
+
+	double _Ratio(const Enco::uint64& count, const Enco::uint64& per)
+	{
+		return (per == 0) ? 0 : (double)count / per;
+	}
+}
+
+ShareStats::Scope::Scope(const Stage& stage, const Enco::uint64& bytes) :
+m_pStats(g_pAttached), m_pParent(nullptr), m_stage(stage), m_bytes(bytes), m_wall(0), m_cpu(0), m_childWall(0), m_childCpu(0), m_counting(false)
+{
+	if (m_pStats == nullptr)
+		return;
+
+	// a parent timing other stats is not ours to pause.
+	if (g_pInnermost != nullptr && g_pInnermost->m_pStats == m_pStats)
+		m_pParent = g_pInnermost;
+	g_pInnermost = this;
+	m_cpu = ThreadCpuNow();
+	m_wall = WallNow();
+
+	memset(&m_childEvents, 0, sizeof(m_childEvents));
+	if (m_pStats->Counting())
+		m_counting = PerfCounters::ThreadLocal().Read(m_events);
+}
+
+ShareStats::Scope::~Scope()
+{
+	if (m_pStats == nullptr)
+		return;
+
+	PerfCounters::Sample events;
+	if (m_counting && PerfCounters::ThreadLocal().Read(events))
+	{
+		events = PerfCounters::Delta(m_events, events);
+		m_pStats->AddEvents(m_stage, PerfCounters::Delta(m_childEvents, events));
+		if (m_pParent != nullptr)
+		{
+			for (int c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+			{
+				m_pParent->m_childEvents.values[c] += events.values[c];
+			}
+		}
+	}
+
+	const Enco::uint64 wall = WallNow() - m_wall;
+	const Enco::uint64 cpu = ThreadCpuNow() - m_cpu;
+	m_pStats->Add(m_stage, (wall > m_childWall) ? wall - m_childWall : 0, (cpu > m_childCpu) ? cpu - m_childCpu : 0, m_bytes);
+	if (m_pParent != nullptr)
+	{
+		m_pParent->m_childWall += wall;
+		m_pParent->m_childCpu += cpu;
+	}
+	if (g_pInnermost == this)
+		g_pInnermost = m_pParent;
+}
+
+void ShareStats::Scope::Bytes(const Enco::uint64& bytes)
+{
+	m_bytes += bytes;
+}
+
+ShareStats::Attached::Attached(ShareStats * const pStats) :
+m_pPrevious(ShareStats::Attach(pStats))
+{}
+
+ShareStats::Attached::~Attached()
+{
+	ShareStats::Attach(m_pPrevious);
+}
+
+ShareStats::ShareStats() :
+m_counting(false)
+{
+	Reset();
+}
+
+void ShareStats::Add(const Stage& stage, const Enco::uint64& wallNs, const Enco::uint64& cpuNs, const Enco::uint64& bytes)
+{
+	m_wallNs[stage].fetch_add(wallNs, std::memory_order_relaxed);
+	m_cpuNs[stage].fetch_add(cpuNs, std::memory_order_relaxed);
+	m_bytes[stage].fetch_add(bytes, std::memory_order_relaxed);
+	m_calls[stage].fetch_add(1, std::memory_order_relaxed);
+}
+
+ShareStats::Entry ShareStats::Get(const Stage& stage) const
+{
+	Entry entry;
+	entry.wallNs = m_wallNs[stage].load(std::memory_order_relaxed);
+	entry.cpuNs = m_cpuNs[stage].load(std::memory_order_relaxed);
+	entry.bytes = m_bytes[stage].load(std::memory_order_relaxed);
+	entry.calls = m_calls[stage].load(std::memory_order_relaxed);
+	return entry;
+}
+
+ShareStats::Entry ShareStats::Total() const
+{
+	// the bytes of the stages overlap, so the total has none.
+	Entry total = { 0, 0, 0, 0 };
+	for (int s = 0; s < STAGE_COUNT; ++s)
+	{
+		const Entry entry = Get((Stage)s);
+		total.wallNs += entry.wallNs;
+		total.cpuNs += entry.cpuNs;
+		total.calls += entry.calls;
+	}
+	return total;
+}
+
+void ShareStats::Reset()
+{
+	for (int s = 0; s < STAGE_COUNT; ++s)
+	{
+		m_wallNs[s].store(0, std::memory_order_relaxed);
+		m_cpuNs[s].store(0, std::memory_order_relaxed);
+		m_bytes[s].store(0, std::memory_order_relaxed);
+		m_calls[s].store(0, std::memory_order_relaxed);
+		for (int c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+		{
+			m_events[s][c].store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+void ShareStats::Count(const bool& count)
+{
+	m_counting.store(count, std::memory_order_relaxed);
+}
+
+bool ShareStats::Counting() const
+{
+	return m_counting.load(std::memory_order_relaxed);
+}
+
+void ShareStats::AddEvents(const Stage& stage, const PerfCounters::Sample& events)
+{
+	for (int c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+	{
+		m_events[stage][c].fetch_add(events.values[c], std::memory_order_relaxed);
+	}
+}
+
+PerfCounters::Sample ShareStats::GetEvents(const Stage& stage) const
+{
+	PerfCounters::Sample events;
+	for (int c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+	{
+		events.values[c] = m_events[stage][c].load(std::memory_order_relaxed);
+	}
+	return events;
+}
+
+void ShareStats::Report(std::ostream& out) const
+{
+	const Entry total = Total();
+	out << std::left << std::setw(10) << "stage" << std::right << std::setw(12) << "wall ms" << std::setw(12) << "cpu ms"
+		<< std::setw(8) << "wall%" << std::setw(16) << "bytes" << std::setw(12) << "MB/s" << std::setw(10) << "calls" << "\n";
+	for (int s = 0; s < STAGE_COUNT; ++s)
+	{
+		const Entry entry = Get((Stage)s);
+		if (entry.calls == 0)
+			continue;
+		out << std::left << std::setw(10) << StageName((Stage)s) << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(12) << _Milliseconds(entry.wallNs) << std::setw(12) << _Milliseconds(entry.cpuNs) << std::setprecision(1)
+			<< std::setw(8) << ((total.wallNs == 0) ? 0 : 100.0 * entry.wallNs / total.wallNs) << std::setw(16) << entry.bytes
+			<< std::setprecision(2) << std::setw(12) << _MBps(entry) << std::setw(10) << entry.calls << "\n";
+	}
+	out << std::left << std::setw(10) << "total" << std::right << std::fixed << std::setprecision(3)
+		<< std::setw(12) << _Milliseconds(total.wallNs) << std::setw(12) << _Milliseconds(total.cpuNs) << std::endl;
+
+	if (false == Counting())
+		return;
+
+	// the counters of the reporting thread stand for all: same process, same PMU.
+	const PerfCounters& counters = PerfCounters::ThreadLocal();
+	if (false == counters.Available())
+	{
+		out << "counters: unavailable (" << counters.Reason() << ")" << std::endl;
+		return;
+	}
+
+	out << std::left << std::setw(10) << "stage" << std::right << std::setw(16) << "cycles" << std::setw(16) << "instructions"
+		<< std::setw(8) << "IPC" << std::setw(14) << "cache-miss/B" << std::setw(14) << "branch-miss/B" << std::setw(14) << "dTLB-miss/B" << "\n";
+	for (int s = 0; s < STAGE_COUNT; ++s)
+	{
+		const Entry					entry = Get((Stage)s);
+		const PerfCounters::Sample	events = GetEvents((Stage)s);
+		if (entry.calls == 0)
+			continue;
+		out << std::left << std::setw(10) << StageName((Stage)s) << std::right << std::setw(16) << events.values[PerfCounters::COUNTER_CYCLES]
+			<< std::setw(16) << events.values[PerfCounters::COUNTER_INSTRUCTIONS] << std::setprecision(2)
+			<< std::setw(8) << _Ratio(events.values[PerfCounters::COUNTER_INSTRUCTIONS], events.values[PerfCounters::COUNTER_CYCLES]) << std::setprecision(4);
+		for (int c = PerfCounters::COUNTER_CACHE_MISSES; c < PerfCounters::COUNTER_COUNT; ++c)
+		{
+			// "-" for a counter the CPU lacks, or a stage without bytes.
+			if (counters.Has((PerfCounters::Counter)c) && entry.bytes != 0)
+				out << std::setw(14) << _Ratio(events.values[c], entry.bytes);
+			else
+				out << std::setw(14) << "-";
+		}
+		out << "\n";
+	}
+	if (false == counters.Reason().empty())
+		out << "counters: " << counters.Reason() << "\n";
+	out.flush();
+}
+
+void ShareStats::ReportJson(std::ostream& out) const
+{
+	const Entry				total = Total();
+	const PerfCounters&		counters = PerfCounters::ThreadLocal();
+	const bool				counting = Counting() && counters.Available();
+	out << "{" << std::setprecision(6);
+	for (int s = 0; s < STAGE_COUNT; ++s)
+	{
+		const Entry entry = Get((Stage)s);
+		if (entry.calls == 0)
+			continue;
+		out << "\"" << StageName((Stage)s) << "\": {\"wall_ns\": " << entry.wallNs << ", \"cpu_ns\": " << entry.cpuNs
+			<< ", \"bytes\": " << entry.bytes << ", \"mb_per_s\": " << _MBps(entry) << ", \"calls\": " << entry.calls;
+		if (counting)
+		{
+			const PerfCounters::Sample events = GetEvents((Stage)s);
+			for (int c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+			{
+				if (counters.Has((PerfCounters::Counter)c))
+					out << ", \"" << PerfCounters::CounterName((PerfCounters::Counter)c) << "\": " << events.values[c];
+			}
+			out << ", \"ipc\": " << _Ratio(events.values[PerfCounters::COUNTER_INSTRUCTIONS], events.values[PerfCounters::COUNTER_CYCLES]);
+			for (int c = PerfCounters::COUNTER_CACHE_MISSES; c < PerfCounters::COUNTER_COUNT; ++c)
+			{
+				if (counters.Has((PerfCounters::Counter)c) && entry.bytes != 0)
+					out << ", \"" << PerfCounters::CounterName((PerfCounters::Counter)c) << "_per_byte\": " << _Ratio(events.values[c], entry.bytes);
+			}
+		}
+		out << "}, ";
+	}
+	if (Counting() && false == counting)
+		out << "\"counters\": \"unavailable: " << counters.Reason() << "\", ";
+	out << "\"total\": {\"wall_ns\": " << total.wallNs << ", \"cpu_ns\": " << total.cpuNs << "}}" << std::endl;
+}
+
+const char* ShareStats::StageName(const Stage& stage)
+{
+	static const char* const names[STAGE_COUNT] = { "read", "hash", "random", "math", "cipher", "frame", "checksum", "write", "other" };
+	return (stage >= 0 && stage < STAGE_COUNT) ? names[stage] : "";
+}
+
+ShareStats* ShareStats::Current()
+{
+	return g_pAttached;
+}
+
+ShareStats* ShareStats::Attach(ShareStats * const pStats)
+{
+	ShareStats* const pPrevious = g_pAttached;
+	g_pAttached = pStats;
+	return pPrevious;
+}
+
+Enco::uint64 ShareStats::WallNow()
+{
+	return (Enco::uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Enco::uint64 ShareStats::ThreadCpuNow()
+{
+#if defined(_WIN32)
+	// 100 ns units, advanced per scheduler tick: coarse for short stages.
+	FILETIME creation, exited, kernel, user;
+	if (FALSE == GetThreadTimes(GetCurrentThread(), &creation, &exited, &kernel, &user))
+		return 0;
+	return ((((Enco::uint64)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime) +
+			(((Enco::uint64)user.dwHighDateTime << 32) | user.dwLowDateTime)) * 100;
+#else
+	struct timespec now;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0)
+		return 0;
+	return (Enco::uint64)now.tv_sec * 1000000000ull + (Enco::uint64)now.tv_nsec;
+#endif
+}
@@ -0,0 +1,152 @@
+// share-stats.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(SHARE_STATS_H)
+#define SHARE_STATS_H
+
+/*
+* @class: ShareStats
+*
+* @remarks: wall time, cpu time, bytes and calls of every stage of sharing and
+*           combining. A ShareStats collects while it is attached to a thread:
+*           the Scope timers placed along the pipeline add to the attached one
+*           and do nothing but a thread-local load when none is. Scopes nest,
+*           and a stage is charged its own time only, so the stages add up to
+*           the whole; time outside every named stage goes to STAGE_OTHER
+*           when the caller opens a scope of it around the job.
+*
+*           The counters are atomic: one ShareStats may be attached to several
+*           threads at once, the workers of an AsyncSharer for instance.
+*           Scopes are opened per block or per buffer, never per byte, so the
+*           clocks are read a few times per 64 KB at most.
+*
+*           With Count(true) the scopes read the PerfCounters of their thread
+*           as well, charged the same exclusive way; that is one read() per
+*           scope end, and nothing when the counters are unavailable.
+*/
+class ShareStats
+{
+public:
+	enum Stage
+	{
+		STAGE_READ,			// files and sockets in
+		STAGE_HASH,			// sha256 of the secret
+		STAGE_RANDOM,		// coefficients and key material
+		STAGE_MATH,			// field arithmetic, interpolation, dispersal
+		STAGE_CIPHER,		// AES of the computational shares
+		STAGE_FRAME,		// GUID, indices, hashes: the share headers
+		STAGE_CHECKSUM,		// CRC32C trailers
+		STAGE_WRITE,		// files and sockets out
+		STAGE_OTHER,
+		STAGE_COUNT
+	};
+
+	struct Entry
+	{
+		Enco::uint64	wallNs;
+		Enco::uint64	cpuNs;		// of the thread that ran the stage
+		Enco::uint64	bytes;
+		Enco::uint64	calls;
+	};
+
+	/*
+	* @class: Scope
+	*
+	* @remarks: times one stage from construction to destruction, on the
+	*           stats attached to the thread at construction.
+	*/
+	class Scope
+	{
+	public:
+		explicit Scope(const Stage& stage, const Enco::uint64& bytes = 0);
+		~Scope();
+
+		// deleted:
+		Scope(const Scope& scope) = delete;
+		Scope& operator=(const Scope& scope) = delete;
+
+	public:
+		void			Bytes(const Enco::uint64& bytes);	// adds to the bytes of the stage
+
+	private:
+		ShareStats*		m_pStats;
+		Scope*			m_pParent;
+		Stage			m_stage;
+		Enco::uint64	m_bytes;
+		Enco::uint64	m_wall;
+		Enco::uint64	m_cpu;
+		Enco::uint64	m_childWall;
+		Enco::uint64	m_childCpu;
+		bool			m_counting;
+		PerfCounters::Sample	m_events;
+		PerfCounters::Sample	m_childEvents;
+	};
+
+	// attaches stats to the calling thread for its lifetime; nullptr detaches.
+	class Attached
+	{
+	public:
+		explicit Attached(ShareStats * const pStats);
+		~Attached();
+
+		// deleted:
+		Attached(const Attached& attached) = delete;
+		Attached& operator=(const Attached& attached) = delete;
+
+	private:
+		ShareStats*		m_pPrevious;
+	};
+
+public:
+	ShareStats();
+
+	// deleted:
+	ShareStats(const ShareStats& stats) = delete;
+	ShareStats& operator=(const ShareStats& stats) = delete;
+
+public:
+	void				Add(const Stage& stage, const Enco::uint64& wallNs, const Enco::uint64& cpuNs, const Enco::uint64& bytes);
+	Entry				Get(const Stage& stage) const;
+	Entry				Total() const;
+	void				Reset();
+
+	// hardware counters per stage, see PerfCounters; off by default.
+	void				Count(const bool& count);
+	bool				Counting() const;
+	void				AddEvents(const Stage& stage, const PerfCounters::Sample& events);
+	PerfCounters::Sample	GetEvents(const Stage& stage) const;
+
+	/*
+	* @interface: Report / ReportJson
+	*
+	* @remarks: one line per stage that ran, with MB/s of its bytes over its
+	*           wall time, and the total. The JSON is one object keyed by
+	*           stage name, plus "total". When counting, IPC and the misses per
+	*           byte follow, or "unavailable" and the reason.
+	*/
+	void				Report(std::ostream& out) const;
+	void				ReportJson(std::ostream& out) const;
+
+	static const char*	StageName(const Stage& stage);
+
+	// the stats attached to the calling thread, nullptr if none.
+	static ShareStats*	Current();
+
+	// attaches pStats (nullptr detaches) and returns the one it replaces.
+	static ShareStats*	Attach(ShareStats * const pStats);
+
+	// the clocks the scopes read, in ns.
+	static Enco::uint64	WallNow();
+	static Enco::uint64	ThreadCpuNow();
+
+private:
+	std::atomic<Enco::uint64>	m_wallNs[STAGE_COUNT];
+	std::atomic<Enco::uint64>	m_cpuNs[STAGE_COUNT];
+	std::atomic<Enco::uint64>	m_bytes[STAGE_COUNT];
+	std::atomic<Enco::uint64>	m_calls[STAGE_COUNT];
+	std::atomic<Enco::uint64>	m_events[STAGE_COUNT][PerfCounters::COUNTER_COUNT];
+	std::atomic<bool>			m_counting;
+};
+
+#endif
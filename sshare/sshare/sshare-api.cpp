@@ -0,0 +1,725 @@
+// sshare-api.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "allocator.h"
+#include "buffer.h"
+#include "checksum.h"
+#include "field.h"
+#include "perf-counters.h"
+#include "share-stats.h"
+#include "secret-share.h"
+#include "async-share.h"
+#include "sshare-api.h"
+
+#include <sstream>
+
+static_assert(SSHARE_STAGE_COUNT == ShareStats::STAGE_COUNT && SSHARE_STAGE_OTHER == ShareStats::STAGE_OTHER, "SSHARE_STAGE_* must follow ShareStats::Stage");
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// handles
+
+struct sshare_encoder
+{
+	sshare_encoder(const unsigned int& shares, const unsigned int& threshold) :
+	sharer(randomer), checked(sharer), n(shares), k(threshold), running(false)
+	{}
+
+	DefaultRandomer					randomer;
+	StreamSecretSharer				sharer;
+	ChecksummedSharer				checked;		// the sharer, sealed like sshare -e
+	unsigned int					n;
+	unsigned int					k;
+	bool							running;
+
+	std::vector<Enco::byte>			bodies;			// n slices of share bytes, reused
+	std::vector<MutableBufferView>	views;
+	std::vector<HeaderLastChecksum>	sums;			// the trailers of the running set
+};
+
+struct sshare_decoder
+{
+	sshare_decoder() :
+	sharer(randomer), checked(sharer), count(0), running(false)
+	{}
+
+	DefaultRandomer					randomer;
+	StreamSecretSharer				sharer;
+	ChecksummedSharer				checked;
+	unsigned int					count;
+	bool							running;
+
+	std::vector<Enco::byte>			secret;			// one slice of recovered bytes, reused
+	std::vector<BufferView>			views;
+};
+
+struct sshare_stats
+{
+	ShareStats						stats;
+};
+
+struct sshare_executor
+{
+	explicit sshare_executor(const unsigned int& workers) :
+	executor(workers), sharer(executor, randomer)
+	{}
+
+	// the randomer keys every task on the starting thread, under the lock; it
+	// is destroyed after the executor has run the tasks out.
+	std::mutex						lock;
+	DefaultRandomer					randomer;
+	ShareExecutor					executor;
+	AsyncSharer						sharer;
+};
+
+struct sshare_task
+{
+	ShareTask						task;
+	int								failure;		// the status of STATUS_FAILED
+};
+
+namespace
+{
+	// secret bytes per step of the streaming calls: n * 256 KB of share bytes.
+	const size_t g_cnst_stream_slice = ((size_t)64 << 10);
+
+	// the sharers report allocation failures by throwing; nothing may cross
+	// the C boundary.
+	template <typename F>
+	int _Guarded(F f)
+	{
+		try
+		{
+			return f();
+		}
+		catch (...)
+		{
+			return SSHARE_E_MEMORY;
+		}
+	}
+
+	Enco::byte* _Reserve(std::vector<Enco::byte>& buffer, const size_t& size)
+	{
+		if (buffer.size() < size)
+			buffer.resize(size);
+		return buffer.empty() ? nullptr : &buffer[0];
+	}
+
+	bool _BeginSet(sshare_encoder * const encoder)
+	{
+		if (false == encoder->sharer.BeginEncode(encoder->n, encoder->k))
+			return false;
+		encoder->sums.assign(encoder->n, HeaderLastChecksum(SSHARE_HEADER_SIZE));
+		encoder->running = true;
+		return true;
+	}
+
+	int _EncodeSlice(sshare_encoder * const encoder, Enco::byte const * const pChunk, const size_t& size, sshare_chunk_fn write, void *context)
+	{
+		const size_t	bodySize = sizeof(Enco::uint32) * size;
+		Enco::byte*		pBodies = _Reserve(encoder->bodies, bodySize * encoder->n);
+		encoder->views.clear();
+		for (unsigned int i = 0; i < encoder->n; ++i)
+		{
+			encoder->views.push_back(MutableBufferView(pBodies + bodySize * i, bodySize));
+		}
+
+		const uint64_t offset = SSHARE_HEADER_SIZE + sizeof(Enco::uint32) * encoder->sharer.Processed();
+		if (false == encoder->sharer.EncodeChunk(encoder->views, BufferView(pChunk, size)))
+			return SSHARE_E_ARGUMENT;
+
+		for (unsigned int i = 0; i < encoder->n; ++i)
+		{
+			encoder->sums[i].Update(pBodies + bodySize * i, bodySize);
+			if (write(context, i + 1, offset, pBodies + bodySize * i, bodySize) != 0)
+				return SSHARE_E_ABORTED;
+		}
+		return SSHARE_OK;
+	}
+
+	// the size of the payload of the shares, the first whose trailer holds
+	// telling; shares from before the trailer are payload only.
+	size_t _PayloadSize(const void * const *shares, const unsigned int& count, const size_t& share_size)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const BufferView share(shares[i], share_size);
+			if (ShareChecksum::HasTrailer(share))
+				return ShareChecksum::Payload(share).Size();
+		}
+		return share_size;
+	}
+
+	bool _IsPayloadSize(const size_t& payloadSize)
+	{
+		return payloadSize >= SSHARE_HEADER_SIZE && (payloadSize - SSHARE_HEADER_SIZE) % sizeof(Enco::uint32) == 0;
+	}
+
+	template <typename T>
+	bool _AllSet(T const * const pointers, const unsigned int& count)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			if (pointers[i] == nullptr)
+				return false;
+		}
+		return true;
+	}
+
+	int _Status(const ShareTask::Status& status, const int& failure)
+	{
+		switch (status)
+		{
+		case ShareTask::STATUS_PENDING:		return SSHARE_PENDING;
+		case ShareTask::STATUS_DONE:		return SSHARE_OK;
+		case ShareTask::STATUS_CANCELLED:	return SSHARE_E_CANCELLED;
+		default:							return failure;
+		}
+	}
+
+	// starts one AsyncSharer call under the executor's lock.
+	template <typename F>
+	sshare_task* _StartAsync(sshare_executor * const executor, const int& failure, sshare_done_fn done, void *context, F start)
+	{
+		try
+		{
+			ShareTask::Callback callback;
+			if (done != nullptr)
+			{
+				callback = [done, context, failure](const ShareTask::Status& status)
+				{
+					done(context, _Status(status, failure));
+				};
+			}
+
+			std::unique_ptr<sshare_task> task(new sshare_task());
+			task->failure = failure;
+			{
+				std::lock_guard<std::mutex> guard(executor->lock);
+				task->task = start(executor->sharer, callback);
+			}
+			return task.release();
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+	}
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// common
+
+unsigned int sshare_api_version(void)
+{
+	return SSHARE_API_VERSION;
+}
+
+const char* sshare_status_string(int status)
+{
+	switch (status)
+	{
+	case SSHARE_OK:				return "ok";
+	case SSHARE_E_ARGUMENT:		return "invalid argument";
+	case SSHARE_E_BUFFER:		return "buffer too small";
+	case SSHARE_E_STATE:		return "call out of order";
+	case SSHARE_E_INTEGRITY:	return "shares do not combine";
+	case SSHARE_E_ABORTED:		return "aborted by the callback";
+	case SSHARE_E_MEMORY:		return "out of memory";
+	case SSHARE_E_CANCELLED:	return "cancelled";
+	case SSHARE_E_FILE:			return "file error";
+	case SSHARE_PENDING:		return "pending";
+	default:					return "unknown status";
+	}
+}
+
+uint64_t sshare_share_size(uint64_t secret_size)
+{
+	const uint64_t payloadSize = SSHARE_HEADER_SIZE + sizeof(Enco::uint32) * secret_size;
+	return payloadSize + ShareChecksum::TrailerSize((size_t)payloadSize);
+}
+
+uint64_t sshare_secret_size(uint64_t share_size)
+{
+	// share_size = payload + 4 * chunks + fixed, chunks = ceil(payload / chunk),
+	// so chunks = ceil((share_size - fixed) / (chunk + 4)).
+	const uint64_t chunk = ShareChecksum::m_cnst_chunk_size;
+	if (share_size < SSHARE_HEADER_SIZE + ShareChecksum::m_cnst_fixed_size)
+		return 0;
+
+	const uint64_t rest = share_size - ShareChecksum::m_cnst_fixed_size;
+	const uint64_t chunks = (rest + chunk + sizeof(Enco::uint32) - 1) / (chunk + sizeof(Enco::uint32));
+	const uint64_t payloadSize = rest - sizeof(Enco::uint32) * chunks;
+	if ((payloadSize + chunk - 1) / chunk != chunks || false == _IsPayloadSize((size_t)payloadSize))
+		return 0;
+	return (payloadSize - SSHARE_HEADER_SIZE) / sizeof(Enco::uint32);
+}
+
+uint64_t sshare_payload_size(const void *tail, size_t tail_size, uint64_t share_size)
+{
+	if (tail == nullptr)
+		return share_size;
+
+	const size_t trailerSize = ShareChecksum::StoredTrailerSize(BufferView(tail, tail_size), (size_t)share_size);
+	return share_size - trailerSize;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// encoder
+
+sshare_encoder* sshare_encoder_create(unsigned int n, unsigned int k)
+{
+	if (n == 0 || k == 0 || k > n || n >= ShamirField::Order())
+		return nullptr;
+	return new (std::nothrow) sshare_encoder(n, k);
+}
+
+void sshare_encoder_destroy(sshare_encoder *encoder)
+{
+	if (encoder == nullptr)
+		return;
+
+	if (false == encoder->bodies.empty())
+		memset(&encoder->bodies[0], 0, encoder->bodies.size());
+	delete encoder;
+}
+
+int sshare_encode(sshare_encoder *encoder, const void *secret, size_t secret_size, void * const *shares, size_t share_capacity)
+{
+	if (encoder == nullptr || shares == nullptr || (secret == nullptr && secret_size != 0))
+		return SSHARE_E_ARGUMENT;
+	if (share_capacity < sshare_share_size(secret_size))
+		return SSHARE_E_BUFFER;
+
+	return _Guarded([&]()
+	{
+		// the shares are built in place, in the caller's buffers.
+		encoder->views.clear();
+		for (unsigned int i = 0; i < encoder->n; ++i)
+		{
+			if (shares[i] == nullptr)
+				return SSHARE_E_ARGUMENT;
+			encoder->views.push_back(MutableBufferView(shares[i], (size_t)sshare_share_size(secret_size)));
+		}
+
+		if (false == encoder->checked.Encode(encoder->views, encoder->n, encoder->k, BufferView(secret, secret_size)))
+			return SSHARE_E_ARGUMENT;
+		return SSHARE_OK;
+	});
+}
+
+int sshare_encode_update(sshare_encoder *encoder, const void *chunk, size_t size, sshare_chunk_fn write, void *context)
+{
+	if (encoder == nullptr || write == nullptr || (chunk == nullptr && size != 0))
+		return SSHARE_E_ARGUMENT;
+
+	const int status = _Guarded([&]()
+	{
+		if (false == encoder->running && false == _BeginSet(encoder))
+			return SSHARE_E_ARGUMENT;
+
+		Enco::byte const* pChunk = (Enco::byte const*)chunk;
+		for (size_t done = 0; done < size; done += g_cnst_stream_slice)
+		{
+			const size_t	part = (size - done < g_cnst_stream_slice) ? size - done : g_cnst_stream_slice;
+			const int		result = _EncodeSlice(encoder, pChunk + done, part, write, context);
+			if (result != SSHARE_OK)
+				return result;
+		}
+		return SSHARE_OK;
+	});
+
+	if (status != SSHARE_OK)
+		encoder->running = false;
+	return status;
+}
+
+int sshare_encode_final(sshare_encoder *encoder, sshare_chunk_fn write, void *context)
+{
+	if (encoder == nullptr || write == nullptr)
+		return SSHARE_E_ARGUMENT;
+
+	// a secret that never saw an update is the empty one.
+	const int status = _Guarded([&]()
+	{
+		if (false == encoder->running && false == _BeginSet(encoder))
+			return SSHARE_E_ARGUMENT;
+		encoder->running = false;
+
+		const uint64_t	end = SSHARE_HEADER_SIZE + sizeof(Enco::uint32) * encoder->sharer.Processed();
+		Enco::byte*		pHeaders = _Reserve(encoder->bodies, (size_t)SSHARE_HEADER_SIZE * encoder->n);
+		encoder->views.clear();
+		for (unsigned int i = 0; i < encoder->n; ++i)
+		{
+			encoder->views.push_back(MutableBufferView(pHeaders + SSHARE_HEADER_SIZE * i, SSHARE_HEADER_SIZE));
+		}
+
+		if (false == encoder->sharer.FinishEncode(encoder->views))
+			return SSHARE_E_STATE;
+
+		// the trailers go behind the bodies, as sshare -e writes them.
+		std::vector<Enco::byte> trailer;
+		for (unsigned int i = 0; i < encoder->n; ++i)
+		{
+			encoder->sums[i].Trailer(encoder->views[i], trailer);
+			if (write(context, i + 1, 0, pHeaders + SSHARE_HEADER_SIZE * i, SSHARE_HEADER_SIZE) != 0 ||
+				write(context, i + 1, end, &trailer[0], trailer.size()) != 0)
+				return SSHARE_E_ABORTED;
+		}
+		return SSHARE_OK;
+	});
+
+	encoder->running = false;
+	return status;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// decoder
+
+sshare_decoder* sshare_decoder_create(void)
+{
+	return new (std::nothrow) sshare_decoder();
+}
+
+void sshare_decoder_destroy(sshare_decoder *decoder)
+{
+	if (decoder == nullptr)
+		return;
+
+	if (false == decoder->secret.empty())
+		memset(&decoder->secret[0], 0, decoder->secret.size());
+	delete decoder;
+}
+
+int sshare_decode(sshare_decoder *decoder, const void * const *shares, unsigned int count, size_t share_size, void *secret, size_t secret_capacity, size_t *secret_size)
+{
+	if (decoder == nullptr || shares == nullptr || count == 0 || secret_size == nullptr || false == _AllSet(shares, count))
+		return SSHARE_E_ARGUMENT;
+
+	const size_t payloadSize = _PayloadSize(shares, count, share_size);
+	if (false == _IsPayloadSize(payloadSize))
+		return SSHARE_E_ARGUMENT;
+
+	*secret_size = (payloadSize - SSHARE_HEADER_SIZE) / sizeof(Enco::uint32);
+	if (secret_capacity < *secret_size || (secret == nullptr && *secret_size != 0))
+		return SSHARE_E_BUFFER;
+
+	return _Guarded([&]()
+	{
+		decoder->views.clear();
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			decoder->views.push_back(BufferView(shares[i], share_size));
+		}
+
+		// shares their trailers find damaged are dropped, as sshare -d does.
+		if (false == decoder->checked.Decode(MutableBufferView(secret, *secret_size), decoder->views))
+		{
+			if (*secret_size != 0)
+				memset(secret, 0, *secret_size);
+			return SSHARE_E_INTEGRITY;
+		}
+		return SSHARE_OK;
+	});
+}
+
+int sshare_decode_begin(sshare_decoder *decoder, const void * const *headers, unsigned int count)
+{
+	if (decoder == nullptr || headers == nullptr || count == 0)
+		return SSHARE_E_ARGUMENT;
+
+	return _Guarded([&]()
+	{
+		decoder->running = false;
+		decoder->views.clear();
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			if (headers[i] == nullptr)
+				return SSHARE_E_ARGUMENT;
+			decoder->views.push_back(BufferView(headers[i], SSHARE_HEADER_SIZE));
+		}
+
+		if (false == decoder->sharer.BeginDecode(decoder->views))
+			return SSHARE_E_INTEGRITY;
+
+		decoder->count = count;
+		decoder->running = true;
+		return SSHARE_OK;
+	});
+}
+
+int sshare_decode_update(sshare_decoder *decoder, const void * const *chunks, size_t size, sshare_chunk_fn write, void *context)
+{
+	if (decoder == nullptr || chunks == nullptr || write == nullptr || size % sizeof(Enco::uint32) != 0)
+		return SSHARE_E_ARGUMENT;
+	if (false == decoder->running)
+		return SSHARE_E_STATE;
+
+	const int status = _Guarded([&]()
+	{
+		for (unsigned int j = 0; j < decoder->count; ++j)
+		{
+			if (chunks[j] == nullptr && size != 0)
+				return SSHARE_E_ARGUMENT;
+		}
+
+		// the caller's chunks are read in place, slice by slice.
+		Enco::byte* pSecret = _Reserve(decoder->secret, g_cnst_stream_slice);
+		for (size_t done = 0; done < size; done += sizeof(Enco::uint32) * g_cnst_stream_slice)
+		{
+			const size_t	part = (size - done < sizeof(Enco::uint32) * g_cnst_stream_slice) ? size - done : sizeof(Enco::uint32) * g_cnst_stream_slice;
+			const uint64_t	offset = decoder->sharer.Processed();
+			decoder->views.clear();
+			for (unsigned int j = 0; j < decoder->count; ++j)
+			{
+				decoder->views.push_back(BufferView((Enco::byte const*)chunks[j] + done, part));
+			}
+
+			if (false == decoder->sharer.DecodeChunk(MutableBufferView(pSecret, g_cnst_stream_slice), decoder->views))
+				return SSHARE_E_ARGUMENT;
+			if (write(context, 0, offset, pSecret, part / sizeof(Enco::uint32)) != 0)
+				return SSHARE_E_ABORTED;
+		}
+		return SSHARE_OK;
+	});
+
+	if (status != SSHARE_OK)
+		decoder->running = false;
+	return status;
+}
+
+int sshare_decode_final(sshare_decoder *decoder)
+{
+	if (decoder == nullptr)
+		return SSHARE_E_ARGUMENT;
+	if (false == decoder->running)
+		return SSHARE_E_STATE;
+
+	decoder->running = false;
+	if (false == decoder->secret.empty())
+		memset(&decoder->secret[0], 0, decoder->secret.size());
+	return decoder->sharer.FinishDecode() ? SSHARE_OK : SSHARE_E_INTEGRITY;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// async
+
+sshare_executor* sshare_executor_create(unsigned int workers)
+{
+	try
+	{
+		return new sshare_executor(workers);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void sshare_executor_destroy(sshare_executor *executor)
+{
+	delete executor;
+}
+
+sshare_task* sshare_encode_async(sshare_executor *executor, unsigned int n, unsigned int k, const void *secret, size_t secret_size, void * const *shares, size_t share_capacity, sshare_done_fn done, void *context)
+{
+	if (executor == nullptr || shares == nullptr || (secret == nullptr && secret_size != 0))
+		return nullptr;
+	if (n == 0 || k == 0 || k > n || n >= ShamirField::Order() || share_capacity < sshare_share_size(secret_size))
+		return nullptr;
+
+	if (false == _AllSet(shares, n))
+		return nullptr;
+
+	return _StartAsync(executor, SSHARE_E_ARGUMENT, done, context, [&](AsyncSharer& sharer, const ShareTask::Callback& callback)
+	{
+		std::vector<MutableBufferView> views;
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			views.push_back(MutableBufferView(shares[i], (size_t)sshare_share_size(secret_size)));
+		}
+		return sharer.Encode(views, n, k, BufferView(secret, secret_size), callback);
+	});
+}
+
+sshare_task* sshare_decode_async(sshare_executor *executor, const void * const *shares, unsigned int count, size_t share_size, void *secret, size_t secret_capacity, sshare_done_fn done, void *context)
+{
+	if (executor == nullptr || shares == nullptr || count == 0 || false == _AllSet(shares, count))
+		return nullptr;
+
+	const size_t payloadSize = _PayloadSize(shares, count, share_size);
+	if (false == _IsPayloadSize(payloadSize))
+		return nullptr;
+
+	const size_t secretSize = (payloadSize - SSHARE_HEADER_SIZE) / sizeof(Enco::uint32);
+	if (secret_capacity < secretSize || (secret == nullptr && secretSize != 0))
+		return nullptr;
+
+	return _StartAsync(executor, SSHARE_E_INTEGRITY, done, context, [&](AsyncSharer& sharer, const ShareTask::Callback& callback)
+	{
+		std::vector<BufferView> views;
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			views.push_back(BufferView(shares[i], share_size));
+		}
+		return sharer.Decode(MutableBufferView(secret, secretSize), views, callback);
+	});
+}
+
+sshare_task* sshare_encode_file_async(sshare_executor *executor, const char *file_name, const char * const *share_names, unsigned int n, unsigned int k, sshare_done_fn done, void *context)
+{
+	if (executor == nullptr || file_name == nullptr || share_names == nullptr)
+		return nullptr;
+	if (n == 0 || k == 0 || k > n || n >= ShamirField::Order() || false == _AllSet(share_names, n))
+		return nullptr;
+
+	return _StartAsync(executor, SSHARE_E_FILE, done, context, [&](AsyncSharer& sharer, const ShareTask::Callback& callback)
+	{
+		std::vector<std::string> names;
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			names.push_back(share_names[i]);
+		}
+		return sharer.EncodeFile(file_name, names, k, callback);
+	});
+}
+
+sshare_task* sshare_decode_files_async(sshare_executor *executor, const char *out_file_name, const char * const *share_names, unsigned int count, sshare_done_fn done, void *context)
+{
+	if (executor == nullptr || out_file_name == nullptr || share_names == nullptr || count == 0 || false == _AllSet(share_names, count))
+		return nullptr;
+
+	return _StartAsync(executor, SSHARE_E_FILE, done, context, [&](AsyncSharer& sharer, const ShareTask::Callback& callback)
+	{
+		std::vector<std::string> names;
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			names.push_back(share_names[i]);
+		}
+		return sharer.DecodeFiles(out_file_name, names, callback);
+	});
+}
+
+int sshare_task_poll(const sshare_task *task)
+{
+	if (task == nullptr)
+		return SSHARE_E_ARGUMENT;
+	return _Status(task->task.Poll(), task->failure);
+}
+
+int sshare_task_wait(const sshare_task *task)
+{
+	if (task == nullptr)
+		return SSHARE_E_ARGUMENT;
+	return _Status(task->task.Wait(), task->failure);
+}
+
+uint64_t sshare_task_processed(const sshare_task *task)
+{
+	return (task == nullptr) ? 0 : task->task.Processed();
+}
+
+void sshare_task_cancel(const sshare_task *task)
+{
+	if (task != nullptr)
+		task->task.Cancel();
+}
+
+void sshare_task_destroy(sshare_task *task)
+{
+	delete task;
+}
+
+// //////////////////////////////////////////////////////////////////////////////////////////////
+// stats
+
+sshare_stats* sshare_stats_create(void)
+{
+	return new (std::nothrow) sshare_stats();
+}
+
+void sshare_stats_destroy(sshare_stats *stats)
+{
+	delete stats;
+}
+
+void sshare_stats_reset(sshare_stats *stats)
+{
+	if (stats != nullptr)
+		stats->stats.Reset();
+}
+
+sshare_stats* sshare_stats_attach(sshare_stats *stats)
+{
+	// every sshare_stats begins with its ShareStats, so the previous one maps back.
+	ShareStats* const pPrevious = ShareStats::Attach((stats == nullptr) ? nullptr : &stats->stats);
+	return (pPrevious == nullptr) ? nullptr : reinterpret_cast<sshare_stats*>(pPrevious);
+}
+
+int sshare_stats_get(const sshare_stats *stats, int stage, sshare_stage_stats *out)
+{
+	if (stats == nullptr || out == nullptr || stage < 0 || stage >= SSHARE_STAGE_COUNT)
+		return SSHARE_E_ARGUMENT;
+
+	const ShareStats::Entry entry = stats->stats.Get((ShareStats::Stage)stage);
+	out->wall_ns = entry.wallNs;
+	out->cpu_ns = entry.cpuNs;
+	out->bytes = entry.bytes;
+	out->calls = entry.calls;
+	return SSHARE_OK;
+}
+
+const char* sshare_stage_name(int stage)
+{
+	return ShareStats::StageName((ShareStats::Stage)stage);
+}
+
+int sshare_stats_count(sshare_stats *stats, int enable)
+{
+	if (stats == nullptr)
+		return 0;
+
+	stats->stats.Count(enable != 0);
+	return PerfCounters::ThreadLocal().Available() ? 1 : 0;
+}
+
+int sshare_stats_get_counters(const sshare_stats *stats, int stage, sshare_stage_counters *out)
+{
+	if (stats == nullptr || out == nullptr || stage < 0 || stage >= SSHARE_STAGE_COUNT)
+		return SSHARE_E_ARGUMENT;
+
+	const PerfCounters::Sample events = stats->stats.GetEvents((ShareStats::Stage)stage);
+	out->cycles = events.values[PerfCounters::COUNTER_CYCLES];
+	out->instructions = events.values[PerfCounters::COUNTER_INSTRUCTIONS];
+	out->cache_misses = events.values[PerfCounters::COUNTER_CACHE_MISSES];
+	out->branch_misses = events.values[PerfCounters::COUNTER_BRANCH_MISSES];
+	out->dtlb_misses = events.values[PerfCounters::COUNTER_DTLB_MISSES];
+	return SSHARE_OK;
+}
+
+size_t sshare_stats_format(const sshare_stats *stats, int json, char *buffer, size_t capacity)
+{
+	if (stats == nullptr)
+		return 0;
+
+	try
+	{
+		std::ostringstream out;
+		if (json != 0)
+			stats->stats.ReportJson(out);
+		else
+			stats->stats.Report(out);
+
+		const std::string text = out.str();
+		if (buffer != nullptr && capacity > text.size())
+			memcpy(buffer, text.c_str(), text.size() + 1);
+		return text.size();
+	}
+	catch (...)
+	{
+		return 0;
+	}
+}
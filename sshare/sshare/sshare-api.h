@@ -0,0 +1,211 @@
+// sshare-api.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(SSHARE_API_H)
+#define SSHARE_API_H
+
+// The C interface of libsshare: DefaultStrongSSharer shares (the ones of
+// "sshare -e") built and combined in the caller's process.
+//
+//  * the secret and the shares stay in caller memory: sshare_encode() and
+//    sshare_decode() read and write the caller's buffers directly;
+//  * the streaming calls hand every chunk to a callback that points into
+//    the handle's own buffer, valid only for the duration of the call;
+//  * a handle keeps its buffers between calls, so reusing one saves the setup
+//    of the next operation. A handle is used by one thread at a time;
+//    different handles are independent;
+//  * every call returns an SSHARE_* status, and nothing is thrown across;
+//  * the *_async calls run on an executor's worker threads and hand back a
+//    task to poll, wait on or cancel, or report through a callback.
+//
+// A share is SSHARE_HEADER_SIZE bytes of header followed by 4 bytes per
+// secret byte, then the chunk crc trailer sshare -e appends (see checksum.h);
+// the header is written last, since it holds the secret's hash. Shares
+// without a trailer, from before it existed, are decoded as they are.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#	if defined(SSHARE_EXPORTS)
+#		define SSHARE_API __declspec(dllexport)
+#	else
+#		define SSHARE_API __declspec(dllimport)
+#	endif
+#	define SSHARE_CALL __cdecl
+#else
+#	define SSHARE_API __attribute__((visibility("default")))
+#	define SSHARE_CALL
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define SSHARE_API_VERSION		1
+#define SSHARE_HEADER_SIZE		52
+#define SSHARE_TAIL_SIZE		20		// the end of a share sshare_payload_size() reads
+
+#define SSHARE_OK				0
+#define SSHARE_E_ARGUMENT		(-1)	// bad n / k, null pointer, mismatched sizes
+#define SSHARE_E_BUFFER			(-2)	// an output buffer is too small
+#define SSHARE_E_STATE			(-3)	// streaming call out of order
+#define SSHARE_E_INTEGRITY		(-4)	// shares of different sets, or the hash does not match
+#define SSHARE_E_ABORTED		(-5)	// a callback returned non-zero
+#define SSHARE_E_MEMORY			(-6)
+#define SSHARE_E_CANCELLED		(-7)	// an async task was cancelled
+#define SSHARE_E_FILE			(-8)	// a file cannot be read or written, or its shares do not combine
+#define SSHARE_PENDING			1		// an async task is still running
+
+#define SSHARE_STAGE_READ		0
+#define SSHARE_STAGE_HASH		1
+#define SSHARE_STAGE_RANDOM		2
+#define SSHARE_STAGE_MATH		3
+#define SSHARE_STAGE_CIPHER		4
+#define SSHARE_STAGE_FRAME		5
+#define SSHARE_STAGE_CHECKSUM	6
+#define SSHARE_STAGE_WRITE		7
+#define SSHARE_STAGE_OTHER		8
+#define SSHARE_STAGE_COUNT		9
+
+typedef struct sshare_encoder sshare_encoder;
+typedef struct sshare_decoder sshare_decoder;
+typedef struct sshare_stats sshare_stats;
+typedef struct sshare_executor sshare_executor;
+typedef struct sshare_task sshare_task;
+
+typedef struct sshare_stage_stats
+{
+	uint64_t	wall_ns;
+	uint64_t	cpu_ns;
+	uint64_t	bytes;
+	uint64_t	calls;
+} sshare_stage_stats;
+
+// hardware counters of a stage, 0 where the CPU or the system has none.
+typedef struct sshare_stage_counters
+{
+	uint64_t	cycles;
+	uint64_t	instructions;
+	uint64_t	cache_misses;
+	uint64_t	branch_misses;
+	uint64_t	dtlb_misses;
+} sshare_stage_counters;
+
+// one chunk of output. share is the 1-based share index for encoding, 0 for
+// decoding; offset is where data goes in that share or in the secret. A
+// non-zero return stops the stream with SSHARE_E_ABORTED.
+typedef int (SSHARE_CALL *sshare_chunk_fn)(void *context, unsigned int share, uint64_t offset, const void *data, size_t size);
+
+// the end of an async task, called once on a worker thread with its status.
+typedef void (SSHARE_CALL *sshare_done_fn)(void *context, int status);
+
+SSHARE_API unsigned int		SSHARE_CALL sshare_api_version(void);
+SSHARE_API const char*		SSHARE_CALL sshare_status_string(int status);
+
+// size of every share of a secret_size-byte secret, trailer included, and
+// back; a share_size no such share can have gives 0, like the share of the
+// empty secret.
+SSHARE_API uint64_t			SSHARE_CALL sshare_share_size(uint64_t secret_size);
+SSHARE_API uint64_t			SSHARE_CALL sshare_secret_size(uint64_t share_size);
+
+// header and body bytes of a share of share_size bytes, from its last
+// tail_size (at least SSHARE_TAIL_SIZE) bytes: what streaming decoding
+// reads. share_size itself for a share without a trailer.
+SSHARE_API uint64_t			SSHARE_CALL sshare_payload_size(const void *tail, size_t tail_size, uint64_t share_size);
+
+// ---------------------------------------------------------------------------
+// encoder: k-of-n, 0 < k <= n < 65809; null on a bad n / k or no memory.
+SSHARE_API sshare_encoder*	SSHARE_CALL sshare_encoder_create(unsigned int n, unsigned int k);
+SSHARE_API void				SSHARE_CALL sshare_encoder_destroy(sshare_encoder *encoder);
+
+// writes share i + 1 to shares[i], n buffers of share_capacity bytes, at
+// least sshare_share_size(secret_size).
+SSHARE_API int				SSHARE_CALL sshare_encode(sshare_encoder *encoder, const void *secret, size_t secret_size, void * const *shares, size_t share_capacity);
+
+// streaming: update() any number of times, then final(). Each update emits
+// 4 * size bytes per share at offset SSHARE_HEADER_SIZE + 4 * (bytes before
+// it); final() emits the headers at offset 0 and the trailers behind the
+// bodies. An update after final() starts a new set; an error or an abort
+// drops the running one.
+SSHARE_API int				SSHARE_CALL sshare_encode_update(sshare_encoder *encoder, const void *chunk, size_t size, sshare_chunk_fn write, void *context);
+SSHARE_API int				SSHARE_CALL sshare_encode_final(sshare_encoder *encoder, sshare_chunk_fn write, void *context);
+
+// ---------------------------------------------------------------------------
+// decoder: any set size, taken from the shares.
+SSHARE_API sshare_decoder*	SSHARE_CALL sshare_decoder_create(void);
+SSHARE_API void				SSHARE_CALL sshare_decoder_destroy(sshare_decoder *decoder);
+
+// combines count shares of share_size bytes each into secret, which holds
+// at least sshare_secret_size(share_size) bytes; *secret_size receives the
+// size of the secret. Shares their trailers find damaged are left out.
+SSHARE_API int				SSHARE_CALL sshare_decode(sshare_decoder *decoder, const void * const *shares, unsigned int count, size_t share_size, void *secret, size_t secret_capacity, size_t *secret_size);
+
+// streaming: begin() with the SSHARE_HEADER_SIZE-byte headers of the shares,
+// then update() with the next size bytes (a multiple of 4) of every share
+// body, in the same order, and final(). The body ends where the payload of
+// sshare_payload_size() does; the trailer is not read. Secret bytes are
+// emitted before they can be verified: unless final() returns SSHARE_OK,
+// discard all of them.
+SSHARE_API int				SSHARE_CALL sshare_decode_begin(sshare_decoder *decoder, const void * const *headers, unsigned int count);
+SSHARE_API int				SSHARE_CALL sshare_decode_update(sshare_decoder *decoder, const void * const *chunks, size_t size, sshare_chunk_fn write, void *context);
+SSHARE_API int				SSHARE_CALL sshare_decode_final(sshare_decoder *decoder);
+
+// ---------------------------------------------------------------------------
+// async: AsyncSharer on a pool of workers (0: one per hardware thread). The
+// calls return at once with a task, or null on a bad argument or no memory;
+// buffers and the done callback's context MUST outlive the task. Any thread
+// may start tasks on an executor. Destroying it first runs every started
+// task to its end.
+SSHARE_API sshare_executor*	SSHARE_CALL sshare_executor_create(unsigned int workers);
+SSHARE_API void				SSHARE_CALL sshare_executor_destroy(sshare_executor *executor);
+
+// the buffers of sshare_encode() and sshare_decode(); a failed or cancelled
+// decode leaves the secret zeroed.
+SSHARE_API sshare_task*		SSHARE_CALL sshare_encode_async(sshare_executor *executor, unsigned int n, unsigned int k, const void *secret, size_t secret_size, void * const *shares, size_t share_capacity, sshare_done_fn done, void *context);
+SSHARE_API sshare_task*		SSHARE_CALL sshare_decode_async(sshare_executor *executor, const void * const *shares, unsigned int count, size_t share_size, void *secret, size_t secret_capacity, sshare_done_fn done, void *context);
+
+// a file to n share files and back, a chunk in memory at a time; what a
+// failed or cancelled task has written is deleted.
+SSHARE_API sshare_task*		SSHARE_CALL sshare_encode_file_async(sshare_executor *executor, const char *file_name, const char * const *share_names, unsigned int n, unsigned int k, sshare_done_fn done, void *context);
+SSHARE_API sshare_task*		SSHARE_CALL sshare_decode_files_async(sshare_executor *executor, const char *out_file_name, const char * const *share_names, unsigned int count, sshare_done_fn done, void *context);
+
+// SSHARE_PENDING while the task runs, then its status; wait() blocks until
+// then. cancel() stops it at its next chunk. destroy() only drops the
+// handle: the task itself runs on.
+SSHARE_API int				SSHARE_CALL sshare_task_poll(const sshare_task *task);
+SSHARE_API int				SSHARE_CALL sshare_task_wait(const sshare_task *task);
+SSHARE_API uint64_t			SSHARE_CALL sshare_task_processed(const sshare_task *task);
+SSHARE_API void				SSHARE_CALL sshare_task_cancel(const sshare_task *task);
+SSHARE_API void				SSHARE_CALL sshare_task_destroy(sshare_task *task);
+
+
+// ---------------------------------------------------------------------------
+// stats: wall / cpu time and bytes per SSHARE_STAGE_*. Attached to a thread,
+// a stats object collects from every call that thread makes; one object may
+// be attached to several threads. It MUST outlive its attachments.
+SSHARE_API sshare_stats*		SSHARE_CALL sshare_stats_create(void);
+SSHARE_API void				SSHARE_CALL sshare_stats_destroy(sshare_stats *stats);
+SSHARE_API void				SSHARE_CALL sshare_stats_reset(sshare_stats *stats);
+
+// attaches stats (NULL detaches) to the calling thread; returns the previous one.
+SSHARE_API sshare_stats*		SSHARE_CALL sshare_stats_attach(sshare_stats *stats);
+SSHARE_API int				SSHARE_CALL sshare_stats_get(const sshare_stats *stats, int stage, sshare_stage_stats *out);
+SSHARE_API const char*		SSHARE_CALL sshare_stage_name(int stage);
+
+// turns the hardware counters (perf_event_open, Linux only) on or off for
+// the stages; returns 1 if the calling thread can count, 0 if not.
+SSHARE_API int				SSHARE_CALL sshare_stats_count(sshare_stats *stats, int enable);
+SSHARE_API int				SSHARE_CALL sshare_stats_get_counters(const sshare_stats *stats, int stage, sshare_stage_counters *out);
+
+// the report of "sshare --stats", as text or JSON, NUL-terminated into buffer.
+// Returns the length it needs without the NUL; nothing is written when
+// capacity is not above that.
+SSHARE_API size_t			SSHARE_CALL sshare_stats_format(const sshare_stats *stats, int json, char *buffer, size_t capacity);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
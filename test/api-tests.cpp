@@ -0,0 +1,400 @@
+// api-tests.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "sshare-api.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "test-harness.h"
+
+namespace
+{
+	// the sshare binary, from --cli=; the interop cases are skipped without it.
+	std::string g_cli;
+
+	std::vector<unsigned char> _Secret(const size_t& size, const unsigned int& seed)
+	{
+		std::vector<unsigned char>	secret(size);
+		unsigned int				state = seed * 2654435761u + 1;
+		for (size_t i = 0; i < size; ++i)
+		{
+			state = state * 1103515245u + 12345u;
+			secret[i] = (unsigned char)(state >> 16);
+		}
+		return secret;
+	}
+
+	// where the streaming calls put their bytes: shares[i] is share i, the
+	// secret is share 0.
+	struct Sink
+	{
+		std::vector<std::vector<unsigned char>> shares;
+	};
+
+	int SSHARE_CALL _Write(void* context, unsigned int share, uint64_t offset, const void* data, size_t size)
+	{
+		std::vector<unsigned char>& out = static_cast<Sink*>(context)->shares[share];
+		if (out.size() < offset + size)
+			out.resize((size_t)(offset + size));
+		memcpy(out.data() + offset, data, size);
+		return 0;
+	}
+
+	int SSHARE_CALL _Abort(void*, unsigned int, uint64_t, const void*, size_t)
+	{
+		return 1;
+	}
+
+	std::filesystem::path _Scratch(const char* name)
+	{
+		const std::filesystem::path dir = std::filesystem::temp_directory_path() / (std::string("sshare-api-tests-") + name);
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directories(dir);
+		return dir;
+	}
+
+	std::vector<unsigned char> _ReadFile(const std::filesystem::path& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		return std::vector<unsigned char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	void _WriteFile(const std::filesystem::path& path, const std::vector<unsigned char>& data)
+	{
+		std::ofstream(path, std::ios::binary).write((const char*)data.data(), data.size());
+	}
+
+	bool _RunCli(const std::string& arguments)
+	{
+#if defined(_WIN32)
+		const std::string command = "\"\"" + g_cli + "\" " + arguments + " > NUL\"";
+#else
+		const std::string command = "\"" + g_cli + "\" " + arguments + " > /dev/null";
+#endif
+		return std::system(command.c_str()) == 0;
+	}
+
+	std::string _Quoted(const std::filesystem::path& path)
+	{
+		return "\"" + path.string() + "\"";
+	}
+}
+
+
+
+TEST(SizeHelpers)
+{
+	CHECK(sshare_api_version() == SSHARE_API_VERSION);
+	const uint64_t sizes[] = { 0, 1, 1000, 16371, 16372, 200000, 100000000 };
+	for (const uint64_t& size : sizes)
+	{
+		CHECK(sshare_secret_size(sshare_share_size(size)) == size);
+		CHECK(sshare_secret_size(sshare_share_size(size) + 1) == 0);
+	}
+
+	// 200000 bytes: a payload of 800052 bytes in 13 chunks, and 20 more.
+	CHECK(sshare_share_size(200000) == 800052 + 13 * 4 + SSHARE_TAIL_SIZE);
+	CHECK(sshare_secret_size(sshare_share_size(200000)) == 200000);
+	CHECK(sshare_payload_size(nullptr, 0, 1000) == 1000);
+}
+
+TEST(SyncRoundTrip)
+{
+	const std::vector<unsigned char>		secret = _Secret(100000, 3);
+	const size_t							shareSize = (size_t)sshare_share_size(secret.size());
+	std::vector<std::vector<unsigned char>>	shares(5, std::vector<unsigned char>(shareSize));
+	void*									pShares[5];
+	for (int i = 0; i < 5; ++i)
+	{
+		pShares[i] = shares[i].data();
+	}
+
+	CHECK(sshare_encoder_create(2, 3) == nullptr);
+	sshare_encoder* const pEncoder = sshare_encoder_create(5, 3);
+	CHECK(sshare_encode(pEncoder, secret.data(), secret.size(), pShares, shareSize - 1) == SSHARE_E_BUFFER);
+	CHECK(sshare_encode(pEncoder, secret.data(), secret.size(), pShares, shareSize) == SSHARE_OK);
+	sshare_encoder_destroy(pEncoder);
+
+	sshare_decoder* const		pDecoder = sshare_decoder_create();
+	std::vector<unsigned char>	recovered(secret.size());
+	size_t						recoveredSize = 0;
+	const void*					picked[3] = { pShares[4], pShares[0], pShares[2] };
+	CHECK(sshare_decode(pDecoder, picked, 3, shareSize, recovered.data(), recovered.size(), &recoveredSize) == SSHARE_OK);
+	CHECK(recoveredSize == secret.size() && recovered == secret);
+
+	// the trailer gives the payload away.
+	const unsigned char* pTail = shares[1].data() + shareSize - SSHARE_TAIL_SIZE;
+	CHECK(sshare_payload_size(pTail, SSHARE_TAIL_SIZE, shareSize) == SSHARE_HEADER_SIZE + 4 * secret.size());
+
+	// two shares miss the hash; a flipped byte drops its share, which leaves
+	// too few of three, but not of four.
+	CHECK(sshare_decode(pDecoder, picked, 2, shareSize, recovered.data(), recovered.size(), &recoveredSize) != SSHARE_OK);
+	shares[0][SSHARE_HEADER_SIZE + 10] ^= 1;
+	CHECK(sshare_decode(pDecoder, picked, 3, shareSize, recovered.data(), recovered.size(), &recoveredSize) != SSHARE_OK);
+	const void* more[4] = { pShares[4], pShares[0], pShares[2], pShares[3] };
+	CHECK(sshare_decode(pDecoder, more, 4, shareSize, recovered.data(), recovered.size(), &recoveredSize) == SSHARE_OK);
+	CHECK(recovered == secret);
+	sshare_decoder_destroy(pDecoder);
+}
+
+TEST(StreamingRoundTrip)
+{
+	const std::vector<unsigned char>	secret = _Secret(300001, 5);
+	sshare_encoder* const				pEncoder = sshare_encoder_create(4, 2);
+	Sink								sink;
+	sink.shares.resize(5);
+
+	for (size_t at = 0; at < secret.size(); at += 70000)
+	{
+		const size_t size = std::min<size_t>(70000, secret.size() - at);
+		CHECK(sshare_encode_update(pEncoder, secret.data() + at, size, _Write, &sink) == SSHARE_OK);
+	}
+	CHECK(sshare_encode_final(pEncoder, _Write, &sink) == SSHARE_OK);
+
+	// an aborting callback stops the set there.
+	CHECK(sshare_encode_update(pEncoder, secret.data(), 100, _Abort, nullptr) == SSHARE_E_ABORTED);
+	sshare_encoder_destroy(pEncoder);
+
+	const size_t shareSize = (size_t)sshare_share_size(secret.size());
+	for (unsigned int i = 1; i <= 4; ++i)
+	{
+		CHECK(sink.shares[i].size() == shareSize);
+	}
+
+	// the streamed shares decode in one go, and a stream at a time.
+	sshare_decoder* const		pDecoder = sshare_decoder_create();
+	std::vector<unsigned char>	recovered(secret.size());
+	size_t						recoveredSize = 0;
+	const void*					picked[2] = { sink.shares[4].data(), sink.shares[2].data() };
+	CHECK(sshare_decode(pDecoder, picked, 2, shareSize, recovered.data(), recovered.size(), &recoveredSize) == SSHARE_OK);
+	CHECK(recovered == secret);
+
+	Sink out;
+	out.shares.resize(1);
+	CHECK(sshare_decode_begin(pDecoder, picked, 2) == SSHARE_OK);
+	const size_t body = 4 * secret.size();
+	for (size_t at = 0; at < body; at += 4 * 30000)
+	{
+		const size_t	size = std::min<size_t>(4 * 30000, body - at);
+		const void*		chunks[2] = { sink.shares[4].data() + SSHARE_HEADER_SIZE + at, sink.shares[2].data() + SSHARE_HEADER_SIZE + at };
+		CHECK(sshare_decode_update(pDecoder, chunks, size, _Write, &out) == SSHARE_OK);
+	}
+	CHECK(sshare_decode_final(pDecoder) == SSHARE_OK);
+	CHECK(out.shares[0] == secret);
+	sshare_decoder_destroy(pDecoder);
+}
+
+TEST(AsyncRoundTrip)
+{
+	const std::vector<unsigned char>		secret = _Secret(1 << 20, 7);
+	const size_t							shareSize = (size_t)sshare_share_size(secret.size());
+	std::vector<std::vector<unsigned char>>	shares(5, std::vector<unsigned char>(shareSize));
+	void*									pShares[5];
+	for (int i = 0; i < 5; ++i)
+	{
+		pShares[i] = shares[i].data();
+	}
+
+	sshare_executor* const pExecutor = sshare_executor_create(4);
+	CHECK(sshare_encode_async(pExecutor, 2, 3, secret.data(), secret.size(), pShares, shareSize, nullptr, nullptr) == nullptr);
+
+	sshare_task* pTask = sshare_encode_async(pExecutor, 5, 3, secret.data(), secret.size(), pShares, shareSize, nullptr, nullptr);
+	CHECK(sshare_task_wait(pTask) == SSHARE_OK);
+	sshare_task_destroy(pTask);
+
+	std::vector<unsigned char>	recovered(secret.size());
+	const void*					picked[3] = { pShares[1], pShares[3], pShares[4] };
+	pTask = sshare_decode_async(pExecutor, picked, 3, shareSize, recovered.data(), recovered.size(), nullptr, nullptr);
+	CHECK(sshare_task_wait(pTask) == SSHARE_OK);
+	CHECK(recovered == secret);
+	sshare_task_destroy(pTask);
+
+	// files, through the same executor.
+	const std::filesystem::path	dir = _Scratch("async");
+	const std::string			in = (dir / "secret").string();
+	const std::string			out = (dir / "recovered").string();
+	const std::string			names[3] = { (dir / "s1").string(), (dir / "s2").string(), (dir / "s3").string() };
+	const char*					pNames[3] = { names[0].c_str(), names[1].c_str(), names[2].c_str() };
+	std::ofstream(in, std::ios::binary).write((const char*)secret.data(), secret.size());
+
+	pTask = sshare_encode_file_async(pExecutor, in.c_str(), pNames, 3, 2, nullptr, nullptr);
+	CHECK(sshare_task_wait(pTask) == SSHARE_OK);
+	sshare_task_destroy(pTask);
+
+	pTask = sshare_decode_files_async(pExecutor, out.c_str(), pNames + 1, 2, nullptr, nullptr);
+	CHECK(sshare_task_wait(pTask) == SSHARE_OK);
+	CHECK(_ReadFile(out) == secret);
+	sshare_task_destroy(pTask);
+
+	sshare_executor_destroy(pExecutor);
+	std::filesystem::remove_all(dir);
+}
+
+TEST(CliFilesInterop)
+{
+	if (g_cli.empty())
+	{
+		printf("  skipped: no --cli\n");
+		return;
+	}
+
+	// shares of sshare -e carry the checksum trailer: the file tasks read them,
+	// drop a damaged one by it, and write the same format back.
+	const std::filesystem::path			dir = _Scratch("cli-files");
+	const std::vector<unsigned char>	secret = _Secret(200000, 11);
+	_WriteFile(dir / "secret", secret);
+	CHECK(_RunCli("-e " + _Quoted(dir / "secret") + " 3 2"));
+
+	const std::string	cliNames[3] = { (dir / "secret-ssA").string(), (dir / "secret-ssB").string(), (dir / "secret-ssC").string() };
+	const char*			pCliNames[3] = { cliNames[0].c_str(), cliNames[1].c_str(), cliNames[2].c_str() };
+	const std::string	out = (dir / "recovered").string();
+
+	sshare_executor* const	pExecutor = sshare_executor_create(2);
+	sshare_task*			pTask = sshare_decode_files_async(pExecutor, out.c_str(), pCliNames + 1, 2, nullptr, nullptr);
+	CHECK(sshare_task_wait(pTask) == SSHARE_OK);
+	CHECK(_ReadFile(out) == secret);
+	sshare_task_destroy(pTask);
+
+	// the same shares in memory.
+	std::vector<std::vector<unsigned char>>	held = { _ReadFile(cliNames[2]), _ReadFile(cliNames[0]) };
+	const void*								pHeld[2] = { held[0].data(), held[1].data() };
+	std::vector<unsigned char>				recovered((size_t)sshare_secret_size(held[0].size()));
+	pTask = sshare_decode_async(pExecutor, pHeld, 2, held[0].size(), recovered.data(), recovered.size(), nullptr, nullptr);
+	CHECK(sshare_task_wait(pTask) == SSHARE_OK);
+	CHECK(recovered == secret);
+	sshare_task_destroy(pTask);
+
+	std::vector<unsigned char> damaged = _ReadFile(cliNames[0]);
+	damaged[SSHARE_HEADER_SIZE + 70000] ^= 1;
+	_WriteFile(cliNames[0], damaged);
+	std::filesystem::remove(out);
+	pTask = sshare_decode_files_async(pExecutor, out.c_str(), pCliNames, 3, nullptr, nullptr);
+	CHECK(sshare_task_wait(pTask) == SSHARE_OK);
+	CHECK(_ReadFile(out) == secret);
+	sshare_task_destroy(pTask);
+
+	const std::string	libNames[3] = { (dir / "lib-ssA").string(), (dir / "lib-ssB").string(), (dir / "lib-ssC").string() };
+	const char*			pLibNames[3] = { libNames[0].c_str(), libNames[1].c_str(), libNames[2].c_str() };
+	pTask = sshare_encode_file_async(pExecutor, (dir / "secret").string().c_str(), pLibNames, 3, 2, nullptr, nullptr);
+	CHECK(sshare_task_wait(pTask) == SSHARE_OK);
+	sshare_task_destroy(pTask);
+	sshare_executor_destroy(pExecutor);
+
+	CHECK(std::filesystem::file_size(libNames[0]) == std::filesystem::file_size(cliNames[1]));
+	CHECK(_RunCli("-d " + _Quoted(dir / "cli-") + " " + _Quoted(libNames[2]) + " " + _Quoted(libNames[0])));
+	CHECK(_ReadFile(dir / "cli-rvd-0") == secret);
+	std::filesystem::remove_all(dir);
+}
+
+TEST(CliMemoryInterop)
+{
+	if (g_cli.empty())
+	{
+		printf("  skipped: no --cli\n");
+		return;
+	}
+
+	// sshare -e shares through sshare_decode(), and both kinds of library
+	// shares through sshare -d.
+	const std::filesystem::path			dir = _Scratch("cli-memory");
+	const std::vector<unsigned char>	secret = _Secret(200000, 13);
+	_WriteFile(dir / "secret", secret);
+	CHECK(_RunCli("-e " + _Quoted(dir / "secret") + " 4 3"));
+
+	std::vector<std::vector<unsigned char>> cli;
+	for (const char* name : { "secret-ssA", "secret-ssB", "secret-ssC", "secret-ssD" })
+	{
+		cli.push_back(_ReadFile(dir / name));
+	}
+	const size_t shareSize = cli[0].size();
+	CHECK(shareSize == sshare_share_size(secret.size()));
+	CHECK(sshare_secret_size(shareSize) == secret.size());
+
+	sshare_decoder* const		pDecoder = sshare_decoder_create();
+	std::vector<unsigned char>	recovered((size_t)sshare_secret_size(shareSize));
+	size_t						recoveredSize = 0;
+	const void*					picked[3] = { cli[3].data(), cli[1].data(), cli[0].data() };
+	CHECK(sshare_decode(pDecoder, picked, 3, shareSize, recovered.data(), recovered.size(), &recoveredSize) == SSHARE_OK);
+	CHECK(recoveredSize == secret.size() && recovered == secret);
+
+	// streaming, up to the payload the trailer names.
+	Sink out;
+	out.shares.resize(1);
+	const uint64_t payloadSize = sshare_payload_size(cli[2].data() + shareSize - SSHARE_TAIL_SIZE, SSHARE_TAIL_SIZE, shareSize);
+	CHECK(payloadSize == SSHARE_HEADER_SIZE + 4 * secret.size());
+	const void* headers[3] = { cli[2].data(), cli[0].data(), cli[1].data() };
+	CHECK(sshare_decode_begin(pDecoder, headers, 3) == SSHARE_OK);
+	const void* bodies[3] = { cli[2].data() + SSHARE_HEADER_SIZE, cli[0].data() + SSHARE_HEADER_SIZE, cli[1].data() + SSHARE_HEADER_SIZE };
+	CHECK(sshare_decode_update(pDecoder, bodies, (size_t)payloadSize - SSHARE_HEADER_SIZE, _Write, &out) == SSHARE_OK);
+	CHECK(sshare_decode_final(pDecoder) == SSHARE_OK);
+	CHECK(out.shares[0] == secret);
+	sshare_decoder_destroy(pDecoder);
+
+	// library shares, whole and streamed, are sshare -e shares.
+	std::vector<std::vector<unsigned char>>	held(3, std::vector<unsigned char>(shareSize));
+	void*									pHeld[3] = { held[0].data(), held[1].data(), held[2].data() };
+	sshare_encoder* const					pEncoder = sshare_encoder_create(3, 2);
+	CHECK(sshare_encode(pEncoder, secret.data(), secret.size(), pHeld, shareSize) == SSHARE_OK);
+
+	Sink streamed;
+	streamed.shares.resize(4);
+	CHECK(sshare_encode_update(pEncoder, secret.data(), 150000, _Write, &streamed) == SSHARE_OK);
+	CHECK(sshare_encode_update(pEncoder, secret.data() + 150000, secret.size() - 150000, _Write, &streamed) == SSHARE_OK);
+	CHECK(sshare_encode_final(pEncoder, _Write, &streamed) == SSHARE_OK);
+	sshare_encoder_destroy(pEncoder);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		_WriteFile(dir / ("whole-ss" + std::string(1, (char)('A' + i))), held[i]);
+		_WriteFile(dir / ("streamed-ss" + std::string(1, (char)('A' + i))), streamed.shares[i + 1]);
+	}
+	CHECK(_RunCli("-d " + _Quoted(dir / "whole-") + " " + _Quoted(dir / "whole-ssC") + " " + _Quoted(dir / "whole-ssA")));
+	CHECK(_ReadFile(dir / "whole-rvd-0") == secret);
+	CHECK(_RunCli("-d " + _Quoted(dir / "streamed-") + " " + _Quoted(dir / "streamed-ssB") + " " + _Quoted(dir / "streamed-ssC")));
+	CHECK(_ReadFile(dir / "streamed-rvd-0") == secret);
+	std::filesystem::remove_all(dir);
+}
+
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strncmp(argv[i], "--cli=", 6) == 0)
+			g_cli = argv[i] + 6;
+	}
+	return RunTests(argc, argv);
+}
+
+TEST(CliRefreshRefused)
+{
+	if (g_cli.empty())
+	{
+		printf("  skipped: no --cli\n");
+		return;
+	}
+
+	// ida and the field engines have nothing sshare -f can renew: the files
+	// are left as they were. Shamir shares are refreshed as a control.
+	const std::filesystem::path			dir = _Scratch("cli-refresh");
+	const std::vector<unsigned char>	secret = _Secret(5000, 13);
+	const char*							engines[] = { "ida", "gf256", "gf65536", "p65809", "m31", "shamir" };
+	for (const char* engine : engines)
+	{
+		const std::filesystem::path base = dir / engine;
+		_WriteFile(base, secret);
+		CHECK(_RunCli(std::string("--engine=") + engine + " -e " + _Quoted(base) + " 3 2"));
+
+		const std::filesystem::path				names[3] = { base.string() + "-ssA", base.string() + "-ssB", base.string() + "-ssC" };
+		const std::vector<unsigned char>		before = _ReadFile(names[0]);
+		const bool								refreshed = _RunCli("-f 2 " + _Quoted(names[0]) + " " + _Quoted(names[1]) + " " + _Quoted(names[2]));
+		CHECK(refreshed == (strcmp(engine, "shamir") == 0));
+		CHECK((_ReadFile(names[0]) == before) == (false == refreshed));
+	}
+	std::filesystem::remove_all(dir);
+}
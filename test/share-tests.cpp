@@ -0,0 +1,498 @@
+// share-tests.cpp
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+
+#include "precompile.h"
+#include "datatypes.h"
+#include "allocator.h"
+#include "buffer.h"
+#include "checksum.h"
+#include "cipher.h"
+#include "field.h"
+#include "secret-share.h"
+#include "perf-counters.h"
+
+#include "test-harness.h"
+
+namespace
+{
+	// deterministic secrets, so a failure can be replayed.
+	OwnedBuffer _Secret(const size_t& size, const unsigned int& seed)
+	{
+		OwnedBuffer		secret(size);
+		Enco::uint32	state = seed * 2654435761u + 1;
+		for (size_t i = 0; i < size; ++i)
+		{
+			state = state * 1103515245u + 12345u;
+			secret.Data()[i] = (Enco::byte)(state >> 16);
+		}
+		return secret;
+	}
+
+	bool _Same(const BufferView& a, const BufferView& b)
+	{
+		return a.Size() == b.Size() && (a.Size() == 0 || memcmp(a.Data(), b.Data(), a.Size()) == 0);
+	}
+
+	std::vector<BufferView> _Pick(const std::vector<OwnedBuffer>& shares, const std::vector<size_t>& which)
+	{
+		std::vector<BufferView> views;
+		for (const size_t& i : which)
+		{
+			views.push_back(shares[i].View());
+		}
+		return views;
+	}
+
+	std::vector<OwnedBuffer> _Copy(const std::vector<OwnedBuffer>& shares)
+	{
+		std::vector<OwnedBuffer> copies;
+		for (const OwnedBuffer& share : shares)
+		{
+			copies.push_back(OwnedBuffer(share.Size()));
+			memcpy(copies.back().Data(), share.Data(), share.Size());
+		}
+		return copies;
+	}
+
+	// true only when the shares decode, and to the secret.
+	bool _Decodes(SecretSharer& sharer, const std::vector<BufferView>& shares, const BufferView& secret)
+	{
+		OwnedBuffer recovered(sharer.DecodedSize(shares[0]));
+		return sharer.Decode(recovered.MutableView(), shares) && _Same(recovered.View(), secret);
+	}
+
+	// flips one byte of the share body at every stride bytes from offset on.
+	void _Damage(OwnedBuffer& share, const size_t& offset, const size_t& stride)
+	{
+		for (size_t i = offset; i < share.Size(); i += stride)
+		{
+			share.Data()[i] ^= 0x5A;
+		}
+	}
+
+	const size_t g_cnst_strong_header = sizeof(GUID) + sizeof(Enco::uint32) + 32;
+
+	// a source that runs dry after a number of draws, as SystemRandom would.
+	class DryRandomer : public Randomer
+	{
+	public:
+		explicit DryRandomer(const size_t& draws) :
+		m_left(draws)
+		{}
+
+		virtual int Random() const override
+		{
+			if (m_left == 0)
+				return 0;
+			--m_left;
+			return (int)(m_left * 2654435761u >> 7);
+		}
+
+		virtual bool Failed() const override
+		{
+			return m_left == 0;
+		}
+
+	private:
+		mutable size_t	m_left;
+	};
+}
+
+
+
+TEST(ShamirRoundTrip)
+{
+	DefaultRandomer			randomer;
+	DefaultStrongSSharer	sharer(randomer);
+	const size_t			sizes[] = { 0, 1, 7, 1000, 100000 };
+	const unsigned int		sets[][2] = { { 2, 2 }, { 5, 3 }, { 8, 5 } };
+	for (const size_t& size : sizes)
+	{
+		for (const auto& set : sets)
+		{
+			const unsigned int			n = set[0];
+			const unsigned int			k = set[1];
+			const OwnedBuffer			secret = _Secret(size, n * 31 + k);
+			std::vector<OwnedBuffer>	shares;
+			CHECK(sharer.Encode(shares, n, k, secret.View()));
+			CHECK(shares.size() == n);
+
+			std::vector<size_t> first, last, all;
+			for (unsigned int i = 0; i < n; ++i)
+			{
+				all.push_back(i);
+				if (i < k)
+					first.push_back(i);
+				if (i >= n - k)
+					last.push_back(i);
+			}
+			CHECK(_Decodes(sharer, _Pick(shares, first), secret.View()));
+			CHECK(_Decodes(sharer, _Pick(shares, last), secret.View()));
+			CHECK(_Decodes(sharer, _Pick(shares, all), secret.View()));
+
+			// k - 1 shares miss the hash; one byte would still come out right
+			// one time in 256.
+			if (size >= 7)
+			{
+				first.pop_back();
+				CHECK(false == _Decodes(sharer, _Pick(shares, first), secret.View()));
+			}
+		}
+	}
+}
+
+TEST(ShamirLargeN)
+{
+	// n and k large enough for the NTT multipoint path.
+	DefaultRandomer				randomer;
+	DefaultStrongSSharer		sharer(randomer);
+	const OwnedBuffer			secret = _Secret(3000, 7);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(sharer.Encode(shares, 300, 200, secret.View()));
+
+	std::vector<size_t> picked;
+	for (size_t i = 0; i < 200; ++i)
+	{
+		picked.push_back(299 - i);
+	}
+	CHECK(_Decodes(sharer, _Pick(shares, picked), secret.View()));
+}
+
+TEST(ErrorCorrectionLimits)
+{
+	DefaultRandomer				randomer;
+	DefaultStrongSSharer		sharer(randomer);
+	const OwnedBuffer			secret = _Secret(5000, 11);
+	std::vector<OwnedBuffer>	clean;
+	CHECK(sharer.Encode(clean, 7, 3, secret.View()));
+
+	// 7 shares of a 3-of-7 set correct up to (7 - 3) / 2 = 2 bad ones.
+	for (size_t bad = 0; bad <= 3; ++bad)
+	{
+		std::vector<OwnedBuffer> shares = _Copy(clean);
+		for (size_t b = 0; b < bad; ++b)
+		{
+			_Damage(shares[1 + 2 * b], g_cnst_strong_header + 3 * b, 97);
+		}
+
+		std::vector<size_t>	badShares;
+		OwnedBuffer			recovered(secret.Size());
+		const bool			ok = sharer.Decode(recovered.MutableView(), _Pick(shares, { 0, 1, 2, 3, 4, 5, 6 }), 3, badShares);
+		if (bad <= 2)
+		{
+			CHECK(ok);
+			CHECK(_Same(recovered.View(), secret.View()));
+			CHECK(badShares.size() == bad);
+			for (size_t b = 0; b < badShares.size() && b < bad; ++b)
+			{
+				CHECK(badShares[b] == 1 + 2 * b);
+			}
+		}
+		else
+		{
+			// past the limit it must fail, never hand back a wrong secret.
+			CHECK(false == ok || _Same(recovered.View(), secret.View()));
+		}
+	}
+
+	// k = n leaves nothing to correct with: clean works, one bad share fails.
+	std::vector<OwnedBuffer> full;
+	CHECK(sharer.Encode(full, 4, 4, secret.View()));
+	{
+		std::vector<size_t>	badShares;
+		OwnedBuffer			recovered(secret.Size());
+		CHECK(sharer.Decode(recovered.MutableView(), _Pick(full, { 0, 1, 2, 3 }), 4, badShares));
+		CHECK(_Same(recovered.View(), secret.View()));
+		CHECK(badShares.empty());
+
+		_Damage(full[2], g_cnst_strong_header, 501);
+		CHECK(false == sharer.Decode(recovered.MutableView(), _Pick(full, { 0, 1, 2, 3 }), 4, badShares));
+	}
+}
+
+TEST(RepairRoundTrip)
+{
+	DefaultRandomer				randomer;
+	DefaultStrongSSharer		sharer(randomer);
+	const OwnedBuffer			secret = _Secret(20000, 13);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(sharer.Encode(shares, 5, 3, secret.View()));
+
+	// share 2 rebuilt from 1, 4 and 5 is the very same share.
+	OwnedBuffer repaired(shares[1].Size());
+	CHECK(sharer.Repair(repaired.MutableView(), _Pick(shares, { 0, 3, 4 }), 2));
+	CHECK(_Same(repaired.View(), shares[1].View()));
+
+	// fewer than k shares are refused.
+	CHECK(false == sharer.Repair(repaired.MutableView(), _Pick(shares, { 0, 3 }), 2));
+}
+
+TEST(RefreshRoundTrip)
+{
+	DefaultRandomer				randomer;
+	DefaultStrongSSharer		sharer(randomer);
+	const OwnedBuffer			secret = _Secret(20000, 17);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(sharer.Encode(shares, 5, 3, secret.View()));
+	const std::vector<OwnedBuffer> old = _Copy(shares);
+
+	std::vector<MutableBufferView> views;
+	for (OwnedBuffer& share : shares)
+	{
+		views.push_back(share.MutableView());
+	}
+
+	// a k that is not the set's is refused and leaves the shares alone.
+	CHECK(false == sharer.Refresh(views, 2));
+	CHECK(false == sharer.Refresh(views, 4));
+	for (size_t i = 0; i < shares.size(); ++i)
+	{
+		CHECK(_Same(shares[i].View(), old[i].View()));
+	}
+
+	CHECK(sharer.Refresh(views, 3));
+	CHECK(false == _Same(shares[0].View(), old[0].View()));
+	CHECK(_Decodes(sharer, _Pick(shares, { 0, 2, 4 }), secret.View()));
+	CHECK(_Decodes(sharer, _Pick(shares, { 1, 3, 4 }), secret.View()));
+
+	// an old share no longer combines with refreshed ones.
+	std::vector<BufferView> mixed = _Pick(shares, { 0, 1 });
+	mixed.push_back(old[2].View());
+	CHECK(false == _Decodes(sharer, mixed, secret.View()));
+}
+
+TEST(ReshareRoundTrip)
+{
+	DefaultRandomer				randomer;
+	DefaultStrongSSharer		sharer(randomer);
+	const OwnedBuffer			secret = _Secret(20000, 19);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(sharer.Encode(shares, 5, 3, secret.View()));
+
+	const std::vector<BufferView>	from = _Pick(shares, { 4, 1, 2 });
+	const size_t					size = sharer.ResharedSize(from[0], 4, 2);
+	std::vector<OwnedBuffer>		reshared;
+	std::vector<MutableBufferView>	views;
+	for (int i = 0; i < 4; ++i)
+	{
+		reshared.push_back(OwnedBuffer(size));
+		views.push_back(reshared.back().MutableView());
+	}
+	CHECK(sharer.Reshare(views, 4, 2, from));
+	CHECK(_Decodes(sharer, _Pick(reshared, { 0, 3 }), secret.View()));
+	CHECK(_Decodes(sharer, _Pick(reshared, { 2, 1 }), secret.View()));
+
+	// the new set is a set of its own.
+	std::vector<BufferView> mixed = _Pick(reshared, { 0 });
+	mixed.push_back(shares[0].View());
+	CHECK(false == _Decodes(sharer, mixed, secret.View()));
+}
+
+TEST(PackedRoundTrip)
+{
+	DefaultRandomer				randomer;
+	PackedSecretSharer			sharer(randomer, 2);
+	const OwnedBuffer			secret = _Secret(30001, 23);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(sharer.Encode(shares, 7, 5, secret.View()));
+	CHECK(PackedSecretSharer::IsPacked(shares[0].View()));
+	CHECK(_Decodes(sharer, _Pick(shares, { 0, 1, 2, 3, 4 }), secret.View()));
+	CHECK(_Decodes(sharer, _Pick(shares, { 6, 4, 2, 1, 5 }), secret.View()));
+	CHECK(false == _Decodes(sharer, _Pick(shares, { 0, 1, 2, 3 }), secret.View()));
+
+	OwnedBuffer repaired(shares[3].Size());
+	CHECK(sharer.Repair(repaired.MutableView(), _Pick(shares, { 0, 1, 2, 4, 5 }), 4));
+	CHECK(_Same(repaired.View(), shares[3].View()));
+
+	std::vector<MutableBufferView> views;
+	for (OwnedBuffer& share : shares)
+	{
+		views.push_back(share.MutableView());
+	}
+	CHECK(false == sharer.Refresh(views, 4));
+	CHECK(sharer.Refresh(views, 5));
+	CHECK(_Decodes(sharer, _Pick(shares, { 6, 5, 4, 3, 2 }), secret.View()));
+}
+
+TEST(KrawczykRoundTrip)
+{
+	DefaultRandomer				randomer;
+	KrawczykSecretSharer		sharer(randomer, 1024);
+	const OwnedBuffer			secret = _Secret(100000, 29);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(sharer.Encode(shares, 5, 3, secret.View()));
+
+	// computational shares are about a k-th of the secret.
+	if (Aes128Ctr::Available())
+		CHECK(shares[0].Size() < secret.Size() / 2);
+
+	CHECK(_Decodes(sharer, _Pick(shares, { 0, 1, 2 }), secret.View()));
+	CHECK(_Decodes(sharer, _Pick(shares, { 4, 2, 3 }), secret.View()));
+	CHECK(false == _Decodes(sharer, _Pick(shares, { 4, 2 }), secret.View()));
+
+	OwnedBuffer repaired(shares[0].Size());
+	CHECK(sharer.Repair(repaired.MutableView(), _Pick(shares, { 1, 2, 3 }), 1));
+	CHECK(_Same(repaired.View(), shares[0].View()));
+
+	// a small secret falls back to plain strong shares.
+	const OwnedBuffer			small = _Secret(100, 31);
+	std::vector<OwnedBuffer>	smallShares;
+	CHECK(sharer.Encode(smallShares, 3, 2, small.View()));
+	CHECK(_Decodes(sharer, _Pick(smallShares, { 2, 0 }), small.View()));
+}
+
+TEST(DispersalAndFieldRoundTrip)
+{
+	DefaultRandomer				randomer;
+	DispersalSharer				ida;
+	const OwnedBuffer			secret = _Secret(10007, 37);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(ida.Encode(shares, 6, 4, secret.View()));
+	CHECK(_Decodes(ida, _Pick(shares, { 5, 3, 1, 0 }), secret.View()));
+
+	FieldSecretSharer<Gf256Field>		gf256(randomer);
+	FieldSecretSharer<Gf65536Field>		gf65536(randomer);
+	FieldSecretSharer<ShamirField>		p65809(randomer);
+	FieldSecretSharer<Mersenne31Field>	m31(randomer);
+	SecretSharer* const					engines[] = { &gf256, &gf65536, &p65809, &m31 };
+	for (SecretSharer* const pEngine : engines)
+	{
+		std::vector<OwnedBuffer> fieldShares;
+		CHECK(pEngine->Encode(fieldShares, 5, 3, secret.View()));
+		CHECK(_Decodes(*pEngine, _Pick(fieldShares, { 4, 0, 2 }), secret.View()));
+	}
+}
+
+TEST(FailedRandomerRefused)
+{
+	const OwnedBuffer			secret = _Secret(5000, 43);
+	DefaultRandomer				randomer;
+	DefaultStrongSSharer		good(randomer);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(good.Encode(shares, 5, 3, secret.View()));
+
+	// dry from the start: nothing is drawn, the shares are left as they were.
+	DryRandomer							dry(0);
+	DefaultStrongSSharer				strong(dry);
+	PackedSecretSharer					packed(dry, 1);
+	FieldSecretSharer<Gf256Field>		gf256(dry);
+	std::vector<OwnedBuffer>			refused;
+	CHECK(false == strong.Encode(refused, 5, 3, secret.View()));
+	CHECK(false == packed.Encode(refused, 5, 3, secret.View()));
+	CHECK(false == gf256.Encode(refused, 5, 3, secret.View()));
+
+	const std::vector<OwnedBuffer>	old = _Copy(shares);
+	std::vector<MutableBufferView>	views;
+	for (OwnedBuffer& share : shares)
+	{
+		views.push_back(share.MutableView());
+	}
+	CHECK(false == strong.Refresh(views, 3));
+	for (size_t i = 0; i < shares.size(); ++i)
+	{
+		CHECK(_Same(shares[i].View(), old[i].View()));
+	}
+
+	// dry half way: the shares are not reported good.
+	DryRandomer				late(4000);
+	DefaultStrongSSharer	halfway(late);
+	CHECK(false == halfway.Encode(refused, 5, 3, secret.View()));
+}
+
+TEST(ChecksumTamper)
+{
+	DefaultRandomer				randomer;
+	DefaultStrongSSharer		inner(randomer);
+	ChecksummedSharer			sharer(inner);
+	const OwnedBuffer			secret = _Secret(200000, 41);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(sharer.Encode(shares, 4, 3, secret.View()));
+
+	std::vector<size_t> badChunks;
+	for (const OwnedBuffer& share : shares)
+	{
+		CHECK(ShareChecksum::HasTrailer(share.View()));
+		CHECK(ShareChecksum::Verify(share.View(), badChunks));
+	}
+
+	// one flipped byte is pinned to its 64 KB chunk.
+	const size_t at = 3 * ShareChecksum::m_cnst_chunk_size + 5;
+	shares[1].Data()[at] ^= 1;
+	CHECK(false == ShareChecksum::Verify(shares[1].View(), badChunks));
+	CHECK(badChunks.size() == 1 && badChunks[0] == 3);
+
+	// the damaged share is screened out, the other three still decode.
+	CHECK(_Decodes(sharer, _Pick(shares, { 0, 1, 2, 3 }), secret.View()));
+
+	std::vector<size_t>	badShares;
+	OwnedBuffer			recovered(secret.Size());
+	CHECK(sharer.Decode(recovered.MutableView(), _Pick(shares, { 0, 1, 2, 3 }), 3, badShares));
+	CHECK(badShares.size() == 1 && badShares[0] == 1);
+
+	// a damaged trailer counts as damage too.
+	shares[1].Data()[at] ^= 1;
+	shares[2].Data()[shares[2].Size() - 6] ^= 1;
+	CHECK(false == ShareChecksum::Verify(shares[2].View(), badChunks));
+}
+
+TEST(HeaderLastTrailer)
+{
+	// the trailer of a share written body first is the one Seal() writes.
+	const size_t sizes[] = { 0, 100, 65484, 65485, 300000 };
+	for (const size_t& body : sizes)
+	{
+		const size_t		payloadSize = g_cnst_strong_header + body;
+		const size_t		trailerSize = ShareChecksum::TrailerSize(payloadSize);
+		const OwnedBuffer	payload = _Secret(payloadSize, (unsigned int)body);
+		OwnedBuffer			sealed(payloadSize + trailerSize);
+		memcpy(sealed.Data(), payload.Data(), payloadSize);
+		ShareChecksum::Seal(sealed.MutableView(), payloadSize);
+
+		HeaderLastChecksum sum(g_cnst_strong_header);
+		for (size_t at = 0; at < body; at += 7000)
+		{
+			sum.Update(payload.Data() + g_cnst_strong_header + at, (body - at < 7000) ? body - at : 7000);
+		}
+
+		std::vector<Enco::byte> trailer;
+		sum.Trailer(payload.View().Sub(0, g_cnst_strong_header), trailer);
+		CHECK(trailer.size() == trailerSize);
+		CHECK(trailer.size() == trailerSize && memcmp(&trailer[0], sealed.Data() + payloadSize, trailerSize) == 0);
+	}
+}
+
+TEST(PerfCountersReport)
+{
+	// either the group counts, or the report says why it does not.
+	PerfCounters&			counters = PerfCounters::ThreadLocal();
+	PerfCounters::Sample	before, after;
+	const bool				read = counters.Read(before);
+	CHECK(read == counters.Available());
+
+	DefaultRandomer				randomer;
+	DefaultStrongSSharer		sharer(randomer);
+	const OwnedBuffer			secret = _Secret(100000, 43);
+	std::vector<OwnedBuffer>	shares;
+	CHECK(sharer.Encode(shares, 5, 3, secret.View()));
+
+	if (counters.Available())
+	{
+		CHECK(counters.Read(after));
+		const PerfCounters::Sample delta = PerfCounters::Delta(before, after);
+		CHECK(delta.values[PerfCounters::COUNTER_CYCLES] > 0);
+		CHECK(false == counters.Has(PerfCounters::COUNTER_INSTRUCTIONS) || delta.values[PerfCounters::COUNTER_INSTRUCTIONS] > 0);
+	}
+	else
+	{
+		CHECK(false == counters.Reason().empty());
+		CHECK(false == counters.Read(after));
+		printf("  counters: %s\n", counters.Reason().c_str());
+	}
+}
+
+int main(int argc, char** argv)
+{
+	return RunTests(argc, argv);
+}
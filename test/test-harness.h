@@ -0,0 +1,82 @@
+// test-harness.h
+// Author: 廖添(Tankle L.)
+// Date: October 19th, 2026
+
+#if !defined(TEST_HARNESS_H)
+#define TEST_HARNESS_H
+
+// TEST(name) { ... } registers a case, CHECK(condition) records a failure and
+// goes on. RunTests() runs every case, or those whose name holds the first
+// argument not starting with "--", and returns non-zero when any check
+// failed, for ctest.
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct TestCase
+{
+	const char*	name;
+	void		(*body)();
+};
+
+inline std::vector<TestCase>& TestCases()
+{
+	static std::vector<TestCase> cases;
+	return cases;
+}
+
+inline int& TestFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+struct TestRegistrar
+{
+	TestRegistrar(const char* name, void (*body)())
+	{
+		TestCases().push_back(TestCase{ name, body });
+	}
+};
+
+inline void TestFail(const char* file, const int line, const char* condition)
+{
+	++TestFailures();
+	fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, condition);
+}
+
+inline int RunTests(int argc, char** argv)
+{
+	const char*	filter = nullptr;
+	int			ran = 0;
+	for (int i = 1; i < argc && filter == nullptr; ++i)
+	{
+		if (strncmp(argv[i], "--", 2) != 0)
+			filter = argv[i];
+	}
+
+	for (const TestCase& test : TestCases())
+	{
+		if (filter != nullptr && strstr(test.name, filter) == nullptr)
+			continue;
+
+		const int before = TestFailures();
+		test.body();
+		++ran;
+		printf("%-40s %s\n", test.name, (TestFailures() == before) ? "ok" : "FAILED");
+	}
+
+	printf("%d cases, %d failed checks\n", ran, TestFailures());
+	return (ran == 0 || TestFailures() != 0) ? 1 : 0;
+}
+
+#define TEST(name) \
+	static void name(); \
+	static TestRegistrar name##_registrar(#name, name); \
+	static void name()
+
+#define CHECK(condition) \
+	do { if (!(condition)) TestFail(__FILE__, __LINE__, #condition); } while (0)
+
+#endif